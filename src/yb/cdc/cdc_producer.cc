@@ -189,6 +189,8 @@ Result<bool> SetCommittedRecordIndexForReplicateMsg(
       FALLTHROUGH_INTENDED;
     case consensus::OperationType::CHANGE_AUTO_FLAGS_CONFIG_OP:
       FALLTHROUGH_INTENDED;
+    case consensus::OperationType::INGEST_EXTERNAL_FILE_OP:
+      FALLTHROUGH_INTENDED;
     case consensus::OperationType::UNKNOWN_OP:
       return false;
   }
@@ -86,6 +86,13 @@ DEFINE_UNKNOWN_bool(forward_redis_requests, true,
     "part of the reply and ignores the rest. For now, if this flag is true, we will only "
     "attempt to read from leaders, so redis_allow_reads_from_followers will be ignored.");
 
+DEFINE_RUNTIME_bool(ybclient_strong_reads_from_closest_replica, false,
+    "Send strongly consistent single shard reads, that are not part of a transaction and have no "
+    "read time picked, to the closest replica instead of the leader. Followers serve such reads "
+    "using the leader read index when enable_follower_read_index is set on the tablet server, "
+    "otherwise they are rejected and retried at the leader.");
+TAG_FLAG(ybclient_strong_reads_from_closest_replica, advanced);
+
 DEFINE_UNKNOWN_bool(detect_duplicates_for_retryable_requests, true,
             "Enable tracking of write requests that prevents the same write from being applied "
                 "twice.");
@@ -134,6 +141,17 @@ bool LocalTabletServerOnly(const InFlightOps& ops) {
           !FLAGS_forward_redis_requests);
 }
 
+bool ReadFromClosestReplica(const AsyncRpcData& data, YBConsistencyLevel yb_consistency_level) {
+  if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX) {
+    return true;
+  }
+  return yb_consistency_level == YBConsistencyLevel::STRONG &&
+         GetAtomicFlag(&FLAGS_ybclient_strong_reads_from_closest_replica) &&
+         data.ops.front().yb_op->read_only() &&
+         !data.batcher->read_point() &&
+         data.batcher->in_flight_ops().metadata.transaction.transaction_id.IsNil();
+}
+
 void FillRequestIds(const RetryableRequestId request_id,
                     const RetryableRequestId min_running_request_id,
                     InFlightOps* ops) {
@@ -175,7 +193,7 @@ AsyncRpc::AsyncRpc(
       batcher_(data.batcher),
       ops_(data.ops),
       tablet_invoker_(LocalTabletServerOnly(ops_),
-                      yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX,
+                      ReadFromClosestReplica(data, yb_consistency_level),
                       data.batcher->client_,
                       this,
                       this,
@@ -599,6 +617,25 @@ WriteRpc::~WriteRpc() {
   ReleaseOps(req_.mutable_pgsql_write_batch());
 }
 
+void WriteRpc::SendRpc() {
+  // When the tablet leader recently asked writers to back off, hold the first attempt until the
+  // backoff expires instead of sending a write that would be rejected. Retries already got their
+  // delay from the rejection.
+  if (num_attempts() == 1) {
+    auto backoff = tablet().write_backoff_deadline() - CoarseMonoClock::now();
+    if (backoff > CoarseDuration::zero()) {
+      TRACE_TO(trace_, "Write backoff $0", MonoDelta(backoff));
+      auto status = mutable_retrier()->DelayedRetry(
+          this, STATUS(ServiceUnavailable, "Tablet write backoff"), MonoDelta(backoff));
+      if (status.ok()) {
+        return;
+      }
+      LOG(WARNING) << "Failed to delay write to " << tablet().tablet_id() << ": " << status;
+    }
+  }
+  AsyncRpc::SendRpc();
+}
+
 void WriteRpc::CallRemoteMethod() {
   auto trace = trace_; // It is possible that we receive reply before returning from WriteAsync.
                        // Since send happens before we return from WriteAsync.
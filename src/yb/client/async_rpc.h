@@ -174,6 +174,8 @@ class WriteRpc : public AsyncRpcBase<tserver::WriteRequestPB, tserver::WriteResp
 
   virtual ~WriteRpc();
 
+  void SendRpc() override;
+
  private:
   Status SwapResponses() override;
   void CallRemoteMethod() override;
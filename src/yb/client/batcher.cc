@@ -258,6 +258,9 @@ void Batcher::FlushAsync(
     }
   }
 
+  // Ops are usually grouped by table, so partition list is read once per group of ops.
+  const YBTable* table = nullptr;
+  VersionedTablePartitionListPtr partition_list;
   for (auto& op : ops_queue_) {
     VLOG_WITH_PREFIX(4) << "Looking up tablet for " << op.ToString()
                         << " partition key: " << Slice(op.partition_key).ToDebugHexString();
@@ -265,7 +268,11 @@ void Batcher::FlushAsync(
     if (op.yb_op->tablet()) {
       TabletLookupFinished(&op, op.yb_op->tablet());
     } else {
-      LookupTabletFor(&op);
+      if (op.yb_op->table().get() != table) {
+        table = op.yb_op->table().get();
+        partition_list = table->ArePartitionsStale() ? nullptr : table->GetVersionedPartitions();
+      }
+      LookupTabletFor(&op, partition_list);
     }
   }
 }
@@ -309,7 +316,16 @@ void Batcher::CombineError(const InFlightOp& in_flight_op) {
   }
 }
 
-void Batcher::LookupTabletFor(InFlightOp* op) {
+void Batcher::LookupTabletFor(
+    InFlightOp* op, const VersionedTablePartitionListPtr& partition_list) {
+  // Cache hit does not need lookup callback.
+  auto tablet = client_->data_->meta_cache_->LookupTabletByKeyCached(
+      op->yb_op->table()->id(), partition_list, op->partition_key);
+  if (tablet) {
+    TabletLookupFinished(op, std::move(tablet));
+    return;
+  }
+
   auto shared_this = shared_from_this();
   client_->data_->meta_cache_->LookupTabletByKey(
       op->yb_op->mutable_table(), op->partition_key, deadline_,
@@ -333,7 +349,9 @@ void Batcher::TabletLookupFinished(
           Status::OK() :
           op->yb_op->GetPartitionKey(&op->partition_key);
       if (status.ok()) {
-        LookupTabletFor(op);
+        const auto& table = op->yb_op->table();
+        LookupTabletFor(
+            op, table->ArePartitionsStale() ? nullptr : table->GetVersionedPartitions());
         return;
       }
     }
@@ -515,9 +533,16 @@ void Batcher::ExecuteOperations(Initial initial) {
     //
     // If transaction is not yet ready to do it, then it will notify as via provided when
     // it could be done.
-    if (!transaction->batcher_if().Prepare(
+    auto prepared = transaction->batcher_if().Prepare(
         &ops_info_, force_consistent_read_, deadline_, initial,
-        std::bind(&Batcher::TransactionReady, shared_from_this(), _1))) {
+        std::bind(&Batcher::TransactionReady, shared_from_this(), _1));
+    // Batches are assigned during the initial prepare, even if the transaction is not ready yet.
+    if (initial && transaction_prepared_callback_) {
+      auto callback = std::move(transaction_prepared_callback_);
+      transaction_prepared_callback_ = nullptr;
+      callback();
+    }
+    if (!prepared) {
       return;
     }
   } else if (force_consistent_read_ &&
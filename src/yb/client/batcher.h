@@ -191,6 +191,13 @@ class Batcher : public Runnable, public std::enable_shared_from_this<Batcher> {
   // associated transaction (if any) already expects them.
   void FlushAsync(StatusFunctor callback, IsWithinTransactionRetry is_within_transaction_retry);
 
+  // Sets callback that is invoked once operations of this batcher were prepared by the
+  // transaction, i.e. the transaction knows the number of write batches sent to each tablet.
+  // Not invoked if operations fail before that.
+  void SetTransactionPreparedCallback(std::function<void()> callback) {
+    transaction_prepared_callback_ = std::move(callback);
+  }
+
   CoarseTimePoint deadline() const {
     return deadline_;
   }
@@ -283,7 +290,8 @@ class Batcher : public Runnable, public std::enable_shared_from_this<Batcher> {
   void ProcessRpcStatus(const AsyncRpc &rpc, const Status &s);
 
   // Tablet lookup and its async callbacks.
-  void LookupTabletFor(InFlightOp* op);
+  // partition_list is the current partition list of the op table, used for the lookup in cache.
+  void LookupTabletFor(InFlightOp* op, const VersionedTablePartitionListPtr& partition_list);
   void TabletLookupFinished(InFlightOp* op, Result<internal::RemoteTabletPtr> result);
 
   void TransactionReady(const Status& status);
@@ -313,6 +321,8 @@ class Batcher : public Runnable, public std::enable_shared_from_this<Batcher> {
   // will be called exactly once (and the state changed to kFlushed).
   StatusFunctor flush_callback_;
 
+  std::function<void()> transaction_prepared_callback_;
+
   // All buffered or in-flight ops.
   // Added to this set during apply, removed during Finished of AsyncRpc.
   std::vector<std::shared_ptr<YBOperation>> ops_;
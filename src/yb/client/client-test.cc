@@ -131,6 +131,7 @@ DECLARE_int32(min_backoff_ms_exponent);
 DECLARE_int32(max_backoff_ms_exponent);
 DECLARE_bool(TEST_force_master_lookup_all_tablets);
 DECLARE_double(TEST_simulate_lookup_timeout_probability);
+DECLARE_bool(meta_cache_lock_free_lookup);
 
 DECLARE_bool(ysql_legacy_colocated_database_creation);
 DECLARE_int32(pgsql_proxy_webserver_port);
@@ -2653,6 +2654,62 @@ TEST_F(ClientTest, RefreshPartitions) {
   LOG(INFO) << "num_lookups_done: " << num_lookups_done;
 }
 
+TEST_F(ClientTest, LockFreeLookupTabletByKey) {
+  constexpr int kNumKeys = 100;
+  constexpr size_t kNumLookupThreads = 8;
+  const auto kLookupTimeout = 10s;
+  const auto kDuration = 3s;
+
+  auto* meta_cache = client_->data_->meta_cache_.get();
+  const auto table = client_table_.table();
+
+  std::vector<PartitionKey> partition_keys;
+  for (int i = 0; i != kNumKeys; ++i) {
+    const auto hash_code = RandomUniformInt<uint16_t>(0, PartitionSchema::kMaxPartitionKey);
+    partition_keys.push_back(PartitionSchema::EncodeMultiColumnHashValue(hash_code));
+  }
+
+  // After the cache is populated, lookups should be served from published partition indexes.
+  for (const auto& partition_key : partition_keys) {
+    auto tablet = ASSERT_RESULT(meta_cache->LookupTabletByKeyFuture(
+        table, partition_key, CoarseMonoClock::now() + kLookupTimeout).get());
+    auto cached_tablet = meta_cache->LookupTabletByKeyCached(
+        table->id(), table->GetVersionedPartitions(), partition_key);
+    ASSERT_TRUE(cached_tablet) << Slice(partition_key).ToDebugHexString();
+    ASSERT_EQ(cached_tablet->tablet_id(), tablet->tablet_id());
+  }
+
+  for (auto lock_free : {false, true}) {
+    FLAGS_meta_cache_lock_free_lookup = lock_free;
+    TestThreadHolder thread_holder;
+    std::atomic<size_t> total_lookups{0};
+    for (size_t i = 0; i != kNumLookupThreads; ++i) {
+      thread_holder.AddThreadFunctor(
+          [meta_cache, &table, &partition_keys, &total_lookups, kLookupTimeout,
+           &stop = thread_holder.stop_flag()] {
+        size_t lookups = 0;
+        while (!stop.load(std::memory_order_acquire)) {
+          const auto& partition_key = partition_keys[lookups % partition_keys.size()];
+          meta_cache->LookupTabletByKey(
+              table, partition_key, CoarseMonoClock::now() + kLookupTimeout,
+              [](const auto& result) {
+                ASSERT_OK(result);
+              });
+          ++lookups;
+        }
+        total_lookups.fetch_add(lookups);
+      });
+    }
+    thread_holder.WaitAndStop(kDuration);
+    LOG(INFO) << "Lock free: " << lock_free
+              << ", lookups/s: " << total_lookups.load() / kDuration.count();
+  }
+
+  // Lookups with stale partitions should go through the regular path, that refreshes them.
+  ASSERT_FALSE(meta_cache->LookupTabletByKeyCached(
+      table->id(), nullptr, partition_keys.front()));
+}
+
 class ColocationClientTest: public ClientTest {
  public:
   void SetUp() override {
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <list>
 #include <memory>
@@ -116,6 +117,11 @@ DEFINE_test_flag(double, simulate_lookup_timeout_probability, 0,
 DEFINE_test_flag(double, simulate_lookup_partition_list_mismatch_probability, 0,
                  "Probability for simulating the partition list mismatch error on tablet lookup.");
 
+DEFINE_RUNTIME_bool(meta_cache_lock_free_lookup, true,
+                    "Serve tablet lookups by partition key that hit the MetaCache from published "
+                    "immutable partition indexes, without locking the MetaCache.");
+TAG_FLAG(meta_cache_lock_free_lookup, advanced);
+
 METRIC_DEFINE_coarse_histogram(
   server, dns_resolve_latency_during_init_proxy,
   "yb.client.MetaCache.InitProxy DNS Resolve",
@@ -317,8 +323,7 @@ RemoteTablet::RemoteTablet(std::string tablet_id,
       partition_(std::move(partition)),
       partition_list_version_(partition_list_version),
       split_depth_(split_depth),
-      split_parent_tablet_id_(split_parent_tablet_id),
-      stale_(false) {
+      split_parent_tablet_id_(split_parent_tablet_id) {
 }
 
 RemoteTablet::~RemoteTablet() {
@@ -361,18 +366,17 @@ void RemoteTablet::Refresh(
   } else {
     ++lookups_without_new_replicas_;
   }
-  stale_ = false;
+  stale_.store(false, std::memory_order_release);
   refresh_time_.store(MonoTime::Now(), std::memory_order_release);
 }
 
 void RemoteTablet::MarkStale() {
   std::lock_guard<rw_spinlock> lock(mutex_);
-  stale_ = true;
+  stale_.store(true, std::memory_order_release);
 }
 
 bool RemoteTablet::stale() const {
-  SharedLock<rw_spinlock> lock(mutex_);
-  return stale_;
+  return stale_.load(std::memory_order_acquire);
 }
 
 void RemoteTablet::MarkAsSplit() {
@@ -636,6 +640,10 @@ void RemoteTablet::MakeLastKnownPartitionListVersionAtLeast(
       std::max(last_known_partition_list_version_, partition_list_version);
 }
 
+void RemoteTablet::ExtendWriteBackoff(CoarseTimePoint deadline) {
+  UpdateAtomicMax(&write_backoff_deadline_, deadline);
+}
+
 void LookupCallbackVisitor::operator()(const LookupTabletCallback& tablet_callback) const {
   if (error_status_) {
     tablet_callback(*error_status_);
@@ -671,6 +679,10 @@ MetaCache::MetaCache(YBClient* client)
 }
 
 MetaCache::~MetaCache() {
+  std::lock_guard<std::mutex> lock(partition_indexes_mutex_);
+  for (const auto* index : retired_partition_indexes_) {
+    delete index;
+  }
 }
 
 void MetaCache::SetLocalTabletServer(const string& permanent_uuid,
@@ -940,6 +952,7 @@ Status MetaCache::ProcessTabletLocations(
   RETURN_NOT_OK(CheckTabletLocations(locations));
 
   std::vector<std::pair<LookupCallback, LookupCallbackVisitor>> to_notify;
+  TablePartitionIndexUpdates partition_index_updates;
   {
     std::lock_guard<decltype(mutex_)> lock(mutex_);
     ProcessedTablesMap processed_tables;
@@ -961,8 +974,18 @@ Status MetaCache::ProcessTabletLocations(
       lookup_rpc->AddCallbacksToBeNotified(processed_tables, &tables_, &to_notify);
       lookup_rpc->CleanupRequest();
     }
+
+    for (const auto& processed_table : processed_tables) {
+      auto it = tables_.find(processed_table.first);
+      if (it != tables_.end() && it->second.partition_index_dirty) {
+        partition_index_updates.emplace_back(
+            processed_table.first, BuildPartitionIndexUnlocked(&it->second));
+      }
+    }
   }
 
+  PublishPartitionIndexes(&partition_index_updates);
+
   for (const auto& callback_and_param : to_notify) {
     boost::apply_visitor(callback_and_param.second, callback_and_param.first);
   }
@@ -1009,7 +1032,7 @@ Result<RemoteTabletPtr> MetaCache::ProcessTabletLocation(
 
   for (const std::string& table_id : location.table_ids()) {
     auto& processed_table = (*processed_tables)[table_id];
-    std::map<PartitionKey, RemoteTabletPtr>* tablets_by_key = nullptr;
+    TableData* table_data_to_update = nullptr;
 
     auto table_it = tables_.find(table_id);
     if (table_it == tables_.end() && location.table_ids_size() > 1 &&
@@ -1038,7 +1061,7 @@ Result<RemoteTabletPtr> MetaCache::ProcessTabletLocation(
         // version for both response and TableData.
         // This only can happen for those LookupTabletById requests that don't specify table,
         // because they don't care about partitions changing.
-        tablets_by_key = &table_data.tablets_by_partition;
+        table_data_to_update = &table_data;
       }
     }
 
@@ -1061,9 +1084,9 @@ Result<RemoteTabletPtr> MetaCache::ProcessTabletLocation(
 
       // For colocated tables, RemoteTablet already exists because it was processed
       // in a previous iteration of the for loop (for location.table_ids()).
-      // We need to add this tablet to the current table's tablets_by_key map.
-      if (tablets_by_key) {
-        (*tablets_by_key)[remote->partition().partition_key_start()] = remote;
+      // We need to add this tablet to the current table's tablets_by_partition map.
+      if (table_data_to_update) {
+        table_data_to_update->SetTabletForPartition(remote);
       }
 
       VLOG_WITH_PREFIX(5) << "Refreshing tablet " << tablet_id << ": "
@@ -1078,8 +1101,8 @@ Result<RemoteTabletPtr> MetaCache::ProcessTabletLocation(
           location.split_parent_tablet_id());
 
       CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
-      if (tablets_by_key) {
-        (*tablets_by_key)[partition.partition_key_start()] = remote;
+      if (table_data_to_update) {
+        table_data_to_update->SetTabletForPartition(remote);
       }
     }
     remote->Refresh(ts_cache_, location.replicas());
@@ -1114,6 +1137,7 @@ void MetaCache::InvalidateTableCache(const YBTable& table) {
       "table: $0, table.partition_list.version: $1", table_id, table_partition_list->version);
 
   std::vector<LookupCallback> to_notify;
+  TablePartitionIndexUpdates partition_index_updates;
 
   auto invalidate_needed = [this, &table_id, &table_partition_list](const auto& it) {
     const auto table_data_partition_list_version = it->second.partition_list->version;
@@ -1171,7 +1195,9 @@ void MetaCache::InvalidateTableCache(const YBTable& table) {
     // Only update partitions here after invalidating TableData cache to avoid inconsistencies.
     // See https://github.com/yugabyte/yugabyte-db/issues/6890.
     table_data.partition_list = table_partition_list;
+    partition_index_updates.emplace_back(table_id, BuildPartitionIndexUnlocked(&table_data));
   }
+  PublishPartitionIndexes(&partition_index_updates);
   for (const auto& callback : to_notify) {
     const auto s = STATUS_EC_FORMAT(
         TryAgain, ClientError(ClientErrorCode::kMetaCacheInvalidated),
@@ -1827,6 +1853,106 @@ boost::optional<std::vector<RemoteTabletPtr>> MetaCache::FastLookupAllTabletsUnl
   return tablets;
 }
 
+RemoteTabletPtr MetaCache::FastLookupTabletByKeyLockFree(
+    const TableId& table_id, const VersionedPartitionStartKey& partition_start) {
+  RemoteTabletPtr result;
+  {
+    // The index is accessed only while holders are referenced, see PublishPartitionIndexes.
+    auto holders = partition_indexes_.get();
+    auto it = holders->find(table_id);
+    if (it == holders->end()) {
+      return nullptr;
+    }
+    const auto* index = it->second->index.load(std::memory_order_acquire);
+    if (!index || index->partition_list_version != partition_start.partition_list_version) {
+      return nullptr;
+    }
+    auto* tablet = index->Find(*partition_start.key);
+    if (!tablet) {
+      return nullptr;
+    }
+    result = *tablet;
+  }
+
+  // Same checks as in LookupTabletByKeyFastPathUnlocked and FastLookupTabletByKeyUnlocked.
+  if (result->stale()) {
+    return nullptr;
+  }
+  const auto& partition_key_end = result->partition().partition_key_end();
+  if (!partition_key_end.empty() && partition_key_end.compare(*partition_start.key) <= 0) {
+    return nullptr;
+  }
+  if (!result->HasLeader()) {
+    return nullptr;
+  }
+  VLOG_WITH_PREFIX(5) << "Lock-free lookup: found tablet " << result->tablet_id();
+  return result;
+}
+
+TablePartitionIndexPtr MetaCache::BuildPartitionIndexUnlocked(TableData* table_data) {
+  auto result = std::make_unique<TablePartitionIndex>();
+  result->partition_list_version = table_data->partition_list->version;
+  result->generation = ++table_data->partition_index_generation;
+  result->partition_starts.reserve(table_data->tablets_by_partition.size());
+  result->tablets.reserve(table_data->tablets_by_partition.size());
+  for (const auto& [partition_start, tablet] : table_data->tablets_by_partition) {
+    result->partition_starts.push_back(partition_start);
+    result->tablets.push_back(tablet);
+  }
+  table_data->partition_index_dirty = false;
+  return result;
+}
+
+void MetaCache::PublishPartitionIndexes(TablePartitionIndexUpdates* updates) {
+  // Replaced indexes are deleted in batches, so synchronization with lock-free readers is amortized
+  // over several updates.
+  constexpr size_t kMaxRetiredPartitionIndexes = 16;
+
+  std::vector<const TablePartitionIndex*> to_delete;
+  {
+    std::lock_guard<std::mutex> lock(partition_indexes_mutex_);
+    for (auto& [table_id, index] : *updates) {
+      auto holder = PartitionIndexHolderUnlocked(table_id);
+      const auto* current = holder->index.load(std::memory_order_acquire);
+      // Indexes could be built in one order and published in another, keep the latest one.
+      if (current && current->generation >= index->generation) {
+        continue;
+      }
+      holder->index.store(index.release(), std::memory_order_release);
+      if (current) {
+        retired_partition_indexes_.push_back(current);
+      }
+    }
+    if (retired_partition_indexes_.size() >= kMaxRetiredPartitionIndexes) {
+      to_delete.swap(retired_partition_indexes_);
+    }
+  }
+
+  if (to_delete.empty()) {
+    return;
+  }
+  partition_indexes_.Synchronize();
+  for (const auto* index : to_delete) {
+    delete index;
+  }
+}
+
+TablePartitionIndexHolderPtr MetaCache::PartitionIndexHolderUnlocked(const TableId& table_id) {
+  TablePartitionIndexHolders holders;
+  {
+    auto current_holders = partition_indexes_.get();
+    auto it = current_holders->find(table_id);
+    if (it != current_holders->end()) {
+      return it->second;
+    }
+    holders = *current_holders;
+  }
+  auto result = std::make_shared<TablePartitionIndexHolder>();
+  holders.emplace(table_id, result);
+  partition_indexes_.Set(std::move(holders));
+  return result;
+}
+
 // We disable thread safety analysis in this function due to manual conditional locking.
 RemoteTabletPtr MetaCache::FastLookupTabletByKeyUnlocked(
     const TableId& table_id, const VersionedPartitionStartKey& partition_start) {
@@ -2023,6 +2149,15 @@ void MetaCache::LookupTabletByKey(const std::shared_ptr<YBTable>& table,
                     << ", partition_key: " << Slice(partition_key).ToDebugHexString()
                     << ", partition_start: " << Slice(*partition_start).ToDebugHexString();
 
+  if (GetAtomicFlag(&FLAGS_meta_cache_lock_free_lookup)) {
+    auto tablet = FastLookupTabletByKeyLockFree(
+        table->id(), {partition_start, table_partition_list->version});
+    if (tablet) {
+      callback(tablet);
+      return;
+    }
+  }
+
   PartitionGroupStartKeyPtr partition_group_start;
   if (DoLookupTabletByKey<SharedLock<std::shared_timed_mutex>>(
           table, table_partition_list, partition_start, deadline, &callback,
@@ -2037,6 +2172,17 @@ void MetaCache::LookupTabletByKey(const std::shared_ptr<YBTable>& table,
       << ", partition_key: " << Slice(partition_key).ToDebugHexString();
 }
 
+RemoteTabletPtr MetaCache::LookupTabletByKeyCached(
+    const TableId& table_id, const VersionedTablePartitionListPtr& partition_list,
+    const PartitionKey& partition_key) {
+  if (!partition_list || !GetAtomicFlag(&FLAGS_meta_cache_lock_free_lookup)) {
+    return nullptr;
+  }
+
+  const auto partition_start = client::FindPartitionStart(partition_list, partition_key);
+  return FastLookupTabletByKeyLockFree(table_id, {partition_start, partition_list->version});
+}
+
 void MetaCache::LookupAllTablets(const std::shared_ptr<YBTable>& table,
                                  CoarseTimePoint deadline,
                                  LookupTabletRangeCallback callback) {
@@ -2254,6 +2400,22 @@ TableData::TableData(const VersionedTablePartitionListPtr& partition_list_)
   DCHECK_ONLY_NOTNULL(partition_list);
 }
 
+void TableData::SetTabletForPartition(const RemoteTabletPtr& tablet) {
+  auto& current = tablets_by_partition[tablet->partition().partition_key_start()];
+  if (current != tablet) {
+    current = tablet;
+    partition_index_dirty = true;
+  }
+}
+
+const RemoteTabletPtr* TablePartitionIndex::Find(const PartitionKey& partition_start) const {
+  auto it = std::lower_bound(partition_starts.begin(), partition_starts.end(), partition_start);
+  if (it == partition_starts.end() || *it != partition_start) {
+    return nullptr;
+  }
+  return &tablets[it - partition_starts.begin()];
+}
+
 std::string VersionedPartitionStartKey::ToString() const {
   return YB_STRUCT_TO_STRING(key, partition_list_version);
 }
@@ -32,8 +32,10 @@
 // This module is internal to the client and not a public API.
 #pragma once
 
+#include <atomic>
 #include <shared_mutex>
 #include <map>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -64,6 +66,7 @@
 #include "yb/tserver/tserver_fwd.h"
 
 #include "yb/util/capabilities.h"
+#include "yb/util/concurrent_value.h"
 #include "yb/util/format.h"
 #include "yb/util/locks.h"
 #include "yb/util/lockfree.h"
@@ -347,6 +350,14 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
 
   void MakeLastKnownPartitionListVersionAtLeast(PartitionListVersion partition_list_version);
 
+  // Remembers backoff requested by the tablet leader that throttles writes, so writes sent to this
+  // tablet later are delayed until the deadline instead of being rejected.
+  void ExtendWriteBackoff(CoarseTimePoint deadline);
+
+  CoarseTimePoint write_backoff_deadline() const {
+    return write_backoff_deadline_.load(std::memory_order_acquire);
+  }
+
  private:
   // Same as ReplicasAsString(), except that the caller must hold mutex_.
   std::string ReplicasAsStringUnlocked() const;
@@ -360,7 +371,8 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
 
   // All non-const members are protected by 'mutex_'.
   mutable rw_spinlock mutex_;
-  bool stale_;
+  // Changed under mutex_, but read without it on the lookup fast path.
+  std::atomic<bool> stale_{false};
   bool is_split_ = false;
   std::vector<RemoteReplica> replicas_;
   PartitionListVersion last_known_partition_list_version_ = 0;
@@ -371,6 +383,8 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // checking whether it has been initialized everytime we use this value.
   std::atomic<MonoTime> refresh_time_{MonoTime::Min()};
 
+  std::atomic<CoarseTimePoint> write_backoff_deadline_{CoarseTimePoint()};
+
   int64_t lookups_without_new_replicas_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteTablet);
@@ -452,6 +466,14 @@ struct TableData {
   std::vector<RemoteTabletPtr> all_tablets;
   LookupDataGroup full_table_lookups;
   bool stale = false;
+  // Set when tablets_by_partition or partition_list was changed after TablePartitionIndex
+  // for this table was built.
+  bool partition_index_dirty = false;
+  uint64_t partition_index_generation = 0;
+
+  // Maps start of tablet partition to tablet, marking partition index dirty if it was changed.
+  void SetTabletForPartition(const RemoteTabletPtr& tablet);
+
   // To resolve partition_key to tablet_id MetaCache uses client::FindPartitionStart with
   // TableData::partition_list and then translates partition_start to tablet_id based on
   // TableData::tablets_by_partition.
@@ -468,6 +490,38 @@ struct TableData {
   // miss the key, because it doesn't exist in 1st post-split tablet.
 };
 
+// Immutable snapshot of TableData::tablets_by_partition, used to serve cache hits in
+// LookupTabletByKey without locking MetaCache::mutex_. It is replaced as a whole when table data
+// changes.
+struct TablePartitionIndex {
+  PartitionListVersion partition_list_version;
+  // Used to ignore snapshots that were published out of order.
+  uint64_t generation;
+  // Sorted partition starts and tablets serving them.
+  std::vector<PartitionKey> partition_starts;
+  std::vector<RemoteTabletPtr> tablets;
+
+  // Returns tablet that serves partition with specified start, or nullptr if it is not cached.
+  const RemoteTabletPtr* Find(const PartitionKey& partition_start) const;
+};
+
+using TablePartitionIndexPtr = std::unique_ptr<const TablePartitionIndex>;
+using TablePartitionIndexUpdates = std::vector<std::pair<TableId, TablePartitionIndexPtr>>;
+
+// Latest published partition index of a table. Readers access index only while holding a reference
+// to MetaCache::partition_indexes_, so a replaced index is deleted after
+// partition_indexes_.Synchronize().
+struct TablePartitionIndexHolder {
+  std::atomic<const TablePartitionIndex*> index{nullptr};
+
+  ~TablePartitionIndexHolder() {
+    delete index.load(std::memory_order_acquire);
+  }
+};
+
+using TablePartitionIndexHolderPtr = std::shared_ptr<TablePartitionIndexHolder>;
+using TablePartitionIndexHolders = std::unordered_map<TableId, TablePartitionIndexHolderPtr>;
+
 class LookupCallbackVisitor : public boost::static_visitor<> {
  public:
   explicit LookupCallbackVisitor(const LookupCallbackParam& param) : param_(param) {
@@ -522,6 +576,14 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
                          FailOnPartitionListRefreshed fail_on_partition_list_refreshed =
                              FailOnPartitionListRefreshed::kFalse);
 
+  // Looks up tablet with a leader for the given partition key using only the cached data, without
+  // locking and allocating memory. partition_list should be obtained by the caller from the table,
+  // nullptr means that table partitions are stale. Returns nullptr if the tablet is not cached, in
+  // this case LookupTabletByKey should be used.
+  RemoteTabletPtr LookupTabletByKeyCached(
+      const TableId& table_id, const VersionedTablePartitionListPtr& partition_list,
+      const PartitionKey& partition_key);
+
   std::future<Result<internal::RemoteTabletPtr>> LookupTabletByKeyFuture(
       const std::shared_ptr<YBTable>& table,
       const PartitionKey& partition_key,
@@ -595,6 +657,24 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   std::optional<RemoteTabletPtr> LookupTabletByIdFastPathUnlocked(const TabletId& tablet_id)
       REQUIRES_SHARED(mutex_);
 
+  // Same as FastLookupTabletByKeyUnlocked, but uses published partition indexes instead of
+  // tables_, so does not require mutex_.
+  RemoteTabletPtr FastLookupTabletByKeyLockFree(
+      const TableId& table_id, const VersionedPartitionStartKey& partition_start);
+
+  // Builds new partition index for the table and clears its dirty flag.
+  TablePartitionIndexPtr BuildPartitionIndexUnlocked(TableData* table_data) REQUIRES(mutex_);
+
+  // Publishes partition indexes built by BuildPartitionIndexUnlocked. Should be called after
+  // mutex_ is released, since publishing could wait for lock-free readers of partition_indexes_
+  // to complete.
+  void PublishPartitionIndexes(TablePartitionIndexUpdates* updates) EXCLUDES(mutex_);
+
+  // Returns holder of the partition index of the specified table, adding it to
+  // partition_indexes_ if it is absent.
+  TablePartitionIndexHolderPtr PartitionIndexHolderUnlocked(const TableId& table_id)
+      REQUIRES(partition_indexes_mutex_);
+
   // Update our information about the given tablet server.
   //
   // This is called when we get some response from the master which contains
@@ -697,6 +777,17 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   // Cache of tablets, keyed by tablet ID.
   std::unordered_map<TabletId, RemoteTabletPtr> tablets_by_id_ GUARDED_BY(mutex_);
 
+  // Serializes adding holders to partition_indexes_ and replacing indexes in them.
+  std::mutex partition_indexes_mutex_;
+
+  // Indexes replaced by PublishPartitionIndexes, that could still be accessed by lock-free readers.
+  std::vector<const TablePartitionIndex*> retired_partition_indexes_
+      GUARDED_BY(partition_indexes_mutex_);
+
+  // Holders of partition indexes of tables_, published for lock-free lookups. Holder of a table is
+  // added once, after that indexes of the table are replaced in the holder.
+  ConcurrentValue<TablePartitionIndexHolders> partition_indexes_;
+
   std::unordered_map<TabletId, LookupDataGroup> tablet_lookups_by_id_ GUARDED_BY(mutex_);
 
   // Cache of deleted tablets.
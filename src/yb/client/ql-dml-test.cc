@@ -29,6 +29,7 @@
 #include "yb/rocksdb/db.h"
 
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
 
 #include "yb/tserver/mini_tablet_server.h"
@@ -56,6 +57,8 @@ DECLARE_int32(yb_num_shards_per_tserver);
 DECLARE_int64(db_block_cache_size_bytes);
 DECLARE_bool(flush_rocksdb_on_shutdown);
 DECLARE_uint64(max_stale_read_bound_time_ms);
+DECLARE_bool(enable_follower_read_index);
+DECLARE_bool(ybclient_strong_reads_from_closest_replica);
 
 using namespace std::literals;
 
@@ -1239,6 +1242,39 @@ TEST_F(QLDmlTest, OpenRecentlyCreatedTable) {
   }
 }
 
+// Strong reads served by followers through the leader read index must observe every write
+// acknowledged before the read started.
+TEST_F(QLDmlTest, ReadFollowerWithReadIndex) {
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_enable_follower_read_index) = true;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_ybclient_strong_reads_from_closest_replica) = true;
+  constexpr int kNumRows = RegularBuildVsSanitizers(500, 100);
+
+  auto session = NewSession();
+  for (int i = 0; i != kNumRows; ++i) {
+    const auto key = KeyForIndex(i);
+    const auto value = ValueForIndex(i);
+    auto op = InsertRow(session, key, value);
+    ASSERT_OK(session->TEST_Flush());
+    ASSERT_EQ(op->response().status(), QLResponsePB::YQL_STATUS_OK);
+
+    auto row = ASSERT_RESULT(ReadRow(session, key));
+    ASSERT_EQ(row, value);
+  }
+
+  int64_t read_index_reads = 0;
+  for (size_t i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    auto peers = cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers();
+    for (const auto& peer : peers) {
+      auto tablet = peer->shared_tablet();
+      if (tablet) {
+        read_index_reads += tablet->metrics()->read_index_read_requests->value();
+      }
+    }
+  }
+  LOG(INFO) << "Reads served by followers using read index: " << read_index_reads;
+  ASSERT_GT(read_index_reads, 0);
+}
+
 TEST_F(QLDmlTest, ReadFollower) {
   DontVerifyClusterBeforeNextTearDown();
   FLAGS_flush_rocksdb_on_shutdown = false;
@@ -16,11 +16,13 @@
 #include <shared_mutex>
 #include <thread>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 
 #include "yb/client/client-test-util.h"
 #include "yb/client/error.h"
+#include "yb/client/meta_cache.h"
 #include "yb/client/ql-dml-test-base.h"
 #include "yb/client/schema.h"
 #include "yb/client/session.h"
@@ -31,15 +33,19 @@
 #include "yb/common/ql_type.h"
 #include "yb/common/ql_value.h"
 #include "yb/common/schema.h"
+#include "yb/common/wire_protocol.h"
 
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/quorum_util.h"
 #include "yb/consensus/raft_consensus.h"
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/dockv/doc_key.h"
+#include "yb/dockv/primitive_value.h"
 #include "yb/docdb/docdb_test_util.h"
+#include "yb/docdb/external_sst_file_writer.h"
 
 #include "yb/gutil/casts.h"
 
@@ -69,6 +75,7 @@
 #include "yb/tserver/tserver_service.proxy.h"
 
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
 #include "yb/util/range.h"
 #include "yb/util/shared_lock.h"
@@ -109,12 +116,26 @@ DECLARE_int32(timestamp_history_retention_interval_sec);
 DECLARE_int32(raft_heartbeat_interval_ms);
 DECLARE_int32(history_cutoff_propagation_interval_ms);
 DECLARE_int32(TEST_preparer_batch_inject_latency_ms);
+DECLARE_bool(enable_adaptive_group_replicate_batching);
+DECLARE_uint64(adaptive_group_replicate_batch_min_bytes);
+DECLARE_int32(log_inject_append_latency_ms_max);
 DECLARE_double(leader_failure_max_missed_heartbeat_periods);
 DECLARE_int32(TEST_backfill_sabotage_frequency);
 DECLARE_string(regular_tablets_data_block_key_value_encoding);
 DECLARE_string(compression_type);
 DECLARE_bool(ycql_enable_packed_row);
+DECLARE_bool(TEST_skip_ingest_external_file_on_followers);
+DECLARE_string(ingest_external_file_dir);
 DECLARE_bool(ysql_enable_packed_row);
+DECLARE_bool(enable_load_balancing);
+DECLARE_bool(enable_tablet_write_throttling);
+DECLARE_double(tablet_write_throttling_sst_files_ratio);
+DECLARE_uint64(tablet_write_throttling_min_rate_bytes_per_sec);
+
+METRIC_DECLARE_histogram(group_replicate_batch_size);
+METRIC_DECLARE_histogram(group_replicate_batch_wait_time);
+METRIC_DECLARE_gauge_uint64(group_replicate_batch_limit_bytes);
+METRIC_DECLARE_counter(write_throttling_rejections);
 
 namespace yb {
 namespace client {
@@ -429,6 +450,72 @@ class QLTabletTest : public QLDmlTestBase<MiniCluster> {
     return Status::OK();
   }
 
+  // Builds SST file with rows [begin, end) of the single tablet table in ingest_external_file_dir
+  // and ingests it with the IngestExternalFile RPC to the tablet leader.
+  Status IngestRows(int begin, int end, const std::string& file_name, const TableHandle& table) {
+    auto tablet_ids = VERIFY_RESULT(GetTabletIdsAndReplicas(table)).first;
+    SCHECK_EQ(tablet_ids.size(), 1U, IllegalState, "Single tablet table expected");
+    const auto& tablet_id = tablet_ids.front();
+    auto* leader = GetLeaderForTablet(cluster_.get(), tablet_id);
+    SCHECK(leader, NotFound, Format("No leader for $0", tablet_id));
+    auto leader_peer = VERIFY_RESULT(leader->server()->tablet_manager()->GetTablet(tablet_id));
+    auto tablet = VERIFY_RESULT(leader_peer->shared_tablet_safe());
+
+    // Records should be added in the order of encoded keys.
+    std::map<std::string, std::string> records;
+    for (int i = begin; i != end; ++i) {
+      std::string partition_key;
+      RETURN_NOT_OK(CreateReadOp(i, table)->GetPartitionKey(&partition_key));
+      dockv::SubDocKey sub_doc_key(
+          dockv::DocKey(
+              dockv::PartitionSchema::DecodeMultiColumnHashValue(partition_key),
+              {dockv::KeyEntryValue::Int32(i)}),
+          dockv::KeyEntryValue::MakeColumnId(ColumnId(table.ColumnId(kValueColumn))));
+      QLValuePB value;
+      value.set_int32_value(ValueForKey(i));
+      dockv::AppendEncodedValue(value, &records[sub_doc_key.Encode().ToStringBuffer()]);
+    }
+
+    auto file_path = JoinPathSegments(FLAGS_ingest_external_file_dir, file_name);
+    docdb::ExternalSstFileWriter writer(tablet->TEST_db()->GetOptions(), docdb::KeyBounds());
+    RETURN_NOT_OK(writer.Open(file_path));
+    for (const auto& [key, value] : records) {
+      RETURN_NOT_OK(writer.Add(key, value));
+    }
+    RETURN_NOT_OK(writer.Finish());
+
+    auto endpoint = leader->server()->rpc_server()->GetBoundAddresses().front();
+    tserver::TabletServerServiceProxy proxy(
+        &leader->server()->proxy_cache(), HostPort::FromBoundEndpoint(endpoint));
+    tserver::IngestExternalFileRequestPB req;
+    tserver::IngestExternalFileResponsePB resp;
+    req.set_tablet_id(tablet_id);
+    req.mutable_ingest()->set_file_path(file_path);
+    rpc::RpcController controller;
+    controller.set_timeout(30s);
+    RETURN_NOT_OK(proxy.IngestExternalFile(req, &resp, &controller));
+    if (resp.has_error()) {
+      return StatusFromPB(resp.error().status());
+    }
+
+    // Tablet peers use the copy staged by the leader, so the client could remove its file.
+    return Env::Default()->DeleteFile(file_path);
+  }
+
+  // Returns files staged for ingest in ingest_external_file_dir.
+  Result<std::vector<std::string>> StagedFiles() {
+    auto children = VERIFY_RESULT(Env::Default()->GetChildren(
+        FLAGS_ingest_external_file_dir, ExcludeDots::kTrue));
+    std::vector<std::string> result;
+    for (const auto& child : children) {
+      if (boost::ends_with(child, ".staged")) {
+        result.push_back(child);
+      }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
   Status Import() {
     std::this_thread::sleep_for(1s); // Wait until all tablets a synced and flushed.
     EXPECT_OK(cluster_->FlushTablets());
@@ -573,6 +660,46 @@ TEST_F(QLTabletTest, OverlappedImport) {
   ASSERT_NOK(Import());
 }
 
+TEST_F(QLTabletTest, IngestExternalFile) {
+  CreateTable(kTable1Name, &table1_, /* num_tablets= */ 1);
+  FillTable(0, kTotalKeys, table1_);
+
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_ingest_external_file_dir) = GetTestPath("ingest");
+  ASSERT_OK(Env::Default()->CreateDir(FLAGS_ingest_external_file_dir));
+  // Files outside of the shared directory are rejected.
+  ASSERT_NOK(IngestRows(kTotalKeys, 2 * kTotalKeys, "../ingest0.sst", table1_));
+  ASSERT_TRUE(ASSERT_RESULT(StagedFiles()).empty());
+
+  // Followers skip the ingest, so they ingest the file when the operation is replayed by tablet
+  // bootstrap after restart.
+  FLAGS_TEST_skip_ingest_external_file_on_followers = true;
+  ASSERT_OK(IngestRows(kTotalKeys, 2 * kTotalKeys, "ingest1.sst", table1_));
+  VerifyTable(0, 2 * kTotalKeys, table1_);
+  FLAGS_TEST_skip_ingest_external_file_on_followers = false;
+
+  ASSERT_OK(cluster_->RestartSync());
+  ASSERT_OK(WaitSync(0, 2 * kTotalKeys, table1_));
+  VerifyTable(0, 2 * kTotalKeys, table1_);
+
+  // Staged file of the first ingest could be leaked, since it was registered only before restart.
+  auto leaked_files = ASSERT_RESULT(StagedFiles());
+
+  // Ingested records overlap the key range of existing ones, and are replicated to followers.
+  ASSERT_OK(IngestRows(2 * kTotalKeys, 3 * kTotalKeys, "ingest2.sst", table1_));
+  ASSERT_OK(WaitSync(0, 3 * kTotalKeys, table1_));
+  VerifyTable(0, 3 * kTotalKeys, table1_);
+  ASSERT_EQ(ASSERT_RESULT(StagedFiles()).size(), leaked_files.size() + 1);
+
+  // Leader removes the staged file once all peers applied the operation.
+  ASSERT_OK(WaitFor([this, &leaked_files]() -> Result<bool> {
+    for (const auto& peer : ListTableActiveTabletLeadersPeers(cluster_.get(), table1_->id())) {
+      peer->CleanupStagedExternalFiles();
+    }
+    return VERIFY_RESULT(StagedFiles()) == leaked_files;
+  }, 30s * kTimeMultiplier, "Cleanup staged files"));
+  VerifyTable(0, 3 * kTotalKeys, table1_);
+}
+
 void QLTabletTest::CreateAndVerifyIndexConsistency(const int expected_number_rows_mismatched) {
   CreateTable(kTable1Name, &table1_, 1, true);
   FillTable(0, kTotalKeys, table1_);
@@ -1589,6 +1716,164 @@ TEST_F(QLTabletTest, SlowPrepare) {
   workload.StopAndJoin();
 }
 
+TEST_F(QLTabletTest, AdaptiveReplicateBatching) {
+  constexpr uint64_t kMinBatchBytes = 1_KB;
+  FLAGS_enable_adaptive_group_replicate_batching = true;
+  // Use low minimal limit, so batches of small writes fill it.
+  FLAGS_adaptive_group_replicate_batch_min_bytes = kMinBatchBytes;
+
+  TestWorkload workload(cluster_.get());
+  workload.set_table_name(kTable1Name);
+  workload.set_write_timeout_millis(30000 * kTimeMultiplier);
+  workload.set_num_tablets(1);
+  workload.set_num_write_threads(32);
+  workload.set_write_batch_size(1);
+  workload.Setup();
+
+  const auto peers = ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders);
+  ASSERT_EQ(peers.size(), 1);
+  const auto& entity = peers[0]->tablet()->GetTabletMetricsEntity();
+  auto limit_bytes = METRIC_group_replicate_batch_limit_bytes.Instantiate(entity, 0);
+  ASSERT_EQ(limit_bytes->value(), kMinBatchBytes);
+
+  workload.Start();
+  // While WAL is fast, the limit grows.
+  ASSERT_OK(WaitFor([&limit_bytes] {
+    return limit_bytes->value() > kMinBatchBytes;
+  }, 10s * kTimeMultiplier, "Batch limit grows"));
+  LOG(INFO) << "Grown batch limit: " << limit_bytes->value();
+
+  // Slow WAL appends shrink the limit back to the lower bound.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_log_inject_append_latency_ms_max) = 20;
+  ASSERT_OK(WaitFor([&limit_bytes] {
+    return limit_bytes->value() == kMinBatchBytes;
+  }, 10s * kTimeMultiplier, "Batch limit shrinks"));
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_log_inject_append_latency_ms_max) = 0;
+
+  workload.StopAndJoin();
+  ASSERT_GT(workload.rows_inserted(), 0);
+
+  auto batch_size = METRIC_group_replicate_batch_size.Instantiate(entity);
+  auto wait_time = METRIC_group_replicate_batch_wait_time.Instantiate(entity);
+  LOG(INFO) << "Batches: " << batch_size->TotalCount()
+            << ", max batch size: " << batch_size->MaxValueForTests()
+            << ", max wait time: " << wait_time->MaxValueForTests();
+  ASSERT_GT(batch_size->TotalCount(), 0);
+  ASSERT_EQ(wait_time->TotalCount(), batch_size->TotalCount());
+}
+
+// Read request is parsed into the call arena, while the read path fills remote endpoint and proxy
+// uuid of each QL read. Sends batched reads with proxy uuid over TCP, so sanitizer builds catch
+// invalid frees of these fields when the call arena is destroyed.
+TEST_F(QLTabletTest, ReadWithProxyUuid) {
+  constexpr int kKeys = 20;
+  FillTable(0, kKeys, table1_);
+
+  auto [tablet_ids, replicas] = ASSERT_RESULT(GetTabletIdsAndReplicas(table1_));
+  for (const auto& replica : replicas) {
+    auto* tserver = cluster_->find_tablet_server(replica);
+    ASSERT_NE(tserver, nullptr);
+    tserver::TabletServerServiceProxy proxy(
+        &tserver->server()->proxy_cache(),
+        HostPort::FromBoundEndpoint(tserver->bound_rpc_addr()));
+    for (const auto& tablet_id : tablet_ids) {
+      tserver::ReadRequestPB req;
+      req.set_tablet_id(tablet_id);
+      req.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+      req.set_proxy_uuid("test_proxy");
+      for (int key = 0; key != kKeys; ++key) {
+        std::string partition_key;
+        auto op = CreateReadOp(key, table1_);
+        ASSERT_OK(op->GetPartitionKey(&partition_key));
+        auto* ql_batch = req.add_ql_batch();
+        *ql_batch = op->request();
+        auto hash_code = dockv::PartitionSchema::DecodeMultiColumnHashValue(partition_key);
+        ql_batch->set_hash_code(hash_code);
+        ql_batch->set_max_hash_code(hash_code);
+      }
+
+      rpc::RpcController controller;
+      controller.set_timeout(10s);
+      tserver::ReadResponsePB resp;
+      ASSERT_OK(proxy.Read(req, &resp, &controller));
+      ASSERT_FALSE(resp.has_error()) << resp.error().ShortDebugString();
+      ASSERT_EQ(resp.ql_batch_size(), kKeys);
+      for (const auto& ql_resp : resp.ql_batch()) {
+        ASSERT_EQ(ql_resp.status(), QLResponsePB_QLStatus_YQL_STATUS_OK);
+      }
+    }
+  }
+}
+
+TEST_F(QLTabletTest, WriteBackoff) {
+  constexpr auto kBackoff = 2s;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  auto session = CreateSession();
+  SetValue(session, 1, ValueForKey(1), table);
+
+  auto remote_tablet = ASSERT_RESULT(client_->LookupTabletByKeyFuture(
+      table.table(), /* partition_key =*/ "", CoarseMonoClock::now() + 10s).get());
+  remote_tablet->ExtendWriteBackoff(CoarseMonoClock::now() + kBackoff);
+
+  // First attempt of the write waits until the backoff expires.
+  auto start = CoarseMonoClock::now();
+  SetValue(session, 2, ValueForKey(2), table);
+  auto elapsed = CoarseMonoClock::now() - start;
+  LOG(INFO) << "Write time: " << MonoDelta(elapsed);
+  ASSERT_GE(elapsed, kBackoff - 100ms);
+}
+
+TEST_F(QLTabletTest, WriteThrottlingBySstFiles) {
+  constexpr int kNumFlushes = 4;
+  constexpr int kRowsPerFlush = 20;
+
+  FLAGS_enable_tablet_write_throttling = true;
+  FLAGS_rocksdb_disable_compactions = true;
+  // Throttling starts at half of the soft limit and reaches the min rate at the soft limit, while
+  // the huge hard limit keeps the SST files check from rejecting writes on its own.
+  FLAGS_sst_files_soft_limit = kNumFlushes;
+  FLAGS_sst_files_hard_limit = std::numeric_limits<uint64_t>::max() / 4;
+  FLAGS_tablet_write_throttling_sst_files_ratio = 0.5;
+  FLAGS_tablet_write_throttling_min_rate_bytes_per_sec = 1_KB;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  auto session = CreateSession();
+  int key = 0;
+  for (int i = 0; i != kNumFlushes; ++i) {
+    for (int j = 0; j != kRowsPerFlush; ++j) {
+      ++key;
+      SetValue(session, key, ValueForKey(key), table);
+    }
+    ASSERT_OK(cluster_->FlushTablets());
+  }
+
+  const auto peers = ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders);
+  ASSERT_EQ(peers.size(), 1);
+  const auto& peer = peers[0];
+  ASSERT_OK(WaitFor([&peer] {
+    return peer->raft_consensus()->MajorityNumSSTFiles() >= kNumFlushes;
+  }, 10s * kTimeMultiplier, "Majority SST files"));
+
+  auto rejections = METRIC_write_throttling_rejections.Instantiate(
+      peer->tablet()->GetTabletMetricsEntity());
+  auto remote_tablet = ASSERT_RESULT(client_->LookupTabletByKeyFuture(
+      table.table(), /* partition_key =*/ "", CoarseMonoClock::now() + 10s).get());
+
+  // Writes at the min rate are rejected, but still succeed after the client backs off.
+  const auto end_key = key + 200;
+  while (rejections->value() == 0 && key < end_key) {
+    ++key;
+    SetValue(session, key, ValueForKey(key), table);
+  }
+  LOG(INFO) << "Rejections: " << rejections->value() << ", keys: " << key;
+  ASSERT_GT(rejections->value(), 0);
+  ASSERT_NE(remote_tablet->write_backoff_deadline(), CoarseTimePoint());
+  VerifyTable(1, key + 1, table);
+}
+
 TEST_F(QLTabletTest, ElectUnsynchronizedFollower) {
   TableHandle table;
   CreateTable(kTable1Name, &table, 1);
@@ -1630,6 +1915,140 @@ TEST_F(QLTabletTest, ElectUnsynchronizedFollower) {
     tserver::WaitTabletsBootstrapped::kFalse));
 }
 
+Status ChangeTabletConfig(
+    const tablet::TabletPeerPtr& leader, consensus::ChangeConfigType type,
+    tserver::MiniTabletServer* server, bool is_witness = false) {
+  consensus::ChangeConfigRequestPB req;
+  req.set_tablet_id(leader->tablet_id());
+  req.set_type(type);
+  auto& peer = *req.mutable_server();
+  peer.set_permanent_uuid(server->server()->permanent_uuid());
+  if (type == consensus::ADD_SERVER) {
+    peer.set_member_type(consensus::PeerMemberType::PRE_VOTER);
+    peer.set_is_witness(is_witness);
+    HostPortToPB(
+        HostPort::FromBoundEndpoint(server->bound_rpc_addr()),
+        peer.mutable_last_known_private_addr()->Add());
+  }
+  boost::optional<tserver::TabletServerErrorPB::Code> error_code;
+  return leader->raft_consensus()->ChangeConfig(req, [](const Status&) {}, &error_code);
+}
+
+// Witness replica should vote and replicate the WAL, but should not apply ops, serve reads or stay
+// leader.
+TEST_F(QLTabletTest, WitnessReplica) {
+  FLAGS_enable_load_balancing = false;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table, 1);
+  auto session = CreateSession();
+  SetValue(session, 1, -1, table);
+
+  auto leader_idx = ASSERT_RESULT(ServerWithLeaders(cluster_.get()));
+  auto follower_idx = (leader_idx + 1) % cluster_->num_tablet_servers();
+  auto removed_idx = (leader_idx + 2) % cluster_->num_tablet_servers();
+  auto leader_peer = ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders).front();
+  const auto tablet_id = leader_peer->tablet_id();
+
+  ASSERT_OK(cluster_->AddTabletServer());
+  auto* witness_server = cluster_->mini_tablet_server(cluster_->num_tablet_servers() - 1);
+  const auto witness_uuid = witness_server->server()->permanent_uuid();
+  LOG(INFO) << "Witness: " << witness_uuid;
+
+  // Replace data follower with witness, so the tablet has two data replicas and a witness.
+  ASSERT_OK(ChangeTabletConfig(
+      leader_peer, consensus::REMOVE_SERVER, cluster_->mini_tablet_server(removed_idx)));
+  ASSERT_OK(WaitFor([&leader_peer, removed_idx, this] {
+    return !consensus::IsRaftConfigMember(
+        cluster_->mini_tablet_server(removed_idx)->server()->permanent_uuid(),
+        leader_peer->raft_consensus()->CommittedConfig());
+  }, 30s, "Remove data follower"));
+  ASSERT_OK(ChangeTabletConfig(
+      leader_peer, consensus::ADD_SERVER, witness_server, /* is_witness= */ true));
+  ASSERT_OK(WaitFor([&leader_peer, &witness_uuid] {
+    auto config = leader_peer->raft_consensus()->CommittedConfig();
+    return consensus::IsRaftConfigVoter(witness_uuid, config) &&
+           consensus::IsRaftConfigWitness(witness_uuid, config);
+  }, 60s, "Add witness"));
+
+  for (int key = 2; key != 10; ++key) {
+    SetValue(session, key, -key, table);
+  }
+
+  auto witness_peer = ASSERT_RESULT(
+      witness_server->server()->tablet_manager()->GetTablet(tablet_id));
+  ASSERT_OK(WaitFor([&witness_peer, &leader_peer] {
+    return witness_peer->raft_consensus()->GetLastCommittedOpId() >=
+           leader_peer->raft_consensus()->GetLastCommittedOpId();
+  }, 30s, "Witness replicates WAL"));
+  ASSERT_TRUE(witness_peer->tablet()->is_witness());
+  ASSERT_TRUE(witness_peer->tablet_metadata()->is_witness());
+  // Witness was seeded by remote bootstrap with the first row, but did not apply later ones.
+  ASSERT_LE(ASSERT_RESULT(witness_peer->tablet()->TEST_CountRegularDBRecords()), 1U);
+  ASSERT_GT(ASSERT_RESULT(leader_peer->tablet()->TEST_CountRegularDBRecords()), 1U);
+
+  // Follower read from witness is rejected, so client retries it on a data replica.
+  {
+    tserver::TabletServerServiceProxy proxy(
+        &witness_server->server()->proxy_cache(),
+        HostPort::FromBoundEndpoint(witness_server->bound_rpc_addr()));
+    tserver::ReadRequestPB req;
+    std::string partition_key;
+    auto op = CreateReadOp(1, table);
+    ASSERT_OK(op->GetPartitionKey(&partition_key));
+    auto* ql_batch = req.add_ql_batch();
+    *ql_batch = op->request();
+    auto hash_code = dockv::PartitionSchema::DecodeMultiColumnHashValue(partition_key);
+    ql_batch->set_hash_code(hash_code);
+    ql_batch->set_max_hash_code(hash_code);
+    req.set_tablet_id(tablet_id);
+    req.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+
+    rpc::RpcController controller;
+    controller.set_timeout(5s);
+    tserver::ReadResponsePB resp;
+    ASSERT_OK(proxy.Read(req, &resp, &controller));
+    ASSERT_TRUE(resp.has_error());
+    ASSERT_EQ(resp.error().code(), tserver::TabletServerErrorPB::NOT_THE_LEADER)
+        << resp.error().ShortDebugString();
+  }
+
+  // Leadership could not be transferred to witness.
+  {
+    consensus::LeaderStepDownRequestPB req;
+    req.set_tablet_id(tablet_id);
+    req.set_new_leader_uuid(witness_uuid);
+    consensus::LeaderStepDownResponsePB resp;
+    ASSERT_OK(leader_peer->raft_consensus()->StepDown(&req, &resp));
+    ASSERT_EQ(resp.error().code(), tserver::TabletServerErrorPB::LEADER_NOT_READY_TO_STEP_DOWN)
+        << resp.error().ShortDebugString();
+  }
+
+  // Write rows that only leader and witness have, then fail the leader. The lagging data follower
+  // cannot win the election, so witness becomes leader, ships its WAL to the follower and
+  // transfers leadership to it.
+  cluster_->mini_tablet_server(follower_idx)->Shutdown();
+  for (int key = 10; key != 20; ++key) {
+    SetValue(session, key, -key, table);
+  }
+  witness_peer.reset();
+  leader_peer.reset();
+  cluster_->mini_tablet_server(leader_idx)->Shutdown();
+  ASSERT_OK(cluster_->mini_tablet_server(follower_idx)->Start(
+      tserver::WaitTabletsBootstrapped::kFalse));
+
+  for (int key = 1; key != 20; ++key) {
+    ASSERT_EQ(GetValue(session, key, table), -key);
+  }
+  auto follower_peer = ASSERT_RESULT(
+      cluster_->mini_tablet_server(follower_idx)->server()->tablet_manager()->GetTablet(
+          tablet_id));
+  ASSERT_EQ(follower_peer->LeaderStatus(), consensus::LeaderStatus::LEADER_AND_READY);
+
+  ASSERT_OK(cluster_->mini_tablet_server(leader_idx)->Start(
+      tserver::WaitTabletsBootstrapped::kFalse));
+}
+
 TEST_F(QLTabletTest, FollowerRestartDuringWrite) {
   TableHandle table;
   CreateTable(kTable1Name, &table, 1);
@@ -44,6 +44,7 @@
 
 #include "yb/util/async_util.h"
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/size_literals.h"
@@ -73,8 +74,12 @@ DECLARE_int64(transaction_rpc_timeout_ms);
 DECLARE_uint64(TEST_transaction_delay_status_reply_usec_in_tests);
 DECLARE_uint64(aborted_intent_cleanup_ms);
 DECLARE_uint64(max_clock_skew_usec);
+DECLARE_uint64(transaction_heartbeat_batch_window_ms);
 DECLARE_uint64(transaction_heartbeat_usec);
 
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_UpdateTransaction);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_UpdateTransactions);
+
 namespace yb {
 namespace client {
 
@@ -441,6 +446,44 @@ TEST_F(QLTransactionTest, Heartbeat) {
   AssertNoRunningTransactions();
 }
 
+// Returns number of calls of the RPC method with the specified handler latency metric, handled by
+// all tablet servers of the cluster.
+uint64_t CountHandledRpcs(MiniCluster* cluster, const HistogramPrototype& prototype) {
+  uint64_t result = 0;
+  for (size_t i = 0; i != cluster->num_tablet_servers(); ++i) {
+    result += prototype.Instantiate(
+        cluster->mini_tablet_server(i)->server()->metric_entity())->TotalCount();
+  }
+  return result;
+}
+
+TEST_F(QLTransactionTest, BatchedHeartbeat) {
+  FLAGS_transaction_heartbeat_batch_window_ms = 10;
+  constexpr size_t kTransactions = 10;
+  std::vector<YBTransactionPtr> transactions;
+  for (size_t i = 0; i != kTransactions; ++i) {
+    auto txn = CreateTransaction();
+    ASSERT_OK(WriteRows(CreateSession(txn), i));
+    transactions.push_back(std::move(txn));
+  }
+  std::this_thread::sleep_for(GetTransactionTimeout(false /* is_external */) * 2);
+  for (auto& txn : transactions) {
+    ASSERT_OK(txn->CommitFuture().get());
+  }
+  VerifyData(kTransactions);
+  AssertNoRunningTransactions();
+
+  auto batched_rpcs = CountHandledRpcs(
+      cluster_.get(), METRIC_handler_latency_yb_tserver_TabletServerService_UpdateTransactions);
+  auto single_rpcs = CountHandledRpcs(
+      cluster_.get(), METRIC_handler_latency_yb_tserver_TabletServerService_UpdateTransaction);
+  LOG(INFO) << "Batched RPCs: " << batched_rpcs << ", single RPCs: " << single_rpcs;
+  ASSERT_GT(batched_rpcs, 0);
+  // The sleep covers many heartbeat periods, but only create and commit of each transaction should
+  // be sent with UpdateTransaction, while all heartbeats should be batched.
+  ASSERT_LE(single_rpcs, kTransactions * 2);
+}
+
 TEST_F(QLTransactionTest, Expire) {
   SetDisableHeartbeatInTests(true);
   auto txn = CreateTransaction();
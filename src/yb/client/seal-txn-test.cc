@@ -16,6 +16,8 @@
 #include "yb/client/transaction.h"
 #include "yb/client/txn-test-base.h"
 
+#include "yb/common/transaction_error.h"
+
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/transaction_participant.h"
@@ -27,8 +29,10 @@ using namespace std::literals;
 
 DECLARE_bool(enable_load_balancing);
 DECLARE_bool(enable_transaction_sealing);
+DECLARE_bool(transaction_parallel_commit);
 DECLARE_bool(TEST_fail_on_replicated_batch_idx_set_in_txn_record);
 DECLARE_double(transaction_max_missed_heartbeat_periods);
+DECLARE_double(TEST_respond_write_failed_probability);
 DECLARE_int32(TEST_write_rejection_percentage);
 DECLARE_int64(transaction_rpc_timeout_ms);
 
@@ -151,5 +155,55 @@ TEST_F(SealTxnTest, Update) {
   AssertNoRunningTransactions();
 }
 
+TEST_F(SealTxnTest, FlushAndCommit) {
+  FLAGS_transaction_parallel_commit = true;
+  constexpr int kTransactions = 5;
+  for (int i = 0; i != kTransactions; ++i) {
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    ASSERT_OK(WriteRows(session, i, WriteOpType::INSERT, Flush::kFalse));
+    ASSERT_OK(session->FlushAndCommitFuture().get());
+    ASSERT_TRUE(txn->TEST_Sealed());
+    LOG(INFO) << "Committed: " << txn->id();
+  }
+  ASSERT_NO_FATALS(VerifyData(kTransactions));
+  ASSERT_OK(cluster_->RestartSync());
+  AssertNoRunningTransactions();
+}
+
+// Writes of the sealed transaction are retried after the seal record was sent.
+TEST_F(SealTxnTest, FlushAndCommitWithRetries) {
+  FLAGS_transaction_parallel_commit = true;
+  FLAGS_TEST_respond_write_failed_probability = 0.5;
+  constexpr int kTransactions = 5;
+  for (int i = 0; i != kTransactions; ++i) {
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    ASSERT_OK(WriteRows(session, i, WriteOpType::INSERT, Flush::kFalse));
+    ASSERT_OK(session->FlushAndCommitFuture().get());
+    ASSERT_TRUE(txn->TEST_Sealed());
+  }
+  FLAGS_TEST_respond_write_failed_probability = 0;
+  ASSERT_NO_FATALS(VerifyData(kTransactions));
+  AssertNoRunningTransactions();
+}
+
+// Flush of the sealed transaction fails, so the client does not know whether the coordinator
+// committed it.
+TEST_F(SealTxnTest, FlushAndCommitFailure) {
+  FLAGS_transaction_parallel_commit = true;
+  FLAGS_TEST_respond_write_failed_probability = 1;
+  auto txn = CreateTransaction();
+  auto session = CreateSession(txn);
+  session->SetTimeout(5s * kTimeMultiplier);
+  ASSERT_OK(WriteRows(session, 0, WriteOpType::INSERT, Flush::kFalse));
+  auto status = session->FlushAndCommitFuture().get();
+  ASSERT_TRUE(status.IsIncomplete()) << status;
+  ASSERT_EQ(TransactionError(status).value(), TransactionErrorCode::kCommitOutcomeUnknown)
+      << status;
+  ASSERT_TRUE(txn->TEST_Sealed());
+  FLAGS_TEST_respond_write_failed_probability = 0;
+}
+
 } // namespace client
 } // namespace yb
@@ -19,23 +19,33 @@
 #include "yb/client/client_error.h"
 #include "yb/client/error.h"
 #include "yb/client/error_collector.h"
+#include "yb/client/transaction.h"
 #include "yb/client/yb_op.h"
 
 #include "yb/common/consistent_read_point.h"
+#include "yb/common/transaction_error.h"
 
 #include "yb/consensus/consensus_error.h"
 
 #include "yb/tserver/tserver_error.h"
 
+#include "yb/util/async_util.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
+#include "yb/util/status_format.h"
 #include "yb/util/status_log.h"
 #include "yb/util/flags.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
 
+DEFINE_RUNTIME_bool(transaction_parallel_commit, false,
+    "Whether YBSession::FlushAndCommitAsync should seal the transaction in parallel with the last "
+    "flush, instead of committing it after the flush completes. Requires "
+    "enable_transaction_sealing on all tablet servers.");
+TAG_FLAG(transaction_parallel_commit, advanced);
+
 DEFINE_UNKNOWN_int32(client_read_write_timeout_ms, 60000,
     "Timeout for client read and write operations.");
 
@@ -212,8 +222,106 @@ void FlushBatcherAsync(
       is_within_transaction_retry);
 }
 
+// Combines results of the last flush and the commit that were sent in parallel.
+class ParallelCommitState : public std::enable_shared_from_this<ParallelCommitState> {
+ public:
+  ParallelCommitState(YBTransactionPtr transaction, CoarseTimePoint deadline,
+                      CommitCallback callback)
+      : transaction_(std::move(transaction)), deadline_(deadline),
+        callback_(std::move(callback)) {
+  }
+
+  void TransactionPrepared() {
+    sealing_.store(true, std::memory_order_release);
+    transaction_->Commit(
+        deadline_, SealOnly::kTrue,
+        [self = shared_from_this()](const Status& status) {
+          self->Done(status);
+        });
+  }
+
+  void FlushDone(const Status& status) {
+    if (sealing_.load(std::memory_order_acquire)) {
+      Done(status);
+      return;
+    }
+    // Nothing was prepared by the transaction, so there is no seal in flight.
+    if (!status.ok()) {
+      Complete(status);
+      return;
+    }
+    transaction_->Commit(
+        deadline_, [self = shared_from_this()](const Status& commit_status) {
+          self->Complete(commit_status);
+        });
+  }
+
+ private:
+  // Both flush and seal should succeed, but any failure is reported immediately. Sealed
+  // transaction could not be aborted by the client, and the coordinator commits it once all
+  // batches listed in the seal record are replicated, even when the client did not receive
+  // responses for them. So the failure is reported as unknown commit outcome.
+  void Done(const Status& status) {
+    if (!status.ok()) {
+      Complete(STATUS_EC_FORMAT(
+          Incomplete, TransactionError(TransactionErrorCode::kCommitOutcomeUnknown),
+          "Outcome of sealed transaction commit is unknown: $0", status));
+      return;
+    }
+    if (--pending_ == 0) {
+      Complete(status);
+    }
+  }
+
+  void Complete(const Status& status) {
+    if (!completed_.exchange(true, std::memory_order_acq_rel)) {
+      callback_(status);
+    }
+  }
+
+  const YBTransactionPtr transaction_;
+  const CoarseTimePoint deadline_;
+  CommitCallback callback_;
+  std::atomic<bool> sealing_{false};
+  std::atomic<int> pending_{2};
+  std::atomic<bool> completed_{false};
+};
+
 } // namespace
 
+void YBSession::FlushAndCommitAsync(CoarseTimePoint deadline, CommitCallback callback) {
+  auto transaction = batcher_config_.transaction;
+  if (!transaction) {
+    callback(STATUS(IllegalState, "Session does not have transaction"));
+    return;
+  }
+
+  if (!GetAtomicFlag(&FLAGS_transaction_parallel_commit)) {
+    FlushAsync([transaction, deadline, callback = std::move(callback)](FlushStatus* flush_status) {
+      if (!flush_status->status.ok()) {
+        callback(flush_status->status);
+        return;
+      }
+      transaction->Commit(deadline, callback);
+    });
+    return;
+  }
+
+  auto state = std::make_shared<ParallelCommitState>(transaction, deadline, std::move(callback));
+  if (batcher_) {
+    batcher_->SetTransactionPreparedCallback([state] { state->TransactionPrepared(); });
+  }
+  FlushAsync([state](FlushStatus* flush_status) {
+    state->FlushDone(flush_status->status);
+  });
+}
+
+std::future<Status> YBSession::FlushAndCommitFuture(CoarseTimePoint deadline) {
+  return MakeFuture<Status>([this, deadline](auto callback) {
+    FlushAndCommitAsync(deadline, std::move(callback));
+  });
+}
+
 void YBSession::FlushAsync(FlushCallback callback) {
   // Swap in a new batcher to start building the next batch.
   // Save off the old batcher.
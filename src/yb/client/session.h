@@ -170,6 +170,21 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   void FlushAsync(FlushCallback callback);
   std::future<FlushStatus> FlushFuture();
 
+  // Flushes buffered operations and commits the session transaction.
+  //
+  // When transaction_parallel_commit is enabled, the commit is not delayed until the flush
+  // completes. Instead the transaction is sealed as soon as the last batch of operations is
+  // prepared, and the coordinator treats it as committed once all batches listed in the seal
+  // record are replicated. It saves a round trip, but means that operation level errors of the
+  // last batch do not abort the transaction if its batches were replicated. So it should be used
+  // only when such errors are not expected, e.g. for blind writes.
+  //
+  // Callback receives the first failure of flush or commit, or OK if both succeeded. Failure after
+  // the seal record was sent is reported as Incomplete with kCommitOutcomeUnknown transaction
+  // error, since the transaction could still be committed by the coordinator.
+  void FlushAndCommitAsync(CoarseTimePoint deadline, CommitCallback callback);
+  std::future<Status> FlushAndCommitFuture(CoarseTimePoint deadline = CoarseTimePoint());
+
   // For production code use async variants of the following functions instead.
   FlushStatus TEST_FlushAndGetOpsErrors();
   Status TEST_Flush();
@@ -428,6 +428,9 @@ bool TabletInvoker::Done(Status* status) {
       return !FailToNewReplica(*status, rsp_err).ok();
     } else {
       tserver::TabletServerDelay delay(*status);
+      if (delay.value().Initialized() && tablet_) {
+        tablet_->ExtendWriteBackoff(CoarseMonoClock::now() + delay.value());
+      }
       auto retry_status = delay.value().Initialized()
           ? retrier_->DelayedRetry(command_, *status, delay.value())
           : retrier_->DelayedRetry(command_, *status);
@@ -385,6 +385,23 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
         return false;
       }
 
+      if (initial && state_.load(std::memory_order_acquire) == TransactionState::kSealed) {
+        // Number of batches was already sent with the seal record, so the coordinator would not
+        // wait for this batch.
+        SetErrorUnlocked(
+            STATUS(IllegalState, "Operations prepared after transaction was sealed"), "Prepare");
+        auto status = status_;
+        auto commit_callback = TakeSealCallbackUnlocked();
+        lock.unlock();
+        if (commit_callback) {
+          commit_callback(status);
+        }
+        if (waiter) {
+          waiter(status);
+        }
+        return false;
+      }
+
       auto promotion_started = StartPromotionToGlobalIfNecessary(ops_info);
       if (!promotion_started.ok()) {
         QueueWaiter(std::move(waiter));
@@ -504,9 +521,9 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
         }
       }
 
-      if (running_requests_ == 0 && commit_replicated_) {
+      commit_callback = TakeSealCallbackUnlocked();
+      if (commit_callback) {
         notify_commit_status = status_;
-        commit_callback = std::move(commit_callback_);
       }
     }
 
@@ -538,6 +555,7 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
       }
       state_.store(seal_only ? TransactionState::kSealed : TransactionState::kCommitted,
                    std::memory_order_release);
+      sealed_ = seal_only.get();
       commit_callback_ = std::move(callback);
       if (!ready_) {
         // If we have not written any intents and do not even have a transaction status tablet,
@@ -901,6 +919,11 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
     });
   }
 
+  bool TEST_Sealed() EXCLUDES(mutex_) {
+    SharedLock<std::shared_mutex> lock(mutex_);
+    return sealed_;
+  }
+
   bool HasSubTransaction(SubTransactionId id) EXCLUDES(mutex_) {
     return subtransaction_.HasSubTransaction(id);
   }
@@ -1354,10 +1377,14 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
         actual_status.ok()) {
       std::lock_guard<std::shared_mutex> lock(mutex_);
       commit_replicated_ = true;
-      if (running_requests_ != 0) {
+      commit_callback = TakeSealCallbackUnlocked();
+      if (!commit_callback) {
         return;
       }
-      commit_callback = std::move(commit_callback_);
+      if (sealed_) {
+        // Some of the sealed batches could fail.
+        actual_status = status_;
+      }
     } else {
       std::lock_guard<std::shared_mutex> lock(mutex_);
       commit_callback = std::move(commit_callback_);
@@ -1687,22 +1714,37 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
       timeout = TransactionRpcTimeout();
     }
 
-    rpc::RpcCommandPtr rpc;
+    internal::RemoteTabletPtr status_tablet;
     {
       SharedLock<std::shared_mutex> lock(mutex_);
-      internal::RemoteTabletPtr status_tablet;
-
       if (!send_to_new_tablet && old_status_tablet_) {
         status_tablet = old_status_tablet_;
       } else {
         status_tablet = status_tablet_;
       }
-      rpc = PrepareHeartbeatRPC(
-          CoarseMonoClock::now() + timeout, status_tablet, status,
-          std::bind(
-              &Impl::HeartbeatDone, this, _1, _2, _3, status, transaction, send_to_new_tablet));
     }
 
+    auto deadline = CoarseMonoClock::now() + timeout;
+    if (status == TransactionStatus::PENDING && TransactionManager::BatchHeartbeats()) {
+      manager_->SendHeartbeat(
+          status_tablet, metadata_.transaction_id, deadline,
+          [this, transaction, send_to_new_tablet](
+              const Status& heartbeat_status, HybridTime propagated_hybrid_time) {
+            tserver::UpdateTransactionResponsePB response;
+            if (propagated_hybrid_time.is_valid()) {
+              response.set_propagated_hybrid_time(propagated_hybrid_time.ToUint64());
+            }
+            HeartbeatDone(heartbeat_status, /* request= */ {}, response, TransactionStatus::PENDING,
+                          transaction, send_to_new_tablet);
+          });
+      return;
+    }
+
+    auto rpc = PrepareHeartbeatRPC(
+        deadline, status_tablet, status,
+        std::bind(
+            &Impl::HeartbeatDone, this, _1, _2, _3, status, transaction, send_to_new_tablet));
+
     auto& handle = send_to_new_tablet ? new_heartbeat_handle_ : heartbeat_handle_;
     manager_->rpcs().RegisterAndStart(rpc, &handle);
   }
@@ -2065,6 +2107,16 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
     callback(child_txn_data_pb);
   }
 
+  // Returns commit callback of sealed transaction if its outcome is known, i.e. seal record was
+  // replicated and either all requests were flushed or transaction failed. Failed requests are
+  // not always reported via Flushed, so we don't wait for them.
+  CommitCallback TakeSealCallbackUnlocked() REQUIRES(mutex_) {
+    if (!commit_replicated_ || (running_requests_ != 0 && status_.ok())) {
+      return CommitCallback();
+    }
+    return std::exchange(commit_callback_, CommitCallback());
+  }
+
   Status CheckCouldCommitUnlocked(SealOnly seal_only) REQUIRES(mutex_) {
     RETURN_NOT_OK(CheckRunningUnlocked());
     if (child_) {
@@ -2176,6 +2228,8 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
   size_t running_requests_ GUARDED_BY(mutex_) = 0;
   // Set to true after commit record is replicated. Used only during transaction sealing.
   bool commit_replicated_ GUARDED_BY(mutex_) = false;
+  // Set to true when transaction is committed via sealing.
+  bool sealed_ GUARDED_BY(mutex_) = false;
 
   scoped_refptr<Counter> transaction_promotions_;
 };
@@ -2355,5 +2409,9 @@ boost::optional<SubTransactionMetadataPB> YBTransaction::GetSubTransactionMetada
   return impl_->GetSubTransactionMetadataPB();
 }
 
+bool YBTransaction::TEST_Sealed() const {
+  return impl_->TEST_Sealed();
+}
+
 } // namespace client
 } // namespace yb
@@ -187,6 +187,9 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
 
   boost::optional<SubTransactionMetadataPB> GetSubTransactionMetadataPB() const;
 
+  // Returns true if commit of this transaction was requested in the SealOnly mode.
+  bool TEST_Sealed() const;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
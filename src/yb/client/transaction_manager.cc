@@ -15,17 +15,25 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <unordered_map>
+
 #include "yb/client/client.h"
 #include "yb/client/meta_cache.h"
 #include "yb/client/table.h"
+#include "yb/client/transaction_rpc.h"
 #include "yb/client/yb_table_name.h"
 
 #include "yb/master/catalog_manager.h"
 
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/rpc/tasks_pool.h"
 
 #include "yb/server/server_base_options.h"
 
+#include "yb/tserver/tserver_service.pb.h"
+
 #include "yb/util/flags.h"
 #include "yb/util/format.h"
 #include "yb/util/status_format.h"
@@ -39,6 +47,12 @@ DEFINE_UNKNOWN_uint64(transaction_manager_workers_limit, 50,
 DEFINE_UNKNOWN_uint64(transaction_manager_queue_limit, 500,
               "Max number of tasks used by transaction manager");
 
+DEFINE_RUNTIME_uint64(transaction_heartbeat_batch_window_ms, 0,
+    "When positive, PENDING heartbeats of transactions that use the same status tablet and are "
+    "sent within this window are combined into a single UpdateTransactions RPC. Should be enabled "
+    "only when all tablet servers support UpdateTransactions.");
+TAG_FLAG(transaction_heartbeat_batch_window_ms, advanced);
+
 DEFINE_test_flag(string, transaction_manager_preferred_tablet, "",
                  "For testing only. If non-empty, transaction manager will try to use the status "
                  "tablet with id matching this flag, if present in the list of status tablets.");
@@ -235,6 +249,156 @@ class InvokeCallbackTask {
   PickStatusTabletCallback callback_;
   TransactionLocality locality_;
 };
+
+// Combines PENDING heartbeats of transactions that use the same status tablet into a single
+// UpdateTransactions RPC. Heartbeats are collected during transaction_heartbeat_batch_window_ms,
+// then all collected batches are sent at once.
+class HeartbeatBatcher {
+ public:
+  HeartbeatBatcher(YBClient* client, const scoped_refptr<ClockBase>& clock, rpc::Rpcs* rpcs)
+      : client_(client), clock_(clock), rpcs_(rpcs),
+        flush_task_(&client->messenger()->scheduler()) {
+  }
+
+  void Add(const internal::RemoteTabletPtr& status_tablet, const TransactionId& id,
+           CoarseTimePoint deadline, TransactionHeartbeatCallback callback) EXCLUDES(mutex_) {
+    bool closed;
+    {
+      std::lock_guard lock(mutex_);
+      closed = closed_;
+      if (!closed) {
+        auto& batch = batches_[status_tablet->tablet_id()];
+        if (!batch.tablet) {
+          batch.tablet = status_tablet;
+        }
+        batch.deadline = std::max(batch.deadline, deadline);
+        batch.entries.push_back(Entry {
+          .id = id,
+          .callback = std::move(callback),
+        });
+        if (flush_scheduled_) {
+          return;
+        }
+        flush_scheduled_ = true;
+      }
+    }
+    if (closed) {
+      callback(STATUS(Aborted, "Transaction manager shutting down"), HybridTime());
+      return;
+    }
+    flush_task_.Schedule(
+        [this](const Status& status) {
+          // When the flush is aborted, pending heartbeats are failed by Shutdown.
+          if (status.ok()) {
+            Flush();
+          }
+        },
+        std::chrono::milliseconds(FLAGS_transaction_heartbeat_batch_window_ms));
+  }
+
+  void Shutdown() EXCLUDES(mutex_) {
+    {
+      std::lock_guard lock(mutex_);
+      closed_ = true;
+    }
+    flush_task_.Shutdown();
+    // Heartbeats that were not sent because the flush was aborted.
+    for (const auto& [tablet_id, batch] : TakeBatches()) {
+      Fail(batch.entries, STATUS(Aborted, "Transaction manager shutting down"));
+    }
+  }
+
+ private:
+  struct Entry {
+    TransactionId id;
+    TransactionHeartbeatCallback callback;
+  };
+
+  struct Batch {
+    internal::RemoteTabletPtr tablet;
+    CoarseTimePoint deadline;
+    std::vector<Entry> entries;
+  };
+
+  using Batches = std::unordered_map<TabletId, Batch>;
+
+  Batches TakeBatches() EXCLUDES(mutex_) {
+    Batches result;
+    std::lock_guard lock(mutex_);
+    result.swap(batches_);
+    flush_scheduled_ = false;
+    return result;
+  }
+
+  static void Fail(const std::vector<Entry>& entries, const Status& status) {
+    for (const auto& entry : entries) {
+      entry.callback(status, HybridTime());
+    }
+  }
+
+  void Flush() {
+    auto batches = TakeBatches();
+    for (auto& [tablet_id, batch] : batches) {
+      Send(std::move(batch));
+    }
+  }
+
+  void Send(Batch batch) {
+    tserver::UpdateTransactionsRequestPB req;
+    req.set_tablet_id(batch.tablet->tablet_id());
+    req.set_propagated_hybrid_time(clock_->Now().ToUint64());
+    for (const auto& entry : batch.entries) {
+      auto& state = *req.add_states();
+      state.set_transaction_id(entry.id.data(), entry.id.size());
+      state.set_status(TransactionStatus::PENDING);
+    }
+
+    auto handle = rpcs_->Prepare();
+    if (handle == rpcs_->InvalidHandle()) {
+      Fail(batch.entries, STATUS(Aborted, "Transaction manager shutting down"));
+      return;
+    }
+    auto entries = std::make_shared<std::vector<Entry>>(std::move(batch.entries));
+    *handle = UpdateTransactions(
+        batch.deadline, batch.tablet.get(), client_, &req,
+        [this, handle, entries](
+            const Status& status, const tserver::UpdateTransactionsResponsePB& resp) {
+          rpcs_->Unregister(handle);
+          HybridTime propagated_hybrid_time;
+          if (resp.has_propagated_hybrid_time()) {
+            propagated_hybrid_time = HybridTime(resp.propagated_hybrid_time());
+          }
+          auto num_entries = narrow_cast<int>(entries->size());
+          if (status.ok() && resp.results_size() != num_entries) {
+            LOG(DFATAL) << "Wrong number of heartbeat results: " << resp.results_size()
+                        << ", expected: " << num_entries;
+          }
+          for (int i = 0; i != num_entries; ++i) {
+            auto entry_status = status;
+            if (entry_status.ok()) {
+              if (i >= resp.results_size()) {
+                entry_status = STATUS(IllegalState, "Missing heartbeat result");
+              } else if (resp.results(i).has_error()) {
+                entry_status = StatusFromPB(resp.results(i).error().status());
+              }
+            }
+            (*entries)[i].callback(entry_status, propagated_hybrid_time);
+          }
+        });
+    (**handle).SendRpc();
+  }
+
+  YBClient* const client_;
+  const scoped_refptr<ClockBase> clock_;
+  rpc::Rpcs* const rpcs_;
+  rpc::ScheduledTaskTracker flush_task_;
+
+  std::mutex mutex_;
+  bool closed_ GUARDED_BY(mutex_) = false;
+  bool flush_scheduled_ GUARDED_BY(mutex_) = false;
+  Batches batches_ GUARDED_BY(mutex_);
+};
+
 } // namespace
 
 class TransactionManager::Impl {
@@ -249,7 +413,8 @@ class TransactionManager::Impl {
           .max_workers = FLAGS_transaction_manager_workers_limit,
         }),
         tasks_pool_(FLAGS_transaction_manager_queue_limit),
-        invoke_callback_tasks_(FLAGS_transaction_manager_queue_limit) {
+        invoke_callback_tasks_(FLAGS_transaction_manager_queue_limit),
+        heartbeat_batcher_(client, clock, &rpcs_) {
     CHECK(clock);
   }
 
@@ -325,7 +490,14 @@ class TransactionManager::Impl {
     clock_->Update(time);
   }
 
+  void SendHeartbeat(
+      const internal::RemoteTabletPtr& status_tablet, const TransactionId& id,
+      CoarseTimePoint deadline, TransactionHeartbeatCallback callback) {
+    heartbeat_batcher_.Add(status_tablet, id, deadline, std::move(callback));
+  }
+
   void Shutdown() {
+    heartbeat_batcher_.Shutdown();
     rpcs_.Shutdown();
     thread_pool_.Shutdown();
   }
@@ -348,6 +520,7 @@ class TransactionManager::Impl {
   yb::rpc::TasksPool<LoadStatusTabletsTask> tasks_pool_;
   yb::rpc::TasksPool<InvokeCallbackTask> invoke_callback_tasks_;
   yb::rpc::Rpcs rpcs_;
+  HeartbeatBatcher heartbeat_batcher_;
 };
 
 TransactionManager::TransactionManager(
@@ -391,6 +564,16 @@ void TransactionManager::UpdateClock(HybridTime time) {
   impl_->UpdateClock(time);
 }
 
+bool TransactionManager::BatchHeartbeats() {
+  return FLAGS_transaction_heartbeat_batch_window_ms > 0;
+}
+
+void TransactionManager::SendHeartbeat(
+    const internal::RemoteTabletPtr& status_tablet, const TransactionId& id,
+    CoarseTimePoint deadline, TransactionHeartbeatCallback callback) {
+  impl_->SendHeartbeat(status_tablet, id, deadline, std::move(callback));
+}
+
 bool TransactionManager::PlacementLocalTransactionsPossible() {
   return impl_->PlacementLocalTransactionsPossible();
 }
@@ -22,6 +22,7 @@
 
 #include "yb/common/clock.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
 #include "yb/common/transaction.pb.h"
 
 #include "yb/rpc/rpc_fwd.h"
@@ -31,6 +32,8 @@ namespace client {
 
 using PickStatusTabletCallback = std::function<void(const Result<std::string>&)>;
 using UpdateTransactionTablesVersionCallback = std::function<void(const Status&)>;
+using TransactionHeartbeatCallback = std::function<void(
+    const Status& status, HybridTime propagated_hybrid_time)>;
 
 // TransactionManager manages multiple transactions. It lives at the YQL engine layer.
 class TransactionManager {
@@ -50,6 +53,15 @@ class TransactionManager {
 
   void PickStatusTablet(PickStatusTabletCallback callback, TransactionLocality locality);
 
+  // Whether PENDING heartbeats should be sent via SendHeartbeat.
+  static bool BatchHeartbeats();
+
+  // Sends PENDING heartbeat for transaction, combining it with heartbeats of other transactions
+  // that use the same status tablet.
+  void SendHeartbeat(
+      const internal::RemoteTabletPtr& status_tablet, const TransactionId& id,
+      CoarseTimePoint deadline, TransactionHeartbeatCallback callback);
+
   rpc::Rpcs& rpcs();
   YBClient* client() const;
 
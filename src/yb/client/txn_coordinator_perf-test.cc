@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <map>
+
+#include "yb/client/session.h"
+#include "yb/client/transaction.h"
+#include "yb/client/txn-test-base.h"
+
+#include "yb/util/test_thread_holder.h"
+#include "yb/util/tsan_util.h"
+
+using namespace std::literals;
+
+DECLARE_uint64(transaction_heartbeat_usec);
+DECLARE_uint32(transaction_coordinator_num_shards);
+
+namespace yb {
+namespace client {
+
+class TxnCoordinatorPerfTest : public TransactionTestBase<MiniCluster> {
+ protected:
+  void SetUp() override {
+    SetIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    TransactionTestBase::SetUp();
+  }
+
+  // Drives create, heartbeat, get status and commit of many concurrent transactions through the
+  // status tablet for the specified time. Returns number of committed transactions.
+  size_t RunTransactions(CoarseDuration test_time);
+};
+
+size_t TxnCoordinatorPerfTest::RunTransactions(CoarseDuration test_time) {
+  constexpr int kThreads = 32;
+
+  std::atomic<size_t> committed{0};
+  TestThreadHolder thread_holder;
+  for (int i = 0; i != kThreads; ++i) {
+    thread_holder.AddThreadFunctor(
+        [this, i, &committed, &stop = thread_holder.stop_flag()] {
+      auto read_session = CreateSession();
+      int32_t value = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        auto txn = CreateTransaction();
+        auto write_result = WriteRow(CreateSession(txn), i, ++value);
+        if (!write_result.ok()) {
+          continue;
+        }
+        // Read of the pending intents requests transaction status from the coordinator.
+        auto row = SelectRow(read_session, i);
+        VLOG(1) << "Read " << i << ": " << row;
+        if (txn->CommitFuture().get().ok()) {
+          committed.fetch_add(1, std::memory_order_acq_rel);
+        }
+      }
+    });
+  }
+  thread_holder.WaitAndStop(test_time);
+  return committed.load();
+}
+
+// Reports throughput of the transaction coordinator for different number of shards. Sharding
+// should not make the coordinator slower, even when the status tablet lock is not the bottleneck.
+TEST_F(TxnCoordinatorPerfTest, Throughput) {
+  constexpr auto kTestTime = 5s;
+
+  FLAGS_transaction_heartbeat_usec = 10000 * kTimeMultiplier;
+
+  std::map<uint32_t, size_t> committed;
+  for (uint32_t num_shards : {1, 8}) {
+    FLAGS_transaction_coordinator_num_shards = num_shards;
+    ASSERT_OK(cluster_->RestartSync());
+
+    auto& shard_committed = committed[num_shards];
+    shard_committed = RunTransactions(kTestTime);
+    LOG(INFO) << "Shards: " << num_shards << ", committed: " << shard_committed
+              << ", txn/s: " << shard_committed * 1s / kTestTime;
+    ASSERT_GT(shard_committed, 0);
+  }
+
+  // Leave room for the run to run noise of a shared test machine.
+  ASSERT_GE(committed[8] * 4, committed[1] * 3);
+}
+
+} // namespace client
+} // namespace yb
@@ -26,7 +26,10 @@ YB_DEFINE_ENUM(TransactionErrorCode,
     (kReadRestartRequired)
     (kConflict)
     (kSnapshotTooOld)
-    (kSkipLocking));
+    (kSkipLocking)
+    // Commit of sealed transaction failed after seal record was sent, so the transaction could
+    // still be committed by the coordinator.
+    (kCommitOutcomeUnknown));
 
 struct TransactionErrorTag : IntegralErrorTag<TransactionErrorCode> {
   // It is part of the wire protocol and should not be changed once released.
@@ -172,6 +172,10 @@ Status LeaderState::CreateStatus() const {
     case consensus::LeaderStatus::LEADER_BUT_NO_MAJORITY_REPLICATED_LEASE:
         return STATUS(LeaderHasNoLease, "This leader has not yet acquired a lease.");
 
+    case consensus::LeaderStatus::LEADER_BUT_WITNESS:
+        return STATUS(LeaderNotReadyToServe,
+                      "Witness leader does not serve requests until it transfers leadership");
+
     case consensus::LeaderStatus::LEADER_AND_READY:
       return Status::OK();
   }
@@ -75,6 +75,7 @@ YB_DEFINE_ENUM(
     (LEADER_BUT_NO_OP_NOT_COMMITTED)
     (LEADER_BUT_OLD_LEADER_MAY_HAVE_LEASE)
     (LEADER_BUT_NO_MAJORITY_REPLICATED_LEASE)
+    (LEADER_BUT_WITNESS)
     (LEADER_AND_READY));
 
 typedef int64_t ConsensusTerm;
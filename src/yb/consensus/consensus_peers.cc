@@ -86,6 +86,7 @@ TAG_FLAG(max_wait_for_processresponse_before_closing_ms, advanced);
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DECLARE_bool(enable_multi_raft_heartbeat_batcher);
+DECLARE_bool(enable_multi_raft_update_batching);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
                  "Fraction of the time when the leader will crash just before sending an "
@@ -328,16 +329,16 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
       return;
     }
 
-    // TODO(lw_uc) support multiraft heartbeat with LW
-    update_request_->ToGoogleProtobuf(&heartbeat_request_);
-    update_response_->ToGoogleProtobuf(&heartbeat_response_);
+    // update_request_ is reused by the next request once performing_update_lock is released,
+    // so the batch gets a copy of the heartbeat. It does not carry ops, so the copy is cheap.
+    auto heartbeat_request = rpc::SharedMessage<LWConsensusRequestPB>(*update_request_);
     cur_heartbeat_id_++;
     processing_lock.unlock();
     performing_update_lock.unlock();
     performing_heartbeat_lock.release();
     multi_raft_batcher_->AddRequestToBatch(
-        &heartbeat_request_, &heartbeat_response_,
-        std::bind(&Peer::ProcessHeartbeatResponse, retain_self, _1));
+        std::move(heartbeat_request),
+        std::bind(&Peer::ProcessHeartbeatResponse, retain_self, _1, _2));
     return;
   }
 
@@ -349,6 +350,21 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   // and this new request in the same order they were received by the remote peer.
   // TODO: Remove batched but unsent heartbeats (in the respective MultiRaftBatcher) in this case
   minimum_viable_heartbeat_ = cur_heartbeat_id_ + 1;
+
+  // Update batching coalesces ops for all tablets with the same remote tserver into a single
+  // MultiRaftUpdateConsensus RPC, which reduces per-RPC overhead when there are many small tablets.
+  if (multi_raft_batcher_ && FLAGS_enable_multi_raft_update_batching) {
+    // update_request_ is not reused until the response is processed, so the batch references it
+    // without copying. The ops it references are retained until the batch is sent.
+    batched_update_msgs_holder_ = std::move(msgs_holder);
+    processing_lock.unlock();
+    performing_update_lock.release();
+    multi_raft_batcher_->AddUpdateRequestToBatch(
+        rpc::SharedField(retain_self, update_request_),
+        std::bind(&Peer::ProcessBatchedUpdateResponse, retain_self, _1, _2));
+    return;
+  }
+
   processing_lock.unlock();
   performing_update_lock.release();
   controller_.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
@@ -456,9 +472,27 @@ void Peer::ProcessResponse() {
   }
 }
 
-void Peer::ProcessHeartbeatResponse(const Status& status) {
+void Peer::ProcessBatchedUpdateResponse(const Status& status, LWConsensusResponsePB* response) {
+  DCHECK(performing_update_mutex_.is_locked()) << "Got a response when nothing was pending.";
+
+  auto performing_update_lock = LockPerformingUpdate(std::adopt_lock);
+  auto processing_lock = StartProcessingUnlocked();
+  if (!processing_lock.owns_lock()) {
+    return;
+  }
+
+  batched_update_msgs_holder_.Reset();
+  bool more_pending = ProcessResponseWithStatus(status, response);
+
+  if (more_pending) {
+    processing_lock.unlock();
+    performing_update_lock.release();
+    SendNextRequest(RequestTriggerMode::kAlwaysSend);
+  }
+}
+
+void Peer::ProcessHeartbeatResponse(const Status& status, LWConsensusResponsePB* response) {
   DCHECK(performing_heartbeat_mutex_.is_locked()) << "Got a heartbeat when nothing was pending.";
-  DCHECK(heartbeat_request_.ops().empty()) << "Got a heartbeat with a non-zero number of ops.";
 
   auto performing_heartbeat_lock = LockPerformingHeartbeat(std::adopt_lock);
   auto processing_lock = StartProcessingUnlocked();
@@ -474,9 +508,7 @@ void Peer::ProcessHeartbeatResponse(const Status& status) {
     return;
   }
 
-  // TODO(lw_uc) support multiraft heartbeat with LW
-  auto lw_response = rpc::CopySharedMessage(heartbeat_response_);
-  bool more_pending = ProcessResponseWithStatus(status, lw_response.get());
+  bool more_pending = ProcessResponseWithStatus(status, response);
 
   if (more_pending) {
     auto performing_update_lock = LockPerformingUpdate(std::try_to_lock);
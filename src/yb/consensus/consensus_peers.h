@@ -49,6 +49,7 @@
 #include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/consensus_util.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/consensus/replicate_msgs_holder.h"
 
 #include "yb/gutil/integral_types.h"
 
@@ -187,7 +188,10 @@ class Peer : public std::enable_shared_from_this<Peer> {
   void ProcessResponse();
 
   // Signals that a heartbeat response was received from the peer.
-  void ProcessHeartbeatResponse(const Status& status);
+  void ProcessHeartbeatResponse(const Status& status, LWConsensusResponsePB* response);
+
+  // Signals that a response to an update sent through the multi-Raft batcher was received.
+  void ProcessBatchedUpdateResponse(const Status& status, LWConsensusResponsePB* response);
 
   // Returns true if there are more pending ops to process, false otherwise.
   bool ProcessResponseWithStatus(const Status& status,
@@ -238,9 +242,8 @@ class Peer : public std::enable_shared_from_this<Peer> {
   LWConsensusRequestPB* update_request_ = nullptr;
   LWConsensusResponsePB* update_response_ = nullptr;
 
-  // Latest heartbeat request and response
-  ConsensusRequestPB heartbeat_request_;
-  ConsensusResponsePB heartbeat_response_;
+  // Ops of update_request_ while it is sent through the multi-Raft batcher.
+  LWReplicateMsgsHolder batched_update_msgs_holder_;
 
   // Each time a heartbeat request is sent this value is incremented.
   int64_t cur_heartbeat_id_ = 0;
@@ -270,8 +273,8 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // peers whenever we go more than 'FLAGS_raft_heartbeat_interval_ms' without sending actual data.
   std::shared_ptr<rpc::PeriodicTimer> heartbeater_;
 
-  // Batcher that currently batches heartbeat requests that are sent by each consensus peer
-  // on a per tserver level
+  // Batcher that currently batches heartbeat requests (and update requests, when update batching
+  // is enabled) that are sent by each consensus peer on a per tserver level
   MultiRaftHeartbeatBatcherPtr multi_raft_batcher_;
 
   // Thread pool used to construct requests to this peer.
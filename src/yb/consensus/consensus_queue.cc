@@ -218,13 +218,16 @@ PeerMessageQueue::PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_ent
                                    const string& tablet_id,
                                    const server::ClockPtr& clock,
                                    ConsensusContext* context,
-                                   unique_ptr<ThreadPoolToken> raft_pool_token)
+                                   unique_ptr<ThreadPoolToken> raft_pool_token,
+                                   unique_ptr<ThreadPoolToken> log_cache_prefetch_token)
     : raft_pool_observers_token_(std::move(raft_pool_token)),
       local_peer_pb_(local_peer_pb),
       local_peer_uuid_(local_peer_pb_.has_permanent_uuid() ? local_peer_pb_.permanent_uuid()
                                                            : string()),
       tablet_id_(tablet_id),
-      log_cache_(metric_entity, log, server_tracker, local_peer_pb.permanent_uuid(), tablet_id),
+      log_cache_(
+          metric_entity, log, server_tracker, local_peer_pb.permanent_uuid(), tablet_id,
+          std::move(log_cache_prefetch_token)),
       operations_mem_tracker_(
           MemTracker::FindOrCreateTracker("OperationsFromDisk", parent_tracker)),
       metrics_(metric_entity),
@@ -806,7 +809,7 @@ const PeerMessageQueue::TrackedPeer* PeerMessageQueue::FindClosestPeerForBootstr
   for (auto it = peers_map_.begin(); it != peers_map_.end(); it++) {
     // don't consider locality of remote_tracked_peer with itself
     if (!it->second->cloud_info.has_value() || remote_tracked_peer == it->second ||
-        it->second->needs_remote_bootstrap) {
+        it->second->needs_remote_bootstrap || it->second->is_witness) {
       continue;
     }
 
@@ -1249,8 +1252,10 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
         LOG(FATAL) << "Peer " << peer_uuid << " not in active config";
       }
       peer->member_type = peer_pb.member_type();
+      peer->is_witness = peer_pb.is_witness();
     } else {
       peer->member_type = PeerMemberType::UNKNOWN_MEMBER_TYPE;
+      peer->is_witness = false;
     }
 
     // Application level errors should be handled elsewhere
@@ -1649,6 +1654,10 @@ bool PeerMessageQueue::CanPeerBecomeLeader(const std::string& peer_uuid) const {
     LOG(ERROR) << "Invalid peer UUID: " << peer_uuid;
     return false;
   }
+  if (peer->is_witness) {
+    LOG(INFO) << Format("Peer $0 cannot become Leader as it is a witness", peer_uuid);
+    return false;
+  }
   const bool peer_can_be_leader = peer->last_received >= queue_state_.majority_replicated_op_id;
   if (!peer_can_be_leader) {
     LOG(INFO) << Format(
@@ -1675,7 +1684,7 @@ string PeerMessageQueue::GetUpToDatePeer() const {
   {
     std::lock_guard<simple_spinlock> lock(queue_lock_);
     for (const PeersMap::value_type& entry : peers_map_) {
-      if (local_peer_uuid_ == entry.first) {
+      if (local_peer_uuid_ == entry.first || entry.second->is_witness) {
         continue;
       }
       if (highest_op_id > entry.second->last_received) {
@@ -1743,6 +1752,30 @@ size_t PeerMessageQueue::EvictLogCache(size_t bytes_to_evict) {
   return log_cache_.EvictThroughOp(std::numeric_limits<int64_t>::max(), bytes_to_evict);
 }
 
+size_t PeerMessageQueue::EvictLogCacheNotNeededByLiveFollowers(size_t bytes_to_evict) {
+  const int32_t lagging_follower_threshold = FLAGS_consensus_lagging_follower_threshold;
+  // Ops that were not consumed by an actively polling CDC consumer are still needed.
+  int64_t evict_index = GetCDCConsumerOpIdToEvict().index;
+  bool has_live_peers = false;
+  {
+    LockGuard lock(queue_lock_);
+    for (const auto& [uuid, peer] : peers_map_) {
+      if (!peer->is_last_exchange_successful ||
+          (lagging_follower_threshold > 0 &&
+           peer->current_retransmissions >= lagging_follower_threshold)) {
+        continue;
+      }
+      evict_index = std::min(evict_index, peer->last_received.index);
+      has_live_peers = true;
+    }
+  }
+  if (!has_live_peers) {
+    // There are no live peers, so we cannot tell which ops are still needed.
+    return 0;
+  }
+  return log_cache_.EvictThroughOp(evict_index, bytes_to_evict);
+}
+
 void PeerMessageQueue::TrackOperationsMemory(const OpIds& op_ids) {
   log_cache_.TrackOperationsMemory(op_ids);
 }
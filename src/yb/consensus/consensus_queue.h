@@ -120,6 +120,7 @@ class PeerMessageQueue {
         : uuid(raft_peer_pb.permanent_uuid()),
           last_known_committed_idx(OpId::Min().index),
           last_successful_communication_time(MonoTime::Now()) {
+      is_witness = raft_peer_pb.is_witness();
       cloud_info = raft_peer_pb.cloud_info();
       last_known_private_addr = std::vector<HostPortPB>(
           raft_peer_pb.last_known_private_addr().begin(),
@@ -195,6 +196,9 @@ class PeerMessageQueue {
     // Member type of this peer in the config.
     PeerMemberType member_type = PeerMemberType::UNKNOWN_MEMBER_TYPE;
 
+    // Whether this peer is a witness, i.e. does not apply ops to DocDB.
+    bool is_witness = false;
+
     uint64_t num_sst_files = 0;
 
     std::optional<CloudInfoPB> cloud_info;
@@ -218,7 +222,8 @@ class PeerMessageQueue {
                    const std::string& tablet_id,
                    const server::ClockPtr& clock,
                    ConsensusContext* context,
-                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token);
+                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token,
+                   std::unique_ptr<ThreadPoolToken> log_cache_prefetch_token = nullptr);
 
   // Initialize the queue.
   virtual void Init(const OpId& last_locally_replicated);
@@ -398,6 +403,10 @@ class PeerMessageQueue {
   size_t LogCacheSize();
   size_t EvictLogCache(size_t bytes_to_evict);
 
+  // Evicts up to bytes_to_evict bytes of cached ops that are no longer needed by any live
+  // follower, i.e. ops that are retained only for CDC consumers or lagging/unreachable followers.
+  size_t EvictLogCacheNotNeededByLiveFollowers(size_t bytes_to_evict);
+
   // Start memory tracking of following operations in case they are still present in our caches.
   void TrackOperationsMemory(const OpIds& op_ids);
 
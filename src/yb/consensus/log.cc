@@ -81,6 +81,7 @@
 #include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/random.h"
+#include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/shared_lock.h"
 #include "yb/util/size_literals.h"
@@ -890,6 +891,11 @@ Status Log::DoAppend(LogEntryBatch* entry_batch, SkipWalWrite skip_wal_write) {
       LongOperationTracker long_operation_tracker(
           "Log append", FLAGS_consensus_log_scoped_watch_delay_append_threshold_ms * 1ms);
 
+      auto inject_latency_ms_max = GetAtomicFlag(&FLAGS_log_inject_append_latency_ms_max);
+      if (PREDICT_FALSE(inject_latency_ms_max > 0)) {
+        SleepFor(MonoDelta::FromMilliseconds(RandomUniformInt(0, inject_latency_ms_max)));
+      }
+
       RETURN_NOT_OK(active_segment_->WriteEntryBatch(entry_batch_data));
     }
 
@@ -59,6 +59,7 @@
 #include "yb/util/scope_exit.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/test_util.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/tsan_util.h"
 
 using std::atomic;
@@ -129,12 +130,14 @@ class LogCacheTest : public YBTest {
     ASSERT_OK(log_->WaitUntilAllFlushed());
   }
 
-  void CloseAndReopenCache(const OpIdPB& preceding_id) {
+  void CloseAndReopenCache(
+      const OpIdPB& preceding_id, std::unique_ptr<ThreadPoolToken> prefetch_token = nullptr) {
     // Blow away the memtrackers before creating the new cache.
     cache_.reset();
 
     cache_.reset(new LogCache(
-        metric_entity_, log_.get(), nullptr /* mem_tracker */, kPeerUuid, kTestTablet));
+        metric_entity_, log_.get(), nullptr /* mem_tracker */, kPeerUuid, kTestTablet,
+        std::move(prefetch_token)));
     cache_->Init(preceding_id);
   }
 
@@ -321,6 +324,30 @@ TEST_F(LogCacheTest, TestCacheEdgeCases) {
 }
 
 
+// Tests that ops read from disk ahead of the requested range are added to the cache.
+TEST_F(LogCacheTest, TestSegmentPrefetch) {
+  constexpr int kNumOps = 10;
+  CloseAndReopenCache(
+      MinimumOpId(), log_thread_pool_->NewToken(ThreadPool::ExecutionMode::SERIAL));
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumOps));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  cache_->EvictThroughOp(kNumOps);
+  ASSERT_EQ(cache_->num_cached_ops(), 0);
+
+  // Reading the first op from disk triggers prefetch of the rest of the ops.
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 1));
+  ASSERT_EQ(1, read_result.messages.size());
+  ASSERT_OK(WaitFor([this] {
+    return cache_->num_cached_ops() == kNumOps - 1;
+  }, 10s * kTimeMultiplier, "Ops prefetched"));
+  ASSERT_EQ(cache_->metrics_.prefetched_ops->value(), kNumOps - 1);
+
+  // The rest of the ops are served from the cache.
+  read_result = ASSERT_RESULT(cache_->ReadOps(1, 8_MB));
+  ASSERT_EQ(kNumOps - 1, read_result.messages.size());
+  ASSERT_EQ(0, read_result.read_from_disk_size);
+}
+
 TEST_F(LogCacheTest, TestMemoryLimit) {
   FLAGS_log_cache_size_limit_mb = 1;
   CloseAndReopenCache(MinimumOpId());
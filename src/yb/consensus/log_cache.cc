@@ -57,11 +57,13 @@
 #include "yb/util/result.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status_format.h"
+#include "yb/util/threadpool.h"
 
 using std::vector;
 using std::string;
 
 using namespace std::literals;
+using namespace yb::size_literals;
 
 DEFINE_UNKNOWN_int32(log_cache_size_limit_mb, 128,
              "The total per-tablet size of consensus entries which may be kept in memory. "
@@ -80,6 +82,13 @@ DEFINE_UNKNOWN_int32(global_log_cache_size_limit_percentage, 5,
              "entries across all tablets. Default is 5.");
 TAG_FLAG(global_log_cache_size_limit_percentage, advanced);
 
+DEFINE_RUNTIME_int32(log_cache_prefetch_max_segments, 2,
+    "When ops requested from the log cache have to be read from disk, prefetch the WAL segments "
+    "between the read position and the cached ops in the background, so that a follower that "
+    "fell behind the cache is served from memory on its next requests. Prefetch is skipped if the "
+    "missing ops span more than this number of segments. 0 disables prefetch.");
+TAG_FLAG(log_cache_prefetch_max_segments, advanced);
+
 DEFINE_test_flag(bool, log_cache_skip_eviction, false,
                  "Don't evict log entries in tests.");
 
@@ -94,6 +103,9 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
 METRIC_DEFINE_counter(tablet, log_cache_disk_reads, "Log Cache Disk Reads",
                       yb::MetricUnit::kEntries,
                       "Amount of operations read from disk.");
+METRIC_DEFINE_counter(tablet, log_cache_prefetched_ops, "Log Cache Prefetched Ops",
+                      yb::MetricUnit::kEntries,
+                      "Amount of operations prefetched from WAL segments into the log cache.");
 
 DECLARE_bool(get_changes_honor_deadline);
 
@@ -112,7 +124,8 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
                    const log::LogPtr& log,
                    const MemTrackerPtr& server_tracker,
                    const string& local_uuid,
-                   const string& tablet_id)
+                   const string& tablet_id,
+                   std::unique_ptr<ThreadPoolToken> prefetch_token)
   : log_(log),
     local_uuid_(local_uuid),
     tablet_id_(tablet_id),
@@ -120,6 +133,7 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
     next_sequential_op_index_(0),
     min_pinned_op_index_(0),
     num_batches_overwritten_cache_(0),
+    prefetch_token_(std::move(prefetch_token)),
     metrics_(metric_entity) {
 
   const int64_t max_ops_size_bytes = FLAGS_log_cache_size_limit_mb * 1_MB;
@@ -157,6 +171,9 @@ MemTrackerPtr LogCache::GetServerMemTracker(const MemTrackerPtr& server_tracker)
 }
 
 LogCache::~LogCache() {
+  if (prefetch_token_) {
+    prefetch_token_->Shutdown();
+  }
   tracker_->Release(tracker_->consumption());
   {
     std::lock_guard<simple_spinlock> l(lock_);
@@ -215,6 +232,8 @@ LogCache::PrepareAppendResult LogCache::PrepareAppendOperations(const ReplicateM
       num_batches_overwritten_cache_++;
     }
 
+    ++overwrite_generation_;
+
     // Set back min_pinned_op_index_ in case the newly inserted ops are evicted.
     if (first_idx_in_batch < min_pinned_op_index_) {
       LOG_WITH_PREFIX_UNLOCKED(INFO) << Format(
@@ -421,6 +440,10 @@ Result<ReadOpsResult> LogCache::ReadOps(
         result.read_from_disk_size += current_message_size;
         next_index++;
       }
+
+      if (!fetch_single_entry) {
+        MaybeStartPrefetchUnlocked(next_index);
+      }
     } else {
       const auto seg_num_result = log_->GetLogReader()->LookupOpWalSegmentNumber(next_index);
       if (seg_num_result.ok()) {
@@ -456,6 +479,114 @@ Result<ReadOpsResult> LogCache::ReadOps(
   return result;
 }
 
+void LogCache::MaybeStartPrefetchUnlocked(int64_t from_index) {
+  const auto max_segments = FLAGS_log_cache_prefetch_max_segments;
+  if (!prefetch_token_ || prefetch_in_progress_ || max_segments <= 0) {
+    return;
+  }
+  // The cached range starts at the first cached op after from_index, so prefetched ops end right
+  // before it.
+  auto it = cache_.lower_bound(from_index);
+  const int64_t to_index = it == cache_.end() ? next_sequential_op_index_ - 1 : it->first - 1;
+  if (to_index < from_index || to_index >= min_pinned_op_index_) {
+    return;
+  }
+  prefetch_in_progress_ = true;
+  auto status = prefetch_token_->SubmitFunc(
+      [this, from_index, to_index, generation = overwrite_generation_, max_segments] {
+    auto status = PrefetchSegments(from_index, to_index, generation, max_segments);
+    if (!status.ok()) {
+      YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 10)
+          << "Failed to prefetch ops " << from_index << ".." << to_index << ": " << status;
+    }
+    std::lock_guard lock(lock_);
+    prefetch_in_progress_ = false;
+  });
+  if (!status.ok()) {
+    prefetch_in_progress_ = false;
+  }
+}
+
+Status LogCache::PrefetchSegments(
+    int64_t from_index, int64_t to_index, int64_t generation, int max_segments) {
+  auto* reader = log_->GetLogReader();
+  const auto first_segment = VERIFY_RESULT(reader->LookupOpWalSegmentNumber(from_index));
+  const auto last_segment = VERIFY_RESULT(reader->LookupOpWalSegmentNumber(to_index));
+  if (last_segment - first_segment >= max_segments) {
+    VLOG_WITH_PREFIX(1)
+        << "Not prefetching ops " << from_index << ".." << to_index << " spanning segments "
+        << first_segment << ".." << last_segment;
+    return Status::OK();
+  }
+
+  // Segments are read starting from the one that is adjacent to the cached range, so the cached
+  // range stays contiguous even if the prefetch stops early.
+  int64_t up_to = to_index;
+  for (auto segment = last_segment; segment >= first_segment && up_to >= from_index; --segment) {
+    // Binary search for the first op of the segment, segment numbers grow with op index.
+    int64_t segment_start = from_index;
+    int64_t hi = up_to;
+    while (segment_start < hi) {
+      auto mid = segment_start + (hi - segment_start) / 2;
+      if (VERIFY_RESULT(reader->LookupOpWalSegmentNumber(mid)) < segment) {
+        segment_start = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+
+    ReplicateMsgs msgs;
+    RETURN_NOT_OK(reader->ReadReplicatesInRange(
+        segment_start, up_to, log::LogReader::kNoSizeLimit, &msgs,
+        nullptr /* starting_op_segment_seq_num */));
+    if (!AddPrefetchedOps(msgs, up_to, generation)) {
+      break;
+    }
+    up_to = segment_start - 1;
+  }
+  return Status::OK();
+}
+
+bool LogCache::AddPrefetchedOps(const ReplicateMsgs& msgs, int64_t last_index, int64_t generation) {
+  // SpaceUsed is relatively expensive, so do calculations outside the lock.
+  std::vector<CacheEntry> entries;
+  entries.reserve(msgs.size());
+  for (auto it = msgs.rbegin(); it != msgs.rend(); ++it) {
+    entries.push_back({ *it, (*it)->SpaceUsedLong(), /* tracked= */ true });
+  }
+
+  std::lock_guard lock(lock_);
+  // Ops are not added if the cache was overwritten while they were read, since they could be
+  // stale, or if they are not adjacent to the cached range anymore.
+  if (generation != overwrite_generation_) {
+    return false;
+  }
+  auto it = cache_.upper_bound(last_index);
+  const int64_t first_cached_index =
+      it == cache_.end() ? next_sequential_op_index_ : it->first;
+  if (first_cached_index != last_index + 1 || last_index >= min_pinned_op_index_) {
+    return false;
+  }
+
+  size_t num_added = 0;
+  bool all_added = true;
+  // Ops are inserted in descending order, so the cached range stays contiguous.
+  for (auto& entry : entries) {
+    if (!tracker_->TryConsume(entry.mem_usage)) {
+      all_added = false;
+      break;
+    }
+    metrics_.size->IncrementBy(entry.mem_usage);
+    metrics_.num_ops->Increment();
+    const auto index = entry.msg->id().index();
+    it = cache_.emplace_hint(it, index, std::move(entry));
+    ++num_added;
+  }
+  metrics_.prefetched_ops->IncrementBy(num_added);
+  VLOG_WITH_PREFIX_UNLOCKED(1) << "Added " << num_added << " prefetched ops to the cache";
+  return all_added;
+}
+
 size_t LogCache::EvictThroughOp(int64_t index, int64_t bytes_to_evict) {
   // Capture the evicted messages and release the memory outside of lock.
   ReplicateMsgVector evicted_messages;
@@ -667,7 +798,8 @@ int64_t LogCache::num_cached_ops() const {
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : INSTANTIATE_METRIC(num_ops, 0),
     INSTANTIATE_METRIC(size, 0),
-    INSTANTIATE_METRIC(disk_reads) {
+    INSTANTIATE_METRIC(disk_reads),
+    INSTANTIATE_METRIC(prefetched_ops) {
 }
 #undef INSTANTIATE_METRIC
 
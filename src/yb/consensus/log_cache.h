@@ -70,6 +70,7 @@ namespace yb {
 class MetricEntity;
 class MemTracker;
 class OpIdPB;
+class ThreadPoolToken;
 
 namespace consensus {
 
@@ -93,7 +94,8 @@ class LogCache {
            const log::LogPtr& log,
            const std::shared_ptr<MemTracker>& server_tracker,
            const std::string& local_uuid,
-           const std::string& tablet_id);
+           const std::string& tablet_id,
+           std::unique_ptr<ThreadPoolToken> prefetch_token = nullptr);
   ~LogCache();
 
   static std::shared_ptr<MemTracker> GetServerMemTracker(
@@ -188,6 +190,7 @@ class LogCache {
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimitMB);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimitPercentage);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
+  FRIEND_TEST(LogCacheTest, TestSegmentPrefetch);
   friend class LogCacheTest;
 
   // An entry in the cache.
@@ -239,6 +242,20 @@ class LogCache {
 
   PrepareAppendResult PrepareAppendOperations(const ReplicateMsgs& msgs);
 
+  // Schedules background prefetch of the ops between from_index and the cached range, if prefetch
+  // is enabled and there is no prefetch in progress.
+  void MaybeStartPrefetchUnlocked(int64_t from_index) REQUIRES(lock_);
+
+  // Reads WAL segments containing ops in [from_index, to_index] starting from the last one, and
+  // adds their ops to the cache while they fit into the memory limit.
+  Status PrefetchSegments(
+      int64_t from_index, int64_t to_index, int64_t generation, int max_segments);
+
+  // Adds ops read from disk, ending at last_index, to the cache. Ops are added only if they are
+  // adjacent to the cached range and the cache was not overwritten since they were read.
+  // Returns true if all ops were added.
+  bool AddPrefetchedOps(const ReplicateMsgs& msgs, int64_t last_index, int64_t generation);
+
   log::LogPtr const log_;
 
   // The UUID of the local peer.
@@ -270,6 +287,10 @@ class LogCache {
   // Number of batches in progress of preparing that have overwritten min_pinned_op_index_.
   int64_t num_batches_overwritten_cache_;
 
+  // Incremented each time appended ops overwrite ops in the cache. Used to detect that ops read
+  // from disk without holding lock_ could be stale.
+  int64_t overwrite_generation_ GUARDED_BY(lock_) = 0;
+
   // Pointer to a parent memtracker for all log caches. This exists to compute server-wide cache
   // size and enforce a server-wide memory limit.  When the first instance of a log cache is
   // created, a new entry is added to MemTracker's static map; subsequent entries merely increment
@@ -280,6 +301,11 @@ class LogCache {
   // A MemTracker for this instance.
   std::shared_ptr<MemTracker> tracker_;
 
+  // Token used to prefetch WAL segments in the background, nullptr if prefetch is disabled.
+  std::unique_ptr<ThreadPoolToken> prefetch_token_;
+
+  bool prefetch_in_progress_ GUARDED_BY(lock_) = false;
+
   struct Metrics {
     explicit Metrics(const scoped_refptr<MetricEntity>& metric_entity);
 
@@ -290,6 +316,8 @@ class LogCache {
     scoped_refptr<AtomicGauge<int64_t>> size;
 
     scoped_refptr<Counter> disk_reads;
+
+    scoped_refptr<Counter> prefetched_ops;
   };
   Metrics metrics_;
 
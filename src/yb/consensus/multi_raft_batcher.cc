@@ -17,11 +17,15 @@
 #include "yb/common/wire_protocol.h"
 
 #include "yb/consensus/consensus_meta.h"
+#include "yb/consensus/consensus.messages.h"
 #include "yb/consensus/consensus.proxy.h"
 
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/periodic.h"
+#include "yb/rpc/scheduler.h"
 
 #include "yb/util/flags.h"
+#include "yb/util/status_format.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
@@ -37,6 +41,16 @@ DEFINE_UNKNOWN_uint64(multi_raft_batch_size, 0,
               "Maximum batch size for a multi-Raft consensus payload. Ignored if set to zero.");
 TAG_FLAG(multi_raft_batch_size, advanced);
 
+DEFINE_UNKNOWN_bool(enable_multi_raft_update_batching, false,
+            "If true, Raft update requests carrying ops are coalesced per remote tserver into "
+            "a single MultiRaftUpdateConsensus RPC.");
+TAG_FLAG(enable_multi_raft_update_batching, advanced);
+
+DEFINE_UNKNOWN_uint64(multi_raft_update_batch_window_us, 500,
+              "Maximum time an update request carrying ops waits in a multi-Raft batch before "
+              "the batch is sent.");
+TAG_FLAG(multi_raft_update_batch_window_us, advanced);
+
 DECLARE_int32(consensus_rpc_timeout_ms);
 
 namespace yb {
@@ -44,21 +58,16 @@ namespace consensus {
 
 using rpc::PeriodicTimer;
 
-namespace {
-
-// Tracks a single peers ConsensusResponsePB as well as its ProcessResponse callback.
-struct ResponseCallbackData {
-  ConsensusResponsePB* resp;
-  HeartbeatResponseCallback callback;
-};
-
-}
-
 struct MultiRaftHeartbeatBatcher::MultiRaftConsensusData {
-  MultiRaftConsensusRequestPB batch_req;
-  MultiRaftConsensusResponsePB batch_res;
+  ThreadSafeArena arena;
+  // Requests are referenced by batch_req, so they are retained until the batch completes.
+  std::vector<std::shared_ptr<LWConsensusRequestPB>> requests;
+  LWMultiRaftConsensusRequestPB batch_req{&arena};
+  LWMultiRaftConsensusResponsePB batch_res{&arena};
   rpc::RpcController controller;
-  std::vector<ResponseCallbackData> response_callback_data;
+  std::vector<HeartbeatResponseCallback> response_callbacks;
+  // Whether a flush of this batch was already scheduled by an update request.
+  bool flush_scheduled = false;
 };
 
 MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
@@ -86,26 +95,83 @@ void MultiRaftHeartbeatBatcher::Start() {
 
 MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
   std::lock_guard<std::mutex> lock(mutex_);
-  LOG_IF(DFATAL, current_batch_ && !current_batch_->response_callback_data.empty())
+  LOG_IF(DFATAL, current_batch_ && !current_batch_->response_callbacks.empty())
       << "Not empty batch in ~MultiRaftHeartbeatBatcher";
 }
 
-void MultiRaftHeartbeatBatcher::AddRequestToBatch(ConsensusRequestPB* request,
-                                                  ConsensusResponsePB* response,
+void MultiRaftHeartbeatBatcher::AddRequestToBatch(std::shared_ptr<LWConsensusRequestPB> request,
                                                   HeartbeatResponseCallback callback) {
   std::shared_ptr<MultiRaftConsensusData> data = nullptr;
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    current_batch_->response_callback_data.push_back({
-      .resp = response,
-      .callback = std::move(callback)
-    });
-    // Add a ConsensusRequestPB to the batch
-    current_batch_->batch_req.add_consensus_request()->Swap(request);
-    if (FLAGS_multi_raft_batch_size > 0
-        && current_batch_->response_callback_data.size() >= FLAGS_multi_raft_batch_size) {
-      data = PrepareNextBatchRequest();
+    data = DoAddRequestToBatch(std::move(request), std::move(callback));
+  }
+  SendBatchRequest(data);
+}
+
+void MultiRaftHeartbeatBatcher::AddUpdateRequestToBatch(
+    std::shared_ptr<LWConsensusRequestPB> request, HeartbeatResponseCallback callback) {
+  std::shared_ptr<MultiRaftConsensusData> data = nullptr;
+  int64_t batch_id_to_flush = -1;
+  bool added = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_batch_) {
+      added = true;
+      auto batch_id = current_batch_id_;
+      auto batch = current_batch_;
+      data = DoAddRequestToBatch(std::move(request), std::move(callback));
+      if (!data && !batch->flush_scheduled) {
+        batch->flush_scheduled = true;
+        batch_id_to_flush = batch_id;
+      }
+    }
+  }
+  if (!added) {
+    // The batcher was shut down, so the request was not added to any batch.
+    static const Status status = STATUS(Aborted, "MultiRaft shutdown");
+    callback(status, nullptr);
+    return;
+  }
+  SendBatchRequest(data);
+  if (batch_id_to_flush >= 0) {
+    std::weak_ptr<MultiRaftHeartbeatBatcher> weak_self = shared_from_this();
+    messenger_->scheduler().Schedule(
+        [weak_self, batch_id_to_flush](const Status& status) {
+          if (!status.ok()) {
+            return;
+          }
+          if (auto self = weak_self.lock()) {
+            self->FlushUpdateBatch(batch_id_to_flush);
+          }
+        },
+        std::chrono::microseconds(FLAGS_multi_raft_update_batch_window_us));
+  }
+}
+
+std::shared_ptr<MultiRaftHeartbeatBatcher::MultiRaftConsensusData>
+    MultiRaftHeartbeatBatcher::DoAddRequestToBatch(std::shared_ptr<LWConsensusRequestPB> request,
+                                                   HeartbeatResponseCallback callback) {
+  current_batch_->response_callbacks.push_back(std::move(callback));
+  // Add the request to the batch without copying it.
+  current_batch_->batch_req.mutable_consensus_request()->push_back_ref(request.get());
+  current_batch_->requests.push_back(std::move(request));
+  if (FLAGS_multi_raft_batch_size > 0
+      && current_batch_->response_callbacks.size() >= FLAGS_multi_raft_batch_size) {
+    return PrepareNextBatchRequest();
+  }
+  return nullptr;
+}
+
+void MultiRaftHeartbeatBatcher::FlushUpdateBatch(int64_t batch_id) {
+  std::shared_ptr<MultiRaftConsensusData> data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (batch_id != current_batch_id_) {
+      // This batch was already sent because of the size limit or the periodic timer.
+      return;
     }
+    data = PrepareNextBatchRequest();
   }
   SendBatchRequest(data);
 }
@@ -121,12 +187,13 @@ void MultiRaftHeartbeatBatcher::PrepareAndSendBatchRequest() {
 
 std::shared_ptr<MultiRaftHeartbeatBatcher::MultiRaftConsensusData>
     MultiRaftHeartbeatBatcher::PrepareNextBatchRequest() {
-  if (!current_batch_ || current_batch_->batch_req.consensus_request_size() == 0) {
+  if (!current_batch_ || current_batch_->response_callbacks.empty()) {
     return nullptr;
   }
   batch_sender_->Snooze();
   auto data = std::make_shared<MultiRaftConsensusData>();
   current_batch_.swap(data);
+  ++current_batch_id_;
   auto running_calls = ++*running_calls_;
   LOG_IF(DFATAL, running_calls <= 0) << "Wrong number or running calls: " << running_calls;
   return data;
@@ -139,16 +206,24 @@ void MultiRaftHeartbeatBatcher::SendBatchRequest(std::shared_ptr<MultiRaftConsen
 
   data->controller.Reset();
   data->controller.set_timeout(MonoDelta::FromMilliseconds(
-      FLAGS_consensus_rpc_timeout_ms * data->batch_req.consensus_request_size()));
+      FLAGS_consensus_rpc_timeout_ms * data->response_callbacks.size()));
   auto callback = [data, running_calls = running_calls_]() {
     --*running_calls;
     auto status = data->controller.status();
-    for (int i = 0; i < data->batch_req.consensus_request_size(); i++) {
-      auto callback_data = data->response_callback_data[i];
+    auto& responses = *data->batch_res.mutable_consensus_response();
+    if (status.ok() && responses.size() != data->response_callbacks.size()) {
+      status = STATUS_FORMAT(
+          IllegalState, "Wrong number of responses in batch: $0 vs $1", responses.size(),
+          data->response_callbacks.size());
+    }
+    auto response_it = responses.begin();
+    for (const auto& response_callback : data->response_callbacks) {
       if (status.ok()) {
-        callback_data.resp->Swap(data->batch_res.mutable_consensus_response(i));
+        response_callback(status, &*response_it);
+        ++response_it;
+      } else {
+        response_callback(status, nullptr);
       }
-      callback_data.callback(status);
     }
   };
   consensus_proxy_->MultiRaftUpdateConsensusAsync(
@@ -163,8 +238,8 @@ void MultiRaftHeartbeatBatcher::Shutdown() {
     batch.swap(current_batch_);
   }
   static const Status status = STATUS(Aborted, "MultiRaft shutdown");
-  for (const auto& callback : batch->response_callback_data) {
-    callback.callback(status);
+  for (const auto& callback : batch->response_callbacks) {
+    callback(status, nullptr);
   }
 }
 
@@ -175,7 +250,7 @@ MultiRaftManager::MultiRaftManager(rpc::Messenger* messenger,
       local_peer_cloud_info_pb_(std::move(local_peer_cloud_info_pb)) {}
 
 MultiRaftHeartbeatBatcherPtr MultiRaftManager::AddOrGetBatcher(const RaftPeerPB& remote_peer_pb) {
-  if (!FLAGS_enable_multi_raft_heartbeat_batcher) {
+  if (!FLAGS_enable_multi_raft_heartbeat_batcher && !FLAGS_enable_multi_raft_update_batching) {
     return nullptr;
   }
 
@@ -31,7 +31,9 @@ class PeriodicTimer;
 
 namespace consensus {
 
-using HeartbeatResponseCallback = std::function<void(const Status&)>;
+// Invoked with the response of the request. The response is null if the batch failed, and is
+// valid only during the callback.
+using HeartbeatResponseCallback = std::function<void(const Status&, LWConsensusResponsePB*)>;
 
 // - MultiRaftHeartbeatBatcher is responsible for the batching of heartbeats
 //   among peers that are communicating with remote peers at the same tserver
@@ -40,6 +42,9 @@ using HeartbeatResponseCallback = std::function<void(const Status&)>;
 // - A heartbeat is added to a batch upon calling AddRequestToBatch and a batch is sent
 //   out every FLAGS_multi_raft_heartbeat_interval_ms ms or once the batch size reaches
 //   FLAGS_multi_raft_batch_size
+// - When FLAGS_enable_multi_raft_update_batching is set, update requests carrying ops are
+//   also coalesced. The first such request added to a batch schedules a flush after
+//   FLAGS_multi_raft_update_batch_window_us, so ops are not delayed by the heartbeat interval
 // - To improve efficency multiple batches may be processed concurrently
 //   but only a single batch is being built at any given time
 class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
@@ -54,23 +59,35 @@ class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftH
   // Required to start a periodic timer to send out batches.
   void Start();
 
-  // When called adds the request to a batch (request data will be swapped).
-  // If the batch executes sucessfully then the response is populated and the callback is executed.
-  // If the batch rpc call fails the response will NOT be populated and the callback will be
-  // executed with an error status.
-  void AddRequestToBatch(ConsensusRequestPB* request,
-                         ConsensusResponsePB* response,
+  // When called adds the request to a batch. The batch references the request without copying
+  // it, so the request should not be modified until the callback is executed.
+  // If the batch executes sucessfully then the callback is executed with the response.
+  // If the batch rpc call fails the callback will be executed with an error status.
+  void AddRequestToBatch(std::shared_ptr<LWConsensusRequestPB> request,
                          HeartbeatResponseCallback callback);
 
+  // Same as AddRequestToBatch, but for requests that carry ops. The batch containing the request
+  // is sent no later than FLAGS_multi_raft_update_batch_window_us after the request was added.
+  void AddUpdateRequestToBatch(std::shared_ptr<LWConsensusRequestPB> request,
+                               HeartbeatResponseCallback callback);
+
   void Shutdown();
 
  private:
-  // Tracks all the metadata for a single batch request, including a list of all
-  // ResponseCallbackData registered by each local peer with this batch in AddRequestToBatch().
+  // Tracks all the metadata for a single batch request, including the callbacks
+  // registered by each local peer with this batch in AddRequestToBatch().
   struct MultiRaftConsensusData;
 
+  // Appends the request to the current batch and returns the batch if it should be sent now.
+  std::shared_ptr<MultiRaftConsensusData> DoAddRequestToBatch(
+      std::shared_ptr<LWConsensusRequestPB> request,
+      HeartbeatResponseCallback callback) REQUIRES(mutex_);
+
   void PrepareAndSendBatchRequest();
 
+  // Sends the current batch if it is still the one identified by batch_id.
+  void FlushUpdateBatch(int64_t batch_id);
+
   // This method will return a nullptr if the current batch is empty.
   std::shared_ptr<MultiRaftConsensusData> PrepareNextBatchRequest() REQUIRES(mutex_);
 
@@ -89,6 +106,9 @@ class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftH
 
   std::shared_ptr<MultiRaftConsensusData> current_batch_ GUARDED_BY(mutex_);
 
+  // Incremented each time a new batch becomes current, used to skip stale scheduled flushes.
+  int64_t current_batch_id_ GUARDED_BY(mutex_) = 0;
+
   std::atomic<int>* running_calls_;
 };
 
@@ -106,6 +126,7 @@ class MultiRaftManager: public std::enable_shared_from_this<MultiRaftManager> {
 
   // Add a batcher with the given hostport (if one does not already exist)
   // and returns the newly created batcher.
+  // Returns nullptr if neither heartbeat nor update batching is enabled.
   MultiRaftHeartbeatBatcherPtr AddOrGetBatcher(const RaftPeerPB& remote_peer_pb);
 
   void StartShutdown();
@@ -74,5 +74,22 @@ TEST(QuorumUtilTest, TestMemberExtraction) {
   ASSERT_EQ("B", peer_pb.permanent_uuid());
 }
 
+TEST(QuorumUtilTest, TestWitness) {
+  RaftConfigPB config;
+  SetPeerInfo("A", PeerMemberType::VOTER, config.add_peers());
+  SetPeerInfo("B", PeerMemberType::VOTER, config.add_peers());
+  SetPeerInfo("C", PeerMemberType::VOTER, config.add_peers());
+  config.mutable_peers(2)->set_is_witness(true);
+
+  ASSERT_FALSE(IsRaftConfigWitness("A", config));
+  ASSERT_TRUE(IsRaftConfigWitness("C", config));
+  ASSERT_FALSE(IsRaftConfigWitness("invalid", config));
+
+  // Witness is a regular voter for majority computations.
+  ASSERT_TRUE(IsRaftConfigVoter("C", config));
+  ASSERT_EQ(3, CountVoters(config));
+  ASSERT_EQ(2, MajoritySize(CountVoters(config)));
+}
+
 } // namespace consensus
 } // namespace yb
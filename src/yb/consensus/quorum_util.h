@@ -54,6 +54,7 @@ enum RaftConfigState {
 
 bool IsRaftConfigMember(const std::string& uuid, const RaftConfigPB& config);
 bool IsRaftConfigVoter(const std::string& uuid, const RaftConfigPB& config);
+bool IsRaftConfigWitness(const std::string& uuid, const RaftConfigPB& config);
 
 // Get the specified member of the config.
 // Returns Status::NotFound if a member with the specified uuid could not be
@@ -351,6 +351,7 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
       options.tablet_id,
       clock,
       consensus_context,
+      raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL),
       raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL));
 
   DCHECK(local_peer_pb.has_permanent_uuid());
@@ -1393,6 +1394,23 @@ void RaftConsensus::UpdateMajorityReplicated(
 
   majority_num_sst_files_.store(majority_replicated_data.num_sst_files, std::memory_order_release);
 
+  if (!majority_replicated_data.peer_got_all_ops.empty() &&
+      state_->GetActiveRoleUnlocked() == PeerRole::LEADER) {
+    const auto& active_config = state_->GetActiveConfigUnlocked();
+    if (IsRaftConfigWitness(peer_uuid(), active_config)) {
+      // Witness is elected when data replicas lag behind it, for instance after the leader failure.
+      // It ships its WAL and transfers leadership to the first data replica that has all ops.
+      const auto* peer = FindPeer(active_config, majority_replicated_data.peer_got_all_ops);
+      if (peer && !peer->is_witness() && peer->member_type() == PeerMemberType::VOTER) {
+        LOG_WITH_PREFIX(INFO) << "Witness leader transfers leadership to caught up data replica "
+                              << peer->permanent_uuid();
+        WARN_NOT_OK(StartStepDownUnlocked(*peer, /* graceful= */ false),
+                    "Start step down failed");
+        return;
+      }
+    }
+  }
+
   if (!majority_replicated_data.peer_got_all_ops.empty() &&
       delayed_step_down_.term == state_->GetCurrentTermUnlocked() &&
       majority_replicated_data.peer_got_all_ops == delayed_step_down_.protege) {
@@ -3544,6 +3562,10 @@ size_t RaftConsensus::EvictLogCache(size_t bytes_to_evict) {
   return queue_->EvictLogCache(bytes_to_evict);
 }
 
+size_t RaftConsensus::EvictLogCacheNotNeededByLiveFollowers(size_t bytes_to_evict) {
+  return queue_->EvictLogCacheNotNeededByLiveFollowers(bytes_to_evict);
+}
+
 Result<RetryableRequests> RaftConsensus::GetRetryableRequests() const {
   auto lock = state_->LockForRead();
   if(state_->state() != ReplicaState::kRunning) {
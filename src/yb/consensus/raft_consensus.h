@@ -252,6 +252,7 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   size_t LogCacheSize();
   size_t EvictLogCache(size_t bytes_to_evict);
+  size_t EvictLogCacheNotNeededByLiveFollowers(size_t bytes_to_evict);
 
   const scoped_refptr<log::Log>& log() { return log_; }
 
@@ -207,6 +207,8 @@ LeaderState ReplicaState::GetLeaderState(bool allow_stale) const {
       };
     case LeaderStatus::LEADER_BUT_NO_MAJORITY_REPLICATED_LEASE:
       FALLTHROUGH_INTENDED;
+    case LeaderStatus::LEADER_BUT_WITNESS:
+      FALLTHROUGH_INTENDED;
     case LeaderStatus::LEADER_BUT_NO_OP_NOT_COMMITTED:
       FALLTHROUGH_INTENDED;
     case LeaderStatus::NOT_LEADER:
@@ -232,6 +234,12 @@ LeaderState ReplicaState::GetLeaderStateUnlocked(
     return result.MakeNotReadyLeader(LeaderStatus::LEADER_BUT_NO_OP_NOT_COMMITTED);
   }
 
+  if (IsRaftConfigWitness(peer_uuid_, GetActiveConfigUnlocked())) {
+    // Witness leader does not have data, it only ships its WAL to a data replica and transfers
+    // leadership to it. Client will retry on the same server until then.
+    return result.MakeNotReadyLeader(LeaderStatus::LEADER_BUT_WITNESS);
+  }
+
   const auto lease_status = lease_check_mode != LeaderLeaseCheckMode::DONT_NEED_LEASE
       ? GetLeaderLeaseStatusUnlocked(&result.remaining_old_leader_lease, now)
       : LeaderLeaseStatus::HAS_LEASE;
@@ -29,6 +29,7 @@
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
+#include "yb/docdb/external_sst_file_writer.h"
 #include "yb/docdb/in_mem_docdb.h"
 #include "yb/dockv/primitive_value.h"
 
@@ -38,6 +39,7 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/sst_file_writer.h"
 
 #include "yb/server/hybrid_clock.h"
 
@@ -4413,5 +4415,71 @@ TEST_P(DocDBTestWrapper, DISABLED_KeyBuffer) {
   TestKeyBytes<ByteBuffer<64>>("ByteBuffer<64>");
 }
 
+TEST_F(DocDBTestQl, IngestExternalSstFile) {
+  ASSERT_OK(WriteSimple(1));
+  ASSERT_OK(WriteSimple(4));
+
+  auto make_key = [](int index) {
+    return SubDocKey(
+        MakeDocKey(Format("row$0", index), 11111 * index),
+        KeyEntryValue::MakeColumnId(ColumnId(10))).Encode();
+  };
+  auto make_value = [](int index) {
+    QLValuePB value;
+    value.set_int32_value(index);
+    return EncodeValue(value);
+  };
+
+  ExternalSstFileWriter writer(
+      regular_db_options(),
+      KeyBounds(MakeDocKey("row2", 22222).Encode().AsSlice(),
+                MakeDocKey("row4", 44444).Encode().AsSlice()));
+  auto source_path = GetTestPath("ingest-source.sst");
+  ASSERT_OK(writer.Open(source_path));
+  ASSERT_NOK(writer.Add(make_key(1).AsSlice(), make_value(1)));
+  for (int i : {2, 3}) {
+    ASSERT_OK(writer.Add(make_key(i).AsSlice(), make_value(i)));
+  }
+  ASSERT_NOK(writer.Add(make_key(4).AsSlice(), make_value(4)));
+  ASSERT_EQ(ASSERT_RESULT(writer.Finish()), 2U);
+
+  auto file_path = GetTestPath("ingest.sst");
+  ASSERT_EQ(ASSERT_RESULT(RewriteExternalSstFile(
+      regular_db_options(), source_path, file_path, 500_usec_ht)), 2U);
+  ASSERT_OK(doc_db().regular->AddFile(file_path, /* move_file= */ true));
+
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+      SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(10); HT{ physical: 1000 }]) -> 1
+      SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(10); HT{ physical: 500 }]) -> 2
+      SubDocKey(DocKey([], ["row3", 33333]), [ColumnId(10); HT{ physical: 500 }]) -> 3
+      SubDocKey(DocKey([], ["row4", 44444]), [ColumnId(10); HT{ physical: 4000 }]) -> 4
+  )#");
+
+  // Key range of the rewritten file overlaps existing records. It could be added only when the
+  // caller guarantees that none of its keys is present in the DB, as all keys have a new hybrid
+  // time.
+  ExternalSstFileWriter overlapping_writer(regular_db_options(), KeyBounds());
+  ASSERT_OK(overlapping_writer.Open(source_path));
+  for (int i : {1, 5}) {
+    ASSERT_OK(overlapping_writer.Add(make_key(i).AsSlice(), make_value(i * 10)));
+  }
+  ASSERT_OK(overlapping_writer.Finish());
+  ASSERT_OK(RewriteExternalSstFile(regular_db_options(), source_path, file_path, 6000_usec_ht));
+  rocksdb::ExternalSstFileInfo file_info;
+  ASSERT_OK(doc_db().regular->GetExternalSstFileInfo(file_path, &file_info));
+  ASSERT_NOK(doc_db().regular->AddFile(&file_info, /* move_file= */ true));
+  file_info.allow_overlap = true;
+  ASSERT_OK(doc_db().regular->AddFile(&file_info, /* move_file= */ true));
+
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+      SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(10); HT{ physical: 6000 }]) -> 10
+      SubDocKey(DocKey([], ["row1", 11111]), [ColumnId(10); HT{ physical: 1000 }]) -> 1
+      SubDocKey(DocKey([], ["row2", 22222]), [ColumnId(10); HT{ physical: 500 }]) -> 2
+      SubDocKey(DocKey([], ["row3", 33333]), [ColumnId(10); HT{ physical: 500 }]) -> 3
+      SubDocKey(DocKey([], ["row4", 44444]), [ColumnId(10); HT{ physical: 4000 }]) -> 4
+      SubDocKey(DocKey([], ["row5", 55555]), [ColumnId(10); HT{ physical: 6000 }]) -> 50
+  )#");
+}
+
 }  // namespace docdb
 }  // namespace yb
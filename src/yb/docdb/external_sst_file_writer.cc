@@ -0,0 +1,117 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/external_sst_file_writer.h"
+
+#include "yb/common/common.pb.h"
+
+#include "yb/docdb/rocksdb_writer.h"
+
+#include "yb/dockv/partition.h"
+
+#include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/sst_file_writer.h"
+#include "yb/rocksdb/table.h"
+
+#include "yb/util/status_format.h"
+
+namespace yb {
+namespace docdb {
+
+Result<KeyBounds> PartitionKeyBounds(
+    const dockv::Partition& partition, const dockv::PartitionSchema& partition_schema) {
+  PartitionSchemaPB partition_schema_pb;
+  partition_schema.ToPB(&partition_schema_pb);
+  KeyBounds result;
+  if (!partition.partition_key_start().empty()) {
+    result.lower.Reset(VERIFY_RESULT(dockv::PartitionSchema::GetEncodedKeyPrefix(
+        partition.partition_key_start(), partition_schema_pb)));
+  }
+  if (!partition.partition_key_end().empty()) {
+    result.upper.Reset(VERIFY_RESULT(dockv::PartitionSchema::GetEncodedKeyPrefix(
+        partition.partition_key_end(), partition_schema_pb)));
+  }
+  return result;
+}
+
+ExternalSstFileWriter::ExternalSstFileWriter(
+    const rocksdb::Options& options, KeyBounds key_bounds)
+    : options_(options), key_bounds_(std::move(key_bounds)) {
+}
+
+ExternalSstFileWriter::~ExternalSstFileWriter() = default;
+
+Status ExternalSstFileWriter::Open(const std::string& file_path) {
+  writer_ = std::make_unique<rocksdb::SstFileWriter>(
+      rocksdb::EnvOptions(), rocksdb::ImmutableCFOptions(options_), options_.comparator);
+  num_records_ = 0;
+  return writer_->Open(file_path);
+}
+
+Status ExternalSstFileWriter::Add(Slice encoded_sub_doc_key, Slice encoded_value) {
+  SCHECK(writer_, IllegalState, "File is not open");
+  if (!key_bounds_.IsWithinBounds(encoded_sub_doc_key)) {
+    return STATUS_FORMAT(
+        InvalidArgument, "Key $0 is out of tablet bounds $1",
+        encoded_sub_doc_key.ToDebugHexString(), key_bounds_);
+  }
+  RETURN_NOT_OK(writer_->Add(encoded_sub_doc_key, encoded_value));
+  ++num_records_;
+  return Status::OK();
+}
+
+Result<size_t> ExternalSstFileWriter::Finish() {
+  SCHECK(writer_, IllegalState, "File is not open");
+  SCHECK_GT(num_records_, 0U, IllegalState, "No records were added");
+  auto status = writer_->Finish();
+  writer_.reset();
+  RETURN_NOT_OK(status);
+  return num_records_;
+}
+
+Result<size_t> RewriteExternalSstFile(
+    const rocksdb::Options& options, const std::string& source_path, const std::string& dest_path,
+    HybridTime hybrid_time) {
+  SCHECK(hybrid_time.is_valid(), InvalidArgument, "Hybrid time of records is not specified");
+  rocksdb::EnvOptions env_options;
+  rocksdb::ImmutableCFOptions ioptions(options);
+  rocksdb::SstFileWriter writer(env_options, ioptions, options.comparator);
+  RETURN_NOT_OK(writer.Open(dest_path));
+
+  DocHybridTimeBuffer ht_buffer;
+  auto encoded_ht = ht_buffer.EncodeWithValueType(hybrid_time, 0);
+  std::string key_buffer;
+  size_t num_records = 0;
+  auto status = rocksdb::ReadExternalSstFile(
+      env_options, ioptions, options.comparator, source_path,
+      [&writer, &key_buffer, encoded_ht, &num_records](const Slice& key, const Slice& value) {
+    key_buffer.assign(key.cdata(), key.size());
+    key_buffer.append(encoded_ht.cdata(), encoded_ht.size());
+    ++num_records;
+    return writer.Add(key_buffer, value);
+  });
+  if (status.ok()) {
+    status = writer.Finish();
+  }
+  if (!status.ok()) {
+    ioptions.env->CleanupFile(dest_path);
+    if (ioptions.table_factory->IsSplitSstForWriteSupported()) {
+      ioptions.env->CleanupFile(rocksdb::TableBaseToDataFileName(dest_path));
+    }
+    return status;
+  }
+  return num_records;
+}
+
+}  // namespace docdb
+}  // namespace yb
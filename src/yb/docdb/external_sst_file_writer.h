@@ -0,0 +1,74 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "yb/common/hybrid_time.h"
+
+#include "yb/docdb/key_bounds.h"
+
+#include "yb/dockv/dockv_fwd.h"
+
+#include "yb/rocksdb/options.h"
+#include "yb/rocksdb/rocksdb_fwd.h"
+
+#include "yb/util/result.h"
+
+namespace yb {
+namespace docdb {
+
+// Returns bounds of encoded doc keys that belong to the tablet with the specified partition.
+Result<KeyBounds> PartitionKeyBounds(
+    const dockv::Partition& partition, const dockv::PartitionSchema& partition_schema);
+
+// Builds SST file with DocDB records of a single tablet, that could be ingested into this tablet
+// with the IngestExternalFile tablet server RPC, bypassing the WAL and memtables.
+// Records are stored without hybrid time. Each tablet peer assigns the hybrid time of the Raft
+// operation that ingests the file to all of them, see RewriteExternalSstFile.
+//
+// options should be initialized with InitRocksDBOptions, so the file uses the same table format
+// as the tablet regular DB.
+class ExternalSstFileWriter {
+ public:
+  ExternalSstFileWriter(const rocksdb::Options& options, KeyBounds key_bounds);
+  ~ExternalSstFileWriter();
+
+  Status Open(const std::string& file_path);
+
+  // Adds record with the specified encoded SubDocKey, without hybrid time, and encoded value.
+  // Keys should be added in increasing order and should be within the tablet key bounds.
+  Status Add(Slice encoded_sub_doc_key, Slice encoded_value);
+
+  // Finishes the file, returns number of records written.
+  Result<size_t> Finish();
+
+ private:
+  const rocksdb::Options options_;
+  const KeyBounds key_bounds_;
+  std::unique_ptr<rocksdb::SstFileWriter> writer_;
+  size_t num_records_ = 0;
+};
+
+// Writes records of the file built by ExternalSstFileWriter to a new file at dest_path, with the
+// specified hybrid time appended to each key. Appending the same suffix to all keys keeps their
+// order, since the hybrid time type byte sorts before the type byte of any subkey.
+// Returns number of records written.
+Result<size_t> RewriteExternalSstFile(
+    const rocksdb::Options& options, const std::string& source_path, const std::string& dest_path,
+    HybridTime hybrid_time);
+
+}  // namespace docdb
+}  // namespace yb
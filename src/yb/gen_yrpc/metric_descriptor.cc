@@ -129,7 +129,13 @@ void GenerateMethodAssignments(
       printer(
           "    METRIC_$metric_prefix$$metric_name$_$rpc_full_name_plainchars$.Instantiate(entity)");
     }
-    printer((service_side ? ")" : std::string()) + "\n};\n\n");
+    if (service_side) {
+      printer(
+          ",\n"
+          "      ::yb::rpc::InboundCallPhaseMetrics::Create(\n"
+          "          entity, \"$rpc_full_name_plainchars$\"))");
+    }
+    printer("\n};\n\n");
   }
 }
 
@@ -136,6 +136,8 @@ Substitutions CreateSubstitutions(
     request_type = MakeLightweightName(request_type);
     response_type = MakeLightweightName(response_type);
     result.emplace_back("params", "RpcCallLWParams");
+  } else if (IsProtobufArenaMethod(method)) {
+    result.emplace_back("params", "RpcCallPBArenaParams");
   } else {
     result.emplace_back("params", "RpcCallPBParams");
   }
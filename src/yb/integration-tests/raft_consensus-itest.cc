@@ -110,8 +110,11 @@ DECLARE_int32(leader_lease_duration_ms);
 DECLARE_int32(ht_lease_duration_ms);
 DECLARE_int32(rpc_timeout);
 
+METRIC_DECLARE_entity(server);
 METRIC_DECLARE_entity(tablet);
 METRIC_DECLARE_counter(not_leader_rejections);
+METRIC_DECLARE_histogram(handler_latency_yb_consensus_ConsensusService_UpdateConsensus);
+METRIC_DECLARE_histogram(handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus);
 METRIC_DECLARE_gauge_int64(raft_term);
 METRIC_DECLARE_counter(log_cache_disk_reads);
 METRIC_DECLARE_gauge_int64(log_cache_num_ops);
@@ -537,6 +540,36 @@ TEST_F(RaftConsensusITest, TestInsertAndMutateThroughConsensus) {
   ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread * num_iters);
 }
 
+// Same as above, but ops are replicated through the multi-Raft batcher.
+TEST_F(RaftConsensusITest, TestInsertThroughBatchedConsensus) {
+  ASSERT_NO_FATALS(BuildAndStart({
+      "--enable_multi_raft_update_batching=true"s,
+      "--enable_multi_raft_heartbeat_batcher=true"s,
+  }));
+
+  ASSERT_NO_FATALS(InsertTestRowsRemoteThread(
+      0, FLAGS_client_inserts_per_thread, FLAGS_client_num_batches_per_thread,
+      vector<CountDownLatch*>()));
+  ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread);
+
+  // All updates, including the ones carrying ops, should be sent through the batcher.
+  int64_t update_calls = 0;
+  int64_t batched_update_calls = 0;
+  for (size_t i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    auto* ts = cluster_->tablet_server(i);
+    update_calls += ASSERT_RESULT(ts->GetMetric<int64>(
+        &METRIC_ENTITY_server, "yb.tabletserver",
+        &METRIC_handler_latency_yb_consensus_ConsensusService_UpdateConsensus, "total_count"));
+    batched_update_calls += ASSERT_RESULT(ts->GetMetric<int64>(
+        &METRIC_ENTITY_server, "yb.tabletserver",
+        &METRIC_handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus,
+        "total_count"));
+  }
+  LOG(INFO) << "Update calls: " << update_calls << ", batched: " << batched_update_calls;
+  ASSERT_EQ(update_calls, 0);
+  ASSERT_GT(batched_update_calls, 0);
+}
+
 TEST_F(RaftConsensusITest, TestFailedOperation) {
   ASSERT_NO_FATALS(BuildAndStart(vector<string>()));
 
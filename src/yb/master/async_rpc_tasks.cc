@@ -1457,10 +1457,12 @@ bool ShouldRetrySplitTabletRPC(const Status& s) {
 // ============================================================================
 AsyncGetTabletSplitKey::AsyncGetTabletSplitKey(
     Master* master, ThreadPool* callback_pool, const scoped_refptr<TabletInfo>& tablet,
-    const ManualSplit is_manual_split, DataCallbackType result_cb)
+    const ManualSplit is_manual_split, const SplitByKeyAccess split_by_key_access,
+    DataCallbackType result_cb)
     : AsyncTabletLeaderTask(master, callback_pool, tablet), result_cb_(result_cb) {
   req_.set_tablet_id(tablet_id());
   req_.set_is_manual_split(is_manual_split);
+  req_.set_split_by_key_access(split_by_key_access);
 }
 
 void AsyncGetTabletSplitKey::HandleResponse(int attempt) {
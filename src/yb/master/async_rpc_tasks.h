@@ -736,7 +736,8 @@ class AsyncGetTabletSplitKey : public AsyncTabletLeaderTask {
 
   AsyncGetTabletSplitKey(
       Master* master, ThreadPool* callback_pool, const scoped_refptr<TabletInfo>& tablet,
-      ManualSplit is_manual_split, DataCallbackType result_cb);
+      ManualSplit is_manual_split, SplitByKeyAccess split_by_key_access,
+      DataCallbackType result_cb);
 
   server::MonitoredTaskType type() const override {
     return server::MonitoredTaskType::kGetTabletSplitKey;
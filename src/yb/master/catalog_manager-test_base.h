@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include <gtest/gtest.h>
 
 #include "yb/gutil/casts.h"
@@ -324,6 +326,9 @@ class TestLoadBalancerBase {
     gflags::SetCommandLineOption("leader_balance_threshold", "0");
     PrepareTestState(ts_descs_multi_az);
     TestLeaderBlacklist();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingMeasuredLoad();
   }
 
  protected:
@@ -949,6 +954,53 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
   }
 
+  void TestBalancingMeasuredLoad() {
+    LOG(INFO) << "Testing balancing of measured load";
+    auto* options = cb_->state_->options_;
+    options->kAllowMeasuredLoadBalancing = true;
+    options->kMinMeasuredLoadImbalanceRatio = 0.2;
+    options->kMinMeasuredLoadToBalance = 100;
+    options->kMeasuredLoadMoveCooldown = MonoDelta::kZero;
+
+    // Leaders of tablets 0 and 3 are on ts0, tablet 1 on ts1 and tablet 2 on ts2. First tablets 0
+    // and 3 are hot, so ts0 serves most of the load. Then the load moves to tablet 1.
+    const LoadTraceStep kHotTablets0And3 = {{1000, 100}, {100, 10}, {100, 10}, {1000, 100}};
+    const LoadTraceStep kHotTablet1 = {{100, 10}, {1000, 100}, {100, 10}, {100, 10}};
+    auto results = ASSERT_RESULT(ReplayLoadTrace({kHotTablets0And3, kHotTablet1}));
+    ASSERT_EQ(results.size(), 2);
+
+    // Leader of one hot tablet should be moved off ts0. The best possible placement has hot leaders
+    // on two TS and cold leaders on the third one, i.e. 1120, 1120 and 400 ops/s.
+    ASSERT_DOUBLE_EQ(results[0].initial_spread, 1710);
+    ASSERT_DOUBLE_EQ(results[0].final_spread, 720);
+    ASSERT_GT(results[0].num_moves, 0);
+
+    // Leader of the hot tablet 1 cannot be moved without making things worse, but a cold leader
+    // could be moved off the same TS.
+    ASSERT_LT(results[1].final_spread, results[1].initial_spread);
+
+
+    // Nothing is moved when the load is even.
+    const LoadTraceStep kEvenLoad = {{100, 10}, {100, 10}, {100, 10}, {100, 10}};
+    results = ASSERT_RESULT(ReplayLoadTrace({kEvenLoad}));
+    ASSERT_EQ(results[0].num_moves, 0);
+
+    // A tablet moved by measured load balancing is not moved again during the cooldown, even
+    // though the load keeps shifting between tablets.
+    options->kMeasuredLoadMoveCooldown = MonoDelta::FromSeconds(3600);
+    results = ASSERT_RESULT(ReplayLoadTrace(
+        {kHotTablets0And3, kHotTablet1, kHotTablets0And3, kHotTablet1}));
+    std::unordered_set<TabletId> moved_tablets;
+    for (const auto& result : results) {
+      for (const auto& tablet_id : result.moved_tablets) {
+        ASSERT_TRUE(moved_tablets.insert(tablet_id).second) << "Tablet moved twice: " << tablet_id;
+      }
+    }
+    ASSERT_FALSE(moved_tablets.empty());
+
+    options->kAllowMeasuredLoadBalancing = false;
+  }
+
   void TestBalancingLeadersWithThreshold() {
     LOG(INFO) << "Testing moving overloaded leaders with threshold = 2";
     // Move all leaders to ts0.
@@ -1184,6 +1236,102 @@ class TestLoadBalancerBase {
     tablet->SetReplicaLocations(replicas);
   }
 
+  // Load of a tablet in a recorded load trace. The load follows the leadership, so when the load
+  // balancer moves the leader, the new leader starts to serve leader_ops_per_sec.
+  struct TabletLoad {
+    double leader_ops_per_sec = 0;
+    double follower_ops_per_sec = 0;
+  };
+
+  // Load of each tablet from tablets_, in the same order, at some point of time.
+  using LoadTraceStep = std::vector<TabletLoad>;
+
+  struct LoadTraceStepResult {
+    // Difference between measured load of the most and the least loaded tablet servers, before
+    // and after the load balancer moves.
+    double initial_spread = 0;
+    double final_spread = 0;
+    size_t num_moves = 0;
+    std::vector<TabletId> moved_tablets;
+  };
+
+  // Replays a recorded load trace against the mocked load balancer. For every step the replicas
+  // report the recorded load, then the load balancer runs and the moves it picks are applied to
+  // the tablets, until it does not find anything else to move.
+  Result<std::vector<LoadTraceStepResult>> ReplayLoadTrace(
+      const std::vector<LoadTraceStep>& trace) NO_THREAD_SAFETY_ANALYSIS {
+    const size_t kMaxRunsPerStep = 20;
+    std::vector<LoadTraceStepResult> results;
+    for (const auto& step : trace) {
+      LoadTraceStepResult result;
+      ReportLoad(step);
+      result.initial_spread = VERIFY_RESULT(MeasuredLoadSpread());
+      for (;;) {
+        if (result.num_moves > kMaxRunsPerStep) {
+          return STATUS_FORMAT(IllegalState, "Load balancer did not settle after $0 moves",
+                               result.num_moves);
+        }
+        ResetState();
+        RETURN_NOT_OK(AnalyzeTablets());
+        TabletId tablet_id;
+        TabletServerId from_ts, to_ts;
+        if (VERIFY_RESULT(HandleAddReplicas(&tablet_id, &from_ts, &to_ts))) {
+          auto* tablet = tablet_map_[tablet_id].get();
+          AddRunningReplica(tablet, VERIFY_RESULT(FindTS(to_ts)));
+          if (!from_ts.empty()) {
+            RemoveReplica(tablet, VERIFY_RESULT(FindTS(from_ts)));
+          }
+        } else if (VERIFY_RESULT(HandleLeaderMoves(&tablet_id, &from_ts, &to_ts))) {
+          MoveTabletLeader(tablet_map_[tablet_id].get(), VERIFY_RESULT(FindTS(to_ts)));
+        } else {
+          break;
+        }
+        ++result.num_moves;
+        result.moved_tablets.push_back(tablet_id);
+        ReportLoad(step);
+      }
+      result.final_spread = VERIFY_RESULT(MeasuredLoadSpread());
+      LOG(INFO) << "Measured load spread " << result.initial_spread << " -> "
+                << result.final_spread << " after " << result.num_moves << " moves";
+      results.push_back(result);
+    }
+    return results;
+  }
+
+  void ReportLoad(const LoadTraceStep& step) {
+    for (size_t i = 0; i < tablets_.size() && i < step.size(); ++i) {
+      std::shared_ptr<TabletReplicaMap> replicas =
+        std::const_pointer_cast<TabletReplicaMap>(tablets_[i]->GetReplicaLocations());
+      for (auto& replica : *replicas) {
+        replica.second.drive_info.read_ops_per_sec = replica.second.role == PeerRole::LEADER
+            ? step[i].leader_ops_per_sec : step[i].follower_ops_per_sec;
+      }
+      tablets_[i]->SetReplicaLocations(replicas);
+    }
+  }
+
+  Result<double> MeasuredLoadSpread() NO_THREAD_SAFETY_ANALYSIS {
+    ResetState();
+    RETURN_NOT_OK(AnalyzeTablets());
+    auto min_load = std::numeric_limits<double>::max();
+    auto max_load = std::numeric_limits<double>::lowest();
+    for (const auto& ts_desc : ts_descs_) {
+      auto load = cb_->global_state_->GetMeasuredLoad(ts_desc->permanent_uuid());
+      min_load = std::min(min_load, load);
+      max_load = std::max(max_load, load);
+    }
+    return max_load - min_load;
+  }
+
+  Result<std::shared_ptr<TSDescriptor>> FindTS(const TabletServerId& ts_uuid) {
+    for (const auto& ts_desc : ts_descs_) {
+      if (ts_desc->permanent_uuid() == ts_uuid) {
+        return ts_desc;
+      }
+    }
+    return STATUS_FORMAT(NotFound, "Unknown tablet server $0", ts_uuid);
+  }
+
   // Clear the tablets_added_ field from the state, used for testing.
   void ClearTabletsAddedForTest() {
     cb_->state_->tablets_added_.clear();
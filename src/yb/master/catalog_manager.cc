@@ -2844,7 +2844,13 @@ Status CatalogManager::DoSplitTablet(
       // the cluster may have changed, putting us in a new split threshold phase, and it may no
       // longer be a valid candidate. This is not an unexpected error, but we should bail out of
       // splitting this tablet regardless.
-      Status status = ShouldSplitValidCandidate(*source_tablet_info, drive_info);
+      Status status = tablet_split_manager_.ValidateLoadSplitCandidate(
+          *source_tablet_info, source_tablet_lock->pb.split_parent_tablet_id(), drive_info);
+      if (status.ok()) {
+        tablet_split_manager_.DisableLoadSplittingForChildrenOf(source_tablet_info->tablet_id());
+      } else {
+        status = ShouldSplitValidCandidate(*source_tablet_info, drive_info);
+      }
       if (!status.ok()) {
         return STATUS_FORMAT(
             InvalidArgument,
@@ -2976,8 +2982,17 @@ Status CatalogManager::SplitTablet(
     const scoped_refptr<TabletInfo>& tablet, const ManualSplit is_manual_split) {
   VLOG(2) << "Scheduling GetSplitKey request to leader tserver for source tablet ID: "
           << tablet->tablet_id();
+  auto split_by_key_access = SplitByKeyAccess::kFalse;
+  if (!is_manual_split) {
+    auto drive_info = tablet->GetLeaderReplicaDriveInfo();
+    if (drive_info.ok()) {
+      const auto parent_id = tablet->LockForRead()->pb.split_parent_tablet_id();
+      split_by_key_access = SplitByKeyAccess(tablet_split_manager_.ValidateLoadSplitCandidate(
+          *tablet, parent_id, *drive_info).ok());
+    }
+  }
   auto call = std::make_shared<AsyncGetTabletSplitKey>(
-      master_, AsyncTaskPool(), tablet, is_manual_split,
+      master_, AsyncTaskPool(), tablet, is_manual_split, split_by_key_access,
       [this, tablet, is_manual_split]
           (const Result<AsyncGetTabletSplitKey::Data>& result) {
         if (result.ok()) {
@@ -12658,7 +12673,9 @@ void CatalogManager::ProcessTabletMetadata(
         storage_metadata.sst_file_size(),
         storage_metadata.wal_file_size(),
         storage_metadata.uncompressed_sst_file_size(),
-        storage_metadata.may_have_orphaned_post_split_data()};
+        storage_metadata.may_have_orphaned_post_split_data(),
+        storage_metadata.read_ops_per_sec(),
+        storage_metadata.write_ops_per_sec()};
   tablet->UpdateReplicaInfo(ts_uuid, drive_info, leader_lease_info);
 }
 
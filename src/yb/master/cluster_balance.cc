@@ -14,6 +14,7 @@
 #include "yb/master/cluster_balance.h"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <utility>
 
@@ -120,6 +121,23 @@ DEFINE_RUNTIME_bool(load_balancer_drive_aware, true,
 DEFINE_RUNTIME_bool(load_balancer_ignore_cloud_info_similarity, false,
     "If true, ignore the similarity between cloud infos when deciding which tablet to move");
 
+DEFINE_RUNTIME_bool(load_balancer_balance_measured_load, false,
+    "Once tablet and leader counts are balanced, move leaders and replicas to even out the load "
+    "of tablet servers, measured as read and write ops per second reported by tablet replicas.");
+
+DEFINE_RUNTIME_double(load_balancer_measured_load_min_imbalance_ratio, 0.2,
+    "Min difference between measured load of two tablet servers, relative to the higher one, to "
+    "move leaders or replicas between them.");
+
+DEFINE_RUNTIME_double(load_balancer_measured_load_min_ops_per_sec, 100,
+    "Tablet servers serving less read and write ops per second are not considered overloaded by "
+    "measured load balancing.");
+
+DEFINE_RUNTIME_int32(load_balancer_measured_load_move_cooldown_secs, 600,
+    "Time after a move of a tablet replica or leader by measured load balancing, during which "
+    "this tablet is not moved by measured load balancing again, so a hot tablet does not bounce "
+    "between tablet servers.");
+
 METRIC_DEFINE_gauge_int64(cluster,
                           is_load_balancing_enabled,
                           "Is Load Balancing Enabled",
@@ -156,6 +174,22 @@ vector<set<TabletId>> GetTabletsOnTSToMove(bool drive_aware,
   return all_tablets;
 }
 
+// Returns tablet servers sorted ascending by measured load.
+vector<TabletServerId> SortByMeasuredLoad(
+    vector<TabletServerId> ts_uuids, const GlobalLoadState& global_state) {
+  std::stable_sort(ts_uuids.begin(), ts_uuids.end(),
+                   [&global_state](const TabletServerId& lhs, const TabletServerId& rhs) {
+                     return global_state.GetMeasuredLoad(lhs) < global_state.GetMeasuredLoad(rhs);
+                   });
+  return ts_uuids;
+}
+
+// Whether the difference between measured load of two tablet servers is worth moving load.
+bool ShouldBalanceMeasuredLoad(double high_load, double low_load, const Options& options) {
+  return high_load >= options.kMinMeasuredLoadToBalance &&
+         high_load - low_load >= high_load * options.kMinMeasuredLoadImbalanceRatio;
+}
+
 // Returns sorted list of pair tablet id and path on to_ts.
 std::vector<std::pair<TabletId, std::string>> GetLeadersOnTSToMove(
     bool drive_aware, const set<TabletId>& leaders, const CBTabletServerMetadata& to_ts_meta) {
@@ -876,8 +910,9 @@ Result<bool> ClusterLoadBalancer::HandleAddReplicas(
     return true;
   }
 
-  // Finally, handle normal load balancing.
-  if (!VERIFY_RESULT(GetLoadToMove(out_tablet_id, out_from_ts, out_to_ts))) {
+  // Finally, handle normal load balancing, and then balancing of the measured load.
+  if (!VERIFY_RESULT(GetLoadToMove(out_tablet_id, out_from_ts, out_to_ts)) &&
+      !VERIFY_RESULT(GetMeasuredLoadToMove(out_tablet_id, out_from_ts, out_to_ts))) {
     VLOG(1) << "Cannot find any more tablets to move, under current constraints.";
     if (VLOG_IS_ON(1)) {
       DumpSortedLoad();
@@ -1016,6 +1051,7 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
     bool found_tablet_to_move = false;
     CatalogManagerUtil::CloudInfoSimilarity chosen_tablet_ci_similarity =
         CatalogManagerUtil::NO_MATCH;
+    double chosen_tablet_measured_load_imbalance = 0;
     for (const TabletId& tablet_id : drive_tablets) {
       const auto& placement_info = GetPlacementByTablet(tablet_id);
       // TODO(#15853): this should be augmented as well to allow dropping by one replica, if still
@@ -1051,13 +1087,21 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
         ci_similarity = CatalogManagerUtil::ComputeCloudInfoSimilarity(leader_ci, to_ts_ci);
       }
 
-      if (found_tablet_to_move && ci_similarity <= chosen_tablet_ci_similarity) {
+      // Among equally similar tablets prefer the one whose move evens out measured load the most.
+      double measured_load_imbalance = state_->options_->kAllowMeasuredLoadBalancing
+          ? MeasuredLoadImbalanceAfterMove(tablet_id, from_ts, to_ts, false /* leader_only */)
+          : 0;
+      if (found_tablet_to_move &&
+          (ci_similarity < chosen_tablet_ci_similarity ||
+           (ci_similarity == chosen_tablet_ci_similarity &&
+            measured_load_imbalance >= chosen_tablet_measured_load_imbalance))) {
         continue;
       }
       // This is the best tablet to move, so far.
       found_tablet_to_move = true;
       *moving_tablet_id = tablet_id;
       chosen_tablet_ci_similarity = ci_similarity;
+      chosen_tablet_measured_load_imbalance = measured_load_imbalance;
     }
 
     // If there is any tablet we can move from this drive, choose it and return.
@@ -1198,9 +1242,20 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
       // Find the leaders on the higher loaded TS that have running peers on the lower loaded TS.
       // If there are, we have a candidate we want, so fill in the output params and return.
       const set<TabletId>& leaders = state_->per_ts_meta_[high_load_uuid].leaders;
-      for (const auto& tablet : GetLeadersOnTSToMove(global_state_->drive_aware_,
-                                                     leaders,
-                                                     state_->per_ts_meta_[low_load_uuid])) {
+      auto leaders_to_move = GetLeadersOnTSToMove(
+          global_state_->drive_aware_, leaders, state_->per_ts_meta_[low_load_uuid]);
+      if (state_->options_->kAllowMeasuredLoadBalancing) {
+        // Prefer the leaders whose move evens out measured load of the tablet servers the most.
+        std::stable_sort(
+            leaders_to_move.begin(), leaders_to_move.end(),
+            [this, &high_load_uuid, &low_load_uuid](const auto& lhs, const auto& rhs) {
+              return MeasuredLoadImbalanceAfterMove(
+                         lhs.first, high_load_uuid, low_load_uuid, true /* leader_only */) <
+                     MeasuredLoadImbalanceAfterMove(
+                         rhs.first, high_load_uuid, low_load_uuid, true /* leader_only */);
+            });
+      }
+      for (const auto& tablet : leaders_to_move) {
         *moving_tablet_id = tablet.first;
         *to_ts_path = tablet.second;
         *from_ts = high_load_uuid;
@@ -1394,15 +1449,207 @@ Result<bool> ClusterLoadBalancer::HandleLeaderMoves(
     RETURN_NOT_OK(MoveLeader(*out_tablet_id, *out_from_ts, *out_to_ts, out_ts_ts_path));
     return true;
   }
+
+  if (VERIFY_RESULT(GetLeaderToMoveByMeasuredLoad(
+          out_tablet_id, out_from_ts, out_to_ts, &out_ts_ts_path))) {
+    RETURN_NOT_OK(MoveLeader(*out_tablet_id, *out_from_ts, *out_to_ts, out_ts_ts_path));
+    return true;
+  }
   return false;
 }
 
+double ClusterLoadBalancer::MeasuredLoadImbalanceAfterMove(
+    const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts,
+    bool leader_only) const {
+  // The new leader takes over the load of the old one, and vice versa. The new replica takes over
+  // the whole load of the moved one.
+  auto shift = state_->GetReplicaMeasuredLoad(tablet_id, from_ts);
+  if (leader_only) {
+    shift -= state_->GetReplicaMeasuredLoad(tablet_id, to_ts);
+  }
+  auto imbalance =
+      global_state_->GetMeasuredLoad(from_ts) - global_state_->GetMeasuredLoad(to_ts);
+  return std::abs(imbalance - 2 * shift);
+}
+
+Result<bool> ClusterLoadBalancer::GetMeasuredLoadToMove(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  const auto& options = *state_->options_;
+  if (!options.kAllowMeasuredLoadBalancing) {
+    return false;
+  }
+
+  // Similar to GetLoadToMove, we iterate from the most loaded and the least loaded TS. Replica
+  // counts are already balanced at this point, so we only allow moves that do not break the
+  // balance, otherwise the next run would just move some replica back.
+  auto sorted_load = SortByMeasuredLoad(state_->sorted_load_, *global_state_);
+  for (auto right = sorted_load.size(); right > 1;) {
+    --right;
+    const TabletServerId& high_load_uuid = sorted_load[right];
+    const auto high_load = global_state_->GetMeasuredLoad(high_load_uuid);
+    for (size_t left = 0; left < right; ++left) {
+      const TabletServerId& low_load_uuid = sorted_load[left];
+      const auto low_load = global_state_->GetMeasuredLoad(low_load_uuid);
+      if (!ShouldBalanceMeasuredLoad(high_load, low_load, options)) {
+        // Any other TS between left and right is even closer to the high loaded one.
+        break;
+      }
+      if (static_cast<double>(state_->GetLoad(low_load_uuid)) + 2 >=
+              state_->GetLoad(high_load_uuid) + options.kMinLoadVarianceToBalance) {
+        continue;
+      }
+
+      auto best_imbalance = high_load - low_load;
+      bool found_tablet_to_move = false;
+      const auto& high_ts_meta = state_->per_ts_meta_[high_load_uuid];
+      for (const TabletId& tablet_id : high_ts_meta.running_tablets) {
+        // Leaders are moved by GetLeaderToMoveByMeasuredLoad, and removal of the leader replica
+        // would require a stepdown anyway.
+        if (high_ts_meta.leaders.count(tablet_id) ||
+            state_->tablets_over_replicated_.count(tablet_id) ||
+            high_ts_meta.disabled_by_ts_tablets.count(tablet_id) ||
+            InMeasuredLoadMoveCooldown(tablet_id)) {
+          continue;
+        }
+        const auto& placement_info = GetPlacementByTablet(tablet_id);
+        if (!VERIFY_RESULT(state_->CanAddTabletToTabletServer(
+                tablet_id, low_load_uuid, &placement_info))) {
+          continue;
+        }
+        // Keep the same distribution across placement blocks, as GetTabletToMove does.
+        if (!placement_info.placement_blocks().empty()) {
+          auto from_ts_block = state_->GetValidPlacement(high_load_uuid, &placement_info);
+          auto to_ts_block = state_->GetValidPlacement(low_load_uuid, &placement_info);
+          if (!from_ts_block.has_value() || !to_ts_block.has_value() ||
+              TSDescriptor::generate_placement_id(*from_ts_block) !=
+                  TSDescriptor::generate_placement_id(*to_ts_block)) {
+            continue;
+          }
+        }
+        auto imbalance = MeasuredLoadImbalanceAfterMove(
+            tablet_id, high_load_uuid, low_load_uuid, false /* leader_only */);
+        if (imbalance < best_imbalance) {
+          best_imbalance = imbalance;
+          *moving_tablet_id = tablet_id;
+          found_tablet_to_move = true;
+        }
+      }
+
+      if (found_tablet_to_move) {
+        *from_ts = high_load_uuid;
+        *to_ts = low_load_uuid;
+        LOG(INFO) << "Moving replica of " << *moving_tablet_id << " to balance measured load: "
+                  << high_load_uuid << " serves " << high_load << " ops/s, " << low_load_uuid
+                  << " serves " << low_load << " ops/s";
+        RETURN_NOT_OK(MoveReplica(*moving_tablet_id, high_load_uuid, low_load_uuid));
+        RecordMeasuredLoadMove(*moving_tablet_id);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+Result<bool> ClusterLoadBalancer::GetLeaderToMoveByMeasuredLoad(
+    TabletId* moving_tablet_id,
+    TabletServerId* from_ts,
+    TabletServerId* to_ts,
+    std::string* to_ts_path) {
+  const auto& options = *state_->options_;
+  if (!options.kAllowMeasuredLoadBalancing) {
+    return false;
+  }
+
+  // Leaders are only moved within the same affinitized priority, and only if the leader counts
+  // stay balanced, so neither of the leader balancing steps above would undo the move.
+  for (const auto& leader_set : state_->sorted_leader_load_) {
+    vector<TabletServerId> candidates;
+    for (const auto& ts_uuid : leader_set) {
+      if (!global_state_->leader_blacklisted_servers_.count(ts_uuid)) {
+        candidates.push_back(ts_uuid);
+      }
+    }
+    auto sorted_load = SortByMeasuredLoad(std::move(candidates), *global_state_);
+    for (auto right = sorted_load.size(); right > 1;) {
+      --right;
+      const TabletServerId& high_load_uuid = sorted_load[right];
+      const auto high_load = global_state_->GetMeasuredLoad(high_load_uuid);
+      for (size_t left = 0; left < right; ++left) {
+        const TabletServerId& low_load_uuid = sorted_load[left];
+        const auto low_load = global_state_->GetMeasuredLoad(low_load_uuid);
+        if (!ShouldBalanceMeasuredLoad(high_load, low_load, options)) {
+          break;
+        }
+        if (static_cast<double>(state_->GetLeaderLoad(low_load_uuid)) + 2 >=
+                state_->GetLeaderLoad(high_load_uuid) + options.kMinLeaderLoadVarianceToBalance) {
+          continue;
+        }
+
+        auto best_imbalance = high_load - low_load;
+        bool found_leader_to_move = false;
+        for (const auto& tablet : GetLeadersOnTSToMove(
+                 global_state_->drive_aware_, state_->per_ts_meta_[high_load_uuid].leaders,
+                 state_->per_ts_meta_[low_load_uuid])) {
+          // Do not retry a recently failed stepdown to the same TS.
+          if (state_->per_tablet_meta_[tablet.first].leader_stepdown_failures.count(
+                  low_load_uuid) ||
+              InMeasuredLoadMoveCooldown(tablet.first)) {
+            continue;
+          }
+          auto imbalance = MeasuredLoadImbalanceAfterMove(
+              tablet.first, high_load_uuid, low_load_uuid, true /* leader_only */);
+          if (imbalance < best_imbalance) {
+            best_imbalance = imbalance;
+            *moving_tablet_id = tablet.first;
+            *to_ts_path = tablet.second;
+            found_leader_to_move = true;
+          }
+        }
+
+        if (found_leader_to_move) {
+          *from_ts = high_load_uuid;
+          *to_ts = low_load_uuid;
+          LOG(INFO) << "Moving leader of " << *moving_tablet_id << " to balance measured load: "
+                    << high_load_uuid << " serves " << high_load << " ops/s, " << low_load_uuid
+                    << " serves " << low_load << " ops/s";
+          RecordMeasuredLoadMove(*moving_tablet_id);
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+bool ClusterLoadBalancer::InMeasuredLoadMoveCooldown(const TabletId& tablet_id) const {
+  auto it = measured_load_moves_.find(tablet_id);
+  return it != measured_load_moves_.end() &&
+         MonoTime::Now() < it->second + state_->options_->kMeasuredLoadMoveCooldown;
+}
+
+void ClusterLoadBalancer::RecordMeasuredLoadMove(const TabletId& tablet_id) {
+  const auto now = MonoTime::Now();
+  const auto cooldown = state_->options_->kMeasuredLoadMoveCooldown;
+  // Forget moves that are past the cooldown, so the map does not grow with the number of tablets.
+  for (auto it = measured_load_moves_.begin(); it != measured_load_moves_.end();) {
+    if (now >= it->second + cooldown) {
+      it = measured_load_moves_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  measured_load_moves_[tablet_id] = now;
+}
+
 Status ClusterLoadBalancer::MoveReplica(
     const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts) {
   LOG(INFO) << Substitute("Moving replica $0 from $1 to $2", tablet_id, from_ts, to_ts);
   RETURN_NOT_OK(SendReplicaChanges(GetTabletMap().at(tablet_id), to_ts, true /* is_add */,
                                    true /* should_remove_leader */));
   RETURN_NOT_OK(state_->AddReplica(tablet_id, to_ts));
+  state_->MoveReplicaMeasuredLoad(tablet_id, from_ts, to_ts);
   return GetAtomicFlag(&FLAGS_load_balancer_count_move_as_add) ?
       Status::OK() : state_->RemoveReplica(tablet_id, from_ts);
 }
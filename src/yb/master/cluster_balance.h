@@ -286,6 +286,37 @@ class ClusterLoadBalancer {
       const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id)
       REQUIRES_SHARED(catalog_manager_->mutex_);
 
+  // Go through tablet servers sorted by measured load and figure out which tablet replica to move
+  // from a highly loaded TS to a lightly loaded one, so their measured load gets closer.
+  // Called once the replica counts are balanced.
+  //
+  // Returns true if we could find a tablet to rebalance and sets the three output parameters.
+  // Returns false otherwise.
+  Result<bool> GetMeasuredLoadToMove(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts)
+      REQUIRES_SHARED(catalog_manager_->mutex_);
+
+  // Same as GetMeasuredLoadToMove, but moves a tablet leader within a single affinitized priority.
+  // Called once the leader counts are balanced.
+  Result<bool> GetLeaderToMoveByMeasuredLoad(
+      TabletId* moving_tablet_id,
+      TabletServerId* from_ts,
+      TabletServerId* to_ts,
+      std::string* to_ts_path);
+
+  // Returns the difference between measured load of from_ts and to_ts that would remain after
+  // moving the tablet replica, or only its leadership if leader_only is set, from from_ts to
+  // to_ts. The lower is the better.
+  double MeasuredLoadImbalanceAfterMove(
+      const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts,
+      bool leader_only) const;
+
+  // Whether the tablet was moved by measured load balancing less than kMeasuredLoadMoveCooldown
+  // ago, so it should not be moved by measured load balancing again.
+  bool InMeasuredLoadMoveCooldown(const TabletId& tablet_id) const;
+
+  void RecordMeasuredLoadMove(const TabletId& tablet_id);
+
   // Issue the change config and modify the in-memory state for moving a replica from one tablet
   // server to another.
   Status MoveReplica(
@@ -439,6 +470,9 @@ class ClusterLoadBalancer {
 
   std::atomic<MonoTime> last_load_balance_run_;
 
+  // Time of the last move by measured load balancing for tablets that are in the cooldown.
+  std::unordered_map<TabletId, MonoTime> measured_load_moves_;
+
   DISALLOW_COPY_AND_ASSIGN(ClusterLoadBalancer);
 };
 
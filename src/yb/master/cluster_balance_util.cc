@@ -65,6 +65,11 @@ int GlobalLoadState::GetGlobalLeaderLoad(const TabletServerId& ts_uuid) const {
   return ts_meta.leaders_count;
 }
 
+double GlobalLoadState::GetMeasuredLoad(const TabletServerId& ts_uuid) const {
+  const auto& ts_meta = per_ts_global_meta_.at(ts_uuid);
+  return ts_meta.measured_load;
+}
+
 PerTableLoadState::PerTableLoadState(GlobalLoadState* global_state)
     : leader_balance_threshold_(FLAGS_leader_balance_threshold),
       current_time_(MonoTime::Now()),
@@ -122,6 +127,29 @@ size_t PerTableLoadState::GetLeaderLoad(const TabletServerId& ts_uuid) const {
   return per_ts_meta_.at(ts_uuid).leaders.size();
 }
 
+double PerTableLoadState::GetReplicaMeasuredLoad(
+    const TabletId& tablet_id, const TabletServerId& ts_uuid) const {
+  auto it = per_tablet_meta_.find(tablet_id);
+  if (it == per_tablet_meta_.end()) {
+    return 0;
+  }
+  return FindWithDefault(it->second.replica_measured_load, ts_uuid, 0.0);
+}
+
+void PerTableLoadState::MoveReplicaMeasuredLoad(
+    const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts) {
+  auto& replica_measured_load = per_tablet_meta_[tablet_id].replica_measured_load;
+  auto it = replica_measured_load.find(from_ts);
+  if (it == replica_measured_load.end()) {
+    return;
+  }
+  auto load = it->second;
+  replica_measured_load.erase(it);
+  replica_measured_load[to_ts] += load;
+  global_state_->per_ts_global_meta_[from_ts].measured_load -= load;
+  global_state_->per_ts_global_meta_[to_ts].measured_load += load;
+}
+
 bool PerTableLoadState::ShouldSkipReplica(const TabletReplica& replica) {
   bool is_replica_live = IsTsInLivePlacement(replica.ts_desc);
   // Ignore read replica when balancing live nodes.
@@ -228,6 +256,10 @@ Status PerTableLoadState::UpdateTablet(TabletInfo *tablet) {
     // 'RUNNING' state to maintain the existing behavior.
     if (tablet_state == tablet::UNKNOWN || tablet_state == tablet::RUNNING) {
       RETURN_NOT_OK(AddRunningTablet(tablet_id, ts_uuid, replica.fs_data_dir));
+      auto measured_load =
+          replica.drive_info.read_ops_per_sec + replica.drive_info.write_ops_per_sec;
+      tablet_meta.replica_measured_load[ts_uuid] = measured_load;
+      global_state_->per_ts_global_meta_[ts_uuid].measured_load += measured_load;
     } else if (!replica_is_stale &&
                 (tablet_state == tablet::BOOTSTRAPPING || tablet_state == tablet::NOT_STARTED)) {
       // Keep track of transitioning state (not running, but not in a stopped or failed state).
@@ -640,6 +672,12 @@ Status PerTableLoadState::MoveLeader(const TabletId& tablet_id,
   RETURN_NOT_OK(RemoveLeaderTablet(tablet_id, from_ts));
   if (!to_ts.empty()) {
     RETURN_NOT_OK(AddLeaderTablet(tablet_id, to_ts, to_ts_path));
+    // The new leader takes over the load served by the old one, and vice versa.
+    auto& replica_measured_load = per_tablet_meta_[tablet_id].replica_measured_load;
+    auto shift = replica_measured_load[from_ts] - replica_measured_load[to_ts];
+    std::swap(replica_measured_load[from_ts], replica_measured_load[to_ts]);
+    global_state_->per_ts_global_meta_[from_ts].measured_load -= shift;
+    global_state_->per_ts_global_meta_[to_ts].measured_load += shift;
   }
   SortLeaderLoad();
   return Status::OK();
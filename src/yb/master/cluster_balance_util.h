@@ -41,6 +41,14 @@ DECLARE_int32(load_balancer_max_concurrent_moves);
 
 DECLARE_int32(load_balancer_max_concurrent_moves_per_table);
 
+DECLARE_bool(load_balancer_balance_measured_load);
+
+DECLARE_double(load_balancer_measured_load_min_imbalance_ratio);
+
+DECLARE_double(load_balancer_measured_load_min_ops_per_sec);
+
+DECLARE_int32(load_balancer_measured_load_move_cooldown_secs);
+
 namespace yb {
 namespace master {
 
@@ -107,6 +115,10 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Map from tablet server id to the load, in read and write ops per second, that the running
+  // replica on this tablet server reported in its last heartbeat.
+  std::unordered_map<TabletServerId, double> replica_measured_load;
+
   std::string ToString() const;
 };
 
@@ -153,6 +165,8 @@ struct CBTabletServerLoadCounts {
   int running_tablets_count = 0;
   int starting_tablets_count = 0;
   int leaders_count = 0;
+  // Sum of measured load of the running replicas, in read and write ops per second.
+  double measured_load = 0;
 };
 
 struct Options {
@@ -202,6 +216,21 @@ struct Options {
   // Max number of tablet leaders per table to move in any one run of the load balancer.
   int kMaxConcurrentLeaderMovesPerTable = FLAGS_load_balancer_max_concurrent_moves_per_table;
 
+  // Whether to move leaders and replicas to even out the measured load of the tablet servers, once
+  // tablet and leader counts are balanced.
+  bool kAllowMeasuredLoadBalancing = FLAGS_load_balancer_balance_measured_load;
+
+  // If the difference between measured load of two TS, relative to the higher one, goes past this
+  // number, we should try to balance.
+  double kMinMeasuredLoadImbalanceRatio = FLAGS_load_balancer_measured_load_min_imbalance_ratio;
+
+  // TS with measured load below this number are not considered overloaded.
+  double kMinMeasuredLoadToBalance = FLAGS_load_balancer_measured_load_min_ops_per_sec;
+
+  // Time during which a tablet moved by measured load balancing is not moved by it again.
+  MonoDelta kMeasuredLoadMoveCooldown =
+      MonoDelta::FromSeconds(FLAGS_load_balancer_measured_load_move_cooldown_secs);
+
   // Either a live replica or a read.
   ReplicaType type;
 
@@ -222,6 +251,9 @@ class GlobalLoadState {
   // Get global leader load for a certain TS.
   int GetGlobalLeaderLoad(const TabletServerId& ts_uuid) const;
 
+  // Get measured load, in read and write ops per second, for a certain TS.
+  double GetMeasuredLoad(const TabletServerId& ts_uuid) const;
+
   // Used to determine how many tablets are being remote bootstrapped across the cluster.
   int total_starting_tablets_ = 0;
 
@@ -286,6 +318,14 @@ class PerTableLoadState {
   // Get the load for a certain TS.
   size_t GetLeaderLoad(const TabletServerId& ts_uuid) const;
 
+  // Get the measured load of the tablet replica on a certain TS.
+  double GetReplicaMeasuredLoad(const TabletId& tablet_id, const TabletServerId& ts_uuid) const;
+
+  // Move the measured load of the tablet replica from one TS to another, to account for the replica
+  // move until the next heartbeats report the actual load.
+  void MoveReplicaMeasuredLoad(
+      const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts);
+
   bool IsTsInLivePlacement(TSDescriptor* ts_desc) {
     return ts_desc->placement_uuid() == options_->live_placement_uuid;
   }
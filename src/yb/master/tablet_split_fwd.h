@@ -26,6 +26,7 @@ class TabletSplitManager;
 struct SplitTabletIds;
 
 YB_STRONGLY_TYPED_BOOL(ManualSplit);
+YB_STRONGLY_TYPED_BOOL(SplitByKeyAccess);
 
 } // namespace master
 } // namespace yb
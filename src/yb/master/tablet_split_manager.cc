@@ -37,6 +37,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/result.h"
 #include "yb/util/scope_exit.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/unique_lock.h"
 
 using std::vector;
@@ -77,6 +78,22 @@ DEFINE_RUNTIME_uint64(prevent_split_for_small_key_range_tablets_for_seconds, 300
               "Seconds between checks for whether to split a tablet whose key range is too small "
               "to be split. Checks are disabled if this value is set to 0.");
 
+DEFINE_RUNTIME_bool(enable_load_based_tablet_splitting, false,
+    "When set, tablets serving at least tablet_split_load_ops_per_sec_threshold operations per "
+    "second are automatically split regardless of their size, at the median of recently "
+    "accessed keys.");
+
+DEFINE_RUNTIME_uint64(tablet_split_load_ops_per_sec_threshold, 10000,
+    "Sum of read and write operations per second served by the tablet leader at which the tablet "
+    "is split by load. See enable_load_based_tablet_splitting.");
+
+DEFINE_RUNTIME_uint64(tablet_split_load_min_size_bytes, 1_MB,
+    "Tablets with SST size below this value are not split by load.");
+
+DEFINE_RUNTIME_uint64(prevent_load_split_for_seconds, 600,
+    "Seconds after a load based split during which children of the split tablet are not split "
+    "by load. Cooldown is disabled if this value is set to 0.");
+
 DEFINE_RUNTIME_bool(sort_automatic_tablet_splitting_candidates, true,
             "Whether we should sort candidates for new automatic tablet splits, so the largest "
             "candidates are picked first.");
@@ -372,6 +389,45 @@ void TabletSplitManager::DisableSplittingForSmallKeyRangeTablet(const TabletId&
   }
 }
 
+Status TabletSplitManager::ValidateLoadSplitCandidate(
+    const TabletInfo& tablet, const TabletId& parent_id,
+    const TabletReplicaDriveInfo& drive_info) {
+  if (!FLAGS_enable_load_based_tablet_splitting) {
+    return STATUS(IllegalState, "Load based tablet splitting is disabled");
+  }
+  if (drive_info.may_have_orphaned_post_split_data) {
+    return STATUS_FORMAT(IllegalState, "Tablet $0 may have uncompacted post-split data.",
+        tablet.id());
+  }
+  const auto ops_per_sec = drive_info.read_ops_per_sec + drive_info.write_ops_per_sec;
+  if (ops_per_sec < FLAGS_tablet_split_load_ops_per_sec_threshold) {
+    return STATUS_FORMAT(IllegalState,
+        "Tablet $0 ops per second ($1) < tablet_split_load_ops_per_sec_threshold ($2).",
+        tablet.id(), ops_per_sec, FLAGS_tablet_split_load_ops_per_sec_threshold);
+  }
+  if (drive_info.sst_files_size < FLAGS_tablet_split_load_min_size_bytes) {
+    return STATUS_FORMAT(IllegalState,
+        "Tablet $0 SST size ($1) < tablet_split_load_min_size_bytes ($2).",
+        tablet.id(), drive_info.sst_files_size, FLAGS_tablet_split_load_min_size_bytes);
+  }
+  if (!parent_id.empty()) {
+    UniqueLock<decltype(disabled_sets_mutex_)> lock(disabled_sets_mutex_);
+    RETURN_NOT_OK(ValidateAgainstDisabledList(
+        parent_id, &disable_load_splitting_for_children_until_));
+  }
+  return Status::OK();
+}
+
+void TabletSplitManager::DisableLoadSplittingForChildrenOf(const TabletId& parent_id) {
+  if (FLAGS_prevent_load_split_for_seconds != 0) {
+    VLOG(1) << "Disabling load based splitting for children of tablet " << parent_id;
+    const auto recheck_at = CoarseMonoClock::Now()
+        + MonoDelta::FromSeconds(FLAGS_prevent_load_split_for_seconds);
+    UniqueLock<decltype(disabled_sets_mutex_)> lock(disabled_sets_mutex_);
+    disable_load_splitting_for_children_until_[parent_id] = recheck_at;
+  }
+}
+
 Status AllReplicasHaveFinishedCompaction(const TabletReplicaMap& replicas) {
   for (const auto& replica : replicas) {
     if (replica.second.drive_info.may_have_orphaned_post_split_data) {
@@ -738,7 +794,9 @@ void TabletSplitManager::DoSplitting(
           parent = FindPtrOrNull(tablet_info_map, parent_id);
         }
         RETURN_NOT_OK(ValidateSplitCandidateTablet(*tablet, parent));
-        RETURN_NOT_OK(filter_->ShouldSplitValidCandidate(*tablet, drive_info_opt.get()));
+        if (!ValidateLoadSplitCandidate(*tablet, parent_id, drive_info_opt.get()).ok()) {
+          RETURN_NOT_OK(filter_->ShouldSplitValidCandidate(*tablet, drive_info_opt.get()));
+        }
 
         const auto replicas = replica_cache.GetOrAdd(*tablet);
         RETURN_NOT_OK(
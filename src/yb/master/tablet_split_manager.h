@@ -83,6 +83,16 @@ class TabletSplitManager {
   // Disables splitting for tablets that are too small to split.
   void DisableSplittingForSmallKeyRangeTablet(const TabletId& tablet_id);
 
+  // Returns OK if the tablet serves enough operations to be split regardless of its size.
+  // Children of a recent load based split are not considered, to avoid splitting the same hot
+  // key range over and over again.
+  Status ValidateLoadSplitCandidate(
+      const TabletInfo& tablet, const TabletId& parent_id,
+      const TabletReplicaDriveInfo& drive_info);
+
+  // Disables load based splitting for children of the specified tablet.
+  void DisableLoadSplittingForChildrenOf(const TabletId& parent_id);
+
  private:
   void ScheduleSplits(const std::unordered_set<TabletId>& splits_to_schedule);
 
@@ -116,6 +126,9 @@ class TabletSplitManager {
       GUARDED_BY(disabled_sets_mutex_);
   DisabledSet<TabletId> disable_splitting_for_small_key_range_tablet_until_
       GUARDED_BY(disabled_sets_mutex_);
+  // Keyed by the parent tablet id.
+  DisabledSet<TabletId> disable_load_splitting_for_children_until_
+      GUARDED_BY(disabled_sets_mutex_);
 };
 
 }  // namespace master
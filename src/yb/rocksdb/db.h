@@ -383,6 +383,15 @@ class DB {
     //      flushes.
     static const std::string kNumRunningFlushes;
 
+    //  "rocksdb.is-write-stopped" - returns 1 if writes are stopped because of
+    //      too many memtables or level 0 files; otherwise, returns 0.
+    static const std::string kIsWriteStopped;
+
+    //  "rocksdb.actual-delayed-write-rate" - returns the rate, in bytes per
+    //      second, writes are currently delayed to, or 0 if they are not
+    //      delayed.
+    static const std::string kActualDelayedWriteRate;
+
     //  "rocksdb.compaction-pending" - returns 1 if at least one compaction is
     //      pending; otherwise, returns 0.
     static const std::string kCompactionPending;
@@ -522,6 +531,8 @@ class DB {
   //  "rocksdb.estimate-pending-compaction-bytes"
   //  "rocksdb.num-running-compactions"
   //  "rocksdb.num-running-flushes"
+  //  "rocksdb.is-write-stopped"
+  //  "rocksdb.actual-delayed-write-rate"
   virtual bool GetIntProperty(ColumnFamilyHandle* column_family,
                               const Slice& property, uint64_t* value) = 0;
   virtual bool GetIntProperty(const Slice& property, uint64_t* value) {
@@ -874,6 +885,18 @@ class DB {
     return AddFile(DefaultColumnFamily(), file_info, move_file);
   }
 
+  // Reads information about table file located at "file_path", that is required to add it to
+  // "column_family" with AddFile, without adding it.
+  virtual Status GetExternalSstFileInfo(ColumnFamilyHandle* column_family,
+                                        const std::string& file_path,
+                                        ExternalSstFileInfo* file_info) {
+    return STATUS(NotSupported, "");
+  }
+  virtual Status GetExternalSstFileInfo(const std::string& file_path,
+                                        ExternalSstFileInfo* file_info) {
+    return GetExternalSstFileInfo(DefaultColumnFamily(), file_path, file_info);
+  }
+
 
   // Sets the globally unique ID created at database creation time by invoking
   // Env::GenerateUniqueId(), in identity. Returns Status::OK if identity could
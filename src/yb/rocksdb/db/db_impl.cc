@@ -4226,13 +4226,23 @@ std::vector<Status> DBImpl::MultiGet(
 
 Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
                        const std::string& file_path, bool move_file) {
+  ExternalSstFileInfo file_info;
+  Status status = GetExternalSstFileInfo(column_family, file_path, &file_info);
+  if (!status.ok()) {
+    return status;
+  }
+  return AddFile(column_family, &file_info, move_file);
+}
+
+Status DBImpl::GetExternalSstFileInfo(ColumnFamilyHandle* column_family,
+                                      const std::string& file_path,
+                                      ExternalSstFileInfo* file_info) {
   Status status;
   auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family);
   ColumnFamilyData* cfd = cfh->cfd();
 
-  ExternalSstFileInfo file_info;
-  file_info.file_path = file_path;
-  status = env_->GetFileSize(file_path, &file_info.base_file_size);
+  file_info->file_path = file_path;
+  status = env_->GetFileSize(file_path, &file_info->base_file_size);
   if (!status.ok()) {
     return status;
   }
@@ -4251,7 +4261,7 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
   status = cfd->ioptions()->table_factory->NewTableReader(
       TableReaderOptions(*cfd->ioptions(), env_options_,
                          cfd->internal_comparator()),
-      std::move(base_sst_file_reader), file_info.base_file_size,
+      std::move(base_sst_file_reader), file_info->base_file_size,
       &table_reader);
   if (!status.ok()) {
     return status;
@@ -4266,8 +4276,8 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
     return STATUS(InvalidArgument, "Generated table version not found");
   }
 
-  file_info.is_split_sst = table_reader->IsSplitSst();
-  if (file_info.is_split_sst) {
+  file_info->is_split_sst = table_reader->IsSplitSst();
+  if (file_info->is_split_sst) {
     std::unique_ptr<RandomAccessFile> data_sst_file;
     status = env_->NewRandomAccessFile(TableBaseToDataFileName(file_path), &data_sst_file,
         env_options_);
@@ -4279,20 +4289,20 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
     table_reader->SetDataFileReader(std::move(data_sst_file_reader));
   }
 
-  file_info.file_size = file_info.base_file_size +
-      (file_info.is_split_sst ? table_reader->GetTableProperties()->data_size : 0);
+  file_info->file_size = file_info->base_file_size +
+      (file_info->is_split_sst ? table_reader->GetTableProperties()->data_size : 0);
 
-  file_info.version =
+  file_info->version =
       DecodeFixed32(external_sst_file_version_iter->second.c_str());
-  if (file_info.version == 1) {
+  if (file_info->version == 1) {
     // version 1 imply that all sequence numbers in table equal 0
-    file_info.sequence_number = 0;
+    file_info->sequence_number = 0;
   } else {
     return STATUS(InvalidArgument, "Generated table version is not supported");
   }
 
   // Get number of entries in table
-  file_info.num_entries = table_reader->GetTableProperties()->num_entries;
+  file_info->num_entries = table_reader->GetTableProperties()->num_entries;
 
   ParsedInternalKey key;
   std::unique_ptr<InternalIterator> iter(
@@ -4306,7 +4316,7 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
   if (key.sequence != 0) {
     return STATUS(Corruption, "Generated table have non zero sequence number");
   }
-  file_info.smallest_key = key.user_key.ToString();
+  file_info->smallest_key = key.user_key.ToString();
 
   // Get last (largest) key from file
   iter->SeekToLast();
@@ -4316,9 +4326,9 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
   if (key.sequence != 0) {
     return STATUS(Corruption, "Generated table have non zero sequence number");
   }
-  file_info.largest_key = key.user_key.ToString();
+  file_info->largest_key = key.user_key.ToString();
 
-  return AddFile(column_family, &file_info, move_file);
+  return Status::OK();
 }
 
 namespace {
@@ -4382,6 +4392,10 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
     return STATUS(InvalidArgument,
         "Non zero sequence numbers are not supported");
   }
+  if (file_info->frontiers) {
+    meta.smallest.user_frontier = file_info->frontiers->Smallest().Clone();
+    meta.largest.user_frontier = file_info->frontiers->Largest().Clone();
+  }
 
   std::string db_base_fname;
   std::string db_data_fname;
@@ -4425,7 +4439,7 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
             STATUS(NotSupported, "Cannot add a file while holding snapshots");
       }
 
-      if (status.ok()) {
+      if (status.ok() && !file_info->allow_overlap) {
         // Verify that added file key range dont overlap with any keys in DB
         SuperVersion* sv = cfd->GetSuperVersion()->Ref();
         Arena arena;
@@ -4456,6 +4470,9 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
         VersionEdit edit;
         edit.SetColumnFamily(cfd->GetID());
         edit.AddCleanedFile(0, meta);
+        if (file_info->frontiers) {
+          edit.UpdateFlushedFrontier(file_info->frontiers->Largest().Clone());
+        }
 
         status = versions_->LogAndApply(
             cfd, mutable_cf_options, &edit, &mutex_, directories_.GetDbDir());
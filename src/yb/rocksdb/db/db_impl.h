@@ -303,6 +303,11 @@ class DBImpl : public DB {
   virtual Status AddFile(ColumnFamilyHandle* column_family,
                          const std::string& file_path, bool move_file) override;
 
+  using DB::GetExternalSstFileInfo;
+  virtual Status GetExternalSstFileInfo(ColumnFamilyHandle* column_family,
+                                        const std::string& file_path,
+                                        ExternalSstFileInfo* file_info) override;
+
 
   // Similar to GetSnapshot(), but also lets the db know that this snapshot
   // will be used for transaction write-conflict checking.  The DB can then
@@ -462,6 +467,13 @@ class DBImpl : public DB {
     return num_running_flushes_;
   }
 
+  // Returns the controller that stops or delays writes, when flushes or compactions fall behind.
+  // REQUIREMENT: mutex_ must be held when calling this function.
+  const WriteController& write_controller() {
+    mutex_.AssertHeld();
+    return write_controller_;
+  }
+
   // Returns the number of currently running compactions.
   // REQUIREMENT: mutex_ must be held when calling this function.
   int num_running_compactions() {
@@ -163,6 +163,8 @@ static const std::string aggregated_table_properties_at_level =
     aggregated_table_properties + "-at-level";
 static const std::string num_running_compactions = "num-running-compactions";
 static const std::string num_running_flushes = "num-running-flushes";
+static const std::string is_write_stopped = "is-write-stopped";
+static const std::string actual_delayed_write_rate = "actual-delayed-write-rate";
 
 const std::string DB::Properties::kNumFilesAtLevelPrefix =
                       rocksdb_prefix + num_files_at_level_prefix;
@@ -183,6 +185,10 @@ const std::string DB::Properties::kNumRunningCompactions =
     rocksdb_prefix + num_running_compactions;
 const std::string DB::Properties::kNumRunningFlushes =
     rocksdb_prefix + num_running_flushes;
+const std::string DB::Properties::kIsWriteStopped =
+    rocksdb_prefix + is_write_stopped;
+const std::string DB::Properties::kActualDelayedWriteRate =
+    rocksdb_prefix + actual_delayed_write_rate;
 const std::string DB::Properties::kBackgroundErrors =
                       rocksdb_prefix + background_errors;
 const std::string DB::Properties::kCurSizeActiveMemTable =
@@ -290,6 +296,10 @@ const std::unordered_map<std::string,
      {false, nullptr, &InternalStats::HandleNumRunningFlushes}},
     {DB::Properties::kNumRunningCompactions,
      {false, nullptr, &InternalStats::HandleNumRunningCompactions}},
+    {DB::Properties::kIsWriteStopped,
+     {false, nullptr, &InternalStats::HandleIsWriteStopped}},
+    {DB::Properties::kActualDelayedWriteRate,
+     {false, nullptr, &InternalStats::HandleActualDelayedWriteRate}},
 };
 
 const DBPropertyInfo* GetPropertyInfo(const Slice& property) {
@@ -457,6 +467,19 @@ bool InternalStats::HandleNumRunningFlushes(uint64_t* value, DBImpl* db,
   return true;
 }
 
+bool InternalStats::HandleIsWriteStopped(uint64_t* value, DBImpl* db,
+                                         Version* version) {
+  *value = db->write_controller().IsStopped() ? 1 : 0;
+  return true;
+}
+
+bool InternalStats::HandleActualDelayedWriteRate(uint64_t* value, DBImpl* db,
+                                                 Version* version) {
+  const auto& write_controller = db->write_controller();
+  *value = write_controller.NeedsDelay() ? write_controller.delayed_write_rate() : 0;
+  return true;
+}
+
 bool InternalStats::HandleCompactionPending(uint64_t* value, DBImpl* db,
                                             Version* version) {
   // 1 if the system already determines at least one compaction is needed.
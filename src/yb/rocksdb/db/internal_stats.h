@@ -301,6 +301,9 @@ class InternalStats {
   bool HandleMemTableFlushPending(uint64_t* value, DBImpl* db,
                                   Version* version);
   bool HandleNumRunningFlushes(uint64_t* value, DBImpl* db, Version* version);
+  bool HandleIsWriteStopped(uint64_t* value, DBImpl* db, Version* version);
+  bool HandleActualDelayedWriteRate(uint64_t* value, DBImpl* db,
+                                    Version* version);
   bool HandleCompactionPending(uint64_t* value, DBImpl* db, Version* version);
   bool HandleNumRunningCompactions(uint64_t* value, DBImpl* db,
                                    Version* version);
@@ -25,6 +25,7 @@ class DB;
 class Env;
 class MemTable;
 class Iterator;
+class SstFileWriter;
 class Statistics;
 class UserFrontiers;
 class WriteBatch;
@@ -32,6 +33,7 @@ class WriteBatch;
 struct BlockBasedTableOptions;
 struct CompactionContextOptions;
 struct CompactionInputFiles;
+struct ExternalSstFileInfo;
 struct Options;
 struct TableBuilderOptions;
 struct TableProperties;
@@ -20,9 +20,11 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/immutable_options.h"
+#include "yb/rocksdb/rocksdb_fwd.h"
 #include "yb/rocksdb/types.h"
 
 namespace rocksdb {
@@ -64,6 +66,12 @@ struct ExternalSstFileInfo {
   bool is_split_sst;               // is SST split into metadata and data file(s)
   uint64_t num_entries;            // number of entries in file
   int32_t version;                 // file version
+  // If set, the added file gets these frontiers, and the largest one is applied to the flushed
+  // frontier of the DB in the same version edit.
+  const UserFrontiers* frontiers = nullptr;
+  // Skip the check that the key range of the added file does not overlap keys in the DB.
+  // Caller should guarantee that none of the user keys in the file is present in the DB.
+  bool allow_overlap = false;
 };
 
 // SstFileWriter is used to create sst files that can be added to database later
@@ -95,4 +103,15 @@ class SstFileWriter {
   struct Rep;
   Rep* rep_;
 };
+
+// Hard links file created by SstFileWriter, together with its data file, to dest_path. Copies the
+// files when they could not be linked.
+Status LinkExternalSstFile(Env* env, const std::string& source_path, const std::string& dest_path);
+
+// Calls callback for each user key and value of the file created by SstFileWriter, in key order.
+Status ReadExternalSstFile(
+    const EnvOptions& env_options, const ImmutableCFOptions& ioptions,
+    const Comparator* user_comparator, const std::string& file_path,
+    const std::function<Status(const Slice& user_key, const Slice& value)>& callback);
+
 }  // namespace rocksdb
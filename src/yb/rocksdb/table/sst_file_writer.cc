@@ -32,8 +32,11 @@
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/status.h"
+#include "yb/rocksdb/table/internal_iterator.h"
 #include "yb/rocksdb/table/table_builder.h"
+#include "yb/rocksdb/table/table_reader.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
+#include "yb/rocksdb/util/file_util.h"
 #include "yb/util/string_util.h"
 
 namespace rocksdb {
@@ -240,4 +243,64 @@ Status SstFileWriter::Finish(ExternalSstFileInfo* file_info) {
   r->builder.reset();
   return s;
 }
+
+Status ReadExternalSstFile(
+    const EnvOptions& env_options, const ImmutableCFOptions& ioptions,
+    const Comparator* user_comparator, const std::string& file_path,
+    const std::function<Status(const Slice& user_key, const Slice& value)>& callback) {
+  uint64_t base_file_size = 0;
+  RETURN_NOT_OK(ioptions.env->GetFileSize(file_path, &base_file_size));
+  std::unique_ptr<RandomAccessFile> base_sst_file;
+  RETURN_NOT_OK(ioptions.env->NewRandomAccessFile(file_path, &base_sst_file, env_options));
+
+  std::unique_ptr<TableReader> table_reader;
+  RETURN_NOT_OK(ioptions.table_factory->NewTableReader(
+      TableReaderOptions(
+          ioptions, env_options, std::make_shared<InternalKeyComparator>(user_comparator)),
+      std::make_unique<RandomAccessFileReader>(std::move(base_sst_file)), base_file_size,
+      &table_reader));
+  if (table_reader->IsSplitSst()) {
+    std::unique_ptr<RandomAccessFile> data_sst_file;
+    RETURN_NOT_OK(ioptions.env->NewRandomAccessFile(
+        TableBaseToDataFileName(file_path), &data_sst_file, env_options));
+    table_reader->SetDataFileReader(
+        std::make_unique<RandomAccessFileReader>(std::move(data_sst_file)));
+  }
+
+  std::unique_ptr<InternalIterator> iter(table_reader->NewIterator(ReadOptions()));
+  ParsedInternalKey key;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    if (!ParseInternalKey(iter->key(), &key)) {
+      return STATUS(Corruption, "Generated table have corrupted keys");
+    }
+    if (key.sequence != 0) {
+      return STATUS(Corruption, "Generated table have non zero sequence number");
+    }
+    RETURN_NOT_OK(callback(key.user_key, iter->value()));
+  }
+  return iter->status();
+}
+
+Status LinkExternalSstFile(Env* env, const std::string& source_path, const std::string& dest_path) {
+  std::vector<std::pair<std::string, std::string>> files = {{source_path, dest_path}};
+  auto data_file_path = TableBaseToDataFileName(source_path);
+  if (env->FileExists(data_file_path).ok()) {
+    files.emplace_back(data_file_path, TableBaseToDataFileName(dest_path));
+  }
+  for (size_t i = 0; i != files.size(); ++i) {
+    auto status = env->LinkFile(files[i].first, files[i].second);
+    if (status.IsNotSupported()) {
+      // Destination is on a different FS, use copy instead of hard linking.
+      status = CopyFile(env, files[i].first, files[i].second);
+    }
+    if (!status.ok()) {
+      for (size_t j = 0; j != i; ++j) {
+        env->CleanupFile(files[j].second);
+      }
+      return status;
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace rocksdb
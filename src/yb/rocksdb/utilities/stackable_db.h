@@ -92,6 +92,13 @@ class StackableDB : public DB {
     return db_->AddFile(column_family, file_path, move_file);
   }
 
+  using DB::GetExternalSstFileInfo;
+  virtual Status GetExternalSstFileInfo(ColumnFamilyHandle* column_family,
+                                        const std::string& file_path,
+                                        ExternalSstFileInfo* file_info) override {
+    return db_->GetExternalSstFileInfo(column_family, file_path, file_info);
+  }
+
   using DB::KeyMayExist;
   virtual bool KeyMayExist(const ReadOptions& options,
                            ColumnFamilyHandle* column_family, const Slice& key,
@@ -88,10 +88,18 @@ Acceptor::~Acceptor() {
   Shutdown();
 }
 
-Status Acceptor::Listen(const Endpoint& endpoint, Endpoint* bound_endpoint) {
+Status Acceptor::Listen(
+    const Endpoint& endpoint, Endpoint* bound_endpoint, std::optional<size_t> shard) {
   Socket socket;
   RETURN_NOT_OK(socket.Init(endpoint.address().is_v6() ? Socket::FLAG_IPV6 : 0));
   RETURN_NOT_OK(socket.SetReuseAddr(true));
+  if (shard) {
+    RETURN_NOT_OK(socket.SetReusePort(true));
+    auto cpu = ReactorCpu(*shard);
+    if (cpu >= 0) {
+      WARN_NOT_OK(socket.SetIncomingCpu(cpu), "Failed to set incoming cpu");
+    }
+  }
   RETURN_NOT_OK(socket.Bind(endpoint));
   if (bound_endpoint) {
     RETURN_NOT_OK(socket.GetSocketAddress(bound_endpoint));
@@ -106,7 +114,10 @@ Status Acceptor::Listen(const Endpoint& endpoint, Endpoint* bound_endpoint) {
       return STATUS_SUBSTITUTE(ServiceUnavailable, "Acceptor closing");
     }
     was_empty = sockets_to_add_.empty();
-    sockets_to_add_.push_back(std::move(socket));
+    sockets_to_add_.push_back(SocketToAdd {
+      .socket = std::move(socket),
+      .shard = shard,
+    });
   }
 
   if (was_empty) {
@@ -177,7 +188,7 @@ void Acceptor::IoHandler(ev::io& io, int events) {
         continue;
       }
       rpc_connections_accepted_->Increment();
-      handler_(&new_sock, remote);
+      handler_(&new_sock, remote, it->second.shard);
     }
   }
 }
@@ -198,7 +209,7 @@ void Acceptor::AsyncHandler(ev::async& async, int events) {
   }
 
   while (!processing_sockets_to_add_.empty()) {
-    auto& socket = processing_sockets_to_add_.back();
+    auto& socket = processing_sockets_to_add_.back().socket;
     Endpoint endpoint;
     auto status = socket.GetSocketAddress(&endpoint);
     if (!status.ok()) {
@@ -208,7 +219,8 @@ void Acceptor::AsyncHandler(ev::async& async, int events) {
     VLOG(1) << "Adding socket fd " << socket.GetFd() << " at " << endpoint;
     AcceptingSocket ac{ std::unique_ptr<ev::io>(new ev::io),
                         Socket(std::move(socket)),
-                        endpoint };
+                        endpoint,
+                        processing_sockets_to_add_.back().shard };
     processing_sockets_to_add_.pop_back();
     ac.io->set(loop_);
     ac.io->set<Acceptor, &Acceptor::IoHandler>(this);
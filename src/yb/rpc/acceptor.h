@@ -33,6 +33,7 @@
 #pragma once
 
 #include <mutex>
+#include <optional>
 #include <vector>
 #include <unordered_map>
 
@@ -54,8 +55,10 @@ class Thread;
 
 namespace rpc {
 
-// Take ownership of the socket via Socket::Release
-typedef std::function<void(Socket *new_socket, const Endpoint& remote)> NewSocketHandler;
+// Take ownership of the socket via Socket::Release.
+// shard is the reactor index passed to Listen for the socket that accepted the connection.
+typedef std::function<void(
+    Socket *new_socket, const Endpoint& remote, std::optional<size_t> shard)> NewSocketHandler;
 
 // A acceptor that calls accept() to create new connections.
 class Acceptor {
@@ -66,7 +69,11 @@ class Acceptor {
 
   // Setup acceptor to listen address.
   // Return bound address in bound_address.
-  Status Listen(const Endpoint& endpoint, Endpoint* bound_endpoint = nullptr);
+  // When shard is specified, the listening socket is created with SO_REUSEPORT, so several
+  // sockets could be bound to the same endpoint, and the kernel balances connections among them.
+  Status Listen(
+      const Endpoint& endpoint, Endpoint* bound_endpoint = nullptr,
+      std::optional<size_t> shard = std::nullopt);
 
   Status Start();
   void Shutdown();
@@ -80,6 +87,12 @@ class Acceptor {
     std::unique_ptr<ev::io> io;
     Socket socket;
     Endpoint endpoint;
+    std::optional<size_t> shard;
+  };
+
+  struct SocketToAdd {
+    Socket socket;
+    std::optional<size_t> shard;
   };
 
   NewSocketHandler handler_;
@@ -87,8 +100,8 @@ class Acceptor {
   std::mutex mutex_;
   std::unordered_map<ev::io*, AcceptingSocket> sockets_;
 
-  std::vector<Socket> sockets_to_add_;
-  std::vector<Socket> processing_sockets_to_add_;
+  std::vector<SocketToAdd> sockets_to_add_;
+  std::vector<SocketToAdd> processing_sockets_to_add_;
 
   scoped_refptr<Counter> rpc_connections_accepted_;
 
@@ -27,8 +27,12 @@
 #include "yb/rpc/outbound_data.h"
 #include "yb/rpc/refined_stream.h"
 #include "yb/rpc/reactor_thread_role.h"
+#include "yb/rpc/rpc_introspection.pb.h"
 
+#include "yb/util/env.h"
+#include "yb/util/faststring.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/result.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status_format.h"
@@ -37,7 +41,30 @@
 using namespace std::literals;
 
 DEFINE_UNKNOWN_int32(stream_compression_algo, 0, "Algorithm used for stream compression. "
-                                         "0 - no compression, 1 - gzip, 2 - snappy, 3 - lz4.");
+                                         "0 - no compression, 1 - gzip, 2 - snappy, 3 - lz4, "
+                                         "4 - gzip with preset dictionary.");
+
+DEFINE_NON_RUNTIME_string(stream_compression_dictionary_path, "",
+    "Path to the preset dictionary used by the gzip with dictionary stream compression. "
+    "The dictionary should contain byte sequences that are common in RPC traffic, e.g. sampled "
+    "serialized requests, most frequent ones at the end. Only the last 32KB are used. All nodes "
+    "should use the same dictionary.");
+TAG_FLAG(stream_compression_dictionary_path, advanced);
+
+METRIC_DEFINE_simple_counter(
+    server, stream_compression_uncompressed_bytes,
+    "Uncompressed bytes passed through compressed streams, in both directions",
+    yb::MetricUnit::kBytes);
+
+METRIC_DEFINE_simple_counter(
+    server, stream_compression_compressed_bytes,
+    "Compressed bytes passed through compressed streams, in both directions",
+    yb::MetricUnit::kBytes);
+
+METRIC_DEFINE_simple_counter(
+    server, stream_compression_time_us,
+    "Time spent by reactor threads compressing and decompressing stream data",
+    yb::MetricUnit::kMicroseconds);
 
 namespace yb {
 namespace rpc {
@@ -64,8 +91,42 @@ class Compressor {
   virtual OutboundDataPtr ConnectionHeader() = 0;
 
   virtual ~Compressor() = default;
+
+  size_t compressed_bytes_sent() const {
+    return compressed_bytes_sent_;
+  }
+
+ protected:
+  Status SendCompressed(RefinedStream* stream, RefCntBuffer output, OutboundDataPtr data) {
+    compressed_bytes_sent_ += output.size();
+    return stream->SendToLower(std::make_shared<SingleBufferOutboundData>(
+        std::move(output), std::move(data)));
+  }
+
+ private:
+  size_t compressed_bytes_sent_ = 0;
 };
 
+// Dictionary is loaded once, and shared by all connections.
+Result<Slice> CompressionDictionary() {
+  static const Result<std::string> dictionary = []() -> Result<std::string> {
+    if (FLAGS_stream_compression_dictionary_path.empty()) {
+      return STATUS(InvalidArgument, "stream_compression_dictionary_path is not specified");
+    }
+    faststring data;
+    RETURN_NOT_OK(ReadFileToString(
+        Env::Default(), FLAGS_stream_compression_dictionary_path, &data));
+    if (data.size() == 0) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Compression dictionary $0 is empty",
+          FLAGS_stream_compression_dictionary_path);
+    }
+    return data.ToString();
+  }();
+  RETURN_NOT_OK(dictionary);
+  return Slice(*dictionary);
+}
+
 size_t EntrySize(const RefCntSlice& buffer) {
   return buffer.size();
 }
@@ -164,6 +225,16 @@ class ZlibCompressor : public Compressor {
     }
     deflate_inited_ = true;
 
+    if (!dictionary_.empty()) {
+      res = deflateSetDictionary(
+          &deflate_stream_, dictionary_.data(), narrow_cast<uInt>(dictionary_.size()));
+      if (res != Z_OK) {
+        return STATUS_FORMAT(RuntimeError, "Cannot set deflate dictionary: $0", res);
+      }
+      dictionary_id_ = adler32(
+          adler32(0L, Z_NULL, 0), dictionary_.data(), narrow_cast<uInt>(dictionary_.size()));
+    }
+
     memset(&inflate_stream_, 0, sizeof(inflate_stream_));
     res = inflateInit(&inflate_stream_);
     if (res != Z_OK) {
@@ -212,8 +283,7 @@ class ZlibCompressor : public Compressor {
     output.Shrink(deflate_stream_.next_out - output.udata());
 
     // Send compressed data to underlying stream.
-    return stream->SendToLower(std::make_shared<SingleBufferOutboundData>(
-        std::move(output), std::move(data)));
+    return SendCompressed(stream, std::move(output), std::move(data));
   }
 
   Result<ReadBufferFull> Decompress(StreamReadBuffer* inp, StreamReadBuffer* out) override {
@@ -225,6 +295,11 @@ class ZlibCompressor : public Compressor {
       inflate_stream_.avail_out = narrow_cast<uInt>(outlen);
 
       int res = inflate(&inflate_stream_, Z_NO_FLUSH);
+      if (res == Z_NEED_DICT) {
+        // Peer compresses with a preset dictionary, its id is the adler32 of the dictionary.
+        RETURN_NOT_OK(SetInflateDictionary());
+        res = inflate(&inflate_stream_, Z_NO_FLUSH);
+      }
       if (res != Z_OK && res != Z_BUF_ERROR) {
         return STATUS_FORMAT(RuntimeError, "Decompression failed: $0", res);
       }
@@ -234,11 +309,56 @@ class ZlibCompressor : public Compressor {
     });
   }
 
+ protected:
+  Slice dictionary_;
+
  private:
+  Status SetInflateDictionary() {
+    if (dictionary_.empty() || inflate_stream_.adler != dictionary_id_) {
+      return STATUS_FORMAT(
+          RuntimeError, "Peer uses unknown compression dictionary: $0, local dictionary: $1",
+          inflate_stream_.adler, dictionary_.empty() ? "<none>" : AsString(dictionary_id_));
+    }
+    int res = inflateSetDictionary(
+        &inflate_stream_, dictionary_.data(), narrow_cast<uInt>(dictionary_.size()));
+    if (res != Z_OK) {
+      return STATUS_FORMAT(RuntimeError, "Cannot set inflate dictionary: $0", res);
+    }
+    return Status::OK();
+  }
+
   z_stream deflate_stream_;
   z_stream inflate_stream_;
   bool deflate_inited_ = false;
   bool inflate_inited_ = false;
+  uLong dictionary_id_ = 0;
+};
+
+// Zlib compression with preset dictionary, that makes compression of the first messages on the
+// connection, and of small messages in general, much more efficient.
+// Dictionary is identified by its adler32 checksum, that is stored by zlib in the stream header.
+// So receiver verifies that both sides use the same dictionary.
+class ZlibDictCompressor : public ZlibCompressor {
+ public:
+  static const char kId = 'D';
+  static const int kIndex = 4;
+
+  explicit ZlibDictCompressor(MemTrackerPtr mem_tracker)
+      : ZlibCompressor(std::move(mem_tracker)) {
+  }
+
+  OutboundDataPtr ConnectionHeader() override {
+    return GetConnectionHeader<ZlibDictCompressor>();
+  }
+
+  Status Init() override {
+    dictionary_ = VERIFY_RESULT(CompressionDictionary());
+    return ZlibCompressor::Init();
+  }
+
+  std::string ToString() const override {
+    return "ZlibDict";
+  }
 };
 
 // Source implementation that provides input from range of buffers.
@@ -420,11 +540,11 @@ class SnappyCompressor : public Compressor {
       auto compressed_len = snappy::Compress(&source, &sink);
       BigEndian::Store16(output.data(), compressed_len);
       output.Shrink(kHeaderLen + compressed_len);
-      RETURN_NOT_OK(stream->SendToLower(std::make_shared<SingleBufferOutboundData>(
-          std::move(output),
+      RETURN_NOT_OK(SendCompressed(
+          stream, std::move(output),
           // We processed last buffer, attach data to it, so it will be notified when this buffer
           // is transferred.
-          stop ? std::move(data) : nullptr)));
+          stop ? std::move(data) : nullptr));
     }
     return Status::OK();
   }
@@ -709,11 +829,11 @@ class LZ4Compressor : public Compressor {
         }
         BigEndian::Store16(output.data(), res);
         output.Shrink(kHeaderLen + res);
-        RETURN_NOT_OK(stream->SendToLower(std::make_shared<SingleBufferOutboundData>(
-            std::move(output),
+        RETURN_NOT_OK(SendCompressed(
+            stream, std::move(output),
             // We processed last buffer, attach data to it, so it will be notified when this buffer
             // is transferred.
-            input_slice.empty() && input_it == input.end() ? std::move(data) : nullptr)));
+            input_slice.empty() && input_it == input.end() ? std::move(data) : nullptr));
       }
     }
 
@@ -734,7 +854,7 @@ class LZ4Compressor : public Compressor {
 };
 
 #undef LZ4
-#define YB_COMPRESSION_ALGORITHMS (Zlib)(Snappy)(LZ4)
+#define YB_COMPRESSION_ALGORITHMS (Zlib)(Snappy)(LZ4)(ZlibDict)
 
 #define YB_CREATE_COMPRESSOR_CASE(r, data, name) \
   case BOOST_PP_CAT(name, Compressor)::data: \
@@ -763,7 +883,15 @@ BOOST_PP_SEQ_FOR_EACH(YB_CREATE_COMPRESSOR_CASE, kIndex, YB_COMPRESSION_ALGORITH
 
 class CompressedRefiner : public StreamRefiner {
  public:
-  CompressedRefiner() = default;
+  explicit CompressedRefiner(const scoped_refptr<MetricEntity>& metric_entity) {
+    if (metric_entity) {
+      uncompressed_bytes_counter_ =
+          METRIC_stream_compression_uncompressed_bytes.Instantiate(metric_entity);
+      compressed_bytes_counter_ =
+          METRIC_stream_compression_compressed_bytes.Instantiate(metric_entity);
+      time_counter_ = METRIC_stream_compression_time_us.Instantiate(metric_entity);
+    }
+  }
 
  private:
   void Start(RefinedStream* stream) override {
@@ -798,7 +926,16 @@ class CompressedRefiner : public StreamRefiner {
   Status Send(OutboundDataPtr data) ON_REACTOR_THREAD override {
     boost::container::small_vector<RefCntSlice, 10> input;
     data->Serialize(&input);
-    return compressor_->Compress(input, stream_, std::move(data));
+    auto start = MonoTime::Now();
+    auto compressed_before = compressor_->compressed_bytes_sent();
+    auto status = compressor_->Compress(input, stream_, std::move(data));
+    auto uncompressed = TotalLen(input);
+    auto compressed = compressor_->compressed_bytes_sent() - compressed_before;
+    auto time = MonoTime::Now() - start;
+    uncompressed_bytes_sent_ += uncompressed;
+    compress_time_ += time;
+    UpdateMetrics(uncompressed, compressed, time);
+    return status;
   }
 
   Status Handshake() ON_REACTOR_THREAD override {
@@ -817,7 +954,33 @@ class CompressedRefiner : public StreamRefiner {
   Result<ReadBufferFull> Read(StreamReadBuffer* out) override {
     VLOG_WITH_PREFIX(4) << __func__;
 
-    return compressor_->Decompress(&stream_->ReadBuffer(), out);
+    auto& inp = stream_->ReadBuffer();
+    auto start = MonoTime::Now();
+    auto inp_before = inp.DataAvailable();
+    auto out_before = out->DataAvailable();
+    auto result = compressor_->Decompress(&inp, out);
+    auto compressed = inp_before - inp.DataAvailable();
+    auto uncompressed = out->DataAvailable() - out_before;
+    auto time = MonoTime::Now() - start;
+    compressed_bytes_received_ += compressed;
+    uncompressed_bytes_received_ += uncompressed;
+    decompress_time_ += time;
+    UpdateMetrics(uncompressed, compressed, time);
+    return result;
+  }
+
+  void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) override {
+    if (!compressor_) {
+      return;
+    }
+    auto& compression = *resp->mutable_compression();
+    compression.set_algorithm(compressor_->ToString());
+    compression.set_uncompressed_bytes_sent(uncompressed_bytes_sent_);
+    compression.set_compressed_bytes_sent(compressor_->compressed_bytes_sent());
+    compression.set_compressed_bytes_received(compressed_bytes_received_);
+    compression.set_uncompressed_bytes_received(uncompressed_bytes_received_);
+    compression.set_compress_micros(compress_time_.ToMicroseconds());
+    compression.set_decompress_micros(decompress_time_.ToMicroseconds());
   }
 
   const Protocol* GetProtocol() override {
@@ -832,8 +995,25 @@ class CompressedRefiner : public StreamRefiner {
     return stream_->LogPrefix();
   }
 
+  void UpdateMetrics(size_t uncompressed, size_t compressed, MonoDelta time) {
+    IncrementCounterBy(uncompressed_bytes_counter_, static_cast<int64_t>(uncompressed));
+    IncrementCounterBy(compressed_bytes_counter_, static_cast<int64_t>(compressed));
+    IncrementCounterBy(time_counter_, time.ToMicroseconds());
+  }
+
   RefinedStream* stream_ = nullptr;
   std::unique_ptr<Compressor> compressor_ = nullptr;
+
+  // Per connection statistics, reported by DumpPB.
+  size_t uncompressed_bytes_sent_ = 0;
+  size_t compressed_bytes_received_ = 0;
+  size_t uncompressed_bytes_received_ = 0;
+  MonoDelta compress_time_ = MonoDelta::kZero;
+  MonoDelta decompress_time_ = MonoDelta::kZero;
+
+  scoped_refptr<Counter> uncompressed_bytes_counter_;
+  scoped_refptr<Counter> compressed_bytes_counter_;
+  scoped_refptr<Counter> time_counter_;
 };
 
 } // namespace
@@ -847,7 +1027,7 @@ StreamFactoryPtr CompressedStreamFactory(
     StreamFactoryPtr lower_layer_factory, const MemTrackerPtr& buffer_tracker) {
   return std::make_shared<RefinedStreamFactory>(
       std::move(lower_layer_factory), buffer_tracker, [](const StreamCreateData& data) {
-    return std::make_unique<CompressedRefiner>();
+    return std::make_unique<CompressedRefiner>(data.metric_entity);
   });
 }
 
@@ -0,0 +1,80 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/rpc/concurrency_limiter.h"
+
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace rpc {
+
+class ConcurrencyLimiterTest : public YBTest {
+ protected:
+  // Runs a number of windows, keeping the limiter saturated. Latency of each call is calculated
+  // by latency_func from the number of calls in flight.
+  template <class LatencyFunc>
+  void RunWindows(size_t windows, const LatencyFunc& latency_func) {
+    for (size_t window = 0; window != windows; ++window) {
+      size_t acquired = 0;
+      while (limiter_.TryAcquire()) {
+        ++acquired;
+      }
+      ASSERT_GT(acquired, 0);
+      auto latency = latency_func(acquired);
+      now_ += options_.window;
+      for (size_t i = 0; i != acquired; ++i) {
+        limiter_.Release(latency, now_);
+      }
+    }
+  }
+
+  AdaptiveConcurrencyLimiterOptions options_;
+  AdaptiveConcurrencyLimiter limiter_{options_};
+  CoarseTimePoint now_ = CoarseMonoClock::now();
+};
+
+TEST_F(ConcurrencyLimiterTest, GrowsWithStableLatency) {
+  auto initial_limit = limiter_.limit();
+  ASSERT_NO_FATALS(RunWindows(50, [](size_t) { return 1ms; }));
+  LOG(INFO) << "Limiter: " << limiter_.ToString();
+  ASSERT_GT(limiter_.limit(), initial_limit);
+  ASSERT_LE(limiter_.limit(), options_.max_limit);
+  ASSERT_EQ(limiter_.in_flight(), 0);
+}
+
+TEST_F(ConcurrencyLimiterTest, ConvergesPastSaturation) {
+  // Resource that handles up to kCapacity calls w/o queuing, then latency grows linearly.
+  constexpr size_t kCapacity = 64;
+  auto latency_func = [](size_t in_flight) {
+    return 1ms * std::max<size_t>(1, in_flight * 2 / kCapacity);
+  };
+  ASSERT_NO_FATALS(RunWindows(500, latency_func));
+  LOG(INFO) << "Limiter: " << limiter_.ToString();
+  ASSERT_GE(limiter_.limit(), kCapacity / 2);
+  ASSERT_LE(limiter_.limit(), kCapacity * 4);
+
+  // Latency spike should reduce the limit.
+  auto limit_before_spike = limiter_.limit();
+  ASSERT_NO_FATALS(RunWindows(10, [](size_t) { return 100ms; }));
+  LOG(INFO) << "Limiter after spike: " << limiter_.ToString();
+  ASSERT_LT(limiter_.limit(), limit_before_spike);
+  ASSERT_GE(limiter_.limit(), options_.min_limit);
+  ASSERT_GE(limiter_.RetryAfter(), 50ms);
+}
+
+} // namespace rpc
+} // namespace yb
@@ -0,0 +1,113 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/concurrency_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "yb/util/format.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+const MonoDelta kMinRetryAfter = 1ms;
+const MonoDelta kMaxRetryAfter = 1s;
+
+}
+
+AdaptiveConcurrencyLimiter::AdaptiveConcurrencyLimiter(
+    const AdaptiveConcurrencyLimiterOptions& options)
+    : options_(options), limit_(options.initial_limit),
+      estimated_limit_(static_cast<double>(options.initial_limit)) {
+}
+
+bool AdaptiveConcurrencyLimiter::TryAcquire() {
+  auto in_flight = in_flight_.fetch_add(1, std::memory_order_acq_rel);
+  if (in_flight >= limit_.load(std::memory_order_acquire)) {
+    in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+    return false;
+  }
+  return true;
+}
+
+void AdaptiveConcurrencyLimiter::Release(MonoDelta latency, CoarseTimePoint now) {
+  auto in_flight = in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+
+  std::lock_guard lock(mutex_);
+  window_latency_sum_us_ += static_cast<double>(latency.ToMicroseconds());
+  ++window_samples_;
+  window_max_in_flight_ = std::max(window_max_in_flight_, in_flight);
+  if (window_end_ == CoarseTimePoint()) {
+    window_end_ = now + options_.window;
+    return;
+  }
+  if (now < window_end_ || window_samples_ < options_.min_window_samples) {
+    return;
+  }
+  UpdateLimit(now);
+}
+
+void AdaptiveConcurrencyLimiter::UpdateLimit(CoarseTimePoint now) {
+  auto short_latency_us = std::max(
+      window_latency_sum_us_ / static_cast<double>(window_samples_), 1.0);
+  auto max_in_flight = window_max_in_flight_;
+  window_latency_sum_us_ = 0;
+  window_samples_ = 0;
+  window_max_in_flight_ = 0;
+  window_end_ = now + options_.window;
+  last_window_latency_us_.store(short_latency_us, std::memory_order_release);
+
+  if (long_latency_us_ == 0) {
+    long_latency_us_ = short_latency_us;
+  } else {
+    long_latency_us_ +=
+        (short_latency_us - long_latency_us_) / static_cast<double>(options_.long_window);
+  }
+  // Long term latency could drift up during a long overload, decay it faster when the load goes
+  // away, so the limit could grow back.
+  if (long_latency_us_ > short_latency_us * 2) {
+    long_latency_us_ *= 0.95;
+  }
+
+  // Do not grow the limit if it is not used, otherwise it would be unbounded at low load.
+  if (static_cast<double>(max_in_flight) * 2 < estimated_limit_) {
+    return;
+  }
+
+  auto gradient = std::clamp(
+      options_.tolerance * long_latency_us_ / short_latency_us, 0.5, 1.0);
+  auto new_limit = estimated_limit_ * gradient + std::sqrt(estimated_limit_);
+  estimated_limit_ = std::clamp(
+      estimated_limit_ * (1 - options_.smoothing) + new_limit * options_.smoothing,
+      static_cast<double>(options_.min_limit), static_cast<double>(options_.max_limit));
+  limit_.store(static_cast<size_t>(estimated_limit_), std::memory_order_release);
+}
+
+MonoDelta AdaptiveConcurrencyLimiter::RetryAfter() const {
+  auto latency_us = last_window_latency_us_.load(std::memory_order_acquire);
+  return std::clamp(
+      MonoDelta::FromMicroseconds(static_cast<int64_t>(latency_us)), kMinRetryAfter,
+      kMaxRetryAfter);
+}
+
+std::string AdaptiveConcurrencyLimiter::ToString() const {
+  return Format("{ limit: $0 in_flight: $1 }", limit(), in_flight());
+}
+
+} // namespace rpc
+} // namespace yb
@@ -0,0 +1,96 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace rpc {
+
+struct AdaptiveConcurrencyLimiterOptions {
+  size_t initial_limit = 32;
+  size_t min_limit = 4;
+  size_t max_limit = 1024;
+
+  // Weight of the newly calculated limit, when it is combined with the current one.
+  double smoothing = 0.2;
+
+  // Allowed ratio between short term and long term latency, before the limit is reduced.
+  double tolerance = 1.5;
+
+  // Number of windows that long term latency is averaged over.
+  size_t long_window = 600;
+
+  // Limit is recalculated at most once per window, if window has at least min_window_samples.
+  MonoDelta window = MonoDelta::FromMilliseconds(100);
+  size_t min_window_samples = 10;
+};
+
+// Limits number of concurrently handled calls, adjusting the limit based on observed latency.
+// Follows the gradient approach: as long as short term latency stays close to long term latency,
+// the limit grows by a small queue allowance. When short term latency grows, i.e. calls start
+// waiting for some saturated resource, the limit is reduced proportionally.
+class AdaptiveConcurrencyLimiter {
+ public:
+  explicit AdaptiveConcurrencyLimiter(
+      const AdaptiveConcurrencyLimiterOptions& options = AdaptiveConcurrencyLimiterOptions());
+
+  // Returns true if call could be started. In this case Release should be called when it is
+  // completed.
+  bool TryAcquire();
+
+  // Notifies limiter that call acquired with TryAcquire has completed with specified latency.
+  void Release(MonoDelta latency, CoarseTimePoint now = CoarseMonoClock::now());
+
+  size_t limit() const {
+    return limit_.load(std::memory_order_acquire);
+  }
+
+  size_t in_flight() const {
+    return in_flight_.load(std::memory_order_acquire);
+  }
+
+  // Suggested delay before the client retries a rejected call.
+  MonoDelta RetryAfter() const;
+
+  std::string ToString() const;
+
+ private:
+  void UpdateLimit(CoarseTimePoint now) REQUIRES(mutex_);
+
+  const AdaptiveConcurrencyLimiterOptions options_;
+
+  std::atomic<size_t> limit_;
+  std::atomic<size_t> in_flight_{0};
+  // Short term latency of the last completed window, in microseconds.
+  std::atomic<double> last_window_latency_us_{0};
+
+  mutable std::mutex mutex_;
+  // Limit is tracked as double to allow smooth changes, limit_ is its rounded value.
+  double estimated_limit_ GUARDED_BY(mutex_);
+  double long_latency_us_ GUARDED_BY(mutex_) = 0;
+  double window_latency_sum_us_ GUARDED_BY(mutex_) = 0;
+  size_t window_samples_ GUARDED_BY(mutex_) = 0;
+  size_t window_max_in_flight_ GUARDED_BY(mutex_) = 0;
+  CoarseTimePoint window_end_ GUARDED_BY(mutex_);
+};
+
+} // namespace rpc
+} // namespace yb
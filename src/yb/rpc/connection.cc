@@ -66,6 +66,11 @@ using std::vector;
 DEFINE_UNKNOWN_uint64(rpc_connection_timeout_ms, yb::NonTsanVsTsan(15000, 30000),
     "Timeout for RPC connection operations");
 
+DEFINE_RUNTIME_bool(rpc_coalesce_response_writes, false,
+    "Coalesce responses that become ready for the same connection during one reactor loop "
+    "iteration, and write them with a single writev at the end of the iteration.");
+TAG_FLAG(rpc_coalesce_response_writes, advanced);
+
 METRIC_DEFINE_histogram_with_percentiles(
     server, handler_latency_outbound_transfer, "Time taken to transfer the response ",
     yb::MetricUnit::kMicroseconds, "Microseconds spent to queue and write the response to the wire",
@@ -300,7 +305,7 @@ size_t Connection::DoQueueOutboundData(OutboundDataPtr outbound_data, bool batch
   }
 
   if (!batch) {
-    OutboundQueued();
+    ResponsesQueued();
   }
 
   return *result;
@@ -407,6 +412,22 @@ void Connection::QueueOutboundDataBatch(const OutboundDataBatch& batch) {
     DoQueueOutboundData(call, /* batch */ true);
   }
 
+  ResponsesQueued();
+}
+
+void Connection::ResponsesQueued() {
+  if (!FLAGS_rpc_coalesce_response_writes) {
+    OutboundQueued();
+    return;
+  }
+  if (!flush_scheduled_) {
+    flush_scheduled_ = true;
+    reactor_->ScheduleConnectionFlush(shared_from_this());
+  }
+}
+
+void Connection::FlushCoalescedWrites() {
+  flush_scheduled_ = false;
   OutboundQueued();
 }
 
@@ -458,7 +479,7 @@ void Connection::ProcessResponseQueue() {
       DoQueueOutboundData(std::move(call), /* batch */ true);
     }
     outbound_data_being_processed_.clear();
-    OutboundQueued();
+    ResponsesQueued();
   }
 }
 
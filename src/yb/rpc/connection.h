@@ -176,6 +176,9 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   // Do appropriate actions after adding outbound call.
   void OutboundQueued() ON_REACTOR_THREAD;
 
+  // Writes responses that were coalesced during the current reactor loop iteration.
+  void FlushCoalescedWrites() ON_REACTOR_THREAD;
+
   // An incoming packet has completed on the client side. This parses the
   // call response, looks up the CallAwaitingResponse, and calls the
   // client callback.
@@ -212,6 +215,11 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
 
   void ProcessResponseQueue() ON_REACTOR_THREAD;
 
+  // Called after responses were added to the stream. Writes them immediately, or, when write
+  // coalescing is enabled, defers the write to the end of the reactor loop iteration, so responses
+  // that become ready during this iteration are sent with a single writev.
+  void ResponsesQueued() ON_REACTOR_THREAD;
+
   // Stream context implementation
   void UpdateLastRead() override;
 
@@ -288,6 +296,9 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
 
   EvTimerHolder timer_ GUARDED_BY_REACTOR_THREAD;
 
+  // Whether this connection is registered in the reactor to flush coalesced writes.
+  bool flush_scheduled_ GUARDED_BY_REACTOR_THREAD = false;
+
   // ----------------------------------------------------------------------------------------------
   // Fields protected by outbound_data_queue_mtx_
   // ----------------------------------------------------------------------------------------------
@@ -32,6 +32,8 @@
 
 #include "yb/rpc/inbound_call.h"
 
+#include <algorithm>
+
 #include "yb/gutil/strings/substitute.h"
 
 #include "yb/rpc/connection.h"
@@ -91,6 +93,10 @@ InboundCall::~InboundCall() {
 void InboundCall::NotifyTransferred(const Status& status, Connection* conn) {
   if (status.ok()) {
     TRACE_TO(trace(), "Transfer finished");
+    RecordPhase(InboundCallPhase::kResponseSent);
+    if (rpc_method_phase_metrics_) {
+      rpc_method_phase_metrics_->Record(*this);
+    }
   } else {
     YB_LOG_EVERY_N_SECS(WARNING, 10) << LogPrefix() << "Connection torn down before " << ToString()
                                      << " could send its response: " << status.ToString();
@@ -153,11 +159,41 @@ void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_
   // Protect against multiple calls.
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_handled.Initialized()) << "Already marked as started";
   timing_.time_handled = MonoTime::Now();
+  RecordPhase(InboundCallPhase::kHandlingStarted, timing_.time_handled);
   VLOG_WITH_PREFIX(4) << "Handling";
   incoming_queue_time->Increment(
       timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds());
 }
 
+void InboundCall::RecordPhase(InboundCallPhase phase) {
+  RecordPhase(phase, MonoTime::Now());
+}
+
+void InboundCall::RecordPhase(InboundCallPhase phase, MonoTime time) {
+  // 0 means that phase was not reached, so the offset is at least 1ns.
+  auto offset = std::max<int64_t>(time.GetDeltaSince(timing_.time_received).ToNanoseconds(), 1);
+  timing_.phase_offset_ns[to_underlying(phase)].store(offset, std::memory_order_relaxed);
+}
+
+std::optional<MonoDelta> InboundCall::PhaseOffset(InboundCallPhase phase) const {
+  auto offset = timing_.phase_offset_ns[to_underlying(phase)].load(std::memory_order_relaxed);
+  if (offset == 0) {
+    return std::nullopt;
+  }
+  return MonoDelta::FromNanoseconds(offset);
+}
+
+void InboundCall::DumpPhases(RpcCallInProgressPB* resp) const {
+  for (auto phase : InboundCallPhaseList()) {
+    auto offset = PhaseOffset(phase);
+    if (offset) {
+      auto* phase_pb = resp->add_phases();
+      phase_pb->set_phase(ToCString(phase) + 1);
+      phase_pb->set_elapsed_micros(offset->ToMicroseconds());
+    }
+  }
+}
+
 MonoDelta InboundCall::GetTimeInQueue() const {
   return timing_.time_handled.GetDeltaSince(timing_.time_received);
 }
@@ -178,10 +214,14 @@ void InboundCall::RecordHandlingCompleted() {
   // Protect against multiple calls.
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_completed.Initialized()) << "Already marked as completed";
   timing_.time_completed = MonoTime::Now();
+  RecordPhase(InboundCallPhase::kHandlingCompleted, timing_.time_completed);
   VLOG_WITH_PREFIX(4) << "Completed handling";
+  auto handling_time = timing_.time_completed - timing_.time_handled;
   if (rpc_method_handler_latency_) {
-    rpc_method_handler_latency_->Increment(
-        (timing_.time_completed - timing_.time_handled).ToMicroseconds());
+    rpc_method_handler_latency_->Increment(handling_time.ToMicroseconds());
+  }
+  if (completion_handler_) {
+    completion_handler_->CallHandlingCompleted(this, handling_time);
   }
 }
 
@@ -196,6 +236,7 @@ bool InboundCall::ClientTimedOut() const {
 
 void InboundCall::QueueResponse(bool is_success) {
   TRACE_TO(trace(), is_success ? "Queueing success response" : "Queueing failure response");
+  RecordPhase(InboundCallPhase::kResponseQueued);
   LogTrace();
   bool expected = false;
   if (responded_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
@@ -253,6 +294,7 @@ void InboundCall::SetRpcMethodMetrics(std::reference_wrapper<const RpcMethodMetr
   const auto& metrics = value.get();
   rpc_method_response_bytes_ = metrics.response_bytes;
   rpc_method_handler_latency_ = metrics.handler_latency;
+  rpc_method_phase_metrics_ = metrics.phase_latency;
   if (metrics.request_bytes) {
     auto request_size = request_data_.size();
     if (request_size) {
@@ -31,6 +31,9 @@
 //
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -78,6 +81,10 @@ struct InboundCallTiming {
   MonoTime time_received;   // Time the call was first accepted.
   MonoTime time_handled;    // Time the call handler was kicked off.
   MonoTime time_completed;  // Time the call handler completed.
+
+  // Time of each phase in nanoseconds since time_received, 0 if the phase was not reached.
+  // Phases could be recorded by different threads, e.g. Raft apply, so they are atomic.
+  std::array<std::atomic<int64_t>, kInboundCallPhaseMapSize> phase_offset_ns{};
 };
 
 class InboundCallHandler {
@@ -90,6 +97,9 @@ class InboundCallHandler {
 
   virtual void CallDequeued() = 0;
 
+  // Invoked when the service responds to a call that was passed to set_completion_handler.
+  virtual void CallHandlingCompleted(InboundCall* call, MonoDelta handling_time) {}
+
  protected:
   ~InboundCallHandler() = default;
 };
@@ -149,6 +159,13 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
   // Not thread-safe. Should only be called by the current "owner" thread.
   void RecordHandlingCompleted();
 
+  // Records that the call has reached the specified phase. Could be called from any thread.
+  void RecordPhase(InboundCallPhase phase);
+
+  // Returns time between receiving the call and reaching the specified phase, or nullopt if the
+  // phase was not reached.
+  std::optional<MonoDelta> PhaseOffset(InboundCallPhase phase) const;
+
   // Return true if the deadline set by the client has already elapsed.
   // In this case, the server may stop processing the call, since the
   // call response will be ignored anyway.
@@ -159,6 +176,11 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
   // If the client did not specify a deadline, returns MonoTime::Max().
   virtual CoarseTimePoint GetClientDeadline() const = 0;
 
+  // Scheduling class requested by the client.
+  virtual RpcPriorityClass priority_class() const {
+    return RpcPriorityClass::kInteractive;
+  }
+
   virtual void DoSerialize(ByteBlocks* output) = 0;
 
   // Returns the time spent in the service queue -- from the time the call was received, until
@@ -173,12 +195,21 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
     call_processed_listener_ = nullptr;
   }
 
+  void set_completion_handler(InboundCallHandler* handler) {
+    completion_handler_ = handler;
+  }
+
   virtual Slice serialized_remote_method() const = 0;
   virtual Slice method_name() const = 0;
 
 //  virtual const std::string& service_name() const = 0;
   virtual void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) = 0;
 
+  // Responds with ERROR_SERVER_TOO_BUSY, suggesting the client to retry after specified delay.
+  virtual void RespondBusy(const Status& status, MonoDelta retry_after) {
+    RespondFailure(ErrorStatusPB::ERROR_SERVER_TOO_BUSY, status);
+  }
+
   // Do appropriate actions when call is timed out.
   //
   // message contains human readable information on why call timed out.
@@ -233,6 +264,9 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   void QueueResponse(bool is_success);
 
+  // Fills phases that the call has reached so far, for /rpcz.
+  void DumpPhases(RpcCallInProgressPB* resp) const;
+
   // The serialized bytes of the request param protobuf. Set by ParseFrom().
   // This references memory held by 'request_data_'.
   Slice serialized_request_;
@@ -250,11 +284,14 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   scoped_refptr<Counter> rpc_method_response_bytes_;
   scoped_refptr<Histogram> rpc_method_handler_latency_;
+  std::shared_ptr<const InboundCallPhaseMetrics> rpc_method_phase_metrics_;
 
   mutable simple_spinlock mutex_;
   bool cleared_ GUARDED_BY(mutex_) = false;
 
  private:
+  void RecordPhase(InboundCallPhase phase, MonoTime time);
+
   // The trace buffer.
   scoped_refptr<Trace> trace_holder_ GUARDED_BY(mutex_);
   std::atomic<Trace*> trace_ = nullptr;
@@ -284,6 +321,7 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   InboundCallTask task_;
   InboundCallHandler* tracker_ = nullptr;
+  InboundCallHandler* completion_handler_ = nullptr;
 
   size_t method_index_ = 0;
   int64_t rpc_queue_position_ = -1;
@@ -0,0 +1,179 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/io_uring_sender.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "yb/rpc/tcp_stream.h"
+
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+
+DEFINE_NON_RUNTIME_uint32(rpc_io_uring_queue_depth, 256,
+    "Number of submission queue entries of the io_uring used by each reactor for sends, when "
+    "rpc_io_uring_send is set. Reactor with more connections to flush submits them in several "
+    "batches.");
+TAG_FLAG(rpc_io_uring_queue_depth, advanced);
+
+METRIC_DEFINE_simple_counter(
+  server, rpc_io_uring_submits, "Number of io_uring submissions of TCP sends",
+  yb::MetricUnit::kRequests);
+
+METRIC_DEFINE_simple_counter(
+  server, rpc_io_uring_sends, "Number of TCP sends submitted via io_uring",
+  yb::MetricUnit::kRequests);
+
+namespace yb {
+namespace rpc {
+
+IoUringSender::IoUringSender(
+    std::unique_ptr<IoUring> ring, ev::loop_ref* loop,
+    const scoped_refptr<MetricEntity>& metric_entity, std::function<void()> schedule_flush)
+    : ring_(std::move(ring)), schedule_flush_(std::move(schedule_flush)),
+      in_flight_(ring_->capacity()) {
+  if (metric_entity) {
+    submits_counter_ = METRIC_rpc_io_uring_submits.Instantiate(metric_entity);
+    sends_counter_ = METRIC_rpc_io_uring_sends.Instantiate(metric_entity);
+  }
+  free_slots_.reserve(in_flight_.size());
+  for (auto i = in_flight_.size(); i-- > 0;) {
+    free_slots_.push_back(i);
+  }
+  completion_io_.set(*loop);
+  completion_io_.set<IoUringSender, &IoUringSender::CompletionHandler>(this);
+  completion_io_.start(ring_->completion_fd(), ev::READ);
+}
+
+IoUringSender::~IoUringSender() {
+  LOG_IF(DFATAL, !scheduled_.empty()) << "Destroying sender with scheduled streams";
+  LOG_IF(DFATAL, ring_->in_flight()) << "Destroying sender with in flight sends";
+  completion_io_.stop();
+}
+
+Result<std::unique_ptr<IoUringSender>> IoUringSender::Create(
+    ev::loop_ref* loop, const scoped_refptr<MetricEntity>& metric_entity,
+    std::function<void()> schedule_flush) {
+  auto ring = VERIFY_RESULT(IoUring::Create(FLAGS_rpc_io_uring_queue_depth));
+  return std::make_unique<IoUringSender>(
+      std::move(ring), loop, metric_entity, std::move(schedule_flush));
+}
+
+void IoUringSender::Schedule(TcpStream* stream) {
+  if (scheduled_.empty()) {
+    schedule_flush_();
+  }
+  scheduled_.push_back(stream);
+}
+
+void IoUringSender::Cancel(
+    TcpStream* stream, std::vector<TcpStreamSendingData::SendingBytes> in_flight_bytes) {
+  auto it = std::find(scheduled_.begin(), scheduled_.end(), stream);
+  if (it != scheduled_.end()) {
+    scheduled_.erase(it);
+  }
+  std::replace(flushing_.begin(), flushing_.end(), stream, static_cast<TcpStream*>(nullptr));
+  for (auto& send : in_flight_) {
+    if (send.stream == stream) {
+      send.stream = nullptr;
+      send.retained_bytes = std::move(in_flight_bytes);
+      break;
+    }
+  }
+}
+
+void IoUringSender::Flush() {
+  size_t sends = 0;
+  while (!scheduled_.empty() && !free_slots_.empty()) {
+    flushing_.swap(scheduled_);
+    size_t index = 0;
+    for (; index != flushing_.size() && !free_slots_.empty(); ++index) {
+      // Preparing a send could complete data that was skipped, and that could cancel other
+      // streams, so the stream is checked right before it is used.
+      auto* stream = flushing_[index];
+      if (!stream) {
+        continue;
+      }
+      const auto slot = free_slots_.back();
+      auto& send = in_flight_[slot];
+      const auto len = stream->PrepareIoUringSend(send.iov);
+      if (len == 0) {
+        continue;
+      }
+      memset(&send.msg, 0, sizeof(send.msg));
+      send.msg.msg_iov = send.iov;
+      send.msg.msg_iovlen = len;
+      if (!ring_->PrepareSendMsg(
+              stream->socket()->GetFd(), &send.msg, MSG_NOSIGNAL | MSG_DONTWAIT, slot)) {
+        LOG(DFATAL) << "io_uring submission queue is full";
+        stream->IoUringSendCompleted(-EAGAIN, send.iov);
+        continue;
+      }
+      send.stream = stream;
+      free_slots_.pop_back();
+      ++sends;
+    }
+    // Streams that did not fit into the ring are sent when in flight sends are completed.
+    for (; index != flushing_.size(); ++index) {
+      if (flushing_[index]) {
+        scheduled_.push_back(flushing_[index]);
+      }
+    }
+    flushing_.clear();
+  }
+
+  // Entries that were not accepted because of an error stay queued and are submitted by the next
+  // flush.
+  auto submitted = ring_->Submit();
+  if (!submitted.ok()) {
+    LOG(DFATAL) << "Failed to submit " << sends << " sends: " << submitted.status();
+  } else if (*submitted) {
+    IncrementCounter(submits_counter_);
+    IncrementCounterBy(sends_counter_, *submitted);
+  }
+}
+
+void IoUringSender::Shutdown() {
+  completion_io_.stop();
+  auto completed = ring_->WaitAll([this](uint64_t index, int32_t res) {
+    SendCompleted(index, res);
+  });
+  LOG_IF(DFATAL, !completed.ok()) << "Failed to wait in flight sends: " << completed.status();
+}
+
+void IoUringSender::CompletionHandler(ev::io& watcher, int revents) { // NOLINT
+  ring_->ReapCompletions([this](uint64_t index, int32_t res) {
+    SendCompleted(index, res);
+  });
+  // Freed slots could be used by streams that did not fit into the ring.
+  if (!scheduled_.empty()) {
+    Flush();
+  }
+}
+
+void IoUringSender::SendCompleted(uint64_t index, int32_t res) {
+  auto& send = in_flight_[index];
+  auto* stream = send.stream;
+  send.stream = nullptr;
+  if (stream) {
+    stream->IoUringSendCompleted(res, send.iov);
+  }
+  send.retained_bytes.clear();
+  free_slots_.push_back(index);
+}
+
+} // namespace rpc
+} // namespace yb
@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <ev++.h>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/rpc/tcp_stream.h"
+
+#include "yb/util/io_uring.h"
+#include "yb/util/metrics_fwd.h"
+
+namespace yb {
+namespace rpc {
+
+// Sends data of TCP streams via io_uring. Streams that have data to send schedule themselves
+// instead of calling sendmsg, and the reactor flushes all of them at the end of the loop iteration,
+// so sends of all its connections are submitted with a single io_uring_enter. Flush does not wait
+// for sends to complete, completions are reaped when the event fd of the ring becomes readable.
+//
+// Owned by the reactor and used only from its thread.
+class IoUringSender {
+ public:
+  // schedule_flush is invoked when the first stream is scheduled, and should make the reactor
+  // call Flush before it waits for events.
+  IoUringSender(
+      std::unique_ptr<IoUring> ring, ev::loop_ref* loop,
+      const scoped_refptr<MetricEntity>& metric_entity, std::function<void()> schedule_flush);
+  ~IoUringSender();
+
+  // Returns NotSupported if io_uring could not be used on this host.
+  static Result<std::unique_ptr<IoUringSender>> Create(
+      ev::loop_ref* loop, const scoped_refptr<MetricEntity>& metric_entity,
+      std::function<void()> schedule_flush);
+
+  // Schedules send of data queued to the stream.
+  void Schedule(TcpStream* stream);
+
+  // Removes the stream from scheduled ones, used when the stream is shut down. If send of the
+  // stream is in flight, bytes referenced by it are kept until the send is completed.
+  void Cancel(TcpStream* stream, std::vector<TcpStreamSendingData::SendingBytes> in_flight_bytes);
+
+  // Submits sends of scheduled streams. Streams that do not fit into the ring are submitted when
+  // in flight sends are completed.
+  void Flush();
+
+  // Waits for in flight sends, so the bytes they reference could be released.
+  void Shutdown();
+
+ private:
+  // Send that was submitted to the ring, index in in_flight_ is used as user data of the entry.
+  struct InFlightSend {
+    // nullptr when the slot is free or the stream was cancelled.
+    TcpStream* stream = nullptr;
+    msghdr msg;
+    iovec iov[TcpStream::kMaxIov];
+    // Bytes of the cancelled stream, that are referenced by iov.
+    std::vector<TcpStreamSendingData::SendingBytes> retained_bytes;
+  };
+
+  void CompletionHandler(ev::io& watcher, int revents); // NOLINT
+
+  void SendCompleted(uint64_t index, int32_t res);
+
+  std::unique_ptr<IoUring> ring_;
+  std::function<void()> schedule_flush_;
+
+  // Watches event fd of the ring.
+  ev::io completion_io_;
+
+  std::vector<TcpStream*> scheduled_;
+  std::vector<TcpStream*> flushing_;
+  std::vector<InFlightSend> in_flight_;
+  std::vector<size_t> free_slots_;
+
+  scoped_refptr<Counter> submits_counter_;
+  scoped_refptr<Counter> sends_counter_;
+};
+
+} // namespace rpc
+} // namespace yb
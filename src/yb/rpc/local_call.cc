@@ -59,7 +59,8 @@ const std::shared_ptr<LocalYBInboundCall>& LocalOutboundCall::CreateLocalInbound
       timeout.Initialized() ? start_ + timeout : CoarseTimePoint::max();
   auto outbound_call = std::static_pointer_cast<LocalOutboundCall>(shared_from(this));
   inbound_call_ = InboundCall::Create<LocalYBInboundCall>(
-      &rpc_metrics(), remote_method(), outbound_call, deadline);
+      &rpc_metrics(), remote_method(), outbound_call, deadline,
+      controller()->priority_class());
   return inbound_call_;
 }
 
@@ -75,9 +76,10 @@ LocalYBInboundCall::LocalYBInboundCall(
     RpcMetrics* rpc_metrics,
     const RemoteMethod& remote_method,
     std::weak_ptr<LocalOutboundCall> outbound_call,
-    CoarseTimePoint deadline)
+    CoarseTimePoint deadline,
+    RpcPriorityClass priority_class)
     : YBInboundCall(rpc_metrics, remote_method), outbound_call_(outbound_call),
-      deadline_(deadline) {
+      deadline_(deadline), priority_class_(priority_class) {
 }
 
 const Endpoint& LocalYBInboundCall::remote_address() const {
@@ -99,6 +101,14 @@ void LocalYBInboundCall::Respond(AnyMessageConstPtr resp, bool is_success) {
   }
 
   if (is_success) {
+    if (resp.impl() != call->response().impl()) {
+      // Handler used its own response, i.e. service and proxy use different message kinds.
+      auto status = CopyResponse(resp, call->response());
+      if (!status.ok()) {
+        call->SetFailed(status);
+        return;
+      }
+    }
     call->SetFinished();
   } else {
     std::unique_ptr<ErrorStatusPB> error;
@@ -115,7 +125,23 @@ void LocalYBInboundCall::Respond(AnyMessageConstPtr resp, bool is_success) {
 }
 
 Status LocalYBInboundCall::ParseParam(RpcCallParams* params) {
-  LOG(FATAL) << "local call should not require parsing";
+  // Only used when the request kind of the proxy does not match the one expected by the service,
+  // so the request is passed through its serialized form.
+  auto call = outbound_call();
+  if (!call) {
+    return STATUS(Aborted, "Local outbound call already finished");
+  }
+  const auto& req = call->request();
+  RefCntBuffer buffer(req.SerializedSize());
+  RETURN_NOT_OK(req.SerializeToArray(buffer.udata()));
+  RETURN_NOT_OK(params->ParseRequest(buffer.AsSlice(), buffer));
+  return Status::OK();
+}
+
+Status LocalYBInboundCall::CopyResponse(AnyMessageConstPtr source, AnyMessagePtr dest) {
+  RefCntBuffer buffer(source.SerializedSize());
+  RETURN_NOT_OK(source.SerializeToArray(buffer.udata()));
+  return dest.ParseFromSlice(buffer.AsSlice());
 }
 
 Result<size_t> LocalYBInboundCall::ParseRequest(Slice param, const RefCntBuffer& buffer) {
@@ -66,13 +66,14 @@ class LocalYBInboundCall : public YBInboundCall, public RpcCallParams {
  public:
   LocalYBInboundCall(RpcMetrics* rpc_metrics, const RemoteMethod& remote_method,
                      std::weak_ptr<LocalOutboundCall> outbound_call,
-                     CoarseTimePoint deadline);
+                     CoarseTimePoint deadline, RpcPriorityClass priority_class);
 
   bool IsLocalCall() const override { return true; }
 
   const Endpoint& remote_address() const override;
   const Endpoint& local_address() const override;
   CoarseTimePoint GetClientDeadline() const override { return deadline_; }
+  RpcPriorityClass priority_class() const override { return priority_class_; }
 
   Status ParseParam(RpcCallParams* params) override;
 
@@ -91,18 +92,37 @@ class LocalYBInboundCall : public YBInboundCall, public RpcCallParams {
   Result<size_t> ParseRequest(Slice param, const RefCntBuffer& buffer) override;
   AnyMessageConstPtr SerializableResponse() override;
 
+  static Status CopyResponse(AnyMessageConstPtr source, AnyMessagePtr dest);
+
   // Weak pointer back to the outbound call owning this inbound call to avoid circular reference.
   std::weak_ptr<LocalOutboundCall> outbound_call_;
 
   const CoarseTimePoint deadline_;
+  const RpcPriorityClass priority_class_;
 };
 
+template <class Params>
+constexpr bool IsLightweightParams() {
+  return std::is_base_of_v<RpcCallLWParams, Params>;
+}
+
+// Returns true if the local call could pass its request and response to the handler directly.
+// It is not the case when the proxy uses protobuf messages while the service expects lightweight
+// ones, or vice versa.
+template <class Params>
+bool CanPassLocalMessages(const LocalOutboundCall& outbound_call) {
+  return outbound_call.request().is_lightweight() == IsLightweightParams<Params>();
+}
+
 template <class Params, class F>
 auto HandleCall(InboundCallPtr call, F f) {
   auto yb_call = std::static_pointer_cast<YBInboundCall>(call);
+  std::shared_ptr<LocalOutboundCall> outbound_call;
   if (yb_call->IsLocalCall()) {
+    outbound_call = std::static_pointer_cast<LocalYBInboundCall>(yb_call)->outbound_call();
+  }
+  if (outbound_call && CanPassLocalMessages<Params>(*outbound_call)) {
     auto local_call = std::static_pointer_cast<LocalYBInboundCall>(yb_call);
-    auto outbound_call = local_call->outbound_call();
     auto* req = yb::down_cast<const typename Params::RequestType*>(
         Params::CastMessage(outbound_call->request()));
     auto* resp = yb::down_cast<typename Params::ResponseType*>(
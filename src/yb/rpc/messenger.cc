@@ -97,6 +97,12 @@ DEFINE_NON_RUNTIME_int32(rpc_workers_limit, 1024, "Workers limit for rpc server"
 
 DEFINE_UNKNOWN_int32(socket_receive_buffer_size, 0, "Socket receive buffer size, 0 to use default");
 
+DEFINE_NON_RUNTIME_bool(rpc_reuseport_listener_per_reactor, false,
+                        "Bind a separate SO_REUSEPORT listening socket for each reactor, and serve "
+                        "connections accepted on it by this reactor, instead of distributing "
+                        "connections among reactors by remote address.");
+TAG_FLAG(rpc_reuseport_listener_per_reactor, advanced);
+
 DEFINE_test_flag(
     int32, rpc_reactor_index_for_init_failure_simulation,
     -1, "Index of reactor in Messenger to simulate failure of Reactor::Init method");
@@ -241,7 +247,8 @@ Status Messenger::ListenAddress(
     std::lock_guard<percpu_rwlock> guard(lock_);
     if (!acceptor_) {
       acceptor_.reset(new Acceptor(
-          metric_entity_, std::bind(&Messenger::RegisterInboundSocket, this, factory, _1, _2)));
+          metric_entity_,
+          std::bind(&Messenger::RegisterInboundSocket, this, factory, _1, _2, _3)));
     }
     auto accept_host = accept_endpoint.address();
     auto& outbound_address = accept_host.is_v6() ? outbound_address_v6_
@@ -251,7 +258,20 @@ Status Messenger::ListenAddress(
     }
     acceptor = acceptor_.get();
   }
-  return acceptor->Listen(accept_endpoint, bound_endpoint);
+  if (!FLAGS_rpc_reuseport_listener_per_reactor) {
+    return acceptor->Listen(accept_endpoint, bound_endpoint);
+  }
+
+  // The first socket could be bound to port 0, so the others are bound to the port it got.
+  Endpoint bound;
+  RETURN_NOT_OK(acceptor->Listen(accept_endpoint, &bound, /* shard= */ 0));
+  for (size_t i = 1; i < reactors_.size(); ++i) {
+    RETURN_NOT_OK(acceptor->Listen(Endpoint(accept_endpoint.address(), bound.port()), nullptr, i));
+  }
+  if (bound_endpoint) {
+    *bound_endpoint = bound;
+  }
+  return Status::OK();
 }
 
 Status Messenger::StartAcceptor() {
@@ -411,6 +431,25 @@ rpc::ThreadPool& Messenger::ThreadPool(ServicePriority priority) {
   FATAL_INVALID_ENUM_VALUE(ServicePriority, priority);
 }
 
+rpc::ThreadPool& Messenger::WorkStealingThreadPool() {
+  auto work_stealing_thread_pool = work_stealing_thread_pool_.get();
+  if (work_stealing_thread_pool) {
+    return *work_stealing_thread_pool;
+  }
+  std::lock_guard<std::mutex> lock(mutex_work_stealing_thread_pool_);
+  work_stealing_thread_pool = work_stealing_thread_pool_.get();
+  if (work_stealing_thread_pool) {
+    return *work_stealing_thread_pool;
+  }
+  const ThreadPoolOptions& options = normal_thread_pool_->options();
+  work_stealing_thread_pool_.reset(new rpc::ThreadPool(rpc::ThreadPoolOptions {
+    .name = name_ + "-ws",
+    .max_workers = options.max_workers,
+    .work_stealing = true,
+  }));
+  return *work_stealing_thread_pool_.get();
+}
+
 // Register a new RpcService to handle inbound requests.
 Status Messenger::RegisterService(
     const std::string& service_name, const scoped_refptr<RpcService>& service) {
@@ -425,6 +464,10 @@ void Messenger::ShutdownThreadPools() {
   if (high_priority_thread_pool) {
     high_priority_thread_pool->Shutdown();
   }
+  auto work_stealing_thread_pool = work_stealing_thread_pool_.get();
+  if (work_stealing_thread_pool) {
+    work_stealing_thread_pool->Shutdown();
+  }
 }
 
 void Messenger::UnregisterAllServices() {
@@ -531,7 +574,8 @@ const std::shared_ptr<MemTracker>& Messenger::parent_mem_tracker() {
 }
 
 void Messenger::RegisterInboundSocket(
-    const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote) {
+    const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote,
+    std::optional<size_t> shard) {
   if (TEST_ShouldArtificiallyRejectIncomingCallsFrom(remote.address())) {
     auto status = new_socket->Close();
     VLOG(1) << "TEST: Rejected connection from " << remote
@@ -550,8 +594,15 @@ void Messenger::RegisterInboundSocket(
     return;
   }
 
-  int idx = num_connections_accepted_.fetch_add(1) % num_connections_to_server_;
-  Reactor *reactor = RemoteToReactor(remote, idx);
+  Reactor* reactor;
+  if (shard && *shard < reactors_.size()) {
+    // The connection was accepted by the listening socket of this reactor, so the kernel already
+    // balanced it, and its packets are likely processed on the reactor's cpu.
+    reactor = reactors_[*shard].get();
+  } else {
+    int idx = num_connections_accepted_.fetch_add(1) % num_connections_to_server_;
+    reactor = RemoteToReactor(remote, idx);
+  }
   reactor->RegisterInboundSocket(new_socket, *receive_buffer_size, remote, factory);
 }
 
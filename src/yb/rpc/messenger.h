@@ -36,6 +36,7 @@
 #include <atomic>
 #include <list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -279,6 +280,9 @@ class Messenger : public ProxyContext {
 
   rpc::ThreadPool& ThreadPool(ServicePriority priority = ServicePriority::kNormal);
 
+  // Thread pool with per worker task deques and work stealing, for services that opt into it.
+  rpc::ThreadPool& WorkStealingThreadPool();
+
   const std::shared_ptr<RpcMetrics>& rpc_metrics() override {
     return rpc_metrics_;
   }
@@ -320,7 +324,8 @@ class Messenger : public ProxyContext {
 
   // Take ownership of the socket via Socket::Release
   void RegisterInboundSocket(
-      const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote);
+      const ConnectionContextFactoryPtr& factory, Socket *new_socket, const Endpoint& remote,
+      std::optional<size_t> shard);
 
   bool TEST_ShouldArtificiallyRejectOutgoingCallsTo(const IpAddress &remote);
 
@@ -379,6 +384,10 @@ class Messenger : public ProxyContext {
   // This could be used for high-priority services such as Consensus.
   AtomicUniquePtr<rpc::ThreadPool> high_priority_thread_pool_;
 
+  std::mutex mutex_work_stealing_thread_pool_;
+
+  AtomicUniquePtr<rpc::ThreadPool> work_stealing_thread_pool_;
+
   std::unique_ptr<DnsResolver> resolver_;
 
   std::shared_ptr<RpcMetrics> rpc_metrics_;
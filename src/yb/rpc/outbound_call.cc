@@ -221,7 +221,12 @@ Status OutboundCall::SetRequestParam(AnyMessageConstPtr req, const MemTrackerPtr
   size_t timeout_ms_size = Output::VarintSize32(timeout_ms);
   auto serialized_remote_method = remote_method_.serialized();
 
-  size_t header_pb_len = 1 + call_id_size + serialized_remote_method.size() + 1 + timeout_ms_size;
+  // Priority class is omitted for interactive calls, to keep their header unchanged.
+  auto priority_class = static_cast<uint32_t>(to_underlying(controller_->priority_class()));
+  size_t priority_class_size = priority_class ? 1 + Output::VarintSize32(priority_class) : 0;
+
+  size_t header_pb_len = 1 + call_id_size + serialized_remote_method.size() + 1 + timeout_ms_size +
+                         priority_class_size;
   size_t header_size =
       kMsgLengthPrefixLength                            // Int prefix for the total length.
       + CodedOutputStream::VarintSize32(
@@ -245,6 +250,10 @@ Status OutboundCall::SetRequestParam(AnyMessageConstPtr req, const MemTrackerPtr
   dst += serialized_remote_method.size();
   dst = CodedOutputStream::WriteTagToArray(RequestHeader::kTimeoutMillisFieldNumber << 3, dst);
   dst = Output::WriteVarint32ToArray(timeout_ms, dst);
+  if (priority_class) {
+    dst = Output::WriteTagToArray(RequestHeader::kPriorityClassFieldNumber << 3, dst);
+    dst = Output::WriteVarint32ToArray(priority_class, dst);
+  }
 
   DCHECK_EQ(dst - buffer_.udata(), header_size);
 
@@ -563,6 +572,9 @@ Status OutboundCall::InitHeader(RequestHeader* header) {
   if (!IsFinished()) {
     header->set_timeout_millis(VERIFY_RESULT(TimeoutMs()));
   }
+  if (controller_->priority_class() != RpcPriorityClass::kInteractive) {
+    header->set_priority_class(to_underlying(controller_->priority_class()));
+  }
   return Status::OK();
 }
 
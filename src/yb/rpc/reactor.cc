@@ -33,6 +33,8 @@
 #include "yb/rpc/reactor.h"
 
 #include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <sys/types.h>
 
@@ -49,9 +51,11 @@
 
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stringprintf.h"
+#include "yb/gutil/sysinfo.h"
 
 #include "yb/rpc/connection.h"
 #include "yb/rpc/connection_context.h"
+#include "yb/rpc/io_uring_sender.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/rpc/rpc_introspection.pb.h"
@@ -89,6 +93,16 @@ DECLARE_int32(socket_receive_buffer_size);
 DEFINE_RUNTIME_bool(reactor_check_current_thread, true,
                     "Enforce the requirement that operations that require running on a reactor "
                     "thread are always running on the correct reactor thread.");
+DEFINE_NON_RUNTIME_bool(rpc_pin_reactor_threads, false,
+                        "Pin each reactor thread to its own cpu, so connections served by a "
+                        "reactor and calls handled inline on it stay on the same core.");
+TAG_FLAG(rpc_pin_reactor_threads, advanced);
+DEFINE_NON_RUNTIME_bool(rpc_io_uring_send, false,
+                        "Submit sends of all connections of a reactor with a single io_uring_enter "
+                        "per loop iteration, instead of a sendmsg per connection. Falls back to "
+                        "sendmsg when io_uring is not available. Not used with zero copy send.");
+TAG_FLAG(rpc_io_uring_send, advanced);
+
 namespace yb {
 namespace rpc {
 
@@ -126,6 +140,8 @@ inline bool HasReactorStartedClosing(ReactorState state) {
   return state == ReactorState::kClosing || state == ReactorState::kClosed;
 }
 
+thread_local Reactor* current_reactor_ = nullptr;
+
 size_t PatchReceiveBufferSize(size_t receive_buffer_size) {
   return std::max<size_t>(
       64_KB, FLAGS_rpc_read_buffer_size ? FLAGS_rpc_read_buffer_size : receive_buffer_size);
@@ -219,6 +235,7 @@ Reactor::Reactor(Messenger* messenger,
                  int index,
                  const MessengerBuilder &bld)
     : messenger_(*messenger),
+      index_(static_cast<size_t>(index)),
       name_(StringPrintf("%s_R%03d", messenger->name().c_str(), index)),
       log_prefix_(name_ + ": "),
       loop_(kDefaultLibEvFlags),
@@ -269,6 +286,22 @@ Status Reactor::Init() {
   timer_.start(ToSeconds(coarse_timer_granularity_),
                ToSeconds(coarse_timer_granularity_));
 
+  // The prepare watcher is started only when some connection has coalesced writes to flush.
+  flush_prepare_.set(loop_);
+  flush_prepare_.set<Reactor, &Reactor::FlushHandler>(this);
+
+  if (FLAGS_rpc_io_uring_send) {
+    auto sender = IoUringSender::Create(&loop_, messenger_.metric_entity(), [this] {
+      flush_prepare_.start();
+    });
+    if (sender.ok()) {
+      io_uring_sender_ = std::move(*sender);
+    } else {
+      LOG_WITH_PREFIX(WARNING) << "Failed to create io_uring sender, using sendmsg: "
+                               << sender.status();
+    }
+  }
+
   // Create Reactor thread.
   const std::string group_name = messenger_.name() + "_reactor";
   return yb::Thread::Create(group_name, group_name, &Reactor::RunThread, this, &thread_);
@@ -333,6 +366,13 @@ void Reactor::ShutdownInternal() {
   }
   server_conns_.clear();
 
+  flush_prepare_.stop();
+  connections_to_flush_.clear();
+
+  if (io_uring_sender_) {
+    io_uring_sender_->Shutdown();
+  }
+
   // Abort any scheduled tasks.
   //
   // These won't be found in the Reactor's list of pending tasks
@@ -540,6 +580,30 @@ ConnectionPtr Reactor::AssignOutboundCall(const OutboundCallPtr& call) {
   return conn;
 }
 
+void Reactor::ScheduleConnectionFlush(ConnectionPtr conn) {
+  if (connections_to_flush_.empty()) {
+    flush_prepare_.start();
+  }
+  connections_to_flush_.push_back(std::move(conn));
+}
+
+void Reactor::FlushHandler(ev::prepare &watcher, int revents) {
+  // Preparing io_uring sends could complete skipped data and queue more writes, so flush until
+  // there is nothing left, since watcher started from this handler would be invoked only after the
+  // loop blocks for new events.
+  do {
+    flushing_connections_.swap(connections_to_flush_);
+    for (const auto& conn : flushing_connections_) {
+      conn->FlushCoalescedWrites();
+    }
+    flushing_connections_.clear();
+    if (io_uring_sender_) {
+      io_uring_sender_->Flush();
+    }
+  } while (!connections_to_flush_.empty());
+  flush_prepare_.stop();
+}
+
 // Handles timer events.  The periodic timer:
 //
 // 1. updates Reactor::cur_time_
@@ -611,6 +675,29 @@ bool Reactor::IsCurrentThread() const {
   return thread_.get() == yb::Thread::current_thread();
 }
 
+Reactor* Reactor::Current() {
+  return current_reactor_;
+}
+
+void PinCurrentThread(int cpu, const std::string& log_prefix) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  auto res = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (res != 0) {
+    LOG(WARNING) << log_prefix << "Failed to pin thread to cpu " << cpu << ": " << res;
+  }
+#endif
+}
+
+int ReactorCpu(size_t reactor_index) {
+  if (!FLAGS_rpc_pin_reactor_threads) {
+    return -1;
+  }
+  return static_cast<int>(reactor_index % static_cast<size_t>(base::NumCPUs()));
+}
+
 ReactorThreadRoleGuard Reactor::CheckCurrentThread() const NO_THREAD_SAFETY_ANALYSIS {
   if (ShouldCheckCurrentThread()) {
     CHECK_EQ(thread_.get(), yb::Thread::current_thread())
@@ -626,6 +713,11 @@ ReactorThreadRoleGuard Reactor::CheckCurrentThread() const NO_THREAD_SAFETY_ANAL
 void Reactor::RunThread() {
   ThreadRestrictions::SetWaitAllowed(false);
   ThreadRestrictions::SetIOAllowed(false);
+  current_reactor_ = this;
+  auto cpu = ReactorCpu(index_);
+  if (cpu >= 0) {
+    PinCurrentThread(cpu, LogPrefix());
+  }
   DVLOG_WITH_PREFIX(6) << "Calling Reactor::RunThread()...";
   loop_.run(/* flags */ 0);
   VLOG_WITH_PREFIX(1) << "thread exiting.";
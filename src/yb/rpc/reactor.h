@@ -89,6 +89,7 @@ constexpr unsigned int kDefaultLibEvFlags = ev::AUTO;
 typedef std::list<ConnectionPtr> ConnectionList;
 
 class DumpRunningRpcsRequestPB;
+class IoUringSender;
 class DumpRunningRpcsResponsePB;
 class Messenger;
 class MessengerBuilder;
@@ -116,6 +117,13 @@ YB_DEFINE_ENUM(ReactorState,
 
 class DelayedTask;
 
+// Returns the cpu that reactor with the specified index is pinned to, or -1 if reactor threads
+// are not pinned.
+int ReactorCpu(size_t reactor_index);
+
+// Pins the current thread to the specified cpu.
+void PinCurrentThread(int cpu, const std::string& log_prefix);
+
 class Reactor {
  public:
   Reactor(Messenger* messenger, int index, const MessengerBuilder &bld);
@@ -168,6 +176,17 @@ class Reactor {
   // Return true if this reactor thread is the thread currently running.
   bool IsCurrentThread() const EXCLUDES_REACTOR_THREAD;
 
+  // Returns reactor whose thread is currently running, or nullptr if it is not a reactor thread.
+  static Reactor* Current();
+
+  size_t index() const { return index_; }
+
+  // Returns sender that submits sends of this reactor connections via io_uring, or nullptr if
+  // rpc_io_uring_send is not set or io_uring is not available.
+  IoUringSender* io_uring_sender() const {
+    return io_uring_sender_.get();
+  }
+
   // Checks that the current thread is this reactor's thread. The check is always performed in
   // debug mode, and in release mode only if FLAGS_reactor_check_current_thread is set.
   ReactorThreadRoleGuard CheckCurrentThread() const ACQUIRE(ReactorThreadRole::kReactor);
@@ -264,6 +283,9 @@ class Reactor {
 
   void CheckReadyToStop() ON_REACTOR_THREAD;
 
+  // Registers connection to flush its coalesced writes at the end of the current loop iteration.
+  void ScheduleConnectionFlush(ConnectionPtr conn) ON_REACTOR_THREAD;
+
   template<class F>
   Status RunOnReactorThread(const F& f, const SourceLocation& source_location)
       EXCLUDES_REACTOR_THREAD;
@@ -276,6 +298,10 @@ class Reactor {
   // libev callback for handling timer events in our libev thread.
   void TimerHandler(ev::timer &watcher, int revents) ON_REACTOR_THREAD; // NOLINT
 
+  // libev callback invoked before the loop blocks for new events, i.e. after all events of the
+  // current iteration were handled. Flushes coalesced writes.
+  void FlushHandler(ev::prepare &watcher, int revents) ON_REACTOR_THREAD; // NOLINT
+
   // ----------------------------------------------------------------------------------------------
   // Fields set in the constructor
   // ----------------------------------------------------------------------------------------------
@@ -283,6 +309,8 @@ class Reactor {
   // parent messenger
   Messenger& messenger_;
 
+  const size_t index_;
+
   const std::string name_;
 
   const std::string log_prefix_;
@@ -314,6 +342,11 @@ class Reactor {
   // Handles the periodic timer.
   ev::timer timer_;
 
+  // Started while there are connections with coalesced writes, see FlushHandler.
+  ev::prepare flush_prepare_;
+
+  std::unique_ptr<IoUringSender> io_uring_sender_;
+
   // ----------------------------------------------------------------------------------------------
   // Fields protected by pending_tasks_mtx_
   // ----------------------------------------------------------------------------------------------
@@ -380,6 +413,12 @@ class Reactor {
   // ProcessOutboundQueue is executing. An optimization to avoid memory allocation.
   std::vector<ConnectionPtr> processing_connections_ GUARDED_BY_REACTOR_THREAD;
 
+  // Connections that have coalesced writes to flush at the end of the loop iteration.
+  std::vector<ConnectionPtr> connections_to_flush_ GUARDED_BY_REACTOR_THREAD;
+
+  // Connections being flushed by FlushHandler. Member field to avoid memory allocation.
+  std::vector<ConnectionPtr> flushing_connections_ GUARDED_BY_REACTOR_THREAD;
+
   // Tasks moved from pending_tasks_ that are currently being processed by AsyncHandler.
   ReactorTasks pending_tasks_being_processed_ GUARDED_BY_REACTOR_THREAD;
 
@@ -50,6 +50,7 @@ bool RefinedStream::Idle(std::string* reason) {
 }
 
 void RefinedStream::DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) {
+  refiner_->DumpPB(req, resp);
   lower_stream_->DumpPB(req, resp);
 }
 
@@ -35,6 +35,9 @@ class StreamRefiner {
   virtual Result<ReadBufferFull> Read(StreamReadBuffer* out) = 0;
   virtual const Protocol* GetProtocol() = 0;
 
+  // Adds refiner specific information about the connection.
+  virtual void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) {}
+
   virtual std::string ToString() const = 0;
 
   virtual ~StreamRefiner() = default;
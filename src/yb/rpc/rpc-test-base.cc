@@ -383,6 +383,17 @@ class CalculatorService: public CalculatorServiceIf {
     context.RespondSuccess();
   }
 
+  void ProtobufArena(
+      const rpc_test::ProtobufArenaRequestPB* req, rpc_test::ProtobufArenaResponsePB* resp,
+      RpcContext context) override {
+    resp->set_request_in_arena(req->GetArena() != nullptr);
+    resp->set_response_in_arena(resp->GetArena() != nullptr);
+    for (auto it = req->values().rbegin(); it != req->values().rend(); ++it) {
+      resp->add_values(*it);
+    }
+    context.RespondSuccess();
+  }
+
   Result<rpc_test::TrivialResponsePB> Trivial(
       const rpc_test::TrivialRequestPB& req, CoarseTimePoint deadline) override {
     if (req.value() < 0) {
@@ -59,6 +59,7 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/env.h"
 #include "yb/util/format.h"
+#include "yb/util/io_uring.h"
 #include "yb/util/logging_test_util.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/result.h"
@@ -75,7 +76,11 @@ METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
 METRIC_DECLARE_counter(tcp_bytes_sent);
 METRIC_DECLARE_counter(tcp_bytes_received);
+METRIC_DECLARE_counter(tcp_send_syscalls);
 METRIC_DECLARE_counter(rpcs_timed_out_early_in_queue);
+METRIC_DECLARE_counter(rpc_io_uring_sends);
+METRIC_DECLARE_counter(rpc_io_uring_submits);
+METRIC_DECLARE_counter(rpcs_run_to_completion);
 
 DEFINE_UNKNOWN_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
@@ -83,13 +88,26 @@ DEFINE_UNKNOWN_int32(rpc_test_connection_keepalive_num_iterations, 1,
 DECLARE_bool(TEST_pause_calculator_echo_request);
 DECLARE_bool(binary_call_parser_reject_on_mem_tracker_hard_limit);
 DECLARE_bool(enable_rpc_keepalive);
+DECLARE_bool(rpc_coalesce_response_writes);
+DECLARE_bool(rpc_enable_zero_copy_send);
+DECLARE_bool(rpc_inbound_call_phase_metrics);
+DECLARE_bool(rpc_io_uring_send);
+DECLARE_bool(rpc_pin_reactor_threads);
+DECLARE_bool(rpc_reuseport_listener_per_reactor);
+DECLARE_bool(rpc_service_pool_priority_scheduling);
+DECLARE_uint32(rpc_service_pool_min_class_share_percent);
+DECLARE_bool(rpc_skip_redundant_socket_syscalls);
 DECLARE_int32(num_connections_to_server);
 DECLARE_int64(rpc_throttle_threshold_bytes);
 DECLARE_int32(stream_compression_algo);
 DECLARE_int64(memory_limit_hard_bytes);
+DECLARE_string(rpc_adaptive_concurrency_limit_services);
+DECLARE_string(rpc_run_to_completion_methods);
+DECLARE_string(stream_compression_dictionary_path);
 DECLARE_string(vmodule);
 DECLARE_uint64(rpc_connection_timeout_ms);
 DECLARE_uint64(rpc_read_buffer_size);
+DECLARE_uint64(rpc_zero_copy_send_threshold_bytes);
 
 using namespace std::chrono_literals;
 using std::string;
@@ -140,6 +158,64 @@ class TestRpc : public RpcTestBase {
         << "Client should have " << num_connections << " client connection(s)";
   }
 
+  // Blocks the single worker thread of the server with priority scheduling, then sends calls of
+  // the specified classes. Fills completed with classes of the calls in order of their completion.
+  void HandleBlockedCalls(
+      const std::vector<RpcPriorityClass>& classes, std::vector<RpcPriorityClass>* completed) {
+    ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_service_pool_priority_scheduling) = true;
+
+    TestServerOptions options;
+    options.n_worker_threads = 1;
+    HostPort server_addr;
+    StartTestServerWithGeneratedCode(&server_addr, options);
+
+    auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+    Proxy p(client_messenger.get(), server_addr);
+
+    rpc_test::SleepRequestPB sleep_req;
+    sleep_req.set_sleep_micros(500000);
+    rpc_test::SleepResponsePB sleep_resp;
+    RpcController sleep_controller;
+    sleep_controller.set_timeout(10s);
+    CountDownLatch sleep_latch(1);
+    p.AsyncRequest(
+        CalculatorServiceMethods::SleepMethod(), /* method_metrics= */ nullptr, sleep_req,
+        &sleep_resp, &sleep_controller, sleep_latch.CountDownCallback());
+    std::this_thread::sleep_for(100ms);
+
+    struct Call {
+      rpc_test::AddRequestPB req;
+      rpc_test::AddResponsePB resp;
+      RpcController controller;
+    };
+    std::vector<Call> calls(classes.size());
+    CountDownLatch latch(calls.size());
+    std::mutex mutex;
+    for (size_t i = 0; i != calls.size(); ++i) {
+      auto& call = calls[i];
+      auto priority_class = classes[i];
+      call.req.set_x(narrow_cast<int32_t>(i));
+      call.req.set_y(1);
+      call.controller.set_timeout(10s);
+      call.controller.set_priority_class(priority_class);
+      call.controller.set_invoke_callback_mode(InvokeCallbackMode::kReactorThread);
+      p.AsyncRequest(
+          CalculatorServiceMethods::AddMethod(), /* method_metrics= */ nullptr, call.req,
+          &call.resp, &call.controller, [&latch, &call, &mutex, completed, priority_class] {
+        ASSERT_OK(call.controller.status());
+        {
+          std::lock_guard lock(mutex);
+          completed->push_back(priority_class);
+        }
+        latch.CountDown();
+      });
+    }
+
+    sleep_latch.Wait();
+    latch.Wait();
+    ASSERT_OK(sleep_controller.status());
+  }
+
   template <class F>
   void RunPlainTest(const F& f, const TestServerOptions& server_options = TestServerOptions()) {
     RunTest(this, server_options, [this](const std::string& name, const MessengerOptions& options) {
@@ -481,6 +557,38 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(&p, sizes);
 }
 
+// Same as TestRpcSidecar, but always keep calling recvmsg/sendmsg until EAGAIN.
+TEST_F(TestRpc, TestRpcSidecarWithoutSyscallSkipping) {
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_skip_redundant_socket_syscalls) = false;
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  DoTestSidecar(&p, {123, 456});
+  DoTestSidecar(&p, {3_MB, 2_MB, 40_MB});
+}
+
+TEST_F(TestRpc, TestRpcSidecarZeroCopy) {
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_enable_zero_copy_send) = true;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_zero_copy_send_threshold_bytes) = 4_KB;
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  DoTestSidecar(&p, {123, 456});
+  DoTestSidecar(&p, {3_MB, 2_MB, 40_MB});
+
+  std::vector<size_t> sizes(20);
+  std::fill(sizes.begin(), sizes.end(), 16_KB);
+  DoTestSidecar(&p, sizes);
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   HostPort server_addr;
@@ -693,6 +801,52 @@ TEST_F(TestRpc, TestRpcHandlerLatencyMetric) {
   ASSERT_OK(GetHistogram(metric_entity(), METRIC_rpc_incoming_queue_time));
 }
 
+Result<HistogramPtr> GetHistogramByName(
+    const MetricEntityPtr& metric_entity, const std::string& name) {
+  for (const auto& [prototype, metric] : metric_entity->UnsafeMetricsMapForTests()) {
+    if (prototype->name() == name) {
+      return down_cast<Histogram*>(metric.get());
+    }
+  }
+  return STATUS_FORMAT(NotFound, "Metric $0 not found", name);
+}
+
+TEST_F(TestRpc, PhaseLatencyMetrics) {
+  const uint64_t sleep_micros = 20 * 1000;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_inbound_call_phase_metrics) = true;
+
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  RpcController controller;
+  rpc_test::SleepRequestPB req;
+  req.set_sleep_micros(sleep_micros);
+  req.set_deferred(true);
+  rpc_test::SleepResponsePB resp;
+  ASSERT_OK(p.SyncRequest(
+      CalculatorServiceMethods::SleepMethod(), /* method_metrics= */ nullptr, req, &resp,
+      &controller));
+
+  const std::string prefix = "handler_phase_latency_yb_rpc_test_CalculatorService_Sleep_";
+  // Phases are aggregated when the response is sent, that could happen after the client got it.
+  auto sent_histogram = ASSERT_RESULT(GetHistogramByName(
+      metric_entity(), prefix + "response_sent"));
+  ASSERT_OK(WaitFor(
+      [sent_histogram] { return sent_histogram->TotalCount() == 1; }, 5s,
+      "Phases recorded"));
+
+  auto handled_histogram = ASSERT_RESULT(GetHistogramByName(metric_entity(), prefix + "handled"));
+  ASSERT_EQ(handled_histogram->TotalCount(), 1);
+  ASSERT_GE(handled_histogram->MaxValueForTests(), sleep_micros);
+  // Sleep does not start Raft operations.
+  auto replicated_histogram = ASSERT_RESULT(GetHistogramByName(
+      metric_entity(), prefix + "replicated"));
+  ASSERT_EQ(replicated_histogram->TotalCount(), 0);
+}
+
 TEST_F(TestRpc, TestRpcCallbackDestroysMessenger) {
   auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
   HostPort bad_addr;
@@ -794,6 +948,232 @@ TEST_F(TestRpc, QueueTimeout) {
   ASSERT_EQ(counter->value(), kCalls - 1);
 }
 
+// Block the single worker thread, then send background calls followed by interactive calls.
+// Interactive calls should be handled first.
+TEST_F(TestRpc, PriorityScheduling) {
+  constexpr auto kCallsPerClass = 5;
+
+  std::vector<RpcPriorityClass> classes(kCallsPerClass, RpcPriorityClass::kBackground);
+  classes.resize(kCallsPerClass * 2, RpcPriorityClass::kInteractive);
+  std::vector<RpcPriorityClass> completed;
+  ASSERT_NO_FATALS(HandleBlockedCalls(classes, &completed));
+
+  ASSERT_EQ(completed.size(), classes.size());
+  for (size_t i = 0; i != completed.size(); ++i) {
+    ASSERT_EQ(completed[i], i < kCallsPerClass ? RpcPriorityClass::kInteractive
+                                               : RpcPriorityClass::kBackground) << i;
+  }
+}
+
+// Background calls should get their min share of handled calls while interactive calls are queued.
+TEST_F(TestRpc, PrioritySchedulingMinShare) {
+  constexpr auto kBackgroundCalls = 3;
+  constexpr auto kInteractiveCalls = 9;
+  // Each background call is handled after 3 interactive calls.
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_service_pool_min_class_share_percent) = 25;
+
+  std::vector<RpcPriorityClass> classes(kBackgroundCalls, RpcPriorityClass::kBackground);
+  classes.resize(kBackgroundCalls + kInteractiveCalls, RpcPriorityClass::kInteractive);
+  std::vector<RpcPriorityClass> completed;
+  ASSERT_NO_FATALS(HandleBlockedCalls(classes, &completed));
+
+  ASSERT_EQ(completed.size(), classes.size());
+  for (size_t i = 0; i != completed.size(); ++i) {
+    ASSERT_EQ(completed[i], i % 4 == 3 ? RpcPriorityClass::kBackground
+                                       : RpcPriorityClass::kInteractive) << i;
+  }
+}
+
+// Send many concurrent calls that are responded asynchronously, so the number of calls in handling
+// exceeds the concurrency limit of the service. Calls over the limit should be rejected as busy
+// with a retry hint.
+TEST_F(TestRpc, AdaptiveConcurrencyLimit) {
+  constexpr size_t kCalls = 200;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_adaptive_concurrency_limit_services) =
+      rpc_test::CalculatorServiceIf::static_service_name();
+
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  struct Call {
+    rpc_test::SleepRequestPB req;
+    rpc_test::SleepResponsePB resp;
+    RpcController controller;
+  };
+  std::vector<Call> calls(kCalls);
+  CountDownLatch latch(kCalls);
+  for (auto& call : calls) {
+    call.req.set_sleep_micros(500000);
+    call.req.set_deferred(true);
+    call.controller.set_timeout(10s);
+    p.AsyncRequest(
+        CalculatorServiceMethods::SleepMethod(), /* method_metrics= */ nullptr, call.req,
+        &call.resp, &call.controller, latch.CountDownCallback());
+  }
+  latch.Wait();
+
+  size_t succeeded = 0;
+  size_t rejected = 0;
+  for (auto& call : calls) {
+    auto status = call.controller.status();
+    if (status.ok()) {
+      ++succeeded;
+      continue;
+    }
+    ASSERT_TRUE(status.IsRemoteError()) << status;
+    const auto* err = call.controller.error_response();
+    ASSERT_NE(err, nullptr);
+    ASSERT_EQ(err->code(), ErrorStatusPB::ERROR_SERVER_TOO_BUSY);
+    ASSERT_GT(err->retry_after_ms(), 0);
+    ++rejected;
+  }
+  LOG(INFO) << "Succeeded: " << succeeded << ", rejected: " << rejected;
+  ASSERT_GT(succeeded, 0);
+  ASSERT_GT(rejected, 0);
+}
+
+// Handles calls by workers of pinned reactors, that accept connections on their own listening
+// sockets.
+TEST_F(TestRpc, RunToCompletion) {
+  constexpr size_t kClients = 8;
+  constexpr size_t kAddCalls = 10;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_pin_reactor_threads) = true;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_reuseport_listener_per_reactor) = true;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_run_to_completion_methods) = Format(
+      "$0.Add,$0.Sleep", rpc_test::CalculatorServiceIf::static_service_name());
+
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+
+  // Separate messengers use separate connections, so they are spread among reactors.
+  for (size_t i = 0; i != kClients; ++i) {
+    auto client_messenger = CreateAutoShutdownMessengerHolder(Format("Client$0", i));
+    Proxy p(client_messenger.get(), server_addr);
+    for (size_t call = 0; call != kAddCalls; ++call) {
+      ASSERT_OK(DoTestSyncCall(&p, CalculatorServiceMethods::AddMethod()));
+    }
+    {
+      // Sleep blocks, so it could be handled only because the reactor worker is a separate thread.
+      rpc_test::SleepRequestPB req;
+      req.set_sleep_micros(1000);
+      rpc_test::SleepResponsePB resp;
+      RpcController controller;
+      controller.set_timeout(10s);
+      ASSERT_OK(p.SyncRequest(
+          CalculatorServiceMethods::SleepMethod(), /* method_metrics= */ nullptr, req, &resp,
+          &controller));
+    }
+    {
+      // Echo is not listed, so it is still handled by the service thread pool.
+      rpc_test::EchoRequestPB req;
+      req.set_data("X");
+      rpc_test::EchoResponsePB resp;
+      RpcController controller;
+      controller.set_timeout(10s);
+      ASSERT_OK(p.SyncRequest(
+          CalculatorServiceMethods::EchoMethod(), /* method_metrics= */ nullptr, req, &resp,
+          &controller));
+    }
+  }
+
+  auto counter = ASSERT_RESULT(GetCounter(metric_entity(), METRIC_rpcs_run_to_completion));
+  ASSERT_EQ(counter->value(), static_cast<int64_t>(kClients * (kAddCalls + 1)));
+}
+
+// Sends a burst of count async Add calls and checks their responses.
+void RunConcurrentAddCalls(Proxy* proxy, size_t count) {
+  struct CallData {
+    rpc_test::AddRequestPB req;
+    rpc_test::AddResponsePB resp;
+    RpcController controller;
+  };
+  std::vector<CallData> calls(count);
+  CountDownLatch latch(count);
+  for (size_t i = 0; i != count; ++i) {
+    auto& call = calls[i];
+    call.req.set_x(narrow_cast<uint32_t>(i));
+    call.req.set_y(1);
+    call.controller.set_timeout(10s);
+    proxy->AsyncRequest(
+        CalculatorServiceMethods::AddMethod(), /* method_metrics= */ nullptr, call.req,
+        &call.resp, &call.controller, [&latch] { latch.CountDown(); });
+  }
+  latch.Wait();
+
+  for (size_t i = 0; i != count; ++i) {
+    ASSERT_OK(calls[i].controller.status());
+    ASSERT_EQ(calls[i].resp.result(), i + 1);
+  }
+}
+
+// Send a burst of async calls with response write coalescing enabled, responses should be
+// delivered with fewer send syscalls than calls.
+TEST_F(TestRpc, CoalesceResponseWrites) {
+  constexpr size_t kCalls = 100;
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_coalesce_response_writes) = true;
+
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+
+  // Client has its own metric entity, so server counters track only responses.
+  MetricRegistry client_metric_registry;
+  auto client_messenger = rpc::CreateAutoShutdownMessengerHolder(ASSERT_RESULT(
+      CreateMessengerBuilder("Client").set_metric_entity(
+          METRIC_ENTITY_server.Instantiate(&client_metric_registry, "test.rpc_client")).Build()));
+  Proxy p(client_messenger.get(), server_addr);
+
+  ASSERT_NO_FATALS(RunConcurrentAddCalls(&p, kCalls));
+
+  auto syscalls = ASSERT_RESULT(GetCounter(metric_entity(), METRIC_tcp_send_syscalls));
+  auto bytes_sent = ASSERT_RESULT(GetCounter(metric_entity(), METRIC_tcp_bytes_sent));
+  LOG(INFO) << "Send syscalls: " << syscalls->value() << ", bytes sent: " << bytes_sent->value();
+  ASSERT_GT(syscalls->value(), 0);
+  ASSERT_LT(syscalls->value(), static_cast<int64_t>(kCalls));
+  ASSERT_GE(bytes_sent->value(), syscalls->value());
+}
+
+// Responses should be sent via io_uring, including a response that does not fit into the socket
+// send buffer, so it is sent by several submissions.
+TEST_F(TestRpc, IoUringSend) {
+  constexpr size_t kCalls = 100;
+  if (!IoUring::Create(8).ok()) {
+    LOG(INFO) << "io_uring is not available, skipping test";
+    return;
+  }
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_rpc_io_uring_send) = true;
+
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  ASSERT_NO_FATALS(RunConcurrentAddCalls(&p, kCalls));
+
+  rpc_test::EchoRequestPB req;
+  req.set_data(std::string(4_MB, 'X'));
+  rpc_test::EchoResponsePB resp;
+  RpcController controller;
+  controller.set_timeout(30s);
+  ASSERT_OK(p.SyncRequest(
+      CalculatorServiceMethods::EchoMethod(), /* method_metrics= */ nullptr, req, &resp,
+      &controller));
+  ASSERT_EQ(resp.data(), req.data());
+
+  auto sends = ASSERT_RESULT(GetCounter(metric_entity(), METRIC_rpc_io_uring_sends));
+  auto submits = ASSERT_RESULT(GetCounter(metric_entity(), METRIC_rpc_io_uring_submits));
+  auto syscalls = ASSERT_RESULT(GetCounter(metric_entity(), METRIC_tcp_send_syscalls));
+  LOG(INFO) << "io_uring sends: " << sends->value() << ", submits: " << submits->value()
+            << ", send syscalls: " << syscalls->value();
+  ASSERT_GT(sends->value(), 0);
+  ASSERT_GE(sends->value(), submits->value());
+  // All server sends should bypass sendmsg.
+  ASSERT_EQ(syscalls->value(), 0);
+}
+
 struct DisconnectShare {
   Proxy proxy;
   size_t left;
@@ -1221,8 +1601,16 @@ class TestRpcCompression : public RpcTestBase, public testing::WithParamInterfac
   void SetUp() override {
     FLAGS_stream_compression_algo = GetParam();
     RpcTestBase::SetUp();
+    if (GetParam() == kZlibDictCompression) {
+      // Dictionary is loaded once per process, so all tests should use the same one.
+      auto path = GetTestPath("compression_dictionary");
+      ASSERT_OK(WriteStringToFile(Env::Default(), std::string(1_KB, 'Y'), path));
+      FLAGS_stream_compression_dictionary_path = path;
+    }
   }
 
+  static constexpr int kZlibDictCompression = 4;
+
  protected:
   std::unique_ptr<Messenger> CreateCompressedMessenger(
       const std::string& name, const MessengerOptions& options = kDefaultClientMessengerOptions) {
@@ -1315,11 +1703,12 @@ std::string CompressionName(const testing::TestParamInfo<int>& info) {
     case 1: return "Zlib";
     case 2: return "Snappy";
     case 3: return "LZ4";
+    case 4: return "ZlibDict";
   }
   return Format("Unknown compression $0", info.param);
 }
 
-INSTANTIATE_TEST_CASE_P(, TestRpcCompression, testing::Range(1, 4), CompressionName);
+INSTANTIATE_TEST_CASE_P(, TestRpcCompression, testing::Range(1, 5), CompressionName);
 
 class TestRpcSecureCompression : public TestRpcSecure {
  public:
@@ -104,7 +104,15 @@ bool RpcRetrier::HandleResponse(
     if (err &&
         err->has_code() &&
         err->code() == ErrorStatusPB::ERROR_SERVER_TOO_BUSY) {
-      auto status = DelayedRetry(rpc, controller_status, BackoffStrategy::kExponential);
+      Status status;
+      if (err->has_retry_after_ms()) {
+        // Server knows better how long it would stay overloaded, so use its hint instead of
+        // exponential backoff.
+        retry_delay_ = MonoDelta::FromMilliseconds(err->retry_after_ms());
+        status = DoDelayedRetry(rpc, controller_status);
+      } else {
+        status = DelayedRetry(rpc, controller_status, BackoffStrategy::kExponential);
+      }
       if (!status.ok()) {
         *out_status = status;
         return false;
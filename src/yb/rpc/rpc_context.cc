@@ -220,6 +220,10 @@ Trace* RpcContext::trace() {
   return call_->trace();
 }
 
+InboundCallPtr RpcContext::inbound_call() const {
+  return call_;
+}
+
 void RpcContext::EnsureTraceCreated() {
   return call_->EnsureTraceCreated();
 }
@@ -35,6 +35,8 @@
 
 #include <boost/type_traits/is_detected.hpp>
 
+#include <google/protobuf/arena.h>
+
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/rpc/serialization.h"
 #include "yb/rpc/service_if.h"
@@ -105,6 +107,32 @@ class RpcCallPBParamsImpl : public RpcCallPBParams {
   Resp resp_;
 };
 
+// Allocates request and response in the protobuf arena of the call, so nested messages and strings
+// of the parsed request share a few arena blocks instead of being allocated one by one.
+template <class Req, class Resp>
+class RpcCallPBArenaParamsImpl : public RpcCallPBParams {
+ public:
+  using RequestType = Req;
+  using ResponseType = Resp;
+
+  RpcCallPBArenaParamsImpl()
+      : req_(google::protobuf::Arena::CreateMessage<Req>(&arena_)),
+        resp_(google::protobuf::Arena::CreateMessage<Resp>(&arena_)) {}
+
+  Req& request() override {
+    return *req_;
+  }
+
+  Resp& response() override {
+    return *resp_;
+  }
+
+ private:
+  google::protobuf::Arena arena_;
+  Req* req_;
+  Resp* resp_;
+};
+
 class RpcCallLWParams : public RpcCallParams {
  public:
   Result<size_t> ParseRequest(Slice param, const RefCntBuffer& buffer) override;
@@ -199,6 +227,9 @@ class RpcContext {
   // Return the trace buffer for this call.
   Trace* trace();
 
+  // Return the call, so code that continues handling it asynchronously could record its phases.
+  InboundCallPtr inbound_call() const;
+
   // Ensure that this call has a trace associated with it.
   void EnsureTraceCreated();
 
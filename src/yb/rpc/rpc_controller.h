@@ -137,6 +137,10 @@ class RpcController {
 
   InvokeCallbackMode invoke_callback_mode() { return invoke_callback_mode_; }
 
+  // Sets scheduling class of the call, used by the server to order queued calls.
+  void set_priority_class(RpcPriorityClass priority_class) { priority_class_ = priority_class; }
+  RpcPriorityClass priority_class() const { return priority_class_; }
+
   // Return the configured timeout.
   MonoDelta timeout() const;
 
@@ -162,6 +166,7 @@ class RpcController {
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
   InvokeCallbackMode invoke_callback_mode_ = InvokeCallbackMode::kThreadPoolNormal;
+  RpcPriorityClass priority_class_ = RpcPriorityClass::kInteractive;
 
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
@@ -84,6 +84,7 @@ struct OutboundCallMetrics;
 struct OutboundMethodMetrics;
 struct ProcessCallsResult;
 struct ReactorMetrics;
+struct InboundCallPhaseMetrics;
 struct RpcMethodMetrics;
 struct RpcMetrics;
 
@@ -143,6 +144,34 @@ using ResponseCallback = std::function<void()>;
 
 YB_DEFINE_ENUM(ServicePriority, (kNormal)(kHigh));
 
+// Scheduling class of a call. Queued calls of a lower class are handled by the service pool
+// before calls of a higher class, except that each class keeps a min share of handled calls.
+YB_DEFINE_ENUM(RpcPriorityClass,
+    // Latency sensitive user requests, e.g. point reads and writes.
+    (kInteractive)
+    // Throughput oriented user requests, e.g. large scans.
+    (kBatch)
+    // Internal work that could be delayed, e.g. remote bootstrap and backfill.
+    (kBackground));
+
+// Phases of inbound call processing, whose timestamps are recorded by InboundCall.
+// Phases that do not apply to a call, e.g. Raft replication for reads, are skipped.
+YB_DEFINE_ENUM(InboundCallPhase,
+    // Request was read from the socket and its header was parsed on the reactor thread.
+    (kParsed)
+    // Call was taken from the service queue and passed to its handler.
+    (kHandlingStarted)
+    // Raft operation started by the call was replicated, including the WAL append.
+    (kReplicated)
+    // Raft operation started by the call was applied to the tablet.
+    (kApplied)
+    // Handler produced the response.
+    (kHandlingCompleted)
+    // Response was serialized and queued to the connection.
+    (kResponseQueued)
+    // Response was written to the socket.
+    (kResponseSent));
+
 // Specifies how to run callback for async outbound call.
 YB_DEFINE_ENUM(InvokeCallbackMode,
     // On reactor thread.
@@ -1029,6 +1029,49 @@ TEST_F(RpcStubTest, Lightweight) {
   ASSERT_STR_EQ(AsString(resp.short_debug_string()), req_str);
 }
 
+// Local call from protobuf proxy to the service that uses lightweight messages, should pass
+// request and response through their serialized form.
+TEST_F(RpcStubTest, LightweightLocalCall) {
+  ProxyCache local_proxy_cache(server_messenger());
+  CalculatorServiceProxy proxy(&local_proxy_cache, HostPort());
+
+  RpcController controller;
+  rpc_test::LightweightRequestPB req;
+  req.set_i32(RandomUniformInt<int32_t>());
+  req.set_str(RandomHumanReadableString(32));
+  req.set_bytes(RandomHumanReadableString(32));
+  for (int i = 0; i != 7; ++i) {
+    req.mutable_rstr()->Add(RandomHumanReadableString(32));
+  }
+  Generate(req.mutable_message());
+
+  rpc_test::LightweightResponsePB resp;
+  ASSERT_OK(proxy.Lightweight(req, &resp, &controller));
+
+  ASSERT_EQ(resp.i32(), -req.i32());
+  ASSERT_EQ(resp.bytes(), req.str());
+  ASSERT_EQ(resp.str(), req.bytes());
+  ASSERT_EQ(AsString(resp.rstr()), ReversedAsString(req.rstr()));
+  ASSERT_EQ(resp.message().str(), ">" + req.message().str() + "<");
+}
+
+TEST_F(RpcStubTest, ProtobufArena) {
+  CalculatorServiceProxy proxy(proxy_cache_.get(), server_hostport_);
+
+  RpcController controller;
+  rpc_test::ProtobufArenaRequestPB req;
+  for (int i = 0; i != 10; ++i) {
+    req.add_values(RandomHumanReadableString(32));
+  }
+
+  rpc_test::ProtobufArenaResponsePB resp;
+  ASSERT_OK(proxy.ProtobufArena(req, &resp, &controller));
+
+  ASSERT_TRUE(resp.request_in_arena());
+  ASSERT_TRUE(resp.response_in_arena());
+  ASSERT_EQ(AsString(resp.values()), ReversedAsString(req.values()));
+}
+
 TEST_F(RpcStubTest, CustomServiceName) {
   SendSimpleCall();
 
@@ -32,6 +32,8 @@
 
 #include "yb/rpc/serialization.h"
 
+#include <algorithm>
+
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/message.h>
 
@@ -187,6 +189,15 @@ Status ParseHeader(
           return STATUS(Corruption, "Unable to decode timeout_ms field");
         }
         break;
+      case RequestHeader::kPriorityClassFieldNumber: {
+        uint32_t temp;
+        if (!in->ReadVarint32(&temp)) {
+          return STATUS(Corruption, "Unable to decode priority_class field");
+        }
+        // Unknown classes from newer clients are handled as the lowest known class.
+        parsed_header->priority_class = static_cast<RpcPriorityClass>(
+            std::min<uint32_t>(temp, kRpcPriorityClassMapSize - 1));
+        } break;
       default: {
         if (!SkipField(tag & 7, in)) {
           return STATUS_FORMAT(Corruption, "Unable to skip: $0", tag);
@@ -302,6 +313,9 @@ void ParsedRequestHeader::ToPB(RequestHeader* out) const {
   if (timeout_ms) {
     out->set_timeout_millis(timeout_ms);
   }
+  if (priority_class != RpcPriorityClass::kInteractive) {
+    out->set_priority_class(to_underlying(priority_class));
+  }
   auto parsed_remote_method = ParseRemoteMethod(remote_method);
   if (parsed_remote_method.ok()) {
     out->mutable_remote_method()->set_service_name(parsed_remote_method->service.ToBuffer());
@@ -73,6 +73,7 @@ struct ParsedRequestHeader {
   Slice remote_method;
   int32_t call_id = 0;
   uint32_t timeout_ms = 0;
+  RpcPriorityClass priority_class = RpcPriorityClass::kInteractive;
 
   std::string RemoteMethodAsString() const;
   void ToPB(RequestHeader* out) const;
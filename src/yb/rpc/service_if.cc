@@ -33,10 +33,20 @@
 
 #include <string>
 
+#include "yb/rpc/inbound_call.h"
+
+#include "yb/util/flags.h"
+#include "yb/util/format.h"
+#include "yb/util/metric_entity.h"
 #include "yb/util/metrics.h"
 
 using std::string;
 
+DEFINE_NON_RUNTIME_bool(rpc_inbound_call_phase_metrics, false,
+    "Export per method histograms of time spent in each phase of inbound call processing, e.g. "
+    "queue, handler, Raft replication, apply and response send.");
+TAG_FLAG(rpc_inbound_call_phase_metrics, advanced);
+
 namespace yb {
 namespace rpc {
 
@@ -46,13 +56,63 @@ ServiceIf::~ServiceIf() {
 void ServiceIf::Shutdown() {
 }
 
+namespace {
+
+const char* PhaseMetricSuffix(InboundCallPhase phase) {
+  switch (phase) {
+    case InboundCallPhase::kParsed: return "parsed";
+    case InboundCallPhase::kHandlingStarted: return "queued";
+    case InboundCallPhase::kReplicated: return "replicated";
+    case InboundCallPhase::kApplied: return "applied";
+    case InboundCallPhase::kHandlingCompleted: return "handled";
+    case InboundCallPhase::kResponseQueued: return "response_queued";
+    case InboundCallPhase::kResponseSent: return "response_sent";
+  }
+  FATAL_INVALID_ENUM_VALUE(InboundCallPhase, phase);
+}
+
+} // namespace
+
+void InboundCallPhaseMetrics::Record(const InboundCall& call) const {
+  MonoDelta previous = MonoDelta::kZero;
+  for (auto phase : InboundCallPhaseList()) {
+    auto offset = call.PhaseOffset(phase);
+    if (!offset) {
+      continue;
+    }
+    phase_latency[to_underlying(phase)]->Increment((*offset - previous).ToMicroseconds());
+    previous = *offset;
+  }
+}
+
+std::shared_ptr<const InboundCallPhaseMetrics> InboundCallPhaseMetrics::Create(
+    const scoped_refptr<MetricEntity>& entity, const std::string& method_name) {
+  if (!FLAGS_rpc_inbound_call_phase_metrics || !entity) {
+    return nullptr;
+  }
+  auto result = std::make_shared<InboundCallPhaseMetrics>();
+  for (auto phase : InboundCallPhaseList()) {
+    auto name = Format("handler_phase_latency_$0_$1", method_name, PhaseMetricSuffix(phase));
+    auto description = Format(
+        "Microseconds spent by $0() RPC requests between the previous phase and $1 phase",
+        method_name, PhaseMetricSuffix(phase));
+    result->phase_latency[to_underlying(phase)] = entity->FindOrCreateHistogram(
+        std::make_unique<OwningHistogramPrototype>(
+            entity->prototype().name(), name, description, MetricUnit::kMicroseconds,
+            description, MetricLevel::kInfo, /* flags= */ 0, 60000000LU, 2,
+            ExportPercentiles::kTrue));
+  }
+  return result;
+}
+
 RpcMethodMetrics::RpcMethodMetrics() = default;
 
 RpcMethodMetrics::RpcMethodMetrics(const scoped_refptr<Counter>& request_bytes_,
                                    const scoped_refptr<Counter>& response_bytes_,
-                                   const scoped_refptr<Histogram>& handler_latency_)
+                                   const scoped_refptr<Histogram>& handler_latency_,
+                                   std::shared_ptr<const InboundCallPhaseMetrics> phase_latency_)
     : request_bytes(request_bytes_), response_bytes(response_bytes_),
-      handler_latency(handler_latency_) {
+      handler_latency(handler_latency_), phase_latency(std::move(phase_latency_)) {
 }
 
 RpcMethodMetrics::~RpcMethodMetrics() = default;
@@ -31,6 +31,8 @@
 //
 #pragma once
 
+#include <array>
+#include <memory>
 #include <string>
 
 #include <boost/functional/hash.hpp>
@@ -52,15 +54,30 @@ class Message;
 namespace yb {
 namespace rpc {
 
+// Per method histograms of time spent between consecutive phases of inbound call processing.
+struct InboundCallPhaseMetrics {
+  // Time from the previous phase reached by the call to the phase with this index.
+  std::array<scoped_refptr<Histogram>, kInboundCallPhaseMapSize> phase_latency;
+
+  // Records phases reached by the call, whose response was sent.
+  void Record(const InboundCall& call) const;
+
+  // Returns nullptr if rpc_inbound_call_phase_metrics is disabled.
+  static std::shared_ptr<const InboundCallPhaseMetrics> Create(
+      const scoped_refptr<MetricEntity>& entity, const std::string& method_name);
+};
+
 struct RpcMethodMetrics {
   scoped_refptr<Counter> request_bytes;
   scoped_refptr<Counter> response_bytes;
   scoped_refptr<Histogram> handler_latency;
+  std::shared_ptr<const InboundCallPhaseMetrics> phase_latency;
 
   RpcMethodMetrics();
   RpcMethodMetrics(const scoped_refptr<Counter>& request_bytes,
                    const scoped_refptr<Counter>& response_bytes,
-                   const scoped_refptr<Histogram>& handler_latency);
+                   const scoped_refptr<Histogram>& handler_latency,
+                   std::shared_ptr<const InboundCallPhaseMetrics> phase_latency = nullptr);
   RpcMethodMetrics(const RpcMethodMetrics&);
   ~RpcMethodMetrics();
 };
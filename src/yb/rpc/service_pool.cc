@@ -35,10 +35,15 @@
 #include <pthread.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <array>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <boost/asio/strand.hpp>
@@ -49,11 +54,16 @@
 
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/ref_counted.h"
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/thread_annotations.h"
 
+#include "yb/rpc/concurrency_limiter.h"
 #include "yb/rpc/inbound_call.h"
+#include "yb/rpc/reactor.h"
 #include "yb/rpc/scheduler.h"
 #include "yb/rpc/service_if.h"
+#include "yb/rpc/thread_pool.h"
 
 #include "yb/util/countdown_latch.h"
 #include "yb/util/flags.h"
@@ -80,12 +90,72 @@ TAG_FLAG(backpressure_recovery_period_ms, advanced);
 DEFINE_test_flag(bool, enable_backpressure_mode_for_testing, false,
             "For testing purposes. Enables the rpc's to be considered timed out in the queue even "
             "when we have not had any backpressure in the recent past.");
+DEFINE_NON_RUNTIME_bool(rpc_service_pool_priority_scheduling, false,
+    "Handle queued calls in order of their priority class and client deadline instead of "
+    "arrival order.");
+TAG_FLAG(rpc_service_pool_priority_scheduling, advanced);
+DEFINE_RUNTIME_int64(rpc_min_remaining_deadline_to_handle_ms, 2,
+    "With rpc_service_pool_priority_scheduling, fail queued calls that have less than the "
+    "specified amount of time (in ms) left before their client deadline without handling them.");
+TAG_FLAG(rpc_min_remaining_deadline_to_handle_ms, advanced);
+DEFINE_RUNTIME_uint32(rpc_service_pool_min_class_share_percent, 10,
+    "With rpc_service_pool_priority_scheduling, each priority class that has queued calls gets at "
+    "least the specified percent of dequeued calls, so batch and background calls are not starved "
+    "by a steady stream of interactive calls. 0 for strict priority order.");
+TAG_FLAG(rpc_service_pool_min_class_share_percent, advanced);
+DEFINE_NON_RUNTIME_string(rpc_adaptive_concurrency_limit_services, "",
+    "Comma separated list of services, e.g. yb.tserver.TabletServerService, that limit the number "
+    "of concurrently handled calls, adapting the limit to observed handling latency. Calls over "
+    "the limit are rejected as busy with a retry delay hint. Only supported for YB RPC services.");
+TAG_FLAG(rpc_adaptive_concurrency_limit_services, advanced);
+DEFINE_NON_RUNTIME_string(rpc_run_to_completion_methods, "",
+    "Comma separated list of methods, e.g. yb.tserver.TabletServerService.Read, that are handled "
+    "by a dedicated worker thread of the reactor that received the call, instead of the shared "
+    "service thread pool. With rpc_pin_reactor_threads the worker is pinned to the cpu of its "
+    "reactor. Ignored with rpc_service_pool_priority_scheduling.");
+TAG_FLAG(rpc_run_to_completion_methods, advanced);
 
 METRIC_DEFINE_coarse_histogram(server, rpc_incoming_queue_time,
                         "RPC Queue Time",
                         yb::MetricUnit::kMicroseconds,
                         "Number of microseconds incoming RPC requests spend in the worker queue");
 
+METRIC_DEFINE_coarse_histogram(server, rpc_incoming_queue_time_interactive,
+                        "RPC Queue Time for Interactive Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming interactive RPC requests spend in the "
+                        "worker queue");
+
+METRIC_DEFINE_coarse_histogram(server, rpc_incoming_queue_time_batch,
+                        "RPC Queue Time for Batch Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming batch RPC requests spend in the "
+                        "worker queue");
+
+METRIC_DEFINE_coarse_histogram(server, rpc_incoming_queue_time_background,
+                        "RPC Queue Time for Background Calls",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds incoming background RPC requests spend in the "
+                        "worker queue");
+
+METRIC_DEFINE_counter(server, rpcs_shed_in_queue,
+                      "RPC Queue Sheds",
+                      yb::MetricUnit::kRequests,
+                      "Number of RPCs that were failed without handling, because too little "
+                      "time was left before their deadline when they were dequeued.");
+
+METRIC_DEFINE_counter(server, rpcs_rejected_by_concurrency_limit,
+                      "RPCs Rejected by Concurrency Limit",
+                      yb::MetricUnit::kRequests,
+                      "Number of RPCs rejected because the adaptive concurrency limit of the "
+                      "service was reached.");
+
+METRIC_DEFINE_counter(server, rpcs_run_to_completion,
+                      "RPCs handled by reactor worker",
+                      yb::MetricUnit::kRequests,
+                      "Number of RPCs that were handled by the worker thread of the reactor that "
+                      "received them, bypassing the service thread pool.");
+
 METRIC_DEFINE_counter(server, rpcs_timed_out_in_queue,
                       "RPC Queue Timeouts",
                       yb::MetricUnit::kRequests,
@@ -132,6 +202,15 @@ class ServicePoolImpl final : public InboundCallHandler {
         rpcs_timed_out_early_in_queue_(
             METRIC_rpcs_timed_out_early_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
+        rpcs_shed_in_queue_(METRIC_rpcs_shed_in_queue.Instantiate(entity)),
+        rpcs_rejected_by_concurrency_limit_(
+            METRIC_rpcs_rejected_by_concurrency_limit.Instantiate(entity)),
+        rpcs_run_to_completion_(METRIC_rpcs_run_to_completion.Instantiate(entity)),
+        incoming_queue_time_by_class_{
+            METRIC_rpc_incoming_queue_time_interactive.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time_batch.Instantiate(entity),
+            METRIC_rpc_incoming_queue_time_background.Instantiate(entity)},
+        priority_scheduling_(FLAGS_rpc_service_pool_priority_scheduling),
         check_timeout_strand_(scheduler->io_service()),
         log_prefix_(Format("$0: ", service_->service_name())) {
 
@@ -145,6 +224,14 @@ class ServicePoolImpl final : public InboundCallHandler {
                   description, MetricUnit::kRequests, description, MetricLevel::kInfo)),
               static_cast<int64>(0) /* initial_value */);
 
+          if (UseConcurrencyLimiter(service_->service_name())) {
+            concurrency_limiter_ = std::make_unique<AdaptiveConcurrencyLimiter>();
+          }
+
+          if (!priority_scheduling_) {
+            run_to_completion_methods_ = RunToCompletionMethods(service_->service_name());
+          }
+
           LOG_WITH_PREFIX(INFO) << "yb::rpc::ServicePoolImpl created at " << this;
   }
 
@@ -155,6 +242,14 @@ class ServicePoolImpl final : public InboundCallHandler {
 
   void CompleteShutdown() {
     shutdown_complete_latch_.Wait();
+    {
+      std::lock_guard lock(reactor_workers_mutex_);
+      for (auto& worker : reactor_workers_) {
+        if (worker) {
+          worker->Shutdown();
+        }
+      }
+    }
     while (scheduled_tasks_.load(std::memory_order_acquire) != 0) {
       std::this_thread::sleep_for(10ms);
     }
@@ -193,6 +288,26 @@ class ServicePoolImpl final : public InboundCallHandler {
       ScheduleCheckTimeout(call_deadline);
     }
 
+    if (priority_scheduling_) {
+      // The task still goes to the thread pool, but when it runs it handles the best call from
+      // scheduled_calls_, which is not necessarily the call that this task was bound to.
+      std::lock_guard lock(scheduled_calls_mutex_);
+      scheduled_calls_[to_underlying(call->priority_class())].push(ScheduledCall {
+        .deadline = call_deadline,
+        .serial_no = ++scheduled_calls_serial_no_,
+        .call = call,
+      });
+    }
+
+    if (!run_to_completion_methods_.empty() && ShouldRunToCompletion(call->method_name())) {
+      auto* reactor = Reactor::Current();
+      if (reactor) {
+        rpcs_run_to_completion_->Increment();
+        ReactorWorker(reactor->index()).Enqueue(task);
+        return;
+      }
+    }
+
     thread_pool_.Enqueue(task);
   }
 
@@ -229,7 +344,8 @@ class ServicePoolImpl final : public InboundCallHandler {
         CoarseMonoClock::Now().time_since_epoch(), std::memory_order_release);
   }
 
-  void Failure(const InboundCallPtr& call, const Status& status) override {
+  void Failure(const InboundCallPtr& bound_call, const Status& status) override {
+    const auto& call = priority_scheduling_ ? PopScheduledCall(bound_call) : bound_call;
     if (!call->TryStartProcessing()) {
       return;
     }
@@ -247,16 +363,32 @@ class ServicePoolImpl final : public InboundCallHandler {
   }
 
   void Handle(InboundCallPtr incoming) override {
+    if (priority_scheduling_) {
+      incoming = PopScheduledCall(incoming);
+    }
     incoming->RecordHandlingStarted(incoming_queue_time_);
+    incoming_queue_time_by_class_[to_underlying(incoming->priority_class())]->Increment(
+        incoming->GetTimeInQueue().ToMicroseconds());
     ADOPT_TRACE(incoming->trace());
 
     const char* error_message;
+    Counter* metric = rpcs_timed_out_in_queue_.get();
     if (PREDICT_FALSE(incoming->ClientTimedOut())) {
       error_message = kTimedOutInQueue;
     } else if (PREDICT_FALSE(ShouldDropRequestDuringHighLoad(incoming))) {
       error_message = "The server is overloaded. Call waited in the queue past max_time_in_queue.";
+    } else if (PREDICT_FALSE(priority_scheduling_ && CannotMeetDeadline(*incoming))) {
+      error_message = "Call cannot be handled before its deadline";
+      metric = rpcs_shed_in_queue_.get();
     } else {
       if (incoming->TryStartProcessing()) {
+        if (concurrency_limiter_) {
+          if (!concurrency_limiter_->TryAcquire()) {
+            ConcurrencyLimitReached(incoming.get());
+            return;
+          }
+          incoming->set_completion_handler(this);
+        }
         TRACE_TO(incoming->trace(), "Handling call $0", AsString(incoming->method_name()));
         service_->Handle(std::move(incoming));
       }
@@ -269,10 +401,137 @@ class ServicePoolImpl final : public InboundCallHandler {
 
     // Respond as a failure, even though the client will probably ignore
     // the response anyway.
-    TimedOut(incoming.get(), error_message, rpcs_timed_out_in_queue_.get());
+    TimedOut(incoming.get(), error_message, metric);
   }
 
  private:
+  static bool UseConcurrencyLimiter(const std::string& service_name) {
+    if (FLAGS_rpc_adaptive_concurrency_limit_services.empty()) {
+      return false;
+    }
+    std::vector<std::string> services = strings::Split(
+        FLAGS_rpc_adaptive_concurrency_limit_services, ",", strings::SkipEmpty());
+    return std::find(services.begin(), services.end(), service_name) != services.end();
+  }
+
+  // Returns names of the methods of the specified service, listed in
+  // rpc_run_to_completion_methods.
+  static std::vector<std::string> RunToCompletionMethods(const std::string& service_name) {
+    std::vector<std::string> result;
+    if (FLAGS_rpc_run_to_completion_methods.empty()) {
+      return result;
+    }
+    std::vector<std::string> methods = strings::Split(
+        FLAGS_rpc_run_to_completion_methods, ",", strings::SkipEmpty());
+    for (const auto& method : methods) {
+      auto pos = method.rfind('.');
+      if (pos != std::string::npos && method.compare(0, pos, service_name) == 0) {
+        result.push_back(method.substr(pos + 1));
+      }
+    }
+    return result;
+  }
+
+  bool ShouldRunToCompletion(Slice method_name) const {
+    for (const auto& method : run_to_completion_methods_) {
+      if (method_name == Slice(method)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Returns single thread pool that handles run to completion calls received by the reactor with
+  // the specified index. Its thread is pinned to the cpu of this reactor, so the call stays on the
+  // same core, while the handler could still block, unlike on the reactor thread.
+  ThreadPool& ReactorWorker(size_t reactor_index) {
+    std::lock_guard lock(reactor_workers_mutex_);
+    if (reactor_workers_.size() <= reactor_index) {
+      reactor_workers_.resize(reactor_index + 1);
+    }
+    auto& worker = reactor_workers_[reactor_index];
+    if (!worker) {
+      worker = std::make_unique<ThreadPool>(ThreadPoolOptions {
+        .name = Format("$0-rtc-$1", service_->service_name(), reactor_index),
+        .max_workers = 1,
+      });
+      auto cpu = ReactorCpu(reactor_index);
+      if (cpu >= 0) {
+        worker->EnqueueFunctor([cpu, log_prefix = LogPrefix()] {
+          PinCurrentThread(cpu, log_prefix);
+        });
+      }
+    }
+    return *worker;
+  }
+
+  void CallHandlingCompleted(InboundCall* call, MonoDelta handling_time) override {
+    concurrency_limiter_->Release(handling_time);
+  }
+
+  void ConcurrencyLimitReached(InboundCall* call) {
+    const auto err_msg = Format(
+        "$0 request on $1 from $2 rejected, concurrency limit reached: $3",
+        call->method_name().ToBuffer(), service_->service_name(), call->remote_address(),
+        concurrency_limiter_->ToString());
+    YB_LOG_EVERY_N_SECS(WARNING, 3) << LogPrefix() << err_msg;
+    TRACE_TO(call->trace(), "Concurrency limit reached");
+    rpcs_rejected_by_concurrency_limit_->Increment();
+    call->RespondBusy(STATUS(ServiceUnavailable, err_msg), concurrency_limiter_->RetryAfter());
+  }
+
+  // Pops the call that should be handled next. Each task bound by Enqueue pops exactly one call,
+  // so the queues could not be all empty here.
+  InboundCallPtr PopScheduledCall(const InboundCallPtr& bound_call) {
+    std::lock_guard lock(scheduled_calls_mutex_);
+    auto class_idx = PickScheduledClass();
+    if (class_idx == scheduled_calls_.size()) {
+      LOG_WITH_PREFIX(DFATAL) << "No scheduled calls, while handling " << bound_call->ToString();
+      return bound_call;
+    }
+    auto& queue = scheduled_calls_[class_idx];
+    auto result = std::move(queue.top().call);
+    queue.pop();
+    return result;
+  }
+
+  // Returns the index of the class whose call should be handled next, or the number of classes
+  // when there are no queued calls. The highest class with queued calls is picked, unless a lower
+  // class was passed over so many times that it would get less than its min share. Every other
+  // class with queued calls is passed over by this pick.
+  size_t PickScheduledClass() REQUIRES(scheduled_calls_mutex_) {
+    const auto share_percent = GetAtomicFlag(&FLAGS_rpc_service_pool_min_class_share_percent);
+    const size_t max_skips = share_percent ? (100 + share_percent - 1) / share_percent - 1
+                                           : std::numeric_limits<size_t>::max();
+    auto result = scheduled_calls_.size();
+    for (size_t i = 0; i != scheduled_calls_.size(); ++i) {
+      if (scheduled_calls_[i].empty()) {
+        continue;
+      }
+      if (result == scheduled_calls_.size() ||
+          (skipped_picks_[i] >= max_skips && skipped_picks_[i] > skipped_picks_[result])) {
+        result = i;
+      }
+    }
+    for (size_t i = 0; i != scheduled_calls_.size(); ++i) {
+      if (i == result || scheduled_calls_[i].empty()) {
+        skipped_picks_[i] = 0;
+      } else {
+        ++skipped_picks_[i];
+      }
+    }
+    return result;
+  }
+
+  bool CannotMeetDeadline(const InboundCall& call) {
+    auto deadline = call.GetClientDeadline();
+    if (deadline == CoarseTimePoint::max()) {
+      return false;
+    }
+    return deadline - CoarseMonoClock::now() <
+           GetAtomicFlag(&FLAGS_rpc_min_remaining_deadline_to_handle_ms) * 1ms;
+  }
+
   void TimedOut(InboundCall* call, const char* error_message, Counter* metric) {
     if (call->RespondTimedOutIfPending(error_message)) {
       metric->Increment();
@@ -407,10 +666,15 @@ class ServicePoolImpl final : public InboundCallHandler {
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_timed_out_early_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
+  scoped_refptr<Counter> rpcs_shed_in_queue_;
+  scoped_refptr<Counter> rpcs_rejected_by_concurrency_limit_;
+  scoped_refptr<Counter> rpcs_run_to_completion_;
+  std::array<scoped_refptr<Histogram>, kRpcPriorityClassMapSize> incoming_queue_time_by_class_;
   scoped_refptr<AtomicGauge<int64_t>> rpcs_in_queue_;
   // Have to use CoarseDuration here, since CoarseTimePoint does not work with clang + libstdc++
   std::atomic<CoarseDuration> last_backpressure_at_{CoarseTimePoint().time_since_epoch()};
   std::atomic<int64_t> queued_calls_{0};
+  std::unique_ptr<AdaptiveConcurrencyLimiter> concurrency_limiter_;
 
   // It is too expensive to update timeout priority queue when each call is received.
   // So we are doing the following trick.
@@ -448,6 +712,36 @@ class ServicePoolImpl final : public InboundCallHandler {
 
   std::priority_queue<QueuedCheckDeadline> check_timeout_queue_;
 
+  const bool priority_scheduling_;
+
+  // Methods of this service that are handled by the worker of the reactor that received the call.
+  std::vector<std::string> run_to_completion_methods_;
+
+  std::mutex reactor_workers_mutex_;
+  std::vector<std::unique_ptr<ThreadPool>> reactor_workers_ GUARDED_BY(reactor_workers_mutex_);
+
+  struct ScheduledCall {
+    CoarseTimePoint deadline;
+    // Keeps FIFO order for calls with the same deadline, e.g. without deadline.
+    uint64_t serial_no;
+    // Mutable, so it could be moved out of the top of the priority queue.
+    mutable InboundCallPtr call;
+  };
+
+  // The call that should be handled first should be on top, i.e. be the greatest one.
+  friend bool operator<(const ScheduledCall& lhs, const ScheduledCall& rhs) {
+    return std::tie(rhs.deadline, rhs.serial_no) < std::tie(lhs.deadline, lhs.serial_no);
+  }
+
+  std::mutex scheduled_calls_mutex_;
+  // Queued calls of each priority class, ordered by deadline.
+  std::array<std::priority_queue<ScheduledCall>, kRpcPriorityClassMapSize> scheduled_calls_
+      GUARDED_BY(scheduled_calls_mutex_);
+  // Number of consecutive picks that passed over the class while it had queued calls.
+  std::array<size_t, kRpcPriorityClassMapSize> skipped_picks_
+      GUARDED_BY(scheduled_calls_mutex_) = {};
+  uint64_t scheduled_calls_serial_no_ GUARDED_BY(scheduled_calls_mutex_) = 0;
+
   std::atomic<bool> closing_ = {false};
   CountDownLatch shutdown_complete_latch_{1};
   std::string log_prefix_;
@@ -11,11 +11,14 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <deque>
 
 #include "yb/rpc/tcp_stream.h"
 
+#include "yb/rpc/io_uring_sender.h"
 #include "yb/rpc/outbound_data.h"
+#include "yb/rpc/reactor.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/rpc_util.h"
 
@@ -25,27 +28,75 @@
 #include "yb/util/memory/memory_usage.h"
 #include "yb/util/metrics.h"
 #include "yb/util/result.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/status_log.h"
 #include "yb/util/string_util.h"
 
 using namespace std::literals;
+using namespace yb::size_literals;
 
 DECLARE_uint64(rpc_connection_timeout_ms);
+DEFINE_RUNTIME_bool(rpc_skip_redundant_socket_syscalls, true,
+    "Do not issue another recvmsg/sendmsg on a connection in the same reactor iteration "
+    "once the previous call has shown that the socket is drained or its send buffer is full. "
+    "Such a call would only return EAGAIN.");
+TAG_FLAG(rpc_skip_redundant_socket_syscalls, advanced);
+
+DEFINE_NON_RUNTIME_bool(rpc_enable_zero_copy_send, false,
+    "Enable SO_ZEROCOPY on RPC connections, so large outbound batches are sent with "
+    "MSG_ZEROCOPY instead of being copied into the kernel socket buffer. Requires Linux 4.14+.");
+TAG_FLAG(rpc_enable_zero_copy_send, advanced);
+
+DEFINE_RUNTIME_uint64(rpc_zero_copy_send_threshold_bytes, 128_KB,
+    "Minimal size of a single sendmsg batch to send it with MSG_ZEROCOPY, when "
+    "rpc_enable_zero_copy_send is set. Page pinning and completion handling are more "
+    "expensive than copying for small writes.");
+TAG_FLAG(rpc_zero_copy_send_threshold_bytes, advanced);
+
+
 DEFINE_test_flag(int32, delay_connect_ms, 0,
                  "Delay connect in tests for specified amount of milliseconds.");
 
 METRIC_DEFINE_simple_counter(
   server, tcp_bytes_sent, "Bytes sent over TCP connections", yb::MetricUnit::kBytes);
 
+METRIC_DEFINE_simple_counter(
+  server, tcp_send_syscalls, "Number of send syscalls issued for TCP connections",
+  yb::MetricUnit::kRequests);
+
+METRIC_DEFINE_coarse_histogram(
+  server, tcp_bytes_per_send_syscall, "Bytes sent per TCP send syscall", yb::MetricUnit::kBytes,
+  "Number of bytes accepted by the kernel in a single send syscall");
+
 METRIC_DEFINE_simple_counter(
   server, tcp_bytes_received, "Bytes received via TCP connections", yb::MetricUnit::kBytes);
 
+METRIC_DEFINE_simple_counter(
+  server, tcp_zero_copy_bytes_sent, "Bytes sent over TCP connections using MSG_ZEROCOPY",
+  yb::MetricUnit::kBytes);
+
+METRIC_DEFINE_simple_counter(
+  server, tcp_zero_copy_fallbacks,
+  "Number of zero copy sends where the kernel had to copy data or could not pin pages",
+  yb::MetricUnit::kRequests);
+
 namespace yb {
 namespace rpc {
 
 namespace {
 
-const size_t kMaxIov = 16;
+size_t IovTotalSize(const iovec* iov, int len) {
+  size_t result = 0;
+  for (int i = 0; i != len; ++i) {
+    result += iov[i].iov_len;
+  }
+  return result;
+}
+
+// Whether lhs precedes rhs, taking wrap around of 32 bit sequence numbers into account.
+bool SeqBefore(uint32_t lhs, uint32_t rhs) {
+  return static_cast<int32_t>(lhs - rhs) < 0;
+}
 
 }
 
@@ -58,6 +109,11 @@ TcpStream::TcpStream(const StreamCreateData& data)
   if (data.metric_entity) {
     bytes_received_counter_ = METRIC_tcp_bytes_received.Instantiate(data.metric_entity);
     bytes_sent_counter_ = METRIC_tcp_bytes_sent.Instantiate(data.metric_entity);
+    send_syscalls_counter_ = METRIC_tcp_send_syscalls.Instantiate(data.metric_entity);
+    bytes_per_send_syscall_ = METRIC_tcp_bytes_per_send_syscall.Instantiate(data.metric_entity);
+    zero_copy_bytes_sent_counter_ = METRIC_tcp_zero_copy_bytes_sent.Instantiate(
+        data.metric_entity);
+    zero_copy_fallbacks_counter_ = METRIC_tcp_zero_copy_fallbacks.Instantiate(data.metric_entity);
   }
 }
 
@@ -80,6 +136,18 @@ Status TcpStream::Start(bool connect, ev::loop_ref* loop, StreamContext* context
   // These timeouts don't affect non-blocking sockets:
   RETURN_NOT_OK(socket_.SetSendTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
   RETURN_NOT_OK(socket_.SetRecvTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
+  if (FLAGS_rpc_enable_zero_copy_send) {
+    auto status = socket_.SetZeroCopy(true);
+    if (status.ok()) {
+      zero_copy_enabled_ = true;
+    } else {
+      YB_LOG_EVERY_N_SECS(WARNING, 60) << "Failed to enable zero copy send: " << status;
+    }
+  }
+  if (!zero_copy_enabled_) {
+    auto* reactor = Reactor::Current();
+    io_uring_sender_ = reactor ? reactor->io_uring_sender() : nullptr;
+  }
 
   if (connect && FLAGS_TEST_delay_connect_ms) {
     connect_delayer_.set(*loop);
@@ -140,6 +208,29 @@ void TcpStream::Close() {
 }
 
 void TcpStream::Shutdown(const Status& status) {
+  if (io_uring_send_pending_) {
+    // Kernel could still read bytes of the submitted send, so the sender keeps them until the send
+    // is completed.
+    std::vector<TcpStreamSendingData::SendingBytes> in_flight_bytes;
+    in_flight_bytes.reserve(io_uring_in_flight_entries_);
+    for (size_t i = 0; i != io_uring_in_flight_entries_; ++i) {
+      in_flight_bytes.push_back(std::move(sending_[i].bytes));
+    }
+    io_uring_sender_->Cancel(this, std::move(in_flight_bytes));
+    io_uring_send_pending_ = false;
+    io_uring_in_flight_entries_ = 0;
+  }
+  // Kernel could still reference bytes of partially sent entries, so they are kept until their
+  // zero copy sends are completed.
+  for (auto& data : sending_) {
+    if (data.zero_copy_seq && !ZeroCopyCompleted(*data.zero_copy_seq)) {
+      zero_copy_pending_.push_back(ZeroCopyPendingData {
+        .seq = *data.zero_copy_seq,
+        .bytes = std::move(data.bytes),
+        .consumption = std::move(data.consumption),
+      });
+    }
+  }
   ClearSending(status);
 
   if (!ReadBuffer().Empty()) {
@@ -152,7 +243,21 @@ void TcpStream::Shutdown(const Status& status) {
 
   ReadBuffer().Reset();
 
+  if (next_zero_copy_seq_ != zero_copy_completed_up_to_ && socket_.GetFd() >= 0) {
+    WARN_NOT_OK(ProcessZeroCopyCompletions(), "Failed to process zero copy completions");
+  }
+  if (next_zero_copy_seq_ != zero_copy_completed_up_to_ && socket_.GetFd() >= 0) {
+    // Kernel could still transmit pages of the pending zero copy sends after the socket is closed,
+    // while they could be reused by other allocations once released. So the connection is reset
+    // on close, dropping all unsent data, instead of sending it in the background.
+    WARN_NOT_OK(socket_.SetLingerZero(), "Failed to reset connection with pending zero copy sends");
+  }
+
   WARN_NOT_OK(socket_.Close(), "Error closing socket");
+
+  zero_copy_pending_.clear();
+  zero_copy_out_of_order_completions_.clear();
+  zero_copy_completed_up_to_ = next_zero_copy_seq_;
 }
 
 Status TcpStream::TryWrite() {
@@ -167,7 +272,9 @@ TcpStream::FillIovResult TcpStream::FillIov(iovec* out) {
   int index = 0;
   size_t offset = send_position_;
   bool only_heartbeats = true;
+  size_t num_entries = 0;
   for (auto& data : sending_) {
+    ++num_entries;
     const auto wrapped_data = data.data;
     if (wrapped_data && !wrapped_data->IsHeartbeat()) {
       only_heartbeats = false;
@@ -188,12 +295,12 @@ TcpStream::FillIovResult TcpStream::FillIov(iovec* out) {
       out[index].iov_len = bytes.size() - offset;
       offset = 0;
       if (++index == kMaxIov) {
-        return FillIovResult{index, only_heartbeats};
+        return FillIovResult{index, only_heartbeats, num_entries};
       }
     }
   }
 
-  return FillIovResult{index, only_heartbeats};
+  return FillIovResult{index, only_heartbeats, num_entries};
 }
 
 Status TcpStream::DoWrite() {
@@ -206,6 +313,16 @@ Status TcpStream::DoWrite() {
     return Status::OK();
   }
 
+  if (io_uring_sender_) {
+    // Data is sent when the reactor flushes the sender, so sends of all connections that have
+    // data to write in this loop iteration are submitted together.
+    if (!io_uring_send_pending_ && !sending_.empty()) {
+      io_uring_send_pending_ = true;
+      io_uring_sender_->Schedule(this);
+    }
+    return Status::OK();
+  }
+
   // If we weren't waiting write to be ready, we could try to write data to socket.
   while (!sending_.empty()) {
     iovec iov[kMaxIov];
@@ -215,51 +332,206 @@ Status TcpStream::DoWrite() {
       context_->UpdateLastActivity();
     }
 
-    auto result = fill_result.len != 0
-        ? socket_.Writev(iov, fill_result.len)
-        : 0;
+    auto result = fill_result.len != 0 ? Writev(iov, fill_result) : 0;
     DVLOG_WITH_PREFIX(4) << "Queued writes " << queued_bytes_to_send_ << " bytes. Result "
                          << result << ", sending_.size(): " << sending_.size();
 
-    if (PREDICT_FALSE(!result.ok())) {
-      if (!result.status().IsTryAgain()) {
-        YB_LOG_WITH_PREFIX_EVERY_N(WARNING, 50) << "Send failed: " << result.status();
-        return result.status();
-      } else {
-        VLOG_WITH_PREFIX(3) << "Send temporary failed: " << result.status();
-        return Status::OK();
+    if (result.ok() && fill_result.len != 0) {
+      IncrementCounter(send_syscalls_counter_);
+      if (bytes_per_send_syscall_) {
+        bytes_per_send_syscall_->Increment(*result);
       }
     }
 
-    context_->UpdateLastWrite();
+    if (!VERIFY_RESULT(HandleSendResult(result, iov, fill_result))) {
+      break;
+    }
+  }
+
+  return Status::OK();
+}
+
+Result<bool> TcpStream::HandleSendResult(
+    const Result<size_t>& result, const iovec* iov, const FillIovResult& fill_result) {
+  if (PREDICT_FALSE(!result.ok())) {
+    if (!result.status().IsTryAgain()) {
+      YB_LOG_WITH_PREFIX_EVERY_N(WARNING, 50) << "Send failed: " << result.status();
+      return result.status();
+    }
+    VLOG_WITH_PREFIX(3) << "Send temporary failed: " << result.status();
+    return false;
+  }
+
+  context_->UpdateLastWrite();
 
-    IncrementCounterBy(bytes_sent_counter_, *result);
+  IncrementCounterBy(bytes_sent_counter_, *result);
 
-    send_position_ += *result;
-    while (!sending_.empty()) {
-      auto& front = sending_.front();
-      size_t full_size = front.bytes_size();
-      if (front.skipped) {
-        PopSending();
+  // Kernel accepted only part of the data, so the send buffer is full and the next sendmsg
+  // would fail with EAGAIN. Wait for the socket to become writable instead.
+  bool send_buffer_full = false;
+  if (FLAGS_rpc_skip_redundant_socket_syscalls && fill_result.len != 0) {
+    send_buffer_full = *result < IovTotalSize(iov, fill_result.len);
+  }
+
+  send_position_ += *result;
+  while (!sending_.empty()) {
+    auto& front = sending_.front();
+    size_t full_size = front.bytes_size();
+    if (front.skipped) {
+      PopSending();
+      continue;
+    }
+    if (send_position_ < full_size) {
+      break;
+    }
+    auto data = front.data;
+    send_position_ -= full_size;
+    PopSending();
+    if (data) {
+      context_->Transferred(data, Status::OK());
+    }
+  }
+
+  if (send_buffer_full) {
+    VLOG_WITH_PREFIX(4) << "Send buffer full, " << queued_bytes_to_send_ << " bytes queued";
+    return false;
+  }
+
+  return true;
+}
+
+int TcpStream::PrepareIoUringSend(iovec* iov) {
+  io_uring_fill_result_ = FillIov(iov);
+  if (!io_uring_fill_result_.only_heartbeats) {
+    context_->UpdateLastActivity();
+  }
+  if (io_uring_fill_result_.len == 0) {
+    // All queued data was cancelled.
+    IoUringSendCompleted(0, iov);
+    return 0;
+  }
+
+  io_uring_in_flight_entries_ = io_uring_fill_result_.num_entries;
+  return io_uring_fill_result_.len;
+}
+
+void TcpStream::IoUringSendCompleted(int32_t res, const iovec* iov) {
+  io_uring_send_pending_ = false;
+  io_uring_in_flight_entries_ = 0;
+  Result<size_t> result = static_cast<size_t>(std::max(res, 0));
+  if (res < 0) {
+    auto err = -res;
+    if (err == EAGAIN || err == EWOULDBLOCK || err == EINTR) {
+      result = STATUS(TryAgain, "Write not yet ready");
+    } else {
+      result = STATUS(NetworkError, "sendmsg error", Errno(err));
+    }
+  }
+  DVLOG_WITH_PREFIX(4) << "Queued writes " << queued_bytes_to_send_ << " bytes. Result "
+                       << result << ", sending_.size(): " << sending_.size();
+
+  auto can_continue = HandleSendResult(result, iov, io_uring_fill_result_);
+  auto status = can_continue.ok() ? Status::OK() : can_continue.status();
+  if (status.ok() && *can_continue && !sending_.empty()) {
+    // Rest of the data is sent by the next flush of the sender.
+    status = DoWrite();
+  }
+  if (!status.ok()) {
+    context_->Destroy(status);
+    return;
+  }
+  UpdateEvents();
+}
+
+Result<size_t> TcpStream::Writev(const iovec* iov, const FillIovResult& fill_result) {
+  if (!zero_copy_enabled_ ||
+      IovTotalSize(iov, fill_result.len) < FLAGS_rpc_zero_copy_send_threshold_bytes) {
+    return socket_.Writev(iov, fill_result.len);
+  }
+
+  auto result = socket_.WritevZeroCopy(iov, fill_result.len);
+  if (!result.ok()) {
+    if (result.status().IsBusy()) {
+      IncrementCounter(zero_copy_fallbacks_counter_);
+      return socket_.Writev(iov, fill_result.len);
+    }
+    return result;
+  }
+
+  auto seq = next_zero_copy_seq_++;
+  for (size_t i = 0; i != fill_result.num_entries; ++i) {
+    sending_[i].zero_copy_seq = seq;
+  }
+  IncrementCounterBy(zero_copy_bytes_sent_counter_, *result);
+  return result;
+}
+
+bool TcpStream::ZeroCopyCompleted(uint32_t seq) const {
+  return SeqBefore(seq, zero_copy_completed_up_to_);
+}
+
+Status TcpStream::ProcessZeroCopyCompletions() {
+  ZeroCopyCompletion completion;
+  while (VERIFY_RESULT(socket_.ReadZeroCopyCompletion(&completion))) {
+    if (completion.copied) {
+      IncrementCounter(zero_copy_fallbacks_counter_);
+    }
+    ZeroCopySendsCompleted(completion.first, completion.last);
+  }
+  ReleaseZeroCopyPendingData();
+  return Status::OK();
+}
+
+void TcpStream::ZeroCopySendsCompleted(uint32_t first, uint32_t last) {
+  if (SeqBefore(zero_copy_completed_up_to_, first)) {
+    // Notifications for TCP are usually ordered, but it is not guaranteed.
+    auto [it, inserted] = zero_copy_out_of_order_completions_.emplace(first, last);
+    if (!inserted && SeqBefore(it->second, last)) {
+      it->second = last;
+    }
+    return;
+  }
+  // Range could overlap sends that are already completed.
+  if (SeqBefore(last, zero_copy_completed_up_to_)) {
+    return;
+  }
+  zero_copy_completed_up_to_ = last + 1;
+  // Merge out of order ranges that start at or before the new boundary, they could also overlap
+  // each other.
+  bool advanced = true;
+  while (advanced) {
+    advanced = false;
+    for (auto it = zero_copy_out_of_order_completions_.begin();
+         it != zero_copy_out_of_order_completions_.end();) {
+      if (SeqBefore(zero_copy_completed_up_to_, it->first)) {
+        ++it;
         continue;
       }
-      if (send_position_ < full_size) {
-        break;
-      }
-      auto data = front.data;
-      send_position_ -= full_size;
-      PopSending();
-      if (data) {
-        context_->Transferred(data, Status::OK());
+      if (!SeqBefore(it->second, zero_copy_completed_up_to_)) {
+        zero_copy_completed_up_to_ = it->second + 1;
+        advanced = true;
       }
+      it = zero_copy_out_of_order_completions_.erase(it);
     }
   }
+}
 
-  return Status::OK();
+void TcpStream::ReleaseZeroCopyPendingData() {
+  while (!zero_copy_pending_.empty() && ZeroCopyCompleted(zero_copy_pending_.front().seq)) {
+    zero_copy_pending_.pop_front();
+  }
 }
 
 void TcpStream::PopSending() {
-  queued_bytes_to_send_ -= sending_.front().bytes_size();
+  auto& front = sending_.front();
+  queued_bytes_to_send_ -= front.bytes_size();
+  if (front.zero_copy_seq && !ZeroCopyCompleted(*front.zero_copy_seq)) {
+    zero_copy_pending_.push_back(ZeroCopyPendingData {
+      .seq = *front.zero_copy_seq,
+      .bytes = std::move(front.bytes),
+      .consumption = std::move(front.consumption),
+    });
+  }
   sending_.pop_front();
   ++data_blocks_sent_;
 }
@@ -272,6 +544,15 @@ void TcpStream::Handler(ev::io& watcher, int revents) {  // NOLINT
     VLOG_WITH_PREFIX(3) << status;
   }
 
+  // Zero copy completions are delivered via the socket error queue, which is reported by epoll
+  // as an error condition, i.e. as both read and write readiness.
+  if (status.ok() && next_zero_copy_seq_ != zero_copy_completed_up_to_) {
+    status = ProcessZeroCopyCompletions();
+    if (!status.ok()) {
+      VLOG_WITH_PREFIX(3) << "ProcessZeroCopyCompletions() returned error: " << status;
+    }
+  }
+
   if (status.ok() && (revents & ev::READ)) {
     status = ReadHandler();
     if (!status.ok()) {
@@ -303,7 +584,9 @@ void TcpStream::UpdateEvents() {
   if (!read_buffer_full_) {
     events |= ev::READ;
   }
-  waiting_write_ready_ = !sending_.empty() || !connected_;
+  // Socket readiness is not needed while io_uring send is pending, it is submitted in this loop
+  // iteration anyway.
+  waiting_write_ready_ = (!sending_.empty() && !io_uring_send_pending_) || !connected_;
   if (waiting_write_ready_) {
     events |= ev::WRITE;
   }
@@ -338,10 +621,16 @@ Status TcpStream::ReadHandler() {
     if (!continue_receiving.get()) {
       return Status::OK();
     }
+    // Socket had less data than we were ready to accept, so the next recvmsg would return
+    // EAGAIN. Level triggered poll will notify us when more data arrives.
+    if (socket_drained_ && FLAGS_rpc_skip_redundant_socket_syscalls) {
+      return Status::OK();
+    }
   }
 }
 
 Result<bool> TcpStream::Receive() {
+  socket_drained_ = false;
   auto iov = ReadBuffer().PrepareAppend();
   if (!iov.ok()) {
     VLOG_WITH_PREFIX(3) << "ReadBuffer().PrepareAppend() error: " << iov.status();
@@ -372,6 +661,7 @@ Result<bool> TcpStream::Receive() {
     } while (inbound_bytes_to_skip_ > 0);
   }
 
+  const auto capacity = IoVecsFullSize(*iov);
   auto nread = socket_.Recvv(iov.get_ptr());
   if (!nread.ok()) {
     DVLOG_WITH_PREFIX(3) << "socket_.Recvv() error: " << nread.status();
@@ -384,6 +674,7 @@ Result<bool> TcpStream::Receive() {
 
   IncrementCounterBy(bytes_received_counter_, *nread);
   ReadBuffer().DataAppended(*nread);
+  socket_drained_ = *nread < capacity;
   return *nread != 0;
 }
 
@@ -443,6 +734,13 @@ bool TcpStream::Idle(std::string* reason_not_idle) {
     result = false;
   }
 
+  if (!zero_copy_pending_.empty()) {
+    if (reason_not_idle) {
+      AppendWithSeparator("waiting for zero copy completion", reason_not_idle);
+    }
+    result = false;
+  }
+
   return result;
 }
 
@@ -481,7 +779,7 @@ bool TcpStream::Cancelled(size_t handle) {
   LOG_IF_WITH_PREFIX(DFATAL, !sending_[handle].data->IsFinished())
       << "Cancelling not finished data: " << sending_[handle].data->ToString();
   auto& entry = sending_[handle];
-  if (handle == 0 && send_position_ > 0) {
+  if ((handle == 0 && send_position_ > 0) || handle < io_uring_in_flight_entries_) {
     // Transfer already started, cannot drop it.
     return false;
   }
@@ -14,6 +14,8 @@
 #pragma once
 
 #include <deque>
+#include <optional>
+#include <unordered_map>
 
 #include <ev++.h>
 
@@ -26,9 +28,12 @@
 namespace yb {
 
 class Counter;
+class Histogram;
 
 namespace rpc {
 
+class IoUringSender;
+
 struct TcpStreamSendingData {
   typedef boost::container::small_vector<RefCntSlice, 4> SendingBytes;
 
@@ -51,6 +56,8 @@ struct TcpStreamSendingData {
   SendingBytes bytes;
   ScopedTrackedConsumption consumption;
   bool skipped = false;
+  // Sequence number of the last zero copy send that referenced these bytes, if any.
+  std::optional<uint32_t> zero_copy_seq;
 };
 
 class TcpStream : public Stream {
@@ -68,9 +75,22 @@ class TcpStream : public Stream {
   static StreamFactoryPtr Factory();
 
  private:
+  friend class IoUringSender;
+
+  static constexpr size_t kMaxIov = 16;
+
   struct FillIovResult {
     int len;
     bool only_heartbeats;
+    // Number of entries at the front of sending_ that were used to fill iov.
+    size_t num_entries;
+  };
+
+  // Bytes that were fully sent using zero copy, but kernel could still read them.
+  struct ZeroCopyPendingData {
+    uint32_t seq;
+    TcpStreamSendingData::SendingBytes bytes;
+    ScopedTrackedConsumption consumption;
   };
 
   Status Start(bool connect, ev::loop_ref* loop, StreamContext* context) override;
@@ -94,6 +114,10 @@ class TcpStream : public Stream {
   void ParseReceived() override;
 
   Status DoWrite();
+  // Processes result of sending iov filled by FillIov: pops sent data and notifies the context.
+  // Returns true if the rest of data could be sent right away.
+  Result<bool> HandleSendResult(
+      const Result<size_t>& result, const iovec* iov, const FillIovResult& fill_result);
   void HandleOutcome(const Status& status, bool enqueue);
   void ClearSending(const Status& status);
 
@@ -102,9 +126,28 @@ class TcpStream : public Stream {
   Status WriteHandler(bool just_connected);
 
   Result<bool> Receive();
+
+  // Sends iov using MSG_ZEROCOPY when it is enabled and the batch is large enough.
+  Result<size_t> Writev(const iovec* iov, const FillIovResult& fill_result);
+
+  // Reads zero copy notifications from the socket error queue and releases sent bytes
+  // that are no longer referenced by the kernel.
+  Status ProcessZeroCopyCompletions();
+  // Marks zero copy sends with sequence numbers in [first, last] as completed.
+  void ZeroCopySendsCompleted(uint32_t first, uint32_t last);
+  bool ZeroCopyCompleted(uint32_t seq) const;
+  void ReleaseZeroCopyPendingData();
   // Try to parse received data and process it.
   Result<bool> TryProcessReceived();
 
+  // Fills iov for the send submitted by io_uring_sender_, iov is owned by the sender and stays
+  // valid until the send is completed. Returns the number of filled entries, 0 if there is nothing
+  // to send.
+  int PrepareIoUringSend(iovec* iov);
+  // Invoked by io_uring_sender_ with the number of bytes sent or a negated errno, and iov filled
+  // by PrepareIoUringSend.
+  void IoUringSendCompleted(int32_t res, const iovec* iov);
+
   // Updates listening events.
   void UpdateEvents();
 
@@ -145,6 +188,29 @@ class TcpStream : public Stream {
 
   bool read_buffer_full_ = false;
 
+  // Set when the last recvmsg returned less data than the read buffer could accept.
+  bool socket_drained_ = false;
+
+  bool zero_copy_enabled_ = false;
+  // Sequence number that will be assigned to the next zero copy send.
+  uint32_t next_zero_copy_seq_ = 0;
+  // All zero copy sends with sequence number below this one are completed.
+  uint32_t zero_copy_completed_up_to_ = 0;
+  // Completed ranges that start after zero_copy_completed_up_to_, first -> last. Ranges could
+  // overlap each other.
+  std::unordered_map<uint32_t, uint32_t> zero_copy_out_of_order_completions_;
+  std::deque<ZeroCopyPendingData> zero_copy_pending_;
+
+  // Sender of the reactor, that submits sends of all its connections with a single syscall.
+  // Not used with zero copy send.
+  IoUringSender* io_uring_sender_ = nullptr;
+  // Whether send was scheduled via io_uring_sender_ and is not completed yet.
+  bool io_uring_send_pending_ = false;
+  // Number of entries at the front of sending_ that are referenced by the submitted send, kernel
+  // could read their bytes until the send is completed.
+  size_t io_uring_in_flight_entries_ = 0;
+  FillIovResult io_uring_fill_result_;
+
   std::deque<TcpStreamSendingData> sending_;
   size_t data_blocks_sent_ = 0;
   size_t send_position_ = 0;
@@ -154,6 +220,10 @@ class TcpStream : public Stream {
   MemTrackerPtr mem_tracker_;
   scoped_refptr<Counter> bytes_sent_counter_;
   scoped_refptr<Counter> bytes_received_counter_;
+  scoped_refptr<Counter> send_syscalls_counter_;
+  scoped_refptr<Histogram> bytes_per_send_syscall_;
+  scoped_refptr<Counter> zero_copy_bytes_sent_counter_;
+  scoped_refptr<Counter> zero_copy_fallbacks_counter_;
 };
 
 } // namespace rpc
@@ -106,12 +106,13 @@ TEST_F(ThreadPoolTest, TestSingleThread) {
   }
 }
 
-TEST_F(ThreadPoolTest, TestSingleProducer) {
+void TestSingleProducer(bool work_stealing) {
   constexpr size_t kTotalTasks = 10000;
   constexpr size_t kTotalWorkers = 4;
   ThreadPool pool(ThreadPoolOptions {
     .name = "test",
     .max_workers = kTotalWorkers,
+    .work_stealing = work_stealing,
   });
 
   CountDownLatch latch(kTotalTasks);
@@ -126,13 +127,22 @@ TEST_F(ThreadPoolTest, TestSingleProducer) {
   }
 }
 
-TEST_F(ThreadPoolTest, TestMultiProducers) {
+TEST_F(ThreadPoolTest, TestSingleProducer) {
+  TestSingleProducer(/* work_stealing= */ false);
+}
+
+TEST_F(ThreadPoolTest, TestSingleProducerWorkStealing) {
+  TestSingleProducer(/* work_stealing= */ true);
+}
+
+void TestMultiProducers(bool work_stealing) {
   constexpr size_t kTotalTasks = 10000;
   constexpr size_t kTotalWorkers = 4;
   constexpr size_t kProducers = 4;
   ThreadPool pool(ThreadPoolOptions {
     .name = "test",
     .max_workers = kTotalWorkers,
+    .work_stealing = work_stealing,
   });
 
   CountDownLatch latch(kTotalTasks);
@@ -159,6 +169,14 @@ TEST_F(ThreadPoolTest, TestMultiProducers) {
   }
 }
 
+TEST_F(ThreadPoolTest, TestMultiProducers) {
+  TestMultiProducers(/* work_stealing= */ false);
+}
+
+TEST_F(ThreadPoolTest, TestMultiProducersWorkStealing) {
+  TestMultiProducers(/* work_stealing= */ true);
+}
+
 TEST_F(ThreadPoolTest, TestQueueOverflow) {
   constexpr size_t kTotalTasks = 10000;
   constexpr size_t kTotalWorkers = 4;
@@ -200,13 +218,14 @@ TEST_F(ThreadPoolTest, TestQueueOverflow) {
   }
 }
 
-TEST_F(ThreadPoolTest, TestShutdown) {
+void TestShutdown(bool work_stealing) {
   constexpr size_t kTotalTasks = 10000;
   constexpr size_t kTotalWorkers = 4;
   constexpr size_t kProducers = 4;
   ThreadPool pool(ThreadPoolOptions {
     .name = "test",
     .max_workers = kTotalWorkers,
+    .work_stealing = work_stealing,
   });
 
   CountDownLatch latch(kTotalTasks);
@@ -234,6 +253,41 @@ TEST_F(ThreadPoolTest, TestShutdown) {
   }
 }
 
+TEST_F(ThreadPoolTest, TestShutdown) {
+  TestShutdown(/* work_stealing= */ false);
+}
+
+TEST_F(ThreadPoolTest, TestShutdownWorkStealing) {
+  TestShutdown(/* work_stealing= */ true);
+}
+
+// Tasks enqueued from workers go to the local deque of the enqueuing worker, and must be
+// stolen by other workers while it is blocked.
+TEST_F(ThreadPoolTest, TestWorkStealingNestedEnqueue) {
+  constexpr size_t kTotalWorkers = 4;
+  constexpr size_t kNestedTasks = 1000;
+  ThreadPool pool(ThreadPoolOptions {
+    .name = "test",
+    .max_workers = kTotalWorkers,
+    .work_stealing = true,
+  });
+
+  CountDownLatch latch(kNestedTasks);
+  CountDownLatch blocker_done(1);
+  pool.EnqueueFunctor([&pool, &latch, &blocker_done] {
+    for (size_t i = 0; i != kNestedTasks; ++i) {
+      pool.EnqueueFunctor([&latch] {
+        latch.CountDown();
+      });
+    }
+    // Block this worker until all nested tasks are executed by other workers.
+    latch.Wait();
+    blocker_done.CountDown();
+  });
+  blocker_done.Wait();
+  ASSERT_EQ(latch.count(), 0);
+}
+
 TEST_F(ThreadPoolTest, TestOwns) {
   class TestTask : public ThreadPoolTask {
    public:
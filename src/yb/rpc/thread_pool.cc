@@ -15,12 +15,23 @@
 
 #include "yb/rpc/thread_pool.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <condition_variable>
+#include <deque>
+#include <fstream>
 #include <mutex>
 
 #include <cds/container/basket_queue.h>
 #include <cds/gc/dhp.h>
 
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/status_format.h"
 #include "yb/util/thread.h"
@@ -158,21 +169,115 @@ class Worker {
   bool added_to_waiting_workers_ = false;
 };
 
+// Mapping of CPUs to NUMA nodes, read from sysfs. Contains a single node when the topology is not
+// available, in which case no thread affinity is applied.
+class NumaTopology {
+ public:
+  static const NumaTopology& Instance() {
+    static const NumaTopology instance;
+    return instance;
+  }
+
+  size_t num_nodes() const {
+    return std::max<size_t>(node_cpus_.size(), 1);
+  }
+
+  // Returns NUMA node of the CPU the current thread is running on.
+  size_t CurrentNode() const {
+#if defined(__linux__)
+    if (node_cpus_.size() > 1) {
+      auto cpu = sched_getcpu();
+      if (cpu >= 0 && static_cast<size_t>(cpu) < cpu_to_node_.size()) {
+        return cpu_to_node_[cpu];
+      }
+    }
+#endif
+    return 0;
+  }
+
+  // Restricts the current thread to CPUs of the specified node.
+  void BindCurrentThread(size_t node) const {
+#if defined(__linux__)
+    if (node_cpus_.size() <= 1) {
+      return;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (auto cpu : node_cpus_[node]) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    auto res = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (res != 0) {
+      LOG(WARNING) << "Failed to bind thread to NUMA node " << node << ": " << res;
+    }
+#endif
+  }
+
+ private:
+  NumaTopology() {
+#if defined(__linux__)
+    for (size_t node = 0;; ++node) {
+      std::ifstream input(Format("/sys/devices/system/node/node$0/cpulist", node));
+      if (!input) {
+        break;
+      }
+      std::string cpu_list;
+      std::getline(input, cpu_list);
+      std::vector<int> cpus;
+      std::vector<std::string> ranges = strings::Split(cpu_list, ",", strings::SkipEmpty());
+      for (const auto& range : ranges) {
+        int first, last;
+        auto parsed = sscanf(range.c_str(), "%d-%d", &first, &last);
+        if (parsed == 1) {
+          last = first;
+        } else if (parsed != 2 || first < 0 || last < first) {
+          LOG(WARNING) << "Unexpected cpu list of NUMA node " << node << ": " << cpu_list;
+          node_cpus_.clear();
+          cpu_to_node_.clear();
+          return;
+        }
+        for (auto cpu = first; cpu <= last; ++cpu) {
+          cpus.push_back(cpu);
+          if (static_cast<size_t>(cpu) >= cpu_to_node_.size()) {
+            cpu_to_node_.resize(cpu + 1);
+          }
+          cpu_to_node_[cpu] = node;
+        }
+      }
+      node_cpus_.push_back(std::move(cpus));
+    }
+#endif
+  }
+
+  std::vector<std::vector<int>> node_cpus_;
+  std::vector<size_t> cpu_to_node_;
+};
+
 } // namespace
 
 class ThreadPool::Impl {
  public:
-  explicit Impl(ThreadPoolOptions options)
+  virtual ~Impl() = default;
+
+  virtual const ThreadPoolOptions& options() const = 0;
+  virtual bool Enqueue(ThreadPoolTask* task) = 0;
+  virtual void Shutdown() = 0;
+  virtual bool Owns(Thread* thread) = 0;
+};
+
+class ThreadPool::SharedQueueImpl : public ThreadPool::Impl {
+ public:
+  explicit SharedQueueImpl(ThreadPoolOptions options)
       : share_(std::move(options)) {
     LOG(INFO) << "Starting thread pool " << share_.options.ToString();
     workers_.reserve(share_.options.max_workers);
   }
 
-  const ThreadPoolOptions& options() const {
+  const ThreadPoolOptions& options() const override {
     return share_.options;
   }
 
-  bool Enqueue(ThreadPoolTask* task) {
+  bool Enqueue(ThreadPoolTask* task) override {
     ++adding_;
     if (closing_) {
       --adding_;
@@ -213,7 +318,7 @@ class ThreadPool::Impl {
     return true;
   }
 
-  void Shutdown() {
+  void Shutdown() override {
     // Block creating new workers.
     created_workers_ += share_.options.max_workers;
     {
@@ -243,7 +348,7 @@ class ThreadPool::Impl {
     }
   }
 
-  bool Owns(Thread* thread) {
+  bool Owns(Thread* thread) override {
     return thread && thread->user_data() == &share_;
   }
 
@@ -257,8 +362,415 @@ class ThreadPool::Impl {
   const Status shutdown_status_ = STATUS(Aborted, "Service is shutting down");
 };
 
-ThreadPool::ThreadPool(ThreadPoolOptions options)
-    : impl_(new Impl(std::move(options))) {
+// Each worker owns a task deque. Tasks enqueued by a worker go to its own deque, while tasks
+// enqueued by other threads (i.e. reactors) are handed to an idle worker of the NUMA node the
+// enqueuing thread runs on, a newly started worker on that node, an idle worker of another node,
+// or, when all workers are busy, to a busy worker of the same node in round robin order. In the
+// latter case an idle worker, if one appeared in the meantime, is woken up to steal the task.
+// Workers execute tasks from the front of their own deque, and steal from the back of the deques
+// of other workers, first on the same node, when their own deque is empty.
+class ThreadPool::WorkStealingImpl : public ThreadPool::Impl {
+ public:
+  explicit WorkStealingImpl(ThreadPoolOptions options)
+      : options_(std::move(options)), topology_(NumaTopology::Instance()) {
+    for (size_t i = 0; i != topology_.num_nodes(); ++i) {
+      nodes_.push_back(std::make_unique<Node>(options_.max_workers));
+    }
+    LOG(INFO) << "Starting work stealing thread pool " << options_.ToString()
+              << ", NUMA nodes: " << nodes_.size();
+    workers_.reserve(options_.max_workers);
+  }
+
+  const ThreadPoolOptions& options() const override {
+    return options_;
+  }
+
+  bool Enqueue(ThreadPoolTask* task) override {
+    ++adding_;
+    auto se = ScopeExit([this] {
+      --adding_;
+    });
+    if (closing_) {
+      task->Done(shutdown_status_);
+      return false;
+    }
+
+    auto* current = current_worker_ && &current_worker_->pool_ == this ? current_worker_ : nullptr;
+    if (current) {
+      if (!HandOffToIdleWorker(current->node(), task) && !StartWorker(current->node(), task)) {
+        current->Push(task);
+        WakeIdleWorker(current->node());
+      }
+      return true;
+    }
+
+    const auto node = std::min(topology_.CurrentNode(), nodes_.size() - 1);
+    if (HandOffToIdleWorker(node, task) || StartWorker(node, task)) {
+      return true;
+    }
+    for (size_t i = 1; i != nodes_.size(); ++i) {
+      if (HandOffToIdleWorker((node + i) % nodes_.size(), task)) {
+        return true;
+      }
+    }
+    for (;;) {
+      auto* worker = PickWorker(node);
+      if (worker) {
+        worker->Push(task);
+        WakeIdleWorker(node);
+        return true;
+      }
+      if (closing_) {
+        task->Done(shutdown_status_);
+        return false;
+      }
+      // The first worker is being started by a concurrent Enqueue.
+      std::this_thread::yield();
+    }
+  }
+
+  void Shutdown() override {
+    // Block creating new workers.
+    created_workers_ += options_.max_workers;
+    {
+      std::lock_guard lock(mutex_);
+      if (closing_) {
+        CHECK(workers_.empty());
+        return;
+      }
+      closing_ = true;
+    }
+    for (auto& worker : workers_) {
+      worker->Stop();
+    }
+    while (adding_ != 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::vector<ThreadPoolTask*> left_tasks;
+    for (auto& worker : workers_) {
+      worker->Join();
+      worker->Drain(&left_tasks);
+    }
+    for (auto& node : nodes_) {
+      node->num_workers.store(0, std::memory_order_release);
+    }
+    workers_.clear();
+    for (auto* task : left_tasks) {
+      task->Done(shutdown_status_);
+    }
+  }
+
+  bool Owns(Thread* thread) override {
+    return thread && thread->user_data() == this;
+  }
+
+ private:
+  class Worker {
+   public:
+    Worker(WorkStealingImpl* pool, size_t node) : pool_(*pool), node_(node) {}
+
+    ~Worker() {
+      Join();
+    }
+
+    Worker(const Worker& worker) = delete;
+    void operator=(const Worker& worker) = delete;
+
+    Status Start(size_t index) {
+      auto name = strings::Substitute("rpc_tp_$0_$1", pool_.options_.name, index);
+      return yb::Thread::Create(kRpcThreadCategory, name, &Worker::Execute, this, &thread_);
+    }
+
+    void Join() {
+      if (thread_) {
+        thread_->Join();
+      }
+    }
+
+    size_t node() const {
+      return node_;
+    }
+
+    void Push(ThreadPoolTask* task) {
+      std::lock_guard lock(mutex_);
+      tasks_.push_back(task);
+      size_.store(tasks_.size(), std::memory_order_release);
+      if (waiting_) {
+        cond_.notify_one();
+      }
+    }
+
+    // Pushes task only when worker is waiting for tasks, so it will be picked up immediately.
+    bool PushIfWaiting(ThreadPoolTask* task) {
+      std::lock_guard lock(mutex_);
+      if (!waiting_) {
+        return false;
+      }
+      tasks_.push_back(task);
+      size_.store(tasks_.size(), std::memory_order_release);
+      cond_.notify_one();
+      return true;
+    }
+
+    // Wakes up the worker if it is waiting for tasks, so it would try to steal one.
+    void Wake() {
+      std::lock_guard lock(mutex_);
+      if (waiting_) {
+        cond_.notify_one();
+      }
+    }
+
+    ThreadPoolTask* Steal() {
+      if (size_.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+      }
+      // Never block on a victim, it could be trying to steal from us.
+      std::unique_lock lock(mutex_, std::try_to_lock);
+      if (!lock.owns_lock() || tasks_.empty()) {
+        return nullptr;
+      }
+      auto* task = tasks_.back();
+      tasks_.pop_back();
+      size_.store(tasks_.size(), std::memory_order_release);
+      return task;
+    }
+
+    void Stop() {
+      stop_requested_ = true;
+      std::lock_guard lock(mutex_);
+      cond_.notify_one();
+    }
+
+    void Drain(std::vector<ThreadPoolTask*>* out) {
+      std::lock_guard lock(mutex_);
+      out->insert(out->end(), tasks_.begin(), tasks_.end());
+      tasks_.clear();
+      size_.store(0, std::memory_order_release);
+    }
+
+   private:
+    friend class WorkStealingImpl;
+
+    void Execute() {
+      Thread::current_thread()->SetUserData(&pool_);
+      current_worker_ = this;
+      pool_.topology_.BindCurrentThread(node_);
+      while (!stop_requested_) {
+        auto* task = PopFront();
+        if (!task) {
+          task = pool_.Steal(this);
+        }
+        if (!task) {
+          task = Wait();
+        }
+        if (task) {
+          task->Run();
+          task->Done(Status::OK());
+        }
+      }
+      current_worker_ = nullptr;
+    }
+
+    ThreadPoolTask* PopFront() {
+      if (size_.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+      }
+      std::lock_guard lock(mutex_);
+      return PopFrontUnlocked();
+    }
+
+    ThreadPoolTask* PopFrontUnlocked() REQUIRES(mutex_) {
+      if (tasks_.empty()) {
+        return nullptr;
+      }
+      auto* task = tasks_.front();
+      tasks_.pop_front();
+      size_.store(tasks_.size(), std::memory_order_release);
+      return task;
+    }
+
+    ThreadPoolTask* Wait() {
+      std::unique_lock lock(mutex_);
+      waiting_ = true;
+      ThreadPoolTask* task = nullptr;
+      while (!stop_requested_) {
+        task = PopFrontUnlocked();
+        if (task) {
+          break;
+        }
+        pool_.AddIdleWorker(this);
+        // A task could have been pushed to a busy worker before we became visible as idle.
+        task = pool_.Steal(this);
+        if (task) {
+          break;
+        }
+        cond_.wait(lock);
+      }
+      waiting_ = false;
+      return task;
+    }
+
+    WorkStealingImpl& pool_;
+    const size_t node_;
+    scoped_refptr<yb::Thread> thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<ThreadPoolTask*> tasks_ GUARDED_BY(mutex_);
+    // Number of tasks in tasks_, used to skip locking empty deques.
+    std::atomic<size_t> size_{0};
+    std::atomic<bool> stop_requested_{false};
+    bool waiting_ GUARDED_BY(mutex_) = false;
+    // Protected by mutex of the node.
+    bool in_idle_list_ = false;
+  };
+
+  struct Node {
+    explicit Node(size_t max_workers) : workers(new std::atomic<Worker*>[max_workers]()) {}
+
+    std::mutex mutex;
+    std::vector<Worker*> idle_workers GUARDED_BY(mutex);
+    // Workers bound to this node. Only appended to, so it could be read without locking.
+    std::unique_ptr<std::atomic<Worker*>[]> workers;
+    std::atomic<size_t> num_workers{0};
+    std::atomic<size_t> next_worker{0};
+  };
+
+  bool HandOffToIdleWorker(size_t node_idx, ThreadPoolTask* task) {
+    auto& node = *nodes_[node_idx];
+    for (;;) {
+      Worker* worker;
+      {
+        std::lock_guard lock(node.mutex);
+        if (node.idle_workers.empty()) {
+          return false;
+        }
+        worker = node.idle_workers.back();
+        node.idle_workers.pop_back();
+        worker->in_idle_list_ = false;
+      }
+      // Worker could have picked up a task after adding itself to the idle list.
+      if (worker->PushIfWaiting(task)) {
+        return true;
+      }
+    }
+  }
+
+  // Wakes up an idle worker, preferring the specified node, so it could steal a task that was
+  // pushed to a busy worker.
+  void WakeIdleWorker(size_t node_idx) {
+    for (size_t i = 0; i != nodes_.size(); ++i) {
+      auto& node = *nodes_[(node_idx + i) % nodes_.size()];
+      Worker* worker;
+      {
+        std::lock_guard lock(node.mutex);
+        if (node.idle_workers.empty()) {
+          continue;
+        }
+        worker = node.idle_workers.back();
+        node.idle_workers.pop_back();
+        worker->in_idle_list_ = false;
+      }
+      // The worker adds itself back to the idle list before trying to steal.
+      worker->Wake();
+      return;
+    }
+  }
+
+  void AddIdleWorker(Worker* worker) {
+    auto& node = *nodes_[worker->node()];
+    std::lock_guard lock(node.mutex);
+    if (!worker->in_idle_list_) {
+      node.idle_workers.push_back(worker);
+      worker->in_idle_list_ = true;
+    }
+  }
+
+  bool StartWorker(size_t node_idx, ThreadPoolTask* task) {
+    // Same lock free approach as in the shared queue implementation, only first max_workers
+    // increments start a new worker.
+    auto index = created_workers_++;
+    if (index >= options_.max_workers) {
+      --created_workers_;
+      return false;
+    }
+    std::lock_guard lock(mutex_);
+    if (closing_) {
+      return false;
+    }
+    auto worker = std::make_unique<Worker>(this, node_idx);
+    auto status = worker->Start(workers_.size());
+    if (!status.ok()) {
+      if (workers_.empty()) {
+        LOG(FATAL) << "Unable to start first worker: " << status;
+      }
+      LOG(WARNING) << "Unable to start worker: " << status;
+      return false;
+    }
+    auto& node = *nodes_[node_idx];
+    auto num_workers = node.num_workers.load(std::memory_order_relaxed);
+    node.workers[num_workers].store(worker.get(), std::memory_order_release);
+    node.num_workers.store(num_workers + 1, std::memory_order_release);
+    worker->Push(task);
+    workers_.push_back(std::move(worker));
+    return true;
+  }
+
+  // Picks a worker of the specified node in round robin order, or of any other node if there are
+  // no workers on this node.
+  Worker* PickWorker(size_t node_idx) {
+    for (size_t i = 0; i != nodes_.size(); ++i) {
+      auto& node = *nodes_[(node_idx + i) % nodes_.size()];
+      auto num_workers = node.num_workers.load(std::memory_order_acquire);
+      if (num_workers != 0) {
+        auto idx = node.next_worker.fetch_add(1, std::memory_order_relaxed) % num_workers;
+        return node.workers[idx].load(std::memory_order_acquire);
+      }
+    }
+    return nullptr;
+  }
+
+  ThreadPoolTask* Steal(Worker* thief) {
+    for (size_t i = 0; i != nodes_.size(); ++i) {
+      auto& node = *nodes_[(thief->node() + i) % nodes_.size()];
+      auto num_workers = node.num_workers.load(std::memory_order_acquire);
+      if (num_workers == 0) {
+        continue;
+      }
+      auto start = RandomUniformInt<size_t>(0, num_workers - 1);
+      for (size_t j = 0; j != num_workers; ++j) {
+        auto* victim = node.workers[(start + j) % num_workers].load(std::memory_order_acquire);
+        if (victim != thief) {
+          if (auto* task = victim->Steal()) {
+            return task;
+          }
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  static thread_local Worker* current_worker_;
+
+  const ThreadPoolOptions options_;
+  const NumaTopology& topology_;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> created_workers_ = {0};
+  std::mutex mutex_;
+  std::atomic<bool> closing_ = {false};
+  std::atomic<size_t> adding_ = {0};
+  const Status shutdown_status_ = STATUS(Aborted, "Service is shutting down");
+};
+
+thread_local ThreadPool::WorkStealingImpl::Worker* ThreadPool::WorkStealingImpl::current_worker_ =
+    nullptr;
+
+ThreadPool::ThreadPool(ThreadPoolOptions options) {
+  if (options.work_stealing) {
+    impl_ = std::make_unique<WorkStealingImpl>(std::move(options));
+  } else {
+    impl_ = std::make_unique<SharedQueueImpl>(std::move(options));
+  }
 }
 
 ThreadPool::ThreadPool(ThreadPool&& rhs) noexcept
@@ -74,9 +74,12 @@ FunctorThreadPoolTask<F>* MakeFunctorThreadPoolTask(F&& f) {
 struct ThreadPoolOptions {
   std::string name;
   size_t max_workers;
+  // Use per worker task deques with work stealing instead of a single shared task queue.
+  // Tasks are preferably executed by workers on the NUMA node of the thread that enqueued them.
+  bool work_stealing = false;
 
   std::string ToString() const {
-    return YB_STRUCT_TO_STRING(name, max_workers);
+    return YB_STRUCT_TO_STRING(name, max_workers, work_stealing);
   }
 };
 
@@ -118,6 +121,8 @@ class ThreadPool {
 
  private:
   class Impl;
+  class SharedQueueImpl;
+  class WorkStealingImpl;
 
   std::unique_ptr<Impl> impl_;
 };
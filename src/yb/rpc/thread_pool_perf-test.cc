@@ -0,0 +1,90 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/rpc/thread_pool.h"
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/monotime.h"
+#include "yb/util/test_util.h"
+#include "yb/util/thread.h"
+#include "yb/util/tsan_util.h"
+
+namespace yb {
+namespace rpc {
+
+class ThreadPoolPerfTest : public YBTest {
+ protected:
+  // Enqueues tasks from several producer threads, as reactors do, and returns the number of tasks
+  // executed per second.
+  uint64_t RunTasks(bool work_stealing);
+};
+
+uint64_t ThreadPoolPerfTest::RunTasks(bool work_stealing) {
+  constexpr size_t kTotalWorkers = 16;
+  constexpr size_t kProducers = 4;
+  constexpr size_t kTasksPerProducer = 200000;
+
+  ThreadPool pool(ThreadPoolOptions {
+    .name = "bench",
+    .max_workers = kTotalWorkers,
+    .work_stealing = work_stealing,
+  });
+  CountDownLatch latch(kProducers * kTasksPerProducer);
+  std::atomic<uint64_t> total_latency_ns{0};
+  std::vector<std::thread> threads;
+  auto start = MonoTime::Now();
+  for (size_t i = 0; i != kProducers; ++i) {
+    threads.emplace_back([&pool, &latch, &total_latency_ns] {
+      CDSAttacher attacher;
+      for (size_t j = 0; j != kTasksPerProducer; ++j) {
+        pool.EnqueueFunctor([&latch, &total_latency_ns, enqueued = MonoTime::Now()] {
+          total_latency_ns.fetch_add(
+              (MonoTime::Now() - enqueued).ToNanoseconds(), std::memory_order_relaxed);
+          latch.CountDown();
+        });
+      }
+    });
+  }
+  latch.Wait();
+  auto passed = MonoTime::Now() - start;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto total_tasks = kProducers * kTasksPerProducer;
+  const auto tasks_per_second = total_tasks * 1000 / std::max<int64_t>(passed.ToMilliseconds(), 1);
+  LOG(INFO) << (work_stealing ? "Work stealing" : "Shared queue") << " thread pool: "
+            << tasks_per_second << " tasks/s, average latency: "
+            << total_latency_ns.load() / total_tasks << " ns";
+  return tasks_per_second;
+}
+
+// Compares throughput and latency of shared queue and work stealing thread pools.
+TEST_F(ThreadPoolPerfTest, YB_DISABLE_TEST_IN_SANITIZERS(WorkStealing)) {
+  auto shared_queue = RunTasks(/* work_stealing= */ false);
+  auto work_stealing = RunTasks(/* work_stealing= */ true);
+  // Tasks are spread over per worker deques instead of contending on the shared queue, so work
+  // stealing should not be slower. Leave room for the run to run noise of a shared test machine.
+  ASSERT_GE(work_stealing * 4, shared_queue * 3);
+}
+
+} // namespace rpc
+} // namespace yb
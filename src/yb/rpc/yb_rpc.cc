@@ -174,6 +174,7 @@ Status YBInboundConnectionContext::HandleCall(
   if (!s.ok()) {
     return s;
   }
+  call->RecordPhase(InboundCallPhase::kParsed);
 
   s = Store(call.get());
   if (!s.ok()) {
@@ -321,6 +322,7 @@ bool YBInboundCall::DumpPB(const DumpRunningRpcsRequestPB& req,
   }
   resp->set_elapsed_millis(MonoTime::Now().GetDeltaSince(timing_.time_received)
       .ToMilliseconds());
+  DumpPhases(resp);
   return true;
 }
 
@@ -399,6 +401,16 @@ void YBInboundCall::RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code,
   Respond(AnyMessageConstPtr(&err), false);
 }
 
+void YBInboundCall::RespondBusy(const Status& status, MonoDelta retry_after) {
+  TRACE_EVENT0("rpc", "InboundCall::RespondBusy");
+  ErrorStatusPB err;
+  err.set_message(status.ToString());
+  err.set_code(ErrorStatusPB::ERROR_SERVER_TOO_BUSY);
+  err.set_retry_after_ms(narrow_cast<uint32_t>(retry_after.ToMilliseconds()));
+
+  Respond(AnyMessageConstPtr(&err), false);
+}
+
 void YBInboundCall::RespondApplicationError(int error_ext_id, const std::string& message,
                                             const MessageLite& app_error_pb) {
   ErrorStatusPB err;
@@ -165,6 +165,8 @@ class YBInboundCall : public InboundCall {
   void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code,
                       const Status &status) override;
 
+  void RespondBusy(const Status& status, MonoDelta retry_after) override;
+
   void RespondApplicationError(int error_ext_id, const std::string& message,
                                const google::protobuf::MessageLite& app_error_pb);
 
@@ -184,6 +186,10 @@ class YBInboundCall : public InboundCall {
 
   CoarseTimePoint GetClientDeadline() const override;
 
+  RpcPriorityClass priority_class() const override {
+    return header_.priority_class;
+  }
+
   MonoTime ReceiveTime() const {
     return timing_.time_received;
   }
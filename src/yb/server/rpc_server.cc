@@ -32,6 +32,7 @@
 
 #include "yb/server/rpc_server.h"
 
+#include <algorithm>
 #include <list>
 #include <string>
 #include <vector>
@@ -40,6 +41,7 @@
 #include <boost/preprocessor/stringize.hpp>
 
 #include "yb/gutil/casts.h"
+#include "yb/gutil/strings/split.h"
 
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/service_if.h"
@@ -60,6 +62,12 @@ DEFINE_UNKNOWN_string(rpc_bind_addresses, "0.0.0.0",
               "Currently, ephemeral ports (i.e. port 0) are not allowed.");
 TAG_FLAG(rpc_bind_addresses, stable);
 
+DEFINE_NON_RUNTIME_string(rpc_work_stealing_services, "",
+    "Comma separated list of RPC service names, e.g. yb.tserver.TabletServerService, whose "
+    "calls are executed by the work stealing, NUMA aware thread pool instead of the shared "
+    "queue thread pool.");
+TAG_FLAG(rpc_work_stealing_services, advanced);
+
 DEFINE_UNKNOWN_bool(rpc_server_allow_ephemeral_ports, false,
             "Allow binding to ephemeral ports. This can cause problems, so currently "
             "only allowed in tests.");
@@ -70,6 +78,19 @@ DECLARE_int32(rpc_default_keepalive_time_ms);
 namespace yb {
 namespace server {
 
+namespace {
+
+bool UseWorkStealingThreadPool(const std::string& service_name) {
+  if (FLAGS_rpc_work_stealing_services.empty()) {
+    return false;
+  }
+  std::vector<std::string> services =
+      strings::Split(FLAGS_rpc_work_stealing_services, ",", strings::SkipEmpty());
+  return std::find(services.begin(), services.end(), service_name) != services.end();
+}
+
+} // namespace
+
 RpcServerOptions::RpcServerOptions()
   : rpc_bind_addresses(FLAGS_rpc_bind_addresses),
     connection_keepalive_time_ms(FLAGS_rpc_default_keepalive_time_ms) {
@@ -130,7 +151,8 @@ Status RpcServer::RegisterService(size_t queue_limit,
   const scoped_refptr<MetricEntity>& metric_entity = messenger_->metric_entity();
   string service_name = service->service_name();
 
-  rpc::ThreadPool& thread_pool = messenger_->ThreadPool(priority);
+  rpc::ThreadPool& thread_pool = UseWorkStealingThreadPool(service_name)
+      ? messenger_->WorkStealingThreadPool() : messenger_->ThreadPool(priority);
 
   scoped_refptr<rpc::ServicePool> service_pool(new rpc::ServicePool(
       queue_limit, &thread_pool, &messenger_->scheduler(), std::move(service), metric_entity));
@@ -45,8 +45,11 @@
 #include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/status.h"
+#include "yb/util/test_thread_holder.h"
 #include "yb/util/test_util.h"
 
+DECLARE_bool(mvcc_lock_free_safe_time);
+
 using namespace std::literals;
 using std::vector;
 
@@ -65,6 +68,18 @@ class MvccTest : public YBTest {
  protected:
   void RunRandomizedTest(bool use_ht_lease);
 
+  struct ReadsWithWritesStats {
+    size_t reads = 0;
+    size_t writes = 0;
+  };
+
+  // Runs a writer thread that adds, replicates and aborts operations, concurrently with
+  // num_readers threads that request safe time and check that it does not go backwards.
+  void RunReadsWithWrites(
+      size_t num_readers, CoarseDuration duration, ReadsWithWritesStats* stats);
+
+  int64_t next_op_index_ = 1;
+
   server::ClockPtr clock_;
   MvccManager manager_;
 };
@@ -92,6 +107,9 @@ TEST_F(MvccTest, Basic) {
 }
 
 TEST_F(MvccTest, SafeHybridTimeToReadAt) {
+  // Lock-free safe time calls are not recorded in the operation trace, that is checked below.
+  FLAGS_mvcc_lock_free_safe_time = false;
+
   std::ostringstream mvcc_op_trace_stream;
   manager_.TEST_DumpTrace(&mvcc_op_trace_stream);
   ASSERT_STR_CONTAINS(mvcc_op_trace_stream.str(), "No MVCC operations");
@@ -320,6 +338,98 @@ void MvccTest::RunRandomizedTest(bool use_ht_lease) {
   LOG(INFO) << "Passed: " << yb::ToString(end - start);
 }
 
+void MvccTest::RunReadsWithWrites(
+    size_t num_readers, CoarseDuration duration, ReadsWithWritesStats* stats) {
+  constexpr size_t kMaxPending = 8;
+
+  TestThreadHolder thread_holder;
+  std::atomic<size_t> reads{0};
+  std::atomic<size_t> writes{0};
+
+  thread_holder.AddThreadFunctor([this, &stop = thread_holder.stop_flag(), &writes] {
+    std::deque<std::pair<HybridTime, OpId>> pending;
+    while (!stop.load(std::memory_order_acquire)) {
+      OpId op_id(1, next_op_index_++);
+      auto ht = manager_.AddLeaderPending(op_id);
+      if (RandomWithChance(10)) {
+        manager_.Aborted(ht, op_id);
+        continue;
+      }
+      pending.emplace_back(ht, op_id);
+      // Keep some operations pending, so safe time is limited by the queue most of the time.
+      if (pending.size() >= RandomUniformInt<size_t>(1, kMaxPending)) {
+        manager_.Replicated(pending.front().first, pending.front().second);
+        pending.pop_front();
+        manager_.UpdatePropagatedSafeTimeOnLeader(FixedHybridTimeLease());
+        writes.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    for (const auto& [ht, op_id] : pending) {
+      manager_.Replicated(ht, op_id);
+    }
+  });
+
+  for (size_t i = 0; i != num_readers; ++i) {
+    thread_holder.AddThreadFunctor([this, i, &stop = thread_holder.stop_flag(), &reads] {
+      HybridTime last_safe_time = HybridTime::kMin;
+      while (!stop.load(std::memory_order_acquire)) {
+        HybridTime safe_time;
+        switch (i % 3) {
+          case 0:
+            safe_time = manager_.SafeTime(FixedHybridTimeLease());
+            break;
+          case 1: {
+            auto now = clock_->Now();
+            safe_time = manager_.SafeTime(FixedHybridTimeLease {
+              .time = now,
+              .lease = now,
+            });
+            break;
+          }
+          case 2:
+            safe_time = manager_.SafeTimeForFollower(HybridTime::kMin, CoarseTimePoint::max());
+            break;
+        }
+        ASSERT_TRUE(safe_time.is_valid());
+        ASSERT_GE(safe_time, last_safe_time) << "Reader: " << i;
+        last_safe_time = safe_time;
+        reads.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  thread_holder.WaitAndStop(duration);
+
+  stats->reads = reads.load();
+  stats->writes = writes.load();
+  ASSERT_GT(stats->reads, 0);
+  ASSERT_GT(stats->writes, 0);
+}
+
+TEST_F(MvccTest, ConcurrentSafeTimeWithWrites) {
+  ReadsWithWritesStats stats;
+  ASSERT_NO_FATALS(RunReadsWithWrites(/* num_readers= */ 6, 5s, &stats));
+  LOG(INFO) << "Reads: " << stats.reads << ", writes: " << stats.writes;
+}
+
+// Safe time readers should not contend with writers for the MvccManager mutex, so lock-free safe
+// time should serve at least as many reads as the locked one.
+TEST_F(MvccTest, SafeTimeThroughputWithWrites) {
+  constexpr size_t kNumReaders = 4;
+  const auto kDuration = 3s;
+
+  ReadsWithWritesStats stats[2];
+  for (auto lock_free : {false, true}) {
+    FLAGS_mvcc_lock_free_safe_time = lock_free;
+    auto& mode_stats = stats[lock_free];
+    ASSERT_NO_FATALS(RunReadsWithWrites(kNumReaders, kDuration, &mode_stats));
+    LOG(INFO) << "Lock free: " << lock_free
+              << ", reads/s: " << mode_stats.reads / kDuration.count()
+              << ", writes/s: " << mode_stats.writes / kDuration.count();
+  }
+  ASSERT_GE(stats[true].reads, stats[false].reads);
+}
+
 TEST_F(MvccTest, RandomWithoutHTLease) {
   RunRandomizedTest(false);
 }
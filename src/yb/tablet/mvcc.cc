@@ -56,6 +56,12 @@ DEFINE_test_flag(int64, mvcc_op_trace_num_items, 32,
 DEFINE_test_flag(int32, inject_mvcc_delay_add_leader_pending_ms, 0,
                  "Inject delay after MvccManager::AddLeaderPending read clock.");
 
+DEFINE_RUNTIME_bool(mvcc_lock_free_safe_time, true,
+                    "Calculate safe time without locking MvccManager mutex when there are pending "
+                    "operations, so reads do not contend with the write path. Lock-free calls are "
+                    "not recorded in the MVCC operation trace.");
+TAG_FLAG(mvcc_lock_free_safe_time, advanced);
+
 namespace yb {
 namespace tablet {
 
@@ -274,6 +280,10 @@ void MvccManager::Replicated(HybridTime ht, const OpId& op_id) {
              (QueueItem{ .hybrid_time = ht, .op_id = op_id })) << InvariantViolationLogPrefix();
     queue_.pop_front();
     last_replicated_ = ht;
+    // Publish last replicated before the new queue front, so lock-free reader that does not see
+    // ht in the queue anymore, would see it as last replicated.
+    published_last_replicated_.store(ht, std::memory_order_release);
+    PublishQueueFront();
   }
   cond_.notify_all();
 }
@@ -291,6 +301,7 @@ void MvccManager::Aborted(HybridTime ht, const OpId& op_id) {
              (QueueItem{ .hybrid_time = ht, .op_id = op_id }))
         << InvariantViolationLogPrefix() << "It is allowed to abort only last operation";
     queue_.pop_back();
+    PublishQueueFront();
   }
   cond_.notify_all();
 }
@@ -305,6 +316,12 @@ bool BadNextOpId(const OpId& prev, const OpId& next) {
   return false;
 }
 
+void MvccManager::PublishQueueFront() {
+  queue_front_ht_.store(
+      queue_.empty() ? HybridTime::kInvalid : queue_.front().hybrid_time,
+      std::memory_order_release);
+}
+
 HybridTime MvccManager::AddLeaderPending(const OpId& op_id) {
   std::lock_guard<std::mutex> lock(mutex_);
   auto ht = clock_->Now();
@@ -341,11 +358,17 @@ void MvccManager::AddPending(HybridTime ht, const OpId& op_id, bool is_follower_
 
   HybridTime last_ht_in_queue = queue_.empty() ? HybridTime::kMin : queue_.back().hybrid_time;
 
+  // Lock-free readers could return safe time concurrently, so check against the maxima that they
+  // update as well.
+  auto max_safe_time_with_lease = max_safe_time_with_lease_.load(std::memory_order_acquire);
+  auto max_safe_time_without_lease = max_safe_time_without_lease_.load(std::memory_order_acquire);
+  auto max_safe_time_for_follower = max_safe_time_for_follower_.load(std::memory_order_acquire);
+
   HybridTime sanity_check_lower_bound =
       std::max({
-          max_safe_time_returned_with_lease_.safe_time,
-          max_safe_time_returned_without_lease_.safe_time,
-          max_safe_time_returned_for_follower_.safe_time,
+          max_safe_time_with_lease,
+          max_safe_time_without_lease,
+          max_safe_time_for_follower,
           propagated_safe_time_,
           last_replicated_,
           last_ht_in_queue});
@@ -368,6 +391,9 @@ void MvccManager::AddPending(HybridTime ht, const OpId& op_id, bool is_follower_
          << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_with_lease_)
          << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_without_lease_)
          << LOG_INFO_FOR_HT_LOWER_BOUND_WITH_SOURCE(max_safe_time_returned_for_follower_)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_with_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_without_lease)
+         << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_for_follower)
          << LOG_INFO_FOR_HT_LOWER_BOUND(last_replicated_)
          << LOG_INFO_FOR_HT_LOWER_BOUND(last_ht_in_queue)
          << LOG_INFO_FOR_HT_LOWER_BOUND(propagated_safe_time_)
@@ -406,6 +432,9 @@ void MvccManager::AddPending(HybridTime ht, const OpId& op_id, bool is_follower_
     .hybrid_time = ht,
     .op_id = op_id,
   });
+  if (queue_.size() == 1) {
+    PublishQueueFront();
+  }
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
@@ -417,6 +446,7 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
       op_trace_->Add(SetLastReplicatedTraceItem { .ht = ht });
     }
     last_replicated_ = ht;
+    published_last_replicated_.store(ht, std::memory_order_release);
   }
   cond_.notify_all();
 }
@@ -431,6 +461,7 @@ void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
     }
     if (ht >= propagated_safe_time_) {
       propagated_safe_time_ = ht;
+      published_propagated_safe_time_.store(ht, std::memory_order_release);
     } else {
       LOG_WITH_PREFIX(WARNING)
           << "Received propagated safe time " << ht << " less than the old value: "
@@ -459,6 +490,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(const FixedHybridTimeLease& h
         << InvariantViolationLogPrefix()
         << "ht_lease: " << ht_lease;
     propagated_safe_time_ = safe_time;
+    published_propagated_safe_time_.store(safe_time, std::memory_order_release);
 #else
     // Do not crash in production.
     if (safe_time < propagated_safe_time_) {
@@ -467,6 +499,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(const FixedHybridTimeLease& h
           << ", but now safe time is " << safe_time;
     } else {
       propagated_safe_time_ = safe_time;
+      published_propagated_safe_time_.store(safe_time, std::memory_order_release);
     }
 #endif
 
@@ -493,9 +526,16 @@ void MvccManager::SetLeaderOnlyMode(bool leader_only) {
 // NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
 HybridTime MvccManager::SafeTimeForFollower(
     HybridTime min_allowed, CoarseTimePoint deadline) const NO_THREAD_SAFETY_ANALYSIS {
+  if (GetAtomicFlag(&FLAGS_mvcc_lock_free_safe_time)) {
+    auto safe_time = TryGetSafeTimeForFollowerLockFree(min_allowed);
+    if (safe_time) {
+      return safe_time;
+    }
+  }
+
   std::unique_lock<std::mutex> lock(mutex_);
 
-  if (leader_only_mode_) {
+  if (leader_only_mode_.load(std::memory_order_acquire)) {
     // If there are no followers (RF == 1), use SafeTime() because propagated_safe_time_ might not
     // have a valid value.
     return DoGetSafeTime(min_allowed, deadline, FixedHybridTimeLease(), &lock);
@@ -528,15 +568,18 @@ HybridTime MvccManager::SafeTimeForFollower(
   }
   VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
                       << "), result = " << result.ToString();
-  CHECK_GE(result.safe_time, max_safe_time_returned_for_follower_.safe_time)
+  auto max_safe_time_for_follower = max_safe_time_for_follower_.load(std::memory_order_acquire);
+  CHECK_GE(result.safe_time, max_safe_time_for_follower)
       << InvariantViolationLogPrefix()
       << "result: " << result.ToString()
       << ", max_safe_time_returned_for_follower_: "
-      << max_safe_time_returned_for_follower_.ToString();
+      << max_safe_time_returned_for_follower_.ToString()
+      << ", " << EXPR_VALUE_FOR_LOG(max_safe_time_for_follower);
   VTRACE(2, "Min requested safe time was $0", yb::ToString(min_allowed));
   VTRACE(2, "Returning safe time $0. Source $1", yb::ToString(result.safe_time),
          yb::ToString(result.source));
   max_safe_time_returned_for_follower_ = result;
+  UpdateAtomicMax(&max_safe_time_for_follower_, result.safe_time);
   if (op_trace_) {
     op_trace_->Add(SafeTimeForFollowerTraceItem {
       .min_allowed = min_allowed,
@@ -552,6 +595,13 @@ HybridTime MvccManager::SafeTime(
     HybridTime min_allowed,
     CoarseTimePoint deadline,
     const FixedHybridTimeLease& ht_lease) const NO_THREAD_SAFETY_ANALYSIS {
+  if (GetAtomicFlag(&FLAGS_mvcc_lock_free_safe_time)) {
+    auto safe_time = TryGetSafeTimeLockFree(min_allowed, ht_lease);
+    if (safe_time) {
+      return safe_time;
+    }
+  }
+
   std::unique_lock<std::mutex> lock(mutex_);
   auto safe_time = DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
   if (op_trace_) {
@@ -584,9 +634,10 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
   HybridTime result;
   SafeTimeSource source = SafeTimeSource::kUnknown;
   auto predicate = [this, &result, &source, min_allowed, ht_lease, has_lease] {
+    auto max_safe_time_with_lease = max_safe_time_with_lease_.load(std::memory_order_acquire);
     if (queue_.empty()) {
       result = ht_lease.time.is_valid()
-          ? std::max(max_safe_time_returned_with_lease_.safe_time, ht_lease.time)
+          ? std::max(max_safe_time_with_lease, ht_lease.time)
           : clock_->Now();
       source = SafeTimeSource::kNow;
       VLOG_WITH_PREFIX(2) << "DoGetSafeTime, Now: " << result;
@@ -597,7 +648,7 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
     }
 
     if (has_lease) {
-      auto used_lease = std::max({ht_lease.lease, max_safe_time_returned_with_lease_.safe_time});
+      auto used_lease = std::max({ht_lease.lease, max_safe_time_with_lease});
       if (result > used_lease) {
         result = used_lease;
         source = SafeTimeSource::kHybridTimeLease;
@@ -623,8 +674,8 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
   VLOG_WITH_PREFIX_AND_FUNC(1)
       << "(" << min_allowed << ", " << ht_lease << "),  result = " << result;
 
-  auto enforced_min_time = has_lease ? max_safe_time_returned_with_lease_.safe_time
-                                     : max_safe_time_returned_without_lease_.safe_time;
+  auto& max_safe_time = has_lease ? max_safe_time_with_lease_ : max_safe_time_without_lease_;
+  auto enforced_min_time = max_safe_time.load(std::memory_order_acquire);
   CHECK_GE(result, enforced_min_time)
       << InvariantViolationLogPrefix()
       << ": " << EXPR_VALUE_FOR_LOG(has_lease)
@@ -641,12 +692,99 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
   } else {
     max_safe_time_returned_without_lease_ = { result, source };
   }
+  UpdateAtomicMax(&max_safe_time, result);
   VTRACE(2, "Returning safe time $0. Source $1. Min requested safe time was $2",
          yb::ToString(result), yb::ToString(source), yb::ToString(min_allowed));
   return result;
 }
 
+HybridTime MvccManager::TryGetSafeTimeLockFree(
+    HybridTime min_allowed, const FixedHybridTimeLease& ht_lease) const {
+  // While there are pending operations, safe time is limited by the first of them. All operations
+  // before it were already replicated or aborted, and all operations added later will have greater
+  // hybrid time. When the queue is empty, safe time depends on the clock and the maximum returned
+  // safe time, so it is calculated under the lock.
+  auto queue_front = queue_front_ht_.load(std::memory_order_acquire);
+  if (!queue_front) {
+    return HybridTime::kInvalid;
+  }
+  CHECK(ht_lease.lease.is_valid()) << LogPrefix() << "Bad ht lease: " << ht_lease;
+  CHECK_LE(min_allowed, ht_lease.lease) << LogPrefix();
+
+  const bool has_lease = !ht_lease.empty();
+  auto& max_safe_time = has_lease ? max_safe_time_with_lease_ : max_safe_time_without_lease_;
+  auto enforced_min_time = max_safe_time.load(std::memory_order_acquire);
+
+  auto result = queue_front.Decremented();
+  auto source = SafeTimeSource::kNextInQueue;
+  if (has_lease) {
+    auto used_lease = std::max(ht_lease.lease, enforced_min_time);
+    if (result > used_lease) {
+      result = used_lease;
+      source = SafeTimeSource::kHybridTimeLease;
+    }
+  }
+  auto last_replicated = published_last_replicated_.load(std::memory_order_acquire);
+  if (last_replicated > result) {
+    result = last_replicated;
+    source = SafeTimeSource::kLastReplicated;
+  }
+
+  // We could have read the state before a concurrent reader, that already returned greater safe
+  // time. Let the locked path handle this case as well as waiting for min_allowed.
+  if (result < min_allowed || result < enforced_min_time) {
+    return HybridTime::kInvalid;
+  }
+  UpdateAtomicMax(&max_safe_time, result);
+
+  VLOG_WITH_PREFIX_AND_FUNC(1)
+      << "(" << min_allowed << ", " << ht_lease << "), result = " << result;
+  VTRACE(2, "Returning lock-free safe time $0. Source $1. Min requested safe time was $2",
+         yb::ToString(result), yb::ToString(source), yb::ToString(min_allowed));
+  return result;
+}
+
+HybridTime MvccManager::TryGetSafeTimeForFollowerLockFree(HybridTime min_allowed) const {
+  if (leader_only_mode_.load(std::memory_order_acquire)) {
+    return TryGetSafeTimeLockFree(min_allowed, FixedHybridTimeLease());
+  }
+
+  // Propagated safe time is loaded first, so an operation that was replicated after it was loaded
+  // is either still seen in the queue or is covered by last replicated.
+  SafeTimeWithSource result;
+  auto propagated_safe_time = published_propagated_safe_time_.load(std::memory_order_acquire);
+  auto queue_front = queue_front_ht_.load(std::memory_order_acquire);
+  auto last_replicated = published_last_replicated_.load(std::memory_order_acquire);
+  if (propagated_safe_time > last_replicated) {
+    if (!queue_front || propagated_safe_time < queue_front) {
+      result = { propagated_safe_time, SafeTimeSource::kPropagated };
+    } else {
+      result = { queue_front.Decremented(), SafeTimeSource::kNextInQueue };
+    }
+  } else {
+    result = { last_replicated, SafeTimeSource::kLastReplicated };
+  }
+
+  if (result.safe_time < min_allowed ||
+      result.safe_time < max_safe_time_for_follower_.load(std::memory_order_acquire)) {
+    return HybridTime::kInvalid;
+  }
+  UpdateAtomicMax(&max_safe_time_for_follower_, result.safe_time);
+
+  VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
+                      << "), lock-free result = " << result.ToString();
+  VTRACE(2, "Returning lock-free safe time $0. Source $1. Min requested safe time was $2",
+         yb::ToString(result.safe_time), yb::ToString(result.source), yb::ToString(min_allowed));
+  return result.safe_time;
+}
+
 HybridTime MvccManager::LastReplicatedHybridTime() const {
+  if (GetAtomicFlag(&FLAGS_mvcc_lock_free_safe_time)) {
+    auto result = published_last_replicated_.load(std::memory_order_acquire);
+    VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << result;
+    return result;
+  }
+
   std::lock_guard<std::mutex> lock(mutex_);
   VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << last_replicated_;
   if (op_trace_) {
@@ -31,6 +31,7 @@
 //
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <vector>
@@ -79,6 +80,11 @@ inline std::ostream& operator<<(std::ostream& out, const FixedHybridTimeLease& h
 // methods.
 // Operations could be replicated only in the same order as they were added.
 // Time of newly added operation should be after time of all previously added operations.
+//
+// Operations are added and removed under mutex_, since they arrive in Raft order anyway. While
+// there are pending operations, safe time does not depend on the clock, so it is calculated from
+// the state published to atomics by writers, without locking mutex_. So on a hot tablet readers
+// do not block the write path.
 class MvccManager {
  public:
   // `prefix` is used for logging.
@@ -144,7 +150,7 @@ class MvccManager {
       EXCLUDES(mutex_);
 
   // Returns time of last replicated operation.
-  HybridTime LastReplicatedHybridTime() const EXCLUDES(mutex_);
+  HybridTime LastReplicatedHybridTime() const;
 
   class MvccOpTrace;
 
@@ -156,6 +162,18 @@ class MvccManager {
                            const FixedHybridTimeLease& ht_lease,
                            std::unique_lock<std::mutex>* lock) const REQUIRES(mutex_);
 
+  // Returns safe time calculated from the published state without locking mutex_, or invalid
+  // hybrid time when it cannot be done. I.e. there are no pending operations, so the result depends
+  // on the clock, or the result is less than min_allowed, so we should wait.
+  HybridTime TryGetSafeTimeLockFree(
+      HybridTime min_allowed, const FixedHybridTimeLease& ht_lease) const;
+
+  // Same as above, but for SafeTimeForFollower.
+  HybridTime TryGetSafeTimeForFollowerLockFree(HybridTime min_allowed) const;
+
+  // Publishes hybrid time of the first pending operation to queue_front_ht_.
+  void PublishQueueFront() REQUIRES(mutex_);
+
   const std::string& LogPrefix() const { return prefix_; }
 
   struct InvariantViolationLoggingHelper;
@@ -205,12 +223,25 @@ class MvccManager {
   // change.
   HybridTime propagated_safe_time_ = HybridTime::kMin;
   // Special flag for RF==1 mode when propagated_safe_time_ can be not up-to-date.
-  bool leader_only_mode_ = false;
+  std::atomic<bool> leader_only_mode_{false};
 
+  // Values returned by the locked safe time calculation, with their sources for debugging.
   mutable SafeTimeWithSource max_safe_time_returned_with_lease_;
   mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
   mutable SafeTimeWithSource max_safe_time_returned_for_follower_ { HybridTime::kMin };
 
+  // State published for lock-free safe time calculation. Updated by writers under mutex_.
+  // Hybrid time of the first operation in queue_, or invalid hybrid time if it is empty.
+  std::atomic<HybridTime> queue_front_ht_{HybridTime::kInvalid};
+  std::atomic<HybridTime> published_last_replicated_{HybridTime::kMin};
+  std::atomic<HybridTime> published_propagated_safe_time_{HybridTime::kMin};
+
+  // Maximum safe times returned by both locked and lock-free calculations. New operations should
+  // have hybrid time after them.
+  mutable std::atomic<HybridTime> max_safe_time_with_lease_{HybridTime::kMin};
+  mutable std::atomic<HybridTime> max_safe_time_without_lease_{HybridTime::kMin};
+  mutable std::atomic<HybridTime> max_safe_time_for_follower_{HybridTime::kMin};
+
   std::unique_ptr<MvccOpTrace> op_trace_ GUARDED_BY(mutex_);
 };
 
@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/operations/ingest_external_file_operation.h"
+
+#include "yb/consensus/consensus.messages.h"
+
+#include "yb/tablet/tablet.h"
+
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/status_format.h"
+#include "yb/util/status_log.h"
+#include "yb/util/trace.h"
+
+DEFINE_test_flag(bool, skip_ingest_external_file_on_followers, false,
+                 "Used in tests to skip ingesting external file on followers, so it is ingested "
+                 "by tablet bootstrap after restart.");
+
+namespace yb {
+namespace tablet {
+
+template <>
+void RequestTraits<LWIngestExternalFilePB>::SetAllocatedRequest(
+    consensus::LWReplicateMsg* replicate, LWIngestExternalFilePB* request) {
+  replicate->ref_ingest_external_file(request);
+}
+
+template <>
+LWIngestExternalFilePB* RequestTraits<LWIngestExternalFilePB>::MutableRequest(
+    consensus::LWReplicateMsg* replicate) {
+  return replicate->mutable_ingest_external_file();
+}
+
+Status IngestExternalFileOperation::Prepare(IsLeaderSide is_leader_side) {
+  auto tablet = VERIFY_RESULT(tablet_safe());
+  // Apply flushes the memtable before adding the file, start flushing it now, so apply waits only
+  // for records written after this point.
+  WARN_NOT_OK(
+      tablet->Flush(FlushMode::kAsync, FlushFlags::kRegular),
+      Format("Failed to start flush before ingest of $0", staged_file_name()));
+  if (!is_leader_side) {
+    return Status::OK();
+  }
+  // Fail fast on the leader, before the operation is replicated.
+  return tablet->CheckStagedExternalFile(staged_file_name());
+}
+
+Status IngestExternalFileOperation::Apply() {
+  TRACE("APPLY INGEST EXTERNAL FILE: started");
+
+  auto tablet = VERIFY_RESULT(tablet_safe());
+  RETURN_NOT_OK_PREPEND(
+      tablet->IngestExternalFile(this), Format("Failed to ingest $0", staged_file_name()));
+
+  TRACE("APPLY INGEST EXTERNAL FILE: finished");
+  return Status::OK();
+}
+
+Status IngestExternalFileOperation::DoReplicated(int64_t leader_term, Status* complete_status) {
+  if (PREDICT_FALSE(FLAGS_TEST_skip_ingest_external_file_on_followers) &&
+      leader_term == OpId::kUnknownTerm) {
+    LOG_WITH_PREFIX(INFO) << "Skipping ingest of " << staged_file_name() << " on follower";
+    return Status::OK();
+  }
+  return Apply();
+}
+
+Status IngestExternalFileOperation::DoAborted(const Status& status) {
+  return status;
+}
+
+}  // namespace tablet
+}  // namespace yb
@@ -0,0 +1,56 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include "yb/tablet/operations.messages.h"
+#include "yb/tablet/operations/operation.h"
+
+namespace yb {
+namespace tablet {
+
+// Adds SST file built by docdb::ExternalSstFileWriter to the regular DB of the tablet.
+// Only the name of the file staged by the leader in ingest_external_file_dir is replicated, so all
+// peers should have this directory shared. The staged file is removed once all peers applied the
+// operation.
+//
+// Apply rewrites the file and flushes the memtable, so it stalls following operations of the
+// tablet for a time proportional to the file size. Prepare starts the memtable flush in advance.
+class IngestExternalFileOperation
+    : public OperationBase<OperationType::kIngestExternalFile, LWIngestExternalFilePB> {
+ public:
+  template <class... Args>
+  explicit IngestExternalFileOperation(Args&&... args)
+      : OperationBase(std::forward<Args>(args)...) {}
+
+  bool use_mvcc() const override {
+    return true;
+  }
+
+  // Ingests the file. The file is checked by the leader before replication, so any error here
+  // would leave peers in different states and is returned to fail the apply.
+  Status Apply();
+
+  // Returns the name of the staged file, used in logs.
+  Slice staged_file_name() const {
+    return request()->staged_file_name();
+  }
+
+ private:
+  Status Prepare(IsLeaderSide is_leader_side) override;
+  Status DoReplicated(int64_t leader_term, Status* complete_status) override;
+  Status DoAborted(const Status& status) override;
+};
+
+}  // namespace tablet
+}  // namespace yb
@@ -35,6 +35,8 @@
 #include "yb/consensus/consensus.messages.h"
 #include "yb/consensus/consensus_round.h"
 
+#include "yb/rpc/inbound_call.h"
+
 #include "yb/tablet/tablet.h"
 
 #include "yb/tserver/tserver_error.h"
@@ -78,8 +80,16 @@ std::string Operation::ToString() const {
 }
 
 Status Operation::Replicated(int64_t leader_term, WasPending was_pending) {
+  if (inbound_call_) {
+    inbound_call_->RecordPhase(rpc::InboundCallPhase::kReplicated);
+  }
   Status complete_status = Status::OK();
   RETURN_NOT_OK(DoReplicated(leader_term, &complete_status));
+  if (inbound_call_) {
+    inbound_call_->RecordPhase(rpc::InboundCallPhase::kApplied);
+    // Don't keep the call and its request data alive after it is no longer needed.
+    inbound_call_.reset();
+  }
   Replicated(was_pending);
   Release();
   CompleteWithStatus(complete_status);
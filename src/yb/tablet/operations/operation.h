@@ -45,6 +45,7 @@
 #include "yb/consensus/consensus_types.pb.h"
 
 #include "yb/rpc/lightweight_message.h"
+#include "yb/rpc/rpc_fwd.h"
 
 #include "yb/tablet/tablet_fwd.h"
 
@@ -71,7 +72,8 @@ YB_DEFINE_ENUM(
     ((kEmpty, consensus::UNKNOWN_OP))
     ((kHistoryCutoff, consensus::HISTORY_CUTOFF_OP))
     ((kSplit, consensus::SPLIT_OP))
-    ((kChangeAutoFlagsConfig, consensus::CHANGE_AUTO_FLAGS_CONFIG_OP)));
+    ((kChangeAutoFlagsConfig, consensus::CHANGE_AUTO_FLAGS_CONFIG_OP))
+    ((kIngestExternalFile, consensus::INGEST_EXTERNAL_FILE_OP)));
 
 YB_STRONGLY_TYPED_BOOL(WasPending);
 YB_STRONGLY_TYPED_BOOL(IsLeaderSide);
@@ -171,6 +173,12 @@ class Operation {
     completion_clbk_ = std::move(completion_clbk);
   }
 
+  // Sets the rpc call that initiated this operation, so replication and apply phases are recorded
+  // in its timing. Must be set before the operation is submitted.
+  void set_inbound_call(rpc::InboundCallPtr inbound_call) {
+    inbound_call_ = std::move(inbound_call);
+  }
+
   // Sets the hybrid_time for the transaction
   void set_hybrid_time(const HybridTime& hybrid_time) EXCLUDES(mutex_);
 
@@ -257,6 +265,9 @@ class Operation {
   // Optional callback to be called once the transaction completes.
   OperationCompletionCallback completion_clbk_;
 
+  // Optional rpc call that initiated this operation on the leader.
+  rpc::InboundCallPtr inbound_call_;
+
   mutable std::atomic<bool> complete_{false};
 
   mutable simple_spinlock mutex_;
@@ -106,6 +106,11 @@ METRIC_DEFINE_gauge_uint64(tablet, change_auto_flags_config_operations_inflight,
                            yb::MetricUnit::kOperations,
                            "Number of AutoFlags config change operations currently in-flight");
 
+METRIC_DEFINE_gauge_uint64(tablet, ingest_external_file_operations_inflight,
+                           "External file ingest operations in flight",
+                           yb::MetricUnit::kOperations,
+                           "Number of external file ingest operations currently in-flight");
+
 using namespace std::literals;
 using std::shared_ptr;
 using std::vector;
@@ -133,7 +138,8 @@ OperationTracker::Metrics::Metrics(const scoped_refptr<MetricEntity>& entity)
   INSTANTIATE(Empty, empty);
   INSTANTIATE(HistoryCutoff, history_cutoff);
   INSTANTIATE(ChangeAutoFlagsConfig, change_auto_flags_config);
-  static_assert(9== kElementsInOperationType, "Init metrics for all operation types");
+  INSTANTIATE(IngestExternalFile, ingest_external_file);
+  static_assert(10== kElementsInOperationType, "Init metrics for all operation types");
 }
 #undef INSTANTIATE
 #undef GINIT
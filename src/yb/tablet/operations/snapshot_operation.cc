@@ -181,7 +181,8 @@ bool SnapshotOperation::ShouldAllowOpDuringRestore(consensus::OperationType op_t
     case consensus::CHANGE_AUTO_FLAGS_CONFIG_OP:
       return true;
     case consensus::UPDATE_TRANSACTION_OP: FALLTHROUGH_INTENDED;
-    case consensus::WRITE_OP:
+    case consensus::WRITE_OP: FALLTHROUGH_INTENDED;
+    case consensus::INGEST_EXTERNAL_FILE_OP:
       return !FLAGS_consistent_restore;
   }
   FATAL_INVALID_ENUM_VALUE(consensus::OperationType, op_type);
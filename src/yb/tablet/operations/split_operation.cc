@@ -87,7 +87,8 @@ bool SplitOperation::ShouldAllowOpAfterSplitTablet(const consensus::OperationTyp
     case consensus::UPDATE_TRANSACTION_OP: FALLTHROUGH_INTENDED;
     case consensus::TRUNCATE_OP: FALLTHROUGH_INTENDED;
     case consensus::SPLIT_OP: FALLTHROUGH_INTENDED;
-    case consensus::CHANGE_AUTO_FLAGS_CONFIG_OP:
+    case consensus::CHANGE_AUTO_FLAGS_CONFIG_OP: FALLTHROUGH_INTENDED;
+    case consensus::INGEST_EXTERNAL_FILE_OP:
       return false;
   }
   FATAL_INVALID_ENUM_VALUE(consensus::OperationType, op_type);
@@ -13,10 +13,12 @@
 
 #include "yb/tablet/preparer.h"
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 
@@ -29,10 +31,15 @@
 
 #include "yb/tablet/operations/operation_driver.h"
 
+#include "yb/util/atomic.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/flags.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/lockfree.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/threadpool.h"
 
 DEFINE_UNKNOWN_uint64(max_group_replicate_batch_size, 16,
@@ -41,6 +48,25 @@ DEFINE_UNKNOWN_uint64(max_group_replicate_batch_size, 16,
 DEFINE_UNKNOWN_double(estimated_replicate_msg_size_percentage, 0.95,
               "The estimated percentage of replicate message size in a log entry batch.");
 
+DEFINE_RUNTIME_bool(enable_adaptive_group_replicate_batching, false,
+    "Limit leader side replicate batches by size in bytes, adapting the limit to observed WAL "
+    "append and sync latency, instead of using --max_group_replicate_batch_size.");
+TAG_FLAG(enable_adaptive_group_replicate_batching, advanced);
+
+DEFINE_RUNTIME_uint64(adaptive_group_replicate_batch_target_latency_us, 2000,
+    "Adaptive replicate batching grows the batch size limit while full batches are submitted and "
+    "average WAL append and sync latency is below this time, and shrinks it proportionally "
+    "otherwise.");
+TAG_FLAG(adaptive_group_replicate_batch_target_latency_us, advanced);
+
+DEFINE_RUNTIME_uint64(adaptive_group_replicate_batch_min_bytes, 64_KB,
+    "Lower bound of the batch size limit used by adaptive replicate batching.");
+TAG_FLAG(adaptive_group_replicate_batch_min_bytes, advanced);
+
+DEFINE_RUNTIME_uint64(adaptive_group_replicate_batch_max_ops, 1024,
+    "Maximum number of operations in a batch when adaptive replicate batching is enabled.");
+TAG_FLAG(adaptive_group_replicate_batch_max_ops, advanced);
+
 DEFINE_test_flag(int32, preparer_batch_inject_latency_ms, 0,
                  "Inject latency before replicating batch.");
 
@@ -50,18 +76,127 @@ DECLARE_uint64(rpc_max_message_size);
 using namespace std::literals;
 using std::vector;
 
+METRIC_DEFINE_coarse_histogram(tablet, group_replicate_batch_size,
+                               "Group Replicate Batch Size", yb::MetricUnit::kOperations,
+                               "Number of leader side operations submitted to consensus in a "
+                               "single batch.");
+
+METRIC_DEFINE_coarse_histogram(tablet, group_replicate_batch_wait_time,
+                               "Group Replicate Batch Wait Time", yb::MetricUnit::kMicroseconds,
+                               "Time that the first operation of a batch waited for the batch to "
+                               "be submitted to consensus.");
+
+METRIC_DEFINE_gauge_uint64(tablet, group_replicate_batch_limit_bytes,
+                           "Group Replicate Batch Limit", yb::MetricUnit::kBytes,
+                           "Current size limit of leader side batches, used by adaptive replicate "
+                           "batching.");
+
+METRIC_DECLARE_histogram(log_append_latency);
+METRIC_DECLARE_histogram(log_sync_latency);
+
 namespace yb {
 class ThreadPool;
 class ThreadPoolToken;
 
 namespace tablet {
 
+namespace {
+
+// Limit of leader side batch size in bytes, that adapts to WAL latency, in the manner of self-tuning
+// group commit.
+// While full batches are submitted and the WAL keeps up within the target latency the limit is
+// doubled, so a hot tablet quickly reaches batches big enough to amortize the per batch cost. When
+// WAL writes take longer than the target, the limit is reduced proportionally, so operations do not
+// wait behind a batch that is too big for the WAL.
+class AdaptiveBatchLimit {
+ public:
+  explicit AdaptiveBatchLimit(size_t max_bytes)
+      : max_bytes_(max_bytes), limit_bytes_(std::min<size_t>(
+            FLAGS_adaptive_group_replicate_batch_min_bytes, max_bytes)) {}
+
+  size_t limit_bytes() const {
+    return limit_bytes_;
+  }
+
+  void BatchReplicated(bool full, MonoDelta latency) {
+    const auto min_bytes = std::min<size_t>(
+        FLAGS_adaptive_group_replicate_batch_min_bytes, max_bytes_);
+    const auto target_latency_us = std::max<uint64_t>(
+        FLAGS_adaptive_group_replicate_batch_target_latency_us, 1);
+    const auto latency_us = static_cast<uint64_t>(std::max<int64_t>(latency.ToMicroseconds(), 1));
+    if (latency_us > target_latency_us) {
+      limit_bytes_ = limit_bytes_ * target_latency_us / latency_us;
+    } else if (full) {
+      limit_bytes_ = std::min(limit_bytes_ * 2, max_bytes_);
+    }
+    limit_bytes_ = std::clamp(limit_bytes_, min_bytes, max_bytes_);
+  }
+
+ private:
+  const size_t max_bytes_;
+  size_t limit_bytes_;
+};
+
+// Computes average latency of WAL append and sync since the previous sample, from the log metrics
+// of the table. Latency of the log itself is not visible to the preparer, since the WAL append is
+// asynchronous.
+class WalLatencySampler {
+ public:
+  explicit WalLatencySampler(const scoped_refptr<MetricEntity>& table_metric_entity) {
+    if (table_metric_entity) {
+      append_.histogram = METRIC_log_append_latency.Instantiate(table_metric_entity);
+      sync_.histogram = METRIC_log_sync_latency.Instantiate(table_metric_entity);
+    }
+  }
+
+  bool enabled() const {
+    return append_.histogram != nullptr;
+  }
+
+  // Returns average latency of appending a batch to the WAL and syncing it since the previous
+  // call, or nullopt if nothing was appended meanwhile.
+  std::optional<MonoDelta> Sample() {
+    auto append_us = append_.Sample();
+    if (!append_us) {
+      return std::nullopt;
+    }
+    return MonoDelta::FromMicroseconds(*append_us + sync_.Sample().value_or(0));
+  }
+
+ private:
+  struct Source {
+    scoped_refptr<Histogram> histogram;
+    uint64_t total_sum = 0;
+    uint64_t total_count = 0;
+
+    std::optional<uint64_t> Sample() {
+      const auto* hdr = histogram->histogram();
+      const auto sum = hdr->TotalSum();
+      const auto count = hdr->TotalCount();
+      if (count <= total_count) {
+        return std::nullopt;
+      }
+      auto result = (sum - total_sum) / (count - total_count);
+      total_sum = sum;
+      total_count = count;
+      return result;
+    }
+  };
+
+  Source append_;
+  Source sync_;
+};
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 // PreparerImpl
 
 class PreparerImpl {
  public:
-  explicit PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+               const scoped_refptr<MetricEntity>& metric_entity,
+               const scoped_refptr<MetricEntity>& table_metric_entity);
   ~PreparerImpl();
   Status Start();
   void Stop();
@@ -114,6 +249,17 @@ class PreparerImpl {
   const size_t leader_side_batch_size_limit_;
   const size_t leader_side_single_op_size_limit_;
 
+  // Time when the first operation was added to the current leader side batch.
+  CoarseTimePoint leader_side_batch_start_;
+  // Whether the current leader side batch was closed because it reached the size limit.
+  bool leader_side_batch_full_ = false;
+  AdaptiveBatchLimit adaptive_batch_limit_;
+  WalLatencySampler wal_latency_sampler_;
+
+  scoped_refptr<Histogram> batch_size_histogram_;
+  scoped_refptr<Histogram> batch_wait_time_histogram_;
+  scoped_refptr<AtomicGauge<uint64_t>> batch_limit_bytes_gauge_;
+
   std::unique_ptr<ThreadPoolToken> tablet_prepare_pool_token_;
 
   // A temporary buffer of rounds to replicate, used to reduce reallocation.
@@ -126,22 +272,37 @@ class PreparerImpl {
 
   void ProcessFailedItem(OperationDriver* item, Status status);
 
+  // Returns true if the current leader side batch could not accept an operation of the specified
+  // size.
+  bool LeaderSideBatchFull(size_t item_replicate_msg_size) const;
+
   // A wrapper around ProcessAndClearLeaderSideBatch that assumes we are currently holding the
   // mutex.
 
-  void ReplicateSubBatch(OperationDrivers::iterator begin,
-                         OperationDrivers::iterator end);
+  // Replicates the specified operations, returns time spent in consensus.
+  MonoDelta ReplicateSubBatch(OperationDrivers::iterator begin,
+                              OperationDrivers::iterator end);
 };
 
-PreparerImpl::PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool)
+PreparerImpl::PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+                           const scoped_refptr<MetricEntity>& metric_entity,
+                           const scoped_refptr<MetricEntity>& table_metric_entity)
     : consensus_(consensus),
       // Reserve 5% for other LogEntryBatchPB fields in case of big batches.
       leader_side_batch_size_limit_(
           FLAGS_protobuf_message_total_bytes_limit * FLAGS_estimated_replicate_msg_size_percentage),
       leader_side_single_op_size_limit_(
           FLAGS_rpc_max_message_size * FLAGS_estimated_replicate_msg_size_percentage),
+      adaptive_batch_limit_(leader_side_batch_size_limit_),
+      wal_latency_sampler_(table_metric_entity),
       tablet_prepare_pool_token_(tablet_prepare_pool
                                      ->NewToken(ThreadPool::ExecutionMode::SERIAL)) {
+  if (metric_entity) {
+    batch_size_histogram_ = METRIC_group_replicate_batch_size.Instantiate(metric_entity);
+    batch_wait_time_histogram_ = METRIC_group_replicate_batch_wait_time.Instantiate(metric_entity);
+    batch_limit_bytes_gauge_ = METRIC_group_replicate_batch_limit_bytes.Instantiate(
+        metric_entity, adaptive_batch_limit_.limit_bytes());
+  }
 }
 
 PreparerImpl::~PreparerImpl() {
@@ -247,7 +408,8 @@ bool ShouldApplySeparately(OperationType operation_type) {
     case OperationType::kSplit: FALLTHROUGH_INTENDED;
     case OperationType::kEmpty: FALLTHROUGH_INTENDED;
     case OperationType::kHistoryCutoff: FALLTHROUGH_INTENDED;
-    case OperationType::kChangeAutoFlagsConfig:
+    case OperationType::kChangeAutoFlagsConfig: FALLTHROUGH_INTENDED;
+    case OperationType::kIngestExternalFile:
       return true;
 
     case OperationType::kWrite: FALLTHROUGH_INTENDED;
@@ -285,12 +447,16 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
   // Don't add more than the max number of operations to a batch, and also don't add
   // operations bound to different terms, so as not to fail unrelated operations
   // unnecessarily in case of a bound term mismatch.
-  if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
-      leader_side_batch_size_estimate_ + item_replicate_msg_size > leader_side_batch_size_limit_ ||
-      (!leader_side_batch_.empty() &&
-          bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
+  if (LeaderSideBatchFull(item_replicate_msg_size)) {
+    leader_side_batch_full_ = true;
+    ProcessAndClearLeaderSideBatch();
+  } else if (!leader_side_batch_.empty() &&
+             bound_term != leader_side_batch_.back()->consensus_round()->bound_term()) {
     ProcessAndClearLeaderSideBatch();
   }
+  if (leader_side_batch_.empty()) {
+    leader_side_batch_start_ = CoarseMonoClock::now();
+  }
   leader_side_batch_.push_back(item);
   leader_side_batch_size_estimate_ += item_replicate_msg_size;
   if (apply_separately) {
@@ -298,6 +464,22 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
   }
 }
 
+bool PreparerImpl::LeaderSideBatchFull(size_t item_replicate_msg_size) const {
+  if (leader_side_batch_.empty()) {
+    return false;
+  }
+  auto new_size_estimate = leader_side_batch_size_estimate_ + item_replicate_msg_size;
+  if (new_size_estimate > leader_side_batch_size_limit_) {
+    return true;
+  }
+  if (!GetAtomicFlag(&FLAGS_enable_adaptive_group_replicate_batching)) {
+    return leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size;
+  }
+  auto max_ops = GetAtomicFlag(&FLAGS_adaptive_group_replicate_batch_max_ops);
+  return leader_side_batch_.size() >= max_ops ||
+         new_size_estimate > adaptive_batch_limit_.limit_bytes();
+}
+
 void PreparerImpl::ProcessFailedItem(OperationDriver* item, Status status) {
   DCHECK_EQ(leader_side_batch_.size(), 0);
   Status s = item->PrepareAndStart();
@@ -317,9 +499,16 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
           << " leader-side operations, estimated size: " << leader_side_batch_size_estimate_
           << " bytes";
 
+  if (batch_size_histogram_) {
+    batch_size_histogram_->Increment(leader_side_batch_.size());
+    batch_wait_time_histogram_->Increment(
+        MonoDelta(CoarseMonoClock::now() - leader_side_batch_start_).ToMicroseconds());
+  }
+
   auto iter = leader_side_batch_.begin();
   auto replication_subbatch_begin = iter;
   auto replication_subbatch_end = iter;
+  auto replicate_time = MonoDelta::kZero;
 
   // PrepareAndStart does not call Consensus::Replicate anymore as of 07/07/2017, and it is our
   // responsibility to do so in case of success. We call Consensus::ReplicateBatch for batches
@@ -333,7 +522,7 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
     if (PREDICT_TRUE(s.ok())) {
       replication_subbatch_end = ++iter;
     } else {
-      ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
+      replicate_time += ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
 
       // Handle failure for this operation itself.
       operation_driver->HandleFailure(s);
@@ -344,18 +533,32 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   }
 
   // Replicate the remaining batch. No-op for an empty batch.
-  ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
+  replicate_time += ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
+
+  if (GetAtomicFlag(&FLAGS_enable_adaptive_group_replicate_batching)) {
+    // Without log metrics, time spent in consensus is the closest observable cost of a batch.
+    auto latency = wal_latency_sampler_.enabled()
+        ? wal_latency_sampler_.Sample() : std::optional<MonoDelta>(replicate_time);
+    // Keep the limit when no WAL writes completed since the previous batch.
+    if (latency) {
+      adaptive_batch_limit_.BatchReplicated(leader_side_batch_full_, *latency);
+      if (batch_limit_bytes_gauge_) {
+        batch_limit_bytes_gauge_->set_value(adaptive_batch_limit_.limit_bytes());
+      }
+    }
+  }
 
   leader_side_batch_.clear();
   leader_side_batch_size_estimate_ = 0;
+  leader_side_batch_full_ = false;
 }
 
-void PreparerImpl::ReplicateSubBatch(
+MonoDelta PreparerImpl::ReplicateSubBatch(
     OperationDrivers::iterator batch_begin,
     OperationDrivers::iterator batch_end) {
   DCHECK_GE(std::distance(batch_begin, batch_end), 0);
   if (batch_begin == batch_end) {
-    return;
+    return MonoDelta::kZero;
   }
   VLOG(2) << "Replicating a sub-batch of " << std::distance(batch_begin, batch_end)
           << " leader-side operations";
@@ -379,20 +582,26 @@ void PreparerImpl::ReplicateSubBatch(
   // Operation successfully processed by ReplicateBatch, but ReplicateBatch did not return yet.
   // Submit of follower side operation is called from another thread.
   bool should_fail = prepare_should_fail_.load(std::memory_order_acquire);
+  auto start = MonoTime::Now();
   const Status s = consensus_->ReplicateBatch(rounds_to_replicate_);
+  auto replicate_time = MonoTime::Now() - start;
   rounds_to_replicate_.clear();
 
   if (s.ok() && should_fail) {
     LOG(DFATAL) << "Operations should fail, but was successfully prepared: "
                 << AsString(boost::make_iterator_range(batch_begin, batch_end));
   }
+  return replicate_time;
 }
 
 // ------------------------------------------------------------------------------------------------
 // Preparer
 
-Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread)
-    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread)) {
+Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread,
+                   const scoped_refptr<MetricEntity>& metric_entity,
+                   const scoped_refptr<MetricEntity>& table_metric_entity)
+    : impl_(std::make_unique<PreparerImpl>(
+          consensus, tablet_prepare_thread, metric_entity, table_metric_entity)) {
 }
 
 Preparer::~Preparer() = default;
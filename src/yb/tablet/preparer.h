@@ -13,8 +13,10 @@
 
 #pragma once
 
-#include "yb/util/flags.h"
+#include "yb/gutil/ref_counted.h"
 
+#include "yb/util/flags.h"
+#include "yb/util/metrics_fwd.h"
 #include "yb/util/status_fwd.h"
 #include "yb/util/threadpool.h"
 
@@ -39,7 +41,11 @@ class PreparerImpl;
 // Preparer does not manage a thread but only submits to a token in a thread pool.
 class Preparer {
  public:
-  explicit Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  // Batch size and wait time metrics are registered in metric_entity, when it is not null.
+  // Adaptive batching uses WAL latency from log metrics of table_metric_entity, when it is not null.
+  Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+           const scoped_refptr<MetricEntity>& metric_entity = nullptr,
+           const scoped_refptr<MetricEntity>& table_metric_entity = nullptr);
   ~Preparer();
 
   Status Start();
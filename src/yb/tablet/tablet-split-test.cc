@@ -38,6 +38,10 @@
 DECLARE_int64(db_write_buffer_size);
 DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(rocksdb_level0_file_num_compaction_trigger);
+DECLARE_uint32(tablet_key_access_min_samples_for_split);
+DECLARE_uint32(tablet_key_access_sample_interval);
+
+using namespace std::literals;
 
 namespace yb {
 namespace tablet {
@@ -232,6 +236,55 @@ TEST_F(TabletSplitTest, SplitTablet) {
   ASSERT_TRUE(source_docdb_dump.empty()) << boost::algorithm::join(source_docdb_dump, "\n");
 }
 
+TEST_F(TabletSplitTest, SplitKeyByAccess) {
+  constexpr int kNumRows = 1000;
+  constexpr int kNumHotRows = 10;
+  constexpr int kNumHotWrites = 2000;
+  constexpr size_t kBatchSize = 100;
+
+  FLAGS_tablet_key_access_sample_interval = 1;
+  FLAGS_tablet_key_access_min_samples_for_split = 100;
+
+  ASSERT_NOK(tablet()->GetEncodedMedianAccessedSplitKey());
+  const auto start = CoarseMonoClock::now();
+  tablet()->access_tracker().TakeRates(start);
+
+  LocalTabletWriter::Batch batch;
+  for (int i = 0; i != kNumRows; ++i) {
+    InsertRow(i, "cold", &batch);
+    if (batch.size() >= kBatchSize) {
+      ASSERT_OK(writer_->WriteBatch(&batch));
+    }
+  }
+
+  // Keep writing to a few rows, so they take over the whole sample of accessed keys.
+  docdb::DocKeyHash min_hot_hash_code = std::numeric_limits<docdb::DocKeyHash>::max();
+  docdb::DocKeyHash max_hot_hash_code = std::numeric_limits<docdb::DocKeyHash>::min();
+  for (int i = 0; i != kNumHotWrites; ++i) {
+    const auto hash_code = InsertRow(i % kNumHotRows, "hot", &batch);
+    min_hot_hash_code = std::min(min_hot_hash_code, hash_code);
+    max_hot_hash_code = std::max(max_hot_hash_code, hash_code);
+    if (batch.size() >= kBatchSize) {
+      ASSERT_OK(writer_->WriteBatch(&batch));
+    }
+  }
+
+  auto rates = tablet()->access_tracker().TakeRates(start + 1s);
+  ASSERT_DOUBLE_EQ(rates.write_ops_per_sec, kNumRows + kNumHotWrites);
+  ASSERT_DOUBLE_EQ(rates.read_ops_per_sec, 0);
+
+  std::string partition_split_key;
+  const auto split_key =
+      ASSERT_RESULT(tablet()->GetEncodedMedianAccessedSplitKey(&partition_split_key));
+  const auto split_hash_code =
+      dockv::PartitionSchema::DecodeMultiColumnHashValue(partition_split_key);
+  LOG(INFO) << "Split hash code: " << split_hash_code << ", hot hash codes: ["
+            << min_hot_hash_code << ", " << max_hot_hash_code << "]";
+  ASSERT_GE(split_hash_code, min_hot_hash_code);
+  ASSERT_LE(split_hash_code, max_hot_hash_code);
+  ASSERT_EQ(ASSERT_RESULT(dockv::DocKey::DecodeHash(split_key)), split_hash_code);
+}
+
 // TODO: Need to test with distributed transactions both pending and committed
 // (but not yet applied) during split.
 // Split tablets should not return unexpected data for not yet applied, but committed transactions
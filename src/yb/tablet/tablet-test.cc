@@ -54,6 +54,7 @@
 #include "yb/tablet/tablet-test-base.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
+#include "yb/tablet/tablet_write_throttler.h"
 
 #include "yb/util/enums.h"
 #include "yb/util/slice.h"
@@ -64,6 +65,13 @@
 using std::string;
 using std::vector;
 
+using namespace std::literals;
+
+DECLARE_uint32(tablet_write_throttling_memtable_backlog);
+DECLARE_uint64(tablet_write_throttling_min_rate_bytes_per_sec);
+DECLARE_uint32(tablet_write_throttling_burst_ms);
+DECLARE_double(tablet_write_throttling_sst_files_ratio);
+
 namespace yb {
 namespace tablet {
 
@@ -225,5 +233,115 @@ TYPED_TEST(TestTablet, TestFlushedOpId) {
   ASSERT_EQ(id.index, start_index + 2*kCount);
 }
 
+TEST(TabletWriteThrottlerTest, ThrottleOnStallSignals) {
+  FLAGS_tablet_write_throttling_memtable_backlog = 1;
+  FLAGS_tablet_write_throttling_min_rate_bytes_per_sec = 1024;
+  FLAGS_tablet_write_throttling_burst_ms = 100;
+
+  TabletWriteThrottler throttler;
+  auto now = CoarseMonoClock::now();
+  const WriteStallSignals kNoStall;
+  throttler.UpdateSignals(kNoStall, now);
+
+  // Write 1MB/s while RocksDB keeps up.
+  for (int i = 0; i != 10; ++i) {
+    throttler.Consume(100'000);
+    now += 100ms;
+    ASSERT_EQ(throttler.Admit(now), MonoDelta::kZero);
+    throttler.UpdateSignals(kNoStall, now);
+  }
+  ASSERT_FALSE(throttler.active());
+
+  // One memtable waiting for flush halves the observed rate.
+  WriteStallSignals signals;
+  signals.num_unflushed_memtables = 1;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_TRUE(throttler.active());
+  ASSERT_NEAR(throttler.rate(), 500'000, 1);
+
+  // Bucket starts with 100ms of tokens, so 150KB write puts it 100KB into debt, i.e. 200ms.
+  ASSERT_EQ(throttler.Admit(now), MonoDelta::kZero);
+  throttler.Consume(150'000);
+  ASSERT_NEAR(throttler.Admit(now).ToSeconds(), 0.2, 1e-3);
+  now += 100ms;
+  ASSERT_NEAR(throttler.Admit(now).ToSeconds(), 0.1, 1e-3);
+  now += 100ms;
+  ASSERT_EQ(throttler.Admit(now), MonoDelta::kZero);
+
+  // Each additional memtable halves the rate further.
+  signals.num_unflushed_memtables = 2;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_NEAR(throttler.rate(), 250'000, 1);
+
+  // Rate picked by RocksDB write controller is used when it is lower, but not below the min rate.
+  signals.delayed_write_rate = 100'000;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_NEAR(throttler.rate(), 100'000, 1);
+  signals.delayed_write_rate = 10;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_NEAR(throttler.rate(), 1024, 1e-3);
+
+  signals.write_stopped = true;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_EQ(throttler.Admit(now), MonoDelta::kMax);
+
+  throttler.UpdateSignals(kNoStall, now);
+  ASSERT_FALSE(throttler.active());
+  ASSERT_EQ(throttler.Admit(now), MonoDelta::kZero);
+}
+
+TEST(TabletWriteThrottlerTest, ThrottleOnSstFiles) {
+  FLAGS_tablet_write_throttling_memtable_backlog = 1;
+  FLAGS_tablet_write_throttling_sst_files_ratio = 0.5;
+  FLAGS_tablet_write_throttling_min_rate_bytes_per_sec = 1024;
+  FLAGS_tablet_write_throttling_burst_ms = 100;
+
+  TabletWriteThrottler throttler;
+  auto now = CoarseMonoClock::now();
+  WriteStallSignals signals;
+  throttler.UpdateSignals(signals, now);
+
+  // Write 1MB/s while number of SST files is below the threshold.
+  signals.sst_files_ratio = 0.25;
+  for (int i = 0; i != 10; ++i) {
+    throttler.Consume(100'000);
+    now += 100ms;
+    ASSERT_EQ(throttler.Admit(now), MonoDelta::kZero);
+    throttler.UpdateSignals(signals, now);
+  }
+  ASSERT_FALSE(throttler.active());
+
+  // Rate decreases linearly from the observed rate at the threshold to the min rate at the limit.
+  signals.sst_files_ratio = 0.5;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_TRUE(throttler.active());
+  ASSERT_NEAR(throttler.rate(), 1'000'000, 1);
+
+  signals.sst_files_ratio = 0.75;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_NEAR(throttler.rate(), 500'000, 1);
+
+  signals.sst_files_ratio = 1.5;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_NEAR(throttler.rate(), 1024, 1e-3);
+
+  // Lower rate from other signals still wins.
+  signals.sst_files_ratio = 0.75;
+  signals.num_unflushed_memtables = 2;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_NEAR(throttler.rate(), 250'000, 1);
+
+  signals.num_unflushed_memtables = 0;
+  signals.sst_files_ratio = 0.25;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_FALSE(throttler.active());
+
+  // SST files are ignored when the threshold is not set.
+  FLAGS_tablet_write_throttling_sst_files_ratio = 0;
+  signals.sst_files_ratio = 1.5;
+  throttler.UpdateSignals(signals, now);
+  ASSERT_FALSE(throttler.active());
+}
+
 } // namespace tablet
 } // namespace yb
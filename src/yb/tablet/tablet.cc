@@ -32,6 +32,7 @@
 
 #include "yb/tablet/tablet.h"
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/container/static_vector.hpp>
 
 #include "yb/client/auto_flags_manager.h"
@@ -69,15 +70,20 @@
 #include "yb/docdb/docdb_debug.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_statistics.h"
+#include "yb/docdb/external_sst_file_writer.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/ql_rocksdb_storage.h"
 #include "yb/docdb/redis_operation.h"
 #include "yb/docdb/rocksdb_writer.h"
+#include "yb/dockv/doc_key.h"
+#include "yb/dockv/key_bytes.h"
 #include "yb/dockv/value_type.h"
 
 #include "yb/gutil/casts.h"
 
+#include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/sst_file_writer.h"
 #include "yb/rocksdb/utilities/checkpoint.h"
 
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -85,6 +91,7 @@
 #include "yb/server/hybrid_clock.h"
 
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_external_file_operation.h"
 #include "yb/tablet/operations/operation.h"
 #include "yb/tablet/operations/snapshot_operation.h"
 #include "yb/tablet/operations/split_operation.h"
@@ -106,14 +113,18 @@
 
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
+#include "yb/util/env.h"
 #include "yb/util/flags.h"
 #include "yb/util/format.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/path_util.h"
 #include "yb/util/pg_util.h"
+#include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
+#include "yb/util/shared_lock.h"
 #include "yb/util/status_format.h"
 #include "yb/util/status_log.h"
 #include "yb/util/stopwatch.h"
@@ -251,6 +262,11 @@ DEFINE_RUNTIME_bool(tablet_exclusive_post_split_compaction, false,
        "unscheduled compactions are run before post-split compaction and no other compaction "
        "will get scheduled during post-split compaction.");
 
+DEFINE_NON_RUNTIME_string(ingest_external_file_dir, "",
+    "Directory of SST files ingested by the IngestExternalFile RPC. It should be shared by all "
+    "tablet servers, e.g. a network file system mounted at the same path. Files to ingest should "
+    "be placed in it, and they are staged in it for replication. Ingest is disabled when empty.");
+
 // FLAGS_TEST_disable_getting_user_frontier_from_mem_table is used in conjunction with
 // FLAGS_TEST_disable_adding_user_frontier_to_sst.  Two flags are needed for the case in which
 // we're writing a mixture of SST files with and without UserFrontiers, to ensure that we're
@@ -278,6 +294,7 @@ DEFINE_test_flag(uint64, inject_sleep_before_applying_intents_ms, 0,
                  "Sleep before applying intents to docdb after transaction commit");
 
 DECLARE_bool(TEST_invalidate_last_change_metadata_op);
+DECLARE_bool(enable_tablet_write_throttling);
 
 using namespace std::placeholders;
 
@@ -469,6 +486,9 @@ Tablet::Tablet(const TabletInitData& data)
   LOG_WITH_PREFIX(INFO) << "Schema version for " << metadata_->table_name() << " is "
                         << metadata_->schema_version();
 
+  // Witness skips applying ops replayed by tablet bootstrap, before the Raft config is known.
+  is_witness_.store(metadata_->is_witness(), std::memory_order_release);
+
   if (data.metric_registry) {
     MetricEntity::AttributeMap attrs;
     // TODO(KUDU-745): table_id is apparently not set in the metadata.
@@ -1379,6 +1399,12 @@ SplitExternalBatchIntoTransactionBatches(
 
 } // namespace
 
+void Tablet::SetIsWitness(bool is_witness) {
+  if (is_witness_.exchange(is_witness, std::memory_order_acq_rel) != is_witness) {
+    LOG_WITH_PREFIX(INFO) << (is_witness ? "Became" : "No longer") << " a witness replica";
+  }
+}
+
 Status Tablet::ApplyKeyValueRowOperations(
     int64_t batch_idx,
     const docdb::LWKeyValueWriteBatchPB& put_batch,
@@ -1390,6 +1416,11 @@ Status Tablet::ApplyKeyValueRowOperations(
     return Status::OK();
   }
 
+  // Witness keeps ops only in the WAL.
+  if (is_witness()) {
+    return Status::OK();
+  }
+
   // Could return failure only for cases where it is safe to skip applying operations to DB.
   // For instance where aborted transaction intents are written.
   // In all other cases we should crash instead of skipping apply.
@@ -1485,6 +1516,7 @@ void Tablet::WriteToRocksDB(
     LOG_WITH_PREFIX(FATAL) << "Failed to write a batch with " << write_batch->Count()
                            << " operations into RocksDB: " << rocksdb_write_status;
   }
+  write_throttler_.Consume(write_batch->GetDataSize());
 
   if (FLAGS_TEST_docdb_log_write_batches) {
     LOG_WITH_PREFIX(INFO)
@@ -1505,6 +1537,7 @@ Status Tablet::HandleRedisReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  RecordKeyAccess(TabletAccessType::kRead, AccessedHashCode(redis_read_request.key_value()));
 
   docdb::RedisReadOperation doc_op(redis_read_request, doc_db(), deadline, read_time);
   RETURN_NOT_OK(doc_op.Execute());
@@ -1540,6 +1573,7 @@ Status Tablet::HandleQLReadRequest(
   auto scoped_read_operation = CreateNonAbortableScopedRWOperation(deadline);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  RecordKeyAccess(TabletAccessType::kRead, AccessedHashCode(ql_read_request));
 
   bool schema_version_compatible = IsSchemaVersionCompatible(
       metadata()->schema_version(), ql_read_request.schema_version(),
@@ -1633,6 +1667,9 @@ Status Tablet::HandlePgsqlReadRequest(
   auto scoped_read_operation = CreateNonAbortableScopedRWOperation(deadline);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  RecordKeyAccess(
+      TabletAccessType::kRead, AccessedHashCode(pgsql_read_request),
+      pgsql_read_request.ybctid_column_value().value().binary_value());
 
   const shared_ptr<tablet::TableInfo> table_info =
       VERIFY_RESULT(metadata_->GetTableInfo(pgsql_read_request.table_id()));
@@ -3156,6 +3193,164 @@ Status Tablet::Truncate(TruncateOperation* operation) {
   return DoEnableCompactions();
 }
 
+Status Tablet::CheckExternalFile(Slice file_path) {
+  auto scoped_operation = CreateNonAbortableScopedRWOperation();
+  RETURN_NOT_OK(scoped_operation);
+
+  return DoCheckExternalFile(file_path.ToBuffer());
+}
+
+Status Tablet::DoCheckExternalFile(const std::string& file_path) {
+  SCHECK(regular_db_, IllegalState, "Tablet does not have regular DB");
+
+  rocksdb::ExternalSstFileInfo file_info;
+  RETURN_NOT_OK(regular_db_->GetExternalSstFileInfo(file_path, &file_info));
+
+  // The file could contain records of this tablet only, without hybrid time.
+  // Only the smallest and the largest keys are checked, since the file is built by
+  // docdb::ExternalSstFileWriter that checks each record.
+  auto partition_bounds = VERIFY_RESULT(docdb::PartitionKeyBounds(
+      *metadata_->partition(), *metadata_->partition_schema()));
+  for (Slice key : {Slice(file_info.smallest_key), Slice(file_info.largest_key)}) {
+    if (!partition_bounds.IsWithinBounds(key) || !key_bounds_.IsWithinBounds(key)) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Key $0 of $1 is out of tablet bounds", key.ToDebugHexString(),
+          file_path);
+    }
+    dockv::SubDocKey sub_doc_key;
+    RETURN_NOT_OK_PREPEND(
+        sub_doc_key.FullyDecodeFrom(key, dockv::HybridTimeRequired::kFalse),
+        Format("Bad key in $0", file_path));
+    if (sub_doc_key.has_hybrid_time()) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Key $0 of $1 has hybrid time", key.ToDebugHexString(), file_path);
+    }
+  }
+  return Status::OK();
+}
+
+namespace {
+
+Result<std::string> IngestExternalFileDir() {
+  SCHECK(!FLAGS_ingest_external_file_dir.empty(), NotSupported,
+         "Ingest of external files is disabled, ingest_external_file_dir is not set");
+  return Env::Default()->Canonicalize(FLAGS_ingest_external_file_dir);
+}
+
+// Returns path of the staged file in the ingest directory of this tablet server.
+Result<std::string> StagedExternalFilePath(Slice staged_file_name) {
+  auto name = staged_file_name.ToBuffer();
+  SCHECK_FORMAT(
+      !name.empty() && name.find('/') == std::string::npos && name != "." && name != "..",
+      Corruption, "Bad staged file name: $0", name);
+  return JoinPathSegments(VERIFY_RESULT(IngestExternalFileDir()), name);
+}
+
+} // namespace
+
+Status Tablet::CheckStagedExternalFile(Slice staged_file_name) {
+  auto scoped_operation = CreateNonAbortableScopedRWOperation();
+  RETURN_NOT_OK(scoped_operation);
+
+  return DoCheckExternalFile(VERIFY_RESULT(StagedExternalFilePath(staged_file_name)));
+}
+
+Result<std::string> Tablet::StageExternalFile(Slice file_path) {
+  auto scoped_operation = CreateNonAbortableScopedRWOperation();
+  RETURN_NOT_OK(scoped_operation);
+
+  // Only files from the shared directory are accepted, so followers could read the staged file.
+  auto dir = VERIFY_RESULT(IngestExternalFileDir());
+  auto source_path = VERIFY_RESULT(Env::Default()->Canonicalize(file_path.ToBuffer()));
+  if (!boost::starts_with(source_path, dir + "/")) {
+    return STATUS_FORMAT(
+        InvalidArgument, "$0 is not in ingest_external_file_dir $1", source_path, dir);
+  }
+  RETURN_NOT_OK(DoCheckExternalFile(source_path));
+
+  auto staged_file_name = Format("$0-$1.staged", tablet_id(), ThreadLocalRandom()());
+  RETURN_NOT_OK(rocksdb::LinkExternalSstFile(
+      regular_db_->GetEnv(), source_path, JoinPathSegments(dir, staged_file_name)));
+  return staged_file_name;
+}
+
+Status Tablet::IngestExternalFile(IngestExternalFileOperation* operation) {
+  auto scoped_operation = CreateNonAbortableScopedRWOperation();
+  RETURN_NOT_OK(scoped_operation);
+
+  auto staged_path = VERIFY_RESULT(StagedExternalFilePath(
+      operation->request()->staged_file_name()));
+  RETURN_NOT_OK(DoCheckExternalFile(staged_path));
+
+  // Records are written at the hybrid time of the operation, so they become visible to reads
+  // at the same time as a regular write replicated at this op id would.
+  const auto op_id = operation->op_id();
+  auto local_path = JoinPathSegments(
+      metadata_->rocksdb_dir(), Format("ingest-$0-$1.sst", op_id.term, op_id.index));
+  auto num_records = VERIFY_RESULT(docdb::RewriteExternalSstFile(
+      regular_db_->GetOptions(), staged_path, local_path, operation->hybrid_time()));
+
+  // The ingested file advances the flushed op id to the op id of this operation, so records of
+  // all previous operations should be flushed first. The flush was started when the operation was
+  // prepared, so it should wait only for records written after that.
+  RETURN_NOT_OK(regular_db_->Flush(rocksdb::FlushOptions()));
+
+  rocksdb::ExternalSstFileInfo file_info;
+  RETURN_NOT_OK(regular_db_->GetExternalSstFileInfo(local_path, &file_info));
+  // All keys have the hybrid time of this operation, so none of them is present in the DB, even
+  // when the key range of the file overlaps existing records.
+  file_info.allow_overlap = true;
+  docdb::ConsensusFrontiers frontiers;
+  auto frontiers_ptr = InitFrontiers(
+      op_id, operation->hybrid_time(), /* commit_ht= */ HybridTime::kInvalid, &frontiers);
+  if (frontiers_ptr) {
+    frontiers_ptr->Largest().set_max_value_level_ttl_expiration_time(
+        dockv::FileExpirationFromValueTTL(
+            operation->hybrid_time(), dockv::ValueControlFields::kMaxTtl));
+    file_info.frontiers = frontiers_ptr;
+  }
+  RETURN_NOT_OK(regular_db_->AddFile(&file_info, /* move_file= */ true));
+
+  {
+    std::lock_guard lock(staged_external_files_mutex_);
+    staged_external_files_.emplace_back(op_id, std::move(staged_path));
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Ingested " << num_records << " records from "
+                        << staged_path << " at "
+                        << operation->hybrid_time() << ", op id " << op_id;
+  return Status::OK();
+}
+
+void Tablet::CleanupStagedExternalFiles(const OpId& applied_op_id) {
+  std::vector<std::string> paths;
+  {
+    std::lock_guard lock(staged_external_files_mutex_);
+    auto it = staged_external_files_.begin();
+    while (it != staged_external_files_.end() && it->first <= applied_op_id) {
+      paths.push_back(std::move(it->second));
+      ++it;
+    }
+    staged_external_files_.erase(staged_external_files_.begin(), it);
+  }
+  if (paths.empty()) {
+    return;
+  }
+  auto scoped_operation = CreateNonAbortableScopedRWOperation();
+  if (!scoped_operation.ok() || !regular_db_) {
+    return;
+  }
+  auto* env = regular_db_->GetEnv();
+  for (const auto& path : paths) {
+    LOG_WITH_PREFIX(INFO) << "Removing staged external file " << path;
+    for (const auto& file : {path, rocksdb::TableBaseToDataFileName(path)}) {
+      if (env->FileExists(file).ok()) {
+        env->CleanupFile(file);
+      }
+    }
+  }
+}
+
 void Tablet::UpdateMonotonicCounter(int64_t value) {
   int64_t counter = monotonic_counter_;
   while (true) {
@@ -3867,6 +4062,105 @@ Result<std::string> Tablet::GetEncodedMiddleSplitKey(std::string *partition_spli
   return middle_key;
 }
 
+Result<std::string> Tablet::GetEncodedMedianAccessedSplitKey(
+    std::string *partition_split_key) const {
+  const Slice partition_start(metadata()->partition()->partition_key_start());
+  const Slice partition_end(metadata()->partition()->partition_key_end());
+  auto median_key = access_tracker_.MedianAccessedKey(partition_start, partition_end);
+  if (median_key.empty()) {
+    return STATUS_FORMAT(
+        Incomplete, "Not enough accessed key samples for tablet $0: $1",
+        tablet_id(), access_tracker_.num_samples());
+  }
+
+  std::string split_key;
+  if (metadata()->partition_schema()->IsHashPartitioning()) {
+    dockv::KeyBytes encoded_hash;
+    dockv::AppendHash(dockv::PartitionSchema::DecodeMultiColumnHashValue(median_key),
+                      &encoded_hash);
+    split_key = encoded_hash.ToStringBuffer();
+    if (partition_split_key) {
+      *partition_split_key = median_key;
+    }
+  } else {
+    split_key = std::move(median_key);
+  }
+
+  const Slice split_key_slice(split_key);
+  if (split_key_slice.compare(key_bounds_.lower) <= 0 ||
+      (!key_bounds_.upper.empty() && split_key_slice.compare(key_bounds_.upper) >= 0)) {
+    return STATUS_FORMAT(
+        IllegalState,
+        "Median accessed key \"$0\" is out of tablet $1 key bounds (\"$2\" - \"$3\")",
+        split_key_slice.ToDebugHexString(), tablet_id(),
+        Slice(key_bounds_.lower).ToDebugHexString(), Slice(key_bounds_.upper).ToDebugHexString());
+  }
+  return split_key;
+}
+
+void Tablet::RecordKeyAccess(
+    TabletAccessType type, std::optional<uint32_t> hash_code, Slice encoded_doc_key) {
+  if (!access_tracker_.Record(type)) {
+    return;
+  }
+  if (metadata_->partition_schema()->IsHashPartitioning()) {
+    if (hash_code) {
+      access_tracker_.AddSample(dockv::PartitionSchema::EncodeMultiColumnHashValue(
+          static_cast<uint16_t>(*hash_code)));
+    }
+  } else {
+    access_tracker_.AddSample(encoded_doc_key);
+  }
+}
+
+namespace {
+
+WriteStallSignals GetWriteStallSignals(rocksdb::DB* db) {
+  WriteStallSignals result;
+  uint64_t value = 0;
+  if (db->GetIntProperty(rocksdb::DB::Properties::kIsWriteStopped, &value)) {
+    result.write_stopped = value != 0;
+  }
+  if (db->GetIntProperty(rocksdb::DB::Properties::kActualDelayedWriteRate, &value)) {
+    result.delayed_write_rate = value;
+  }
+  result.num_unflushed_memtables = db->GetCfdImmNumNotFlushed();
+  return result;
+}
+
+} // namespace
+
+MonoDelta Tablet::AdmitWrite(double sst_files_ratio) {
+  if (!GetAtomicFlag(&FLAGS_enable_tablet_write_throttling)) {
+    return MonoDelta::kZero;
+  }
+  auto now = CoarseMonoClock::now();
+  if (write_throttler_.NeedsSignalsUpdate(now)) {
+    auto scoped_operation = CreateNonAbortableScopedRWOperation();
+    if (!scoped_operation.ok()) {
+      return MonoDelta::kZero;
+    }
+    WriteStallSignals signals;
+    {
+      SharedLock<rw_spinlock> lock(component_lock_);
+      if (regular_db_) {
+        signals = GetWriteStallSignals(regular_db_.get());
+      }
+      if (intents_db_) {
+        signals.Merge(GetWriteStallSignals(intents_db_.get()));
+      }
+    }
+    signals.sst_files_ratio = sst_files_ratio;
+    auto was_active = write_throttler_.active();
+    write_throttler_.UpdateSignals(signals, now);
+    if (write_throttler_.active() != was_active) {
+      LOG_WITH_PREFIX(INFO) << (was_active ? "Stopped" : "Started") << " throttling writes: "
+                            << signals.ToString();
+    }
+  }
+  return write_throttler_.Admit(now);
+}
+
 bool Tablet::HasActiveFullCompaction() {
   std::lock_guard<std::mutex> lock(full_compaction_token_mutex_);
   return HasActiveFullCompactionUnlocked();
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include <boost/intrusive/list.hpp>
 
 #include "yb/common/common_fwd.h"
@@ -57,6 +59,8 @@
 #include "yb/tablet/tablet_fwd.h"
 #include "yb/tablet/abstract_tablet.h"
 #include "yb/tablet/mvcc.h"
+#include "yb/tablet/tablet_access_tracker.h"
+#include "yb/tablet/tablet_write_throttler.h"
 #include "yb/tablet/operations/operation.h"
 #include "yb/tablet/operation_filter.h"
 #include "yb/tablet/tablet_metadata.h"
@@ -455,6 +459,26 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Truncate this tablet by resetting the content of RocksDB.
   Status Truncate(TruncateOperation* operation);
 
+  // Checks that the file staged by StageExternalFile could be ingested into this tablet.
+  Status CheckStagedExternalFile(Slice staged_file_name);
+
+  // Checks SST file built by docdb::ExternalSstFileWriter, that should be in
+  // ingest_external_file_dir, and hard links it, or copies it when it could not be linked, to a new
+  // file in the same directory. Returns name of the new file. Only this name is replicated, so the
+  // client could not move or change the file while tablet peers ingest it, and each peer resolves
+  // it in its own ingest_external_file_dir.
+  Result<std::string> StageExternalFile(Slice file_path);
+
+  // Rewrites the staged file at the hybrid time of the operation to the tablet directory and adds
+  // it to the regular DB. The file and the flushed op id are updated in the same version edit,
+  // so the operation is not replayed after restart once the file is ingested.
+  // Runs on the apply path: the rewrite reads the whole file and the memtable is flushed before
+  // the file is added, so following operations of the tablet are applied only after that.
+  Status IngestExternalFile(IngestExternalFileOperation* operation);
+
+  // Removes staged files of ingest operations applied up to the specified op id.
+  void CleanupStagedExternalFiles(const OpId& applied_op_id);
+
   // Verbosely dump this entire tablet to the logs. This is only
   // really useful when debugging unit tests failures where the tablet
   // has a very small number of rows.
@@ -602,6 +626,26 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // range-based partitions always matches the returned middle key.
   Result<std::string> GetEncodedMiddleSplitKey(std::string *partition_split_key = nullptr) const;
 
+  // Returns the median of recently accessed keys as the split key, so a tablet that is split
+  // because of its load spreads that load between its children. Keys have the same format as the
+  // ones returned by GetEncodedMiddleSplitKey. Returns Incomplete if there are not enough
+  // accessed key samples.
+  Result<std::string> GetEncodedMedianAccessedSplitKey(
+      std::string *partition_split_key = nullptr) const;
+
+  // Counts an access to the tablet and samples the accessed key. hash_code is used for hash
+  // partitioned tables, encoded_doc_key for range partitioned ones, either could be missing.
+  void RecordKeyAccess(
+      TabletAccessType type, std::optional<uint32_t> hash_code, Slice encoded_doc_key = Slice());
+
+  TabletAccessTracker& access_tracker() { return access_tracker_; }
+
+  // Returns zero if a write to the tablet should be admitted. Otherwise returns the delay after
+  // which the write should be retried, because RocksDB signals that flushes or compactions do not
+  // keep up with writes.
+  // sst_files_ratio is the number of SST files relative to the limit at which writes are rejected.
+  MonoDelta AdmitWrite(double sst_files_ratio = 0);
+
   std::string TEST_DocDBDumpStr(IncludeIntents include_intents = IncludeIntents::kFalse);
 
   void TEST_DocDBDumpToContainer(
@@ -691,6 +735,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   void FlushIntentsDbIfNecessary(const yb::OpId& lastest_log_entry_op_id);
 
   bool is_sys_catalog() const { return is_sys_catalog_; }
+
+  // A witness replica persists the WAL and votes, but does not apply ops to DocDB.
+  bool is_witness() const { return is_witness_.load(std::memory_order_acquire); }
+  void SetIsWitness(bool is_witness);
   bool IsTransactionalRequest(bool is_ysql_request) const override;
 
   void SetCleanupPool(ThreadPool* thread_pool);
@@ -843,6 +891,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       bool is_ysql_catalog_table,
       const SubTransactionMetadataPB* subtransaction_metadata = nullptr) const;
 
+  Status DoCheckExternalFile(const std::string& file_path);
+
   // Pause abortable/non-abortable new read/write operations and wait for all
   // abortable/non-abortable pending read/write operations to finish.
   // If stop is false, ScopedRWOperation constructor will wait while ScopedRWOperationPause is
@@ -953,6 +1003,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   MvccManager mvcc_;
 
+  TabletAccessTracker access_tracker_;
+
+  TabletWriteThrottler write_throttler_;
+
   // Lock used to serialize the creation of RocksDB checkpoints.
   mutable std::mutex create_checkpoint_lock_;
 
@@ -978,6 +1032,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   std::unique_ptr<rocksdb::DB> intents_db_;
   std::atomic<bool> rocksdb_shutdown_requested_{false};
 
+  std::atomic<bool> is_witness_{false};
+
   // Optional key bounds (see docdb::KeyBounds) served by this tablet.
   docdb::KeyBounds key_bounds_;
 
@@ -1091,6 +1147,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   AutoFlagsManager* auto_flags_manager_ = nullptr;
 
+  std::mutex staged_external_files_mutex_;
+  // Staged files of applied ingest operations, that could be removed once all peers applied them.
+  std::vector<std::pair<OpId, std::string>> staged_external_files_
+      GUARDED_BY(staged_external_files_mutex_);
+
   mutable std::mutex control_path_mutex_;
   std::unordered_map<std::string, std::shared_ptr<void>> additional_metadata_
     GUARDED_BY(control_path_mutex_);
@@ -0,0 +1,99 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/tablet_access_tracker.h"
+
+#include <algorithm>
+
+#include "yb/util/flags.h"
+
+DEFINE_RUNTIME_uint32(tablet_key_access_sample_interval, 16,
+    "Sample every N-th accessed key of a tablet, samples are used to pick the split key of a "
+    "tablet that is split because of its load. 0 to disable sampling.");
+TAG_FLAG(tablet_key_access_sample_interval, advanced);
+
+DEFINE_RUNTIME_uint32(tablet_key_access_max_samples, 1024,
+    "Max number of accessed key samples kept per tablet.");
+TAG_FLAG(tablet_key_access_max_samples, advanced);
+
+DEFINE_RUNTIME_uint32(tablet_key_access_min_samples_for_split, 100,
+    "Min number of accessed key samples required to split a tablet at the median accessed key.");
+TAG_FLAG(tablet_key_access_min_samples_for_split, advanced);
+
+namespace yb {
+namespace tablet {
+
+bool TabletAccessTracker::Record(TabletAccessType type) {
+  auto& counter = type == TabletAccessType::kRead ? num_reads_ : num_writes_;
+  auto idx = counter.fetch_add(1, std::memory_order_relaxed);
+  auto interval = FLAGS_tablet_key_access_sample_interval;
+  return interval != 0 && idx % interval == 0;
+}
+
+void TabletAccessTracker::AddSample(Slice partition_key) {
+  if (partition_key.empty()) {
+    return;
+  }
+  size_t max_samples = std::max<uint32_t>(FLAGS_tablet_key_access_max_samples, 1);
+  std::lock_guard lock(samples_mutex_);
+  if (samples_.size() < max_samples) {
+    samples_.push_back(partition_key.ToBuffer());
+    return;
+  }
+  if (next_sample_idx_ >= samples_.size()) {
+    next_sample_idx_ = 0;
+  }
+  samples_[next_sample_idx_++].assign(partition_key.cdata(), partition_key.size());
+}
+
+TabletAccessRates TabletAccessTracker::TakeRates(CoarseTimePoint now) {
+  auto num_reads = num_reads_.load(std::memory_order_relaxed);
+  auto num_writes = num_writes_.load(std::memory_order_relaxed);
+  TabletAccessRates result;
+  std::lock_guard lock(rates_mutex_);
+  if (last_rates_time_ != CoarseTimePoint() && now > last_rates_time_) {
+    auto seconds = MonoDelta(now - last_rates_time_).ToSeconds();
+    result.read_ops_per_sec = (num_reads - last_num_reads_) / seconds;
+    result.write_ops_per_sec = (num_writes - last_num_writes_) / seconds;
+  }
+  last_num_reads_ = num_reads;
+  last_num_writes_ = num_writes;
+  last_rates_time_ = now;
+  return result;
+}
+
+std::string TabletAccessTracker::MedianAccessedKey(Slice lower, Slice upper) const {
+  std::vector<Slice> keys;
+  std::lock_guard lock(samples_mutex_);
+  keys.reserve(samples_.size());
+  for (const auto& sample : samples_) {
+    Slice key(sample);
+    if (key.compare(lower) > 0 && (upper.empty() || key.compare(upper) < 0)) {
+      keys.push_back(key);
+    }
+  }
+  if (keys.empty() || keys.size() < FLAGS_tablet_key_access_min_samples_for_split) {
+    return std::string();
+  }
+  auto median = keys.begin() + keys.size() / 2;
+  std::nth_element(keys.begin(), median, keys.end());
+  return median->ToBuffer();
+}
+
+size_t TabletAccessTracker::num_samples() const {
+  std::lock_guard lock(samples_mutex_);
+  return samples_.size();
+}
+
+} // namespace tablet
+} // namespace yb
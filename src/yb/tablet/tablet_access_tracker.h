@@ -0,0 +1,82 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/monotime.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace tablet {
+
+YB_DEFINE_ENUM(TabletAccessType, (kRead)(kWrite));
+
+struct TabletAccessRates {
+  double read_ops_per_sec = 0;
+  double write_ops_per_sec = 0;
+};
+
+// Returns hash code of the row accessed by the request, if it is specified.
+template <class PB>
+std::optional<uint32_t> AccessedHashCode(const PB& pb) {
+  return pb.has_hash_code() ? std::optional<uint32_t>(pb.hash_code()) : std::nullopt;
+}
+
+// Tracks the load served by a tablet, so master could split hot tablets regardless of their size.
+// Counts read and write operations and keeps a bounded sample of accessed partition keys, i.e.
+// encoded hash codes for hash partitioned tables and encoded doc keys for range partitioned ones.
+// Newer samples replace the older ones, so the sample follows the recent access pattern.
+class TabletAccessTracker {
+ public:
+  // Counts an access of the specified type. Returns true if the accessed key should be sampled,
+  // in this case the caller is expected to pass it to AddSample.
+  bool Record(TabletAccessType type);
+
+  void AddSample(Slice partition_key) EXCLUDES(samples_mutex_);
+
+  // Returns op rates since the previous call.
+  TabletAccessRates TakeRates(CoarseTimePoint now = CoarseMonoClock::now())
+      EXCLUDES(rates_mutex_);
+
+  // Returns median of sampled partition keys that are strictly between lower and upper bounds
+  // (empty upper bound means no upper limit). Returns empty string if there are not enough samples
+  // within the bounds.
+  std::string MedianAccessedKey(Slice lower, Slice upper) const EXCLUDES(samples_mutex_);
+
+  size_t num_samples() const EXCLUDES(samples_mutex_);
+
+ private:
+  std::atomic<uint64_t> num_reads_{0};
+  std::atomic<uint64_t> num_writes_{0};
+
+  std::mutex rates_mutex_;
+  uint64_t last_num_reads_ GUARDED_BY(rates_mutex_) = 0;
+  uint64_t last_num_writes_ GUARDED_BY(rates_mutex_) = 0;
+  CoarseTimePoint last_rates_time_ GUARDED_BY(rates_mutex_);
+
+  mutable std::mutex samples_mutex_;
+  std::vector<std::string> samples_ GUARDED_BY(samples_mutex_);
+  size_t next_sample_idx_ GUARDED_BY(samples_mutex_) = 0;
+};
+
+} // namespace tablet
+} // namespace yb
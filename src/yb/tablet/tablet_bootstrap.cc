@@ -71,6 +71,7 @@
 #include "yb/tablet/operations/change_auto_flags_config_operation.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
 #include "yb/tablet/operations/history_cutoff_operation.h"
+#include "yb/tablet/operations/ingest_external_file_operation.h"
 #include "yb/tablet/operations/snapshot_operation.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
@@ -992,6 +993,9 @@ class TabletBootstrap {
       case consensus::CHANGE_AUTO_FLAGS_CONFIG_OP:
         return PlayChangeAutoFlagsConfigRequest(replicate);
 
+      case consensus::INGEST_EXTERNAL_FILE_OP:
+        return PlayIngestExternalFileRequest(replicate);
+
       // Unexpected cases:
       case consensus::UNKNOWN_OP:
         return STATUS(IllegalState, Substitute("Unsupported operation type: $0", op_type));
@@ -1653,6 +1657,14 @@ class TabletBootstrap {
     return Status::OK();
   }
 
+  Status PlayIngestExternalFileRequest(consensus::LWReplicateMsg* replicate_msg) {
+    IngestExternalFileOperation operation(tablet_, replicate_msg->mutable_ingest_external_file());
+    operation.set_op_id(OpId::FromPB(replicate_msg->id()));
+    operation.set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
+
+    return operation.Apply();
+  }
+
   Status PlayUpdateTransactionRequest(
       consensus::LWReplicateMsg* replicate_msg,
       AlreadyAppliedToRegularDB already_applied_to_regular_db) {
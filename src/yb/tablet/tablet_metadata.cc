@@ -874,6 +874,7 @@ Status RaftGroupMetadata::LoadFromSuperBlock(const RaftGroupReplicaSuperBlockPB&
     cdc_sdk_safe_time_ = HybridTime::FromPB(superblock.cdc_sdk_safe_time());
     is_under_xcluster_replication_ = superblock.is_under_xcluster_replication();
     hidden_ = superblock.hidden();
+    is_witness_ = superblock.is_witness();
     auto restoration_hybrid_time = HybridTime::FromPB(superblock.restoration_hybrid_time());
     if (restoration_hybrid_time) {
       restoration_hybrid_time_ = restoration_hybrid_time;
@@ -1053,6 +1054,7 @@ void RaftGroupMetadata::ToSuperBlockUnlocked(RaftGroupReplicaSuperBlockPB* super
   pb.set_cdc_sdk_safe_time(cdc_sdk_safe_time_.ToUint64());
   pb.set_is_under_xcluster_replication(is_under_xcluster_replication_);
   pb.set_hidden(hidden_);
+  pb.set_is_witness(is_witness_);
   if (restoration_hybrid_time_) {
     pb.set_restoration_hybrid_time(restoration_hybrid_time_.ToUint64());
   }
@@ -1412,6 +1414,16 @@ bool RaftGroupMetadata::hidden() const {
   return hidden_;
 }
 
+void RaftGroupMetadata::SetIsWitness(bool value) {
+  std::lock_guard<MutexType> lock(data_mutex_);
+  is_witness_ = value;
+}
+
+bool RaftGroupMetadata::is_witness() const {
+  std::lock_guard<MutexType> lock(data_mutex_);
+  return is_witness_;
+}
+
 void RaftGroupMetadata::SetRestorationHybridTime(HybridTime value) {
   std::lock_guard<MutexType> lock(data_mutex_);
   restoration_hybrid_time_ = std::max(restoration_hybrid_time_, value);
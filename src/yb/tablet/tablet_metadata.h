@@ -481,6 +481,9 @@ class RaftGroupMetadata : public RefCountedThreadSafe<RaftGroupMetadata>,
   void SetHidden(bool value);
   bool hidden() const;
 
+  void SetIsWitness(bool value);
+  bool is_witness() const;
+
   void SetRestorationHybridTime(HybridTime value);
   HybridTime restoration_hybrid_time() const;
 
@@ -727,6 +730,8 @@ class RaftGroupMetadata : public RefCountedThreadSafe<RaftGroupMetadata>,
 
   bool hidden_ GUARDED_BY(data_mutex_) = false;
 
+  bool is_witness_ GUARDED_BY(data_mutex_) = false;
+
   HybridTime restoration_hybrid_time_ GUARDED_BY(data_mutex_) = HybridTime::kMin;
 
   // SPLIT_OP ID designated for this tablet (so child tablets will have this unset until they've
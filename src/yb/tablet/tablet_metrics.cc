@@ -100,6 +100,12 @@ METRIC_DEFINE_counter(tablet, majority_sst_files_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to number of majority SST files.");
 
+METRIC_DEFINE_counter(tablet, write_throttling_rejections,
+  "Write Throttling Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of RPC requests rejected because writes to the tablet were throttled on RocksDB write "
+  "stall signals.");
+
 METRIC_DEFINE_counter(tablet, transaction_conflicts,
   "Distributed Transaction Conflicts",
   yb::MetricUnit::kRequests,
@@ -120,6 +126,11 @@ METRIC_DEFINE_counter(tablet, consistent_prefix_read_requests,
     yb::MetricUnit::kRequests,
     "Number of consistent prefix read requests");
 
+METRIC_DEFINE_counter(tablet, read_index_read_requests,
+    "Read Index Read Requests",
+    yb::MetricUnit::kRequests,
+    "Number of strong read requests served by a follower using the leader read index");
+
 METRIC_DEFINE_counter(tablet, pgsql_consistent_prefix_read_rows,
                       "Consistent Prefix Read Requests",
                       yb::MetricUnit::kRequests,
@@ -162,10 +173,12 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& table_entity,
     MINIT(tablet_entity, not_leader_rejections),
     MINIT(tablet_entity, leader_memory_pressure_rejections),
     MINIT(tablet_entity, majority_sst_files_rejections),
+    MINIT(tablet_entity, write_throttling_rejections),
     MINIT(tablet_entity, transaction_conflicts),
     MINIT(tablet_entity, expired_transactions),
     MINIT(tablet_entity, restart_read_requests),
     MINIT(tablet_entity, consistent_prefix_read_requests),
+    MINIT(tablet_entity, read_index_read_requests),
     MINIT(tablet_entity, pgsql_consistent_prefix_read_rows),
     MINIT(tablet_entity, tablet_data_corruptions),
     MINIT(tablet_entity, rows_inserted),
@@ -63,10 +63,12 @@ struct TabletMetrics {
   scoped_refptr<Counter> not_leader_rejections;
   scoped_refptr<Counter> leader_memory_pressure_rejections;
   scoped_refptr<Counter> majority_sst_files_rejections;
+  scoped_refptr<Counter> write_throttling_rejections;
   scoped_refptr<Counter> transaction_conflicts;
   scoped_refptr<Counter> expired_transactions;
   scoped_refptr<Counter> restart_read_requests;
   scoped_refptr<Counter> consistent_prefix_read_requests;
+  scoped_refptr<Counter> read_index_read_requests;
   scoped_refptr<Counter> pgsql_consistent_prefix_read_rows;
   scoped_refptr<Counter> tablet_data_corruptions;
 
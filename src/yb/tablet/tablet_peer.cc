@@ -47,6 +47,7 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_util.h"
 #include "yb/consensus/opid_util.h"
+#include "yb/consensus/quorum_util.h"
 #include "yb/consensus/raft_consensus.h"
 #include "yb/consensus/retryable_requests.h"
 #include "yb/consensus/state_change_context.h"
@@ -69,6 +70,7 @@
 #include "yb/tablet/operations/change_auto_flags_config_operation.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
 #include "yb/tablet/operations/history_cutoff_operation.h"
+#include "yb/tablet/operations/ingest_external_file_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/tablet/operations/snapshot_operation.h"
 #include "yb/tablet/operations/split_operation.h"
@@ -302,7 +304,9 @@ Status TabletPeer::InitTabletPeer(
     operation_tracker_.SetPostTracker(
         std::bind(&RaftConsensus::TrackOperationMemory, consensus_.get(), _1));
 
-    prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    prepare_thread_ = std::make_unique<Preparer>(
+        consensus_.get(), tablet_prepare_pool, tablet_->GetTabletMetricsEntity(),
+        tablet_->GetTableMetricsEntity());
 
     // "Publish" the tablet object right before releasing the lock.
     tablet_obj_state_.store(TabletObjectState::kAvailable, std::memory_order_release);
@@ -394,6 +398,31 @@ void TabletPeer::MajorityReplicated() {
 
 void TabletPeer::ChangeConfigReplicated(const RaftConfigPB& config) {
   tablet_->mvcc_manager()->SetLeaderOnlyMode(config.peers_size() == 1);
+  UpdateIsWitness(config);
+}
+
+void TabletPeer::UpdateIsWitness(const RaftConfigPB& config) {
+  const bool is_witness = consensus::IsRaftConfigWitness(permanent_uuid(), config);
+  if (!is_witness && meta_->is_witness()) {
+    // DocDB of the witness misses ops applied while it was a witness, so it is failed instead,
+    // to be replaced by a new replica that is seeded by remote bootstrap.
+    if (error().ok()) {
+      LOG_WITH_PREFIX(WARNING) << "Witness replica could not become a data replica";
+      SetFailed(STATUS(IllegalState, "Witness replica could not become a data replica"));
+    }
+    return;
+  }
+  if (is_witness && !meta_->is_witness()) {
+    // Persist the witness state before skipping apply, so it is not lost on restart.
+    meta_->SetIsWitness(true);
+    auto status = meta_->Flush();
+    if (!status.ok()) {
+      LOG_WITH_PREFIX(WARNING) << "Failed to persist witness state, keep applying ops: " << status;
+      meta_->SetIsWitness(false);
+      return;
+    }
+  }
+  tablet_->SetIsWitness(is_witness);
 }
 
 uint64_t TabletPeer::NumSSTFiles() {
@@ -423,6 +452,9 @@ Status TabletPeer::Start(const ConsensusBootstrapInfo& bootstrap_info) {
       << "Remove from set of tablets that have been shutdown so as to allow reporting metrics";
     metric_registry_->tablets_shutdown_erase(tablet_id());
 
+    UpdateIsWitness(consensus_->CommittedConfig());
+    RETURN_NOT_OK(error());
+
     RETURN_NOT_OK(consensus_->Start(bootstrap_info));
     RETURN_NOT_OK(UpdateState(RaftGroupStatePB::BOOTSTRAPPING, RaftGroupStatePB::RUNNING,
                               "Incorrect state to start TabletPeer, "));
@@ -866,6 +898,9 @@ consensus::OperationType MapOperationTypeToPB(OperationType operation_type) {
     case OperationType::kChangeAutoFlagsConfig:
       return consensus::CHANGE_AUTO_FLAGS_CONFIG_OP;
 
+    case OperationType::kIngestExternalFile:
+      return consensus::INGEST_EXTERNAL_FILE_OP;
+
     case OperationType::kEmpty:
       LOG(FATAL) << "OperationType::kEmpty cannot be converted to consensus::OperationType";
   }
@@ -1277,6 +1312,11 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::LWReplicateMsg
       return std::make_unique<ChangeAutoFlagsConfigOperation>(
           tablet, replicate_msg->mutable_auto_flags_config());
 
+    case consensus::INGEST_EXTERNAL_FILE_OP:
+      DCHECK(replicate_msg->has_ingest_external_file()) << "INGEST_EXTERNAL_FILE_OP replica"
+          " operation must receive an IngestExternalFilePB";
+      return std::make_unique<IngestExternalFileOperation>(tablet);
+
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
     case consensus::CHANGE_CONFIG_OP:
@@ -1562,6 +1602,20 @@ bool TabletPeer::CanBeDeleted() {
   return true;
 }
 
+void TabletPeer::CleanupStagedExternalFiles() {
+  const auto consensus = shared_raft_consensus();
+  if (!consensus || consensus->LeaderTerm() == OpId::kUnknownTerm) {
+    return;
+  }
+
+  const auto tablet = shared_tablet();
+  if (!tablet) {
+    return;
+  }
+
+  tablet->CleanupStagedExternalFiles(consensus->GetAllAppliedOpId());
+}
+
 rpc::Scheduler& TabletPeer::scheduler() const {
   return messenger_->scheduler();
 }
@@ -436,6 +436,10 @@ class TabletPeer : public std::enable_shared_from_this<TabletPeer>,
   // Might update the can_be_deleted_.
   bool CanBeDeleted();
 
+  // When this peer is leader, removes files staged for ingest operations that were applied by all
+  // peers.
+  void CleanupStagedExternalFiles();
+
   std::string LogPrefix() const;
 
   // Called from RemoteBootstrapSession and RemoteBootstrapAnchorSession to change role of the
@@ -542,6 +546,10 @@ class TabletPeer : public std::enable_shared_from_this<TabletPeer>,
   uint64_t NumSSTFiles() override;
   void ListenNumSSTFilesChanged(std::function<void()> listener) override;
   rpc::Scheduler& scheduler() const override;
+
+  // Switches the tablet to the witness mode when this peer is a witness in the config.
+  void UpdateIsWitness(const consensus::RaftConfigPB& config);
+
   Status CheckOperationAllowed(
       const OpId& op_id, consensus::OperationType op_type) override;
   // Return granular types of on-disk size of this tablet replica, in bytes.
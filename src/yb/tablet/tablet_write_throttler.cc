@@ -0,0 +1,169 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/tablet_write_throttler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "yb/util/flags.h"
+#include "yb/util/format.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_RUNTIME_bool(enable_tablet_write_throttling, false,
+    "Throttle writes to a tablet when RocksDB signals that flushes or compactions do not keep up "
+    "with writes, and ask clients to back off, instead of letting RocksDB stall.");
+
+DEFINE_RUNTIME_uint32(tablet_write_throttling_memtable_backlog, 1,
+    "Number of immutable memtables waiting for flush, at which writes to a tablet start being "
+    "throttled. Each additional memtable halves the allowed write rate. 0 to ignore the flush "
+    "backlog.");
+TAG_FLAG(tablet_write_throttling_memtable_backlog, advanced);
+
+DEFINE_RUNTIME_double(tablet_write_throttling_sst_files_ratio, 0.5,
+    "Number of SST files, relative to --sst_files_soft_limit, at which writes to a tablet start "
+    "being throttled. The allowed write rate decreases linearly from the observed write rate to "
+    "the min rate, as the number of SST files approaches the limit. 0 to ignore SST files.");
+TAG_FLAG(tablet_write_throttling_sst_files_ratio, advanced);
+
+DEFINE_RUNTIME_uint64(tablet_write_throttling_min_rate_bytes_per_sec, 1_MB,
+    "Min write rate a throttled tablet admits, unless RocksDB stopped writes.");
+TAG_FLAG(tablet_write_throttling_min_rate_bytes_per_sec, advanced);
+
+DEFINE_RUNTIME_uint32(tablet_write_throttling_burst_ms, 100,
+    "Bytes a throttled tablet could admit in a burst, in milliseconds of its write rate.");
+TAG_FLAG(tablet_write_throttling_burst_ms, advanced);
+
+DEFINE_RUNTIME_uint32(tablet_write_throttling_signals_refresh_ms, 100,
+    "How often a tablet refreshes RocksDB write stall signals used for write throttling.");
+TAG_FLAG(tablet_write_throttling_signals_refresh_ms, advanced);
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+// Weight of the latest sample in the observed write rate.
+constexpr double kRateSmoothingFactor = 0.3;
+
+constexpr auto kUnlimitedRate = std::numeric_limits<double>::infinity();
+
+} // namespace
+
+void WriteStallSignals::Merge(const WriteStallSignals& rhs) {
+  write_stopped = write_stopped || rhs.write_stopped;
+  if (rhs.delayed_write_rate &&
+      (!delayed_write_rate || rhs.delayed_write_rate < delayed_write_rate)) {
+    delayed_write_rate = rhs.delayed_write_rate;
+  }
+  num_unflushed_memtables = std::max(num_unflushed_memtables, rhs.num_unflushed_memtables);
+  sst_files_ratio = std::max(sst_files_ratio, rhs.sst_files_ratio);
+}
+
+std::string WriteStallSignals::ToString() const {
+  return YB_STRUCT_TO_STRING(
+      write_stopped, delayed_write_rate, num_unflushed_memtables, sst_files_ratio);
+}
+
+bool TabletWriteThrottler::NeedsSignalsUpdate(CoarseTimePoint now) const {
+  return MonoDelta(now - signals_time_.load(std::memory_order_acquire)) >=
+         MonoDelta::FromMilliseconds(FLAGS_tablet_write_throttling_signals_refresh_ms);
+}
+
+void TabletWriteThrottler::UpdateSignals(const WriteStallSignals& signals, CoarseTimePoint now) {
+  auto bytes_written = bytes_written_.load(std::memory_order_relaxed);
+  std::lock_guard lock(mutex_);
+  auto prev_time = signals_time_.load(std::memory_order_relaxed);
+  signals_time_.store(now, std::memory_order_release);
+  auto was_active = active_.load(std::memory_order_relaxed);
+  if (!was_active && prev_time != CoarseTimePoint() && now > prev_time) {
+    auto rate = (bytes_written - last_signals_bytes_) / MonoDelta(now - prev_time).ToSeconds();
+    unthrottled_rate_ = unthrottled_rate_ == 0
+        ? rate : kRateSmoothingFactor * rate + (1 - kRateSmoothingFactor) * unthrottled_rate_;
+  }
+  last_signals_bytes_ = bytes_written;
+
+  double new_rate = kUnlimitedRate;
+  if (signals.write_stopped) {
+    new_rate = 0;
+  } else {
+    if (signals.delayed_write_rate) {
+      new_rate = signals.delayed_write_rate;
+    }
+    auto backlog_threshold = FLAGS_tablet_write_throttling_memtable_backlog;
+    if (backlog_threshold && signals.num_unflushed_memtables >= backlog_threshold &&
+        unthrottled_rate_ > 0) {
+      auto excess = signals.num_unflushed_memtables - backlog_threshold + 1;
+      new_rate = std::min(new_rate, std::ldexp(unthrottled_rate_, -static_cast<int>(excess)));
+    }
+    auto sst_files_threshold = FLAGS_tablet_write_throttling_sst_files_ratio;
+    if (sst_files_threshold > 0 && sst_files_threshold < 1 &&
+        signals.sst_files_ratio >= sst_files_threshold && unthrottled_rate_ > 0) {
+      auto headroom = std::max(1.0 - signals.sst_files_ratio, 0.0) / (1.0 - sst_files_threshold);
+      new_rate = std::min(new_rate, unthrottled_rate_ * headroom);
+    }
+    if (new_rate != kUnlimitedRate) {
+      new_rate = std::max<double>(new_rate, FLAGS_tablet_write_throttling_min_rate_bytes_per_sec);
+    }
+  }
+
+  auto active = new_rate != kUnlimitedRate;
+  if (active && !was_active) {
+    // Start with a full bucket, so writes in flight are not rejected right away.
+    rate_ = new_rate;
+    tokens_ = rate_ * FLAGS_tablet_write_throttling_burst_ms / 1000.0;
+    charged_bytes_ = bytes_written;
+    refill_time_ = now;
+  } else if (active) {
+    RefillUnlocked(now);
+    rate_ = new_rate;
+  }
+  active_.store(active, std::memory_order_release);
+}
+
+void TabletWriteThrottler::RefillUnlocked(CoarseTimePoint now) {
+  auto bytes_written = bytes_written_.load(std::memory_order_relaxed);
+  tokens_ -= bytes_written - charged_bytes_;
+  charged_bytes_ = bytes_written;
+  if (now > refill_time_) {
+    tokens_ += rate_ * MonoDelta(now - refill_time_).ToSeconds();
+    refill_time_ = now;
+  }
+  tokens_ = std::min(tokens_, rate_ * FLAGS_tablet_write_throttling_burst_ms / 1000.0);
+}
+
+MonoDelta TabletWriteThrottler::Admit(CoarseTimePoint now) {
+  if (!active()) {
+    return MonoDelta::kZero;
+  }
+  std::lock_guard lock(mutex_);
+  if (rate_ <= 0) {
+    return MonoDelta::kMax;
+  }
+  RefillUnlocked(now);
+  if (tokens_ >= 0) {
+    return MonoDelta::kZero;
+  }
+  return MonoDelta::FromSeconds(-tokens_ / rate_);
+}
+
+double TabletWriteThrottler::rate() const {
+  std::lock_guard lock(mutex_);
+  return rate_;
+}
+
+} // namespace tablet
+} // namespace yb
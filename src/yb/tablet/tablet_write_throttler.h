@@ -0,0 +1,99 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace tablet {
+
+// Signals RocksDB gives about whether flushes and compactions keep up with writes.
+struct WriteStallSignals {
+  // Writes are stopped until flushes or compactions catch up.
+  bool write_stopped = false;
+
+  // Rate in bytes per second RocksDB delays writes to, 0 if writes are not delayed.
+  uint64_t delayed_write_rate = 0;
+
+  // Number of immutable memtables waiting for flush.
+  uint64_t num_unflushed_memtables = 0;
+
+  // Number of SST files relative to the limit at which writes are rejected, 0 if not known.
+  double sst_files_ratio = 0;
+
+  // Combines signals of several RocksDB instances, i.e. regular and intents DBs.
+  void Merge(const WriteStallSignals& rhs);
+
+  std::string ToString() const;
+};
+
+// Token bucket throttling writes to a tablet at the rate derived from RocksDB stall signals.
+// When the signals are clear, throttling is inactive and admission is a single atomic load.
+// Otherwise, the rate is the delayed write rate picked by RocksDB write controller, lowered further
+// by the memtable flush backlog and by the number of SST files approaching the limit, so writers are
+// slowed down smoothly before RocksDB stops writes or the SST files limit rejects them.
+//
+// Written bytes are charged after the fact, so the bucket could go into debt. Writes are not
+// admitted while it is in debt, and the time needed to pay the debt off is returned to the caller,
+// to be passed to the client as a backoff hint.
+class TabletWriteThrottler {
+ public:
+  // Charges bytes written to RocksDB.
+  void Consume(size_t num_bytes) {
+    bytes_written_.fetch_add(num_bytes, std::memory_order_relaxed);
+  }
+
+  // Returns true if the signals are older than the refresh interval.
+  bool NeedsSignalsUpdate(CoarseTimePoint now) const;
+
+  void UpdateSignals(const WriteStallSignals& signals, CoarseTimePoint now = CoarseMonoClock::now())
+      EXCLUDES(mutex_);
+
+  // Returns zero if the write is admitted, otherwise delay after which it should be retried.
+  // MonoDelta::kMax means writes are stopped until the signals change.
+  MonoDelta Admit(CoarseTimePoint now = CoarseMonoClock::now()) EXCLUDES(mutex_);
+
+  bool active() const {
+    return active_.load(std::memory_order_acquire);
+  }
+
+  // Admission rate in bytes per second, only meaningful while throttling is active.
+  double rate() const EXCLUDES(mutex_);
+
+ private:
+  void RefillUnlocked(CoarseTimePoint now) REQUIRES(mutex_);
+
+  std::atomic<uint64_t> bytes_written_{0};
+  std::atomic<bool> active_{false};
+  std::atomic<CoarseTimePoint> signals_time_{CoarseTimePoint()};
+
+  mutable std::mutex mutex_;
+  // Write rate observed while throttling was inactive, used as the base for the backlog based rate.
+  double unthrottled_rate_ GUARDED_BY(mutex_) = 0;
+  uint64_t last_signals_bytes_ GUARDED_BY(mutex_) = 0;
+
+  double rate_ GUARDED_BY(mutex_) = 0;
+  double tokens_ GUARDED_BY(mutex_) = 0;
+  uint64_t charged_bytes_ GUARDED_BY(mutex_) = 0;
+  CoarseTimePoint refill_time_ GUARDED_BY(mutex_);
+};
+
+} // namespace tablet
+} // namespace yb
@@ -15,8 +15,11 @@
 
 #include "yb/tablet/transaction_coordinator.h"
 
+#include <algorithm>
 #include <atomic>
 #include <iterator>
+#include <optional>
+#include <vector>
 
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
@@ -108,6 +111,12 @@ DEFINE_RUNTIME_uint32(external_transaction_apply_rpc_limit, 0,
                       "involved tablets at a given time. If set to 0, the default is half "
                       "--rpc_workers_limit.");
 
+DEFINE_NON_RUNTIME_uint32(transaction_coordinator_num_shards, 8,
+                          "Number of shards that transaction coordinator splits its in-memory "
+                          "transaction states into. Each shard is protected by its own mutex and "
+                          "polled by its own timer.");
+TAG_FLAG(transaction_coordinator_num_shards, advanced);
+
 DECLARE_bool(enable_deadlock_detection);
 DECLARE_int32(rpc_workers_limit);
 
@@ -996,6 +1005,17 @@ struct PostponedLeaderActions {
     complete_with_status.swap(other->complete_with_status);
   }
 
+  // Moves actions to other, that could already contain actions collected from another shard.
+  void MoveTo(PostponedLeaderActions* other) {
+    other->leader_term = leader_term;
+    MoveCollection(&notify_applying, &other->notify_applying);
+    notify_applying.clear();
+    MoveCollection(&updates, &other->updates);
+    updates.clear();
+    MoveCollection(&complete_with_status, &other->complete_with_status);
+    complete_with_status.clear();
+  }
+
   bool leader() const {
     return leader_term != OpId::kUnknownTerm;
   }
@@ -1008,8 +1028,9 @@ std::string TransactionCoordinator::AbortedData::ToString() const {
 }
 
 // Real implementation of transaction coordinator, as in PImpl idiom.
-class TransactionCoordinator::Impl : public TransactionStateContext,
-                                     public TransactionAbortController {
+class TransactionCoordinator::Impl : public TransactionAbortController {
+  class Shard;
+
  public:
   Impl(const std::string& permanent_uuid,
        TransactionCoordinatorContext* context,
@@ -1019,8 +1040,12 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
         expired_metric_(*expired_metric),
         log_prefix_(consensus::MakeTabletLogPrefix(context->tablet_id(), permanent_uuid)),
         deadlock_detector_(context->client_future(), this, context->tablet_id(), metrics),
-        deadlock_detection_poller_(log_prefix_, std::bind(&Impl::PollDeadlockDetector, this)),
-        poller_(log_prefix_, std::bind(&Impl::Poll, this)) {
+        deadlock_detection_poller_(log_prefix_, std::bind(&Impl::PollDeadlockDetector, this)) {
+    auto num_shards = std::max<size_t>(FLAGS_transaction_coordinator_num_shards, 1);
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i != num_shards; ++i) {
+      shards_.push_back(std::make_unique<Shard>(this));
+    }
   }
 
   virtual ~Impl() {
@@ -1032,11 +1057,10 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
   }
 
   void RemoveInactiveTransactions(Waiters* waiters) override {
-    std::lock_guard<std::mutex> lock(managed_mutex_);
     auto& sorted_txn_map = waiters->get<TransactionIdTag>();
     for (auto it = sorted_txn_map.begin(); it != sorted_txn_map.end();) {
       auto next_it = sorted_txn_map.upper_bound(it->txn_id());
-      if (managed_transactions_.contains(it->txn_id())) {
+      if (IsManaged(it->txn_id())) {
         it = next_it;
         continue;
       }
@@ -1053,9 +1077,10 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
                          const SubtxnSet& subtxn_set) override {
     std::shared_ptr<const SubtxnSetAndPB> aborted_subtxn_info;
     {
-      std::lock_guard lock(managed_mutex_);
-      auto it = managed_transactions_.find(transaction_id);
-      if (it == managed_transactions_.end()) {
+      auto& shard = ShardFor(transaction_id);
+      std::lock_guard lock(shard.mutex);
+      auto it = shard.managed_transactions.find(transaction_id);
+      if (it == shard.managed_transactions.end()) {
         return false;
       }
       aborted_subtxn_info = it->GetAbortedSubtxnInfo();
@@ -1067,7 +1092,9 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
   void Shutdown() {
     deadlock_detection_poller_.Shutdown();
     deadlock_detector_.Shutdown();
-    poller_.Shutdown();
+    for (auto& shard : shards_) {
+      shard->poller.Shutdown();
+    }
     rpcs_.Shutdown();
   }
 
@@ -1076,10 +1103,12 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
 
     deleting_.store(true, std::memory_order_release);
 
-    std::unique_lock<std::mutex> lock(managed_mutex_);
-    if (!last_transaction_finished_.wait_until(
-            lock, deadline, [this]() { return managed_transactions_.empty(); })) {
-      return STATUS(TimedOut, "Timed out waiting for running transactions to complete");
+    for (auto& shard : shards_) {
+      std::unique_lock<std::mutex> lock(shard->mutex);
+      if (!shard->last_transaction_finished.wait_until(
+              lock, deadline, [&shard]() { return shard->managed_transactions.empty(); })) {
+        return STATUS(TimedOut, "Timed out waiting for running transactions to complete");
+      }
     }
 
     return Status::OK();
@@ -1091,50 +1120,47 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
     AtomicFlagSleepMs(&FLAGS_TEST_inject_txn_get_status_delay_ms);
     auto leader_term = context_.LeaderTerm();
     PostponedLeaderActions postponed_leader_actions;
-    {
-      std::unique_lock<std::mutex> lock(managed_mutex_);
-      HybridTime leader_safe_time;
-      postponed_leader_actions_.leader_term = leader_term;
-      for (const auto& transaction_id : transaction_ids) {
-        auto id = VERIFY_RESULT(FullyDecodeTransactionId(transaction_id));
-
-        auto it = managed_transactions_.find(id);
-        std::vector<ExpectedTabletBatches> expected_tablet_batches;
-        bool known_txn = it != managed_transactions_.end();
-        auto txn_status_with_ht = known_txn
-            ? VERIFY_RESULT(it->GetStatus(&expected_tablet_batches))
-            : TransactionStatusResult(TransactionStatus::ABORTED, HybridTime::kMax);
-        VLOG_WITH_PREFIX(4) << __func__ << ": " << id << " => " << txn_status_with_ht
-                            << ", last touch: " << it->last_touch();
-        if (txn_status_with_ht.status == TransactionStatus::SEALED) {
-          // TODO(dtxn) Avoid concurrent resolve
-          txn_status_with_ht = VERIFY_RESULT(ResolveSealedStatus(
-              id, txn_status_with_ht.status_time, expected_tablet_batches,
-              /* abort_if_not_replicated = */ false, &lock));
-        }
-        if (!known_txn) {
-          if (!leader_safe_time) {
-            // We should pick leader safe time only after managed_mutex_ is locked.
-            // Otherwise applied transaction could be removed after this safe time.
-            leader_safe_time = VERIFY_RESULT(context_.LeaderSafeTime());
-          }
-          // Please note that for known transactions we send 0, that means invalid hybrid time.
-          // We would wait for safe time only for case when transaction is unknown to coordinator.
-          // Since it is only case when transaction could be actually committed.
-          response->mutable_coordinator_safe_time()->Resize(response->status().size(), 0);
-          response->add_coordinator_safe_time(leader_safe_time.ToUint64());
-        }
-        response->add_status(txn_status_with_ht.status);
-        response->add_status_hybrid_time(txn_status_with_ht.status_time.ToUint64());
-
-        auto mutable_aborted_set_pb = response->add_aborted_subtxn_set();
-        if (it != managed_transactions_.end() &&
-            (txn_status_with_ht.status == TransactionStatus::COMMITTED ||
-             txn_status_with_ht.status == TransactionStatus::PENDING)) {
-          *mutable_aborted_set_pb = it->GetAbortedSubtxnInfo()->pb();
-        }
+    for (const auto& transaction_id : transaction_ids) {
+      auto id = VERIFY_RESULT(FullyDecodeTransactionId(transaction_id));
+
+      auto& shard = ShardFor(id);
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      shard.postponed_leader_actions.leader_term = leader_term;
+      auto it = shard.managed_transactions.find(id);
+      std::vector<ExpectedTabletBatches> expected_tablet_batches;
+      bool known_txn = it != shard.managed_transactions.end();
+      auto txn_status_with_ht = known_txn
+          ? VERIFY_RESULT(it->GetStatus(&expected_tablet_batches))
+          : TransactionStatusResult(TransactionStatus::ABORTED, HybridTime::kMax);
+      VLOG_WITH_PREFIX(4) << __func__ << ": " << id << " => " << txn_status_with_ht
+                          << ", last touch: " << it->last_touch();
+      if (txn_status_with_ht.status == TransactionStatus::SEALED) {
+        // TODO(dtxn) Avoid concurrent resolve
+        txn_status_with_ht = VERIFY_RESULT(ResolveSealedStatus(
+            id, txn_status_with_ht.status_time, expected_tablet_batches,
+            /* abort_if_not_replicated = */ false, &shard, &lock));
+        it = shard.managed_transactions.find(id);
+      }
+      if (!known_txn) {
+        // We should pick leader safe time only after mutex of the shard is locked.
+        // Otherwise applied transaction could be removed after this safe time.
+        auto leader_safe_time = VERIFY_RESULT(context_.LeaderSafeTime());
+        // Please note that for known transactions we send 0, that means invalid hybrid time.
+        // We would wait for safe time only for case when transaction is unknown to coordinator.
+        // Since it is only case when transaction could be actually committed.
+        response->mutable_coordinator_safe_time()->Resize(response->status().size(), 0);
+        response->add_coordinator_safe_time(leader_safe_time.ToUint64());
       }
-      postponed_leader_actions.Swap(&postponed_leader_actions_);
+      response->add_status(txn_status_with_ht.status);
+      response->add_status_hybrid_time(txn_status_with_ht.status_time.ToUint64());
+
+      auto mutable_aborted_set_pb = response->add_aborted_subtxn_set();
+      if (it != shard.managed_transactions.end() &&
+          (txn_status_with_ht.status == TransactionStatus::COMMITTED ||
+           txn_status_with_ht.status == TransactionStatus::PENDING)) {
+        *mutable_aborted_set_pb = it->GetAbortedSubtxnInfo()->pb();
+      }
+      shard.postponed_leader_actions.MoveTo(&postponed_leader_actions);
     }
 
     ExecutePostponedLeaderActions(&postponed_leader_actions);
@@ -1151,6 +1177,7 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
       HybridTime commit_time,
       const std::vector<ExpectedTabletBatches>& expected_tablet_batches,
       bool abort_if_not_replicated,
+      Shard* shard,
       std::unique_lock<std::mutex>* lock) {
     VLOG_WITH_PREFIX(4)
         << __func__ << ", txn: " << transaction_id << ", commit time: " << commit_time
@@ -1219,19 +1246,20 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
       latch.Wait();
     }
 
-    auto txn_it = managed_transactions_.find(transaction_id);
-    if (txn_it == managed_transactions_.end()) {
+    auto& managed_transactions = shard->managed_transactions;
+    auto txn_it = managed_transactions.find(transaction_id);
+    if (txn_it == managed_transactions.end()) {
       // Transaction was completed (aborted/committed) during this procedure.
       return TransactionStatusResult{TransactionStatus::PENDING, commit_time.Decremented()};
     }
 
     for (size_t idx = 0; idx != expected_tablet_batches.size(); ++idx) {
       if (write_hybrid_times[idx] == HybridTime::kMin) {
-        managed_transactions_.modify(txn_it, [](TransactionState& state) {
+        managed_transactions.modify(txn_it, [](TransactionState& state) {
           state.Aborted();
         });
       } else if (write_hybrid_times[idx].is_valid()) {
-        managed_transactions_.modify(
+        managed_transactions.modify(
             txn_it, [idx, &expected_tablet_batches, &write_hybrid_times](TransactionState& state) {
           state.ReplicatedAllBatchesAt(
               expected_tablet_batches[idx].tablet, write_hybrid_times[idx]);
@@ -1264,9 +1292,10 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
   void Abort(const TransactionId& transaction_id, int64_t term, TransactionAbortCallback callback) {
     PostponedLeaderActions actions;
     {
-      std::unique_lock<std::mutex> lock(managed_mutex_);
-      auto it = managed_transactions_.find(transaction_id);
-      if (it == managed_transactions_.end()) {
+      auto& shard = ShardFor(transaction_id);
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      auto it = shard.managed_transactions.find(transaction_id);
+      if (it == shard.managed_transactions.end()) {
         lock.unlock();
         VLOG_WITH_PREFIX_AND_FUNC(4) << "transaction_id: " << transaction_id << " not found.";
         callback(TransactionStatusResult::Aborted());
@@ -1274,9 +1303,9 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
       }
       VLOG_WITH_PREFIX_AND_FUNC(4)
           << "transaction_id: " << transaction_id << " found, aborting now.";
-      postponed_leader_actions_.leader_term = term;
+      shard.postponed_leader_actions.leader_term = term;
       boost::optional<TransactionStatusResult> status;
-      managed_transactions_.modify(it, [&status, &callback](TransactionState& state) {
+      shard.managed_transactions.modify(it, [&status, &callback](TransactionState& state) {
         status = state.Abort(&callback);
       });
       if (callback) {
@@ -1284,26 +1313,32 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
         callback(*status);
         return;
       }
-      actions.Swap(&postponed_leader_actions_);
+      actions.Swap(&shard.postponed_leader_actions);
     }
 
     ExecutePostponedLeaderActions(&actions);
   }
 
   size_t TEST_CountExternalTransactions() {
-    std::lock_guard<std::mutex> lock(managed_mutex_);
-    auto count = 0;
-    for (const auto& transaction : managed_transactions_) {
-      if (transaction.is_external()) {
-        count++;
+    size_t count = 0;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      for (const auto& transaction : shard->managed_transactions) {
+        if (transaction.is_external()) {
+          count++;
+        }
       }
     }
     return count;
   }
 
   size_t test_count_transactions() {
-    std::lock_guard<std::mutex> lock(managed_mutex_);
-    return managed_transactions_.size();
+    size_t count = 0;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      count += shard->managed_transactions.size();
+    }
+    return count;
   }
 
   Status ProcessReplicated(const ReplicatedData& data) {
@@ -1312,25 +1347,26 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
       return std::move(id.status());
     }
 
+    auto& shard = ShardFor(*id);
     bool last_transaction = false;
     PostponedLeaderActions actions;
     Status result;
     {
-      std::lock_guard<std::mutex> lock(managed_mutex_);
-      postponed_leader_actions_.leader_term = data.leader_term;
-      auto it = GetTransaction(*id, data.state.status(), data.hybrid_time);
-      if (it == managed_transactions_.end()) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.postponed_leader_actions.leader_term = data.leader_term;
+      auto it = GetTransaction(&shard, *id, data.state.status(), data.hybrid_time);
+      if (it == shard.managed_transactions.end()) {
         return Status::OK();
       }
-      managed_transactions_.modify(it, [&result, &data](TransactionState& state) {
+      shard.managed_transactions.modify(it, [&result, &data](TransactionState& state) {
         result = state.ProcessReplicated(data);
       });
-      CheckCompleted(it);
-      last_transaction = managed_transactions_.empty();
-      actions.Swap(&postponed_leader_actions_);
+      CheckCompleted(&shard, it);
+      last_transaction = shard.managed_transactions.empty();
+      actions.Swap(&shard.postponed_leader_actions);
     }
     if (last_transaction) {
-      last_transaction_finished_.notify_one();
+      shard.last_transaction_finished.notify_one();
     }
     ExecutePostponedLeaderActions(&actions);
 
@@ -1346,26 +1382,27 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
       return;
     }
 
+    auto& shard = ShardFor(*id);
     bool last_transaction = false;
     PostponedLeaderActions actions;
     {
-      std::lock_guard<std::mutex> lock(managed_mutex_);
-      postponed_leader_actions_.leader_term = OpId::kUnknownTerm;
-      auto it = managed_transactions_.find(*id);
-      if (it == managed_transactions_.end()) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.postponed_leader_actions.leader_term = OpId::kUnknownTerm;
+      auto it = shard.managed_transactions.find(*id);
+      if (it == shard.managed_transactions.end()) {
         LOG_WITH_PREFIX(WARNING) << "Aborted operation for unknown transaction: " << *id;
         return;
       }
-      managed_transactions_.modify(
+      shard.managed_transactions.modify(
           it, [&](TransactionState& ts) {
             ts.ProcessAborted(data);
           });
-      CheckCompleted(it);
-      last_transaction = managed_transactions_.empty();
-      actions.Swap(&postponed_leader_actions_);
+      CheckCompleted(&shard, it);
+      last_transaction = shard.managed_transactions.empty();
+      actions.Swap(&shard.postponed_leader_actions);
     }
     if (last_transaction) {
-      last_transaction_finished_.notify_one();
+      shard.last_transaction_finished.notify_one();
     }
     ExecutePostponedLeaderActions(&actions);
 
@@ -1377,19 +1414,23 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
     deadlock_detection_poller_.Start(
         &context_.client_future().get()->messenger()->scheduler(),
         1us * FLAGS_transaction_deadlock_detection_interval_usec * kTimeMultiplier);
-    poller_.Start(
-        &context_.client_future().get()->messenger()->scheduler(),
-        1us * FLAGS_transaction_check_interval_usec * kTimeMultiplier);
+    for (auto& shard : shards_) {
+      shard->poller.Start(
+          &context_.client_future().get()->messenger()->scheduler(),
+          1us * FLAGS_transaction_check_interval_usec * kTimeMultiplier);
+    }
   }
 
   Result<bool> MaybeIgnoreIfTransactionInWrongState(
       TransactionStatus request_txn_status, TransactionId transaction_id) {
-    auto it = managed_transactions_.find(transaction_id);
+    auto& shard = ShardFor(transaction_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.managed_transactions.find(transaction_id);
     switch (request_txn_status) {
       case TransactionStatus::CREATED:
         // If the transaction is already present, then this CREATE record was already replicated at
         // some point in the past, so we can ignore this record.
-        return it != managed_transactions_.end();
+        return it != shard.managed_transactions.end();
       case TransactionStatus::COMMITTED:
         // We ignore this COMMIT record if one of the following 2 conditions are met:
         // 1. The transaction doesn't exist and we're seeing a COMMIT record without a previous
@@ -1398,7 +1439,7 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
         // 2. The transaction is present but not in CREATED or PENDING state. Because we only
         // replicate CREATED and COMMITTED records, if a transaction is present but not in CREATED
         // state, it must necessarily have already been committed.
-        return it == managed_transactions_.end() ||
+        return it == shard.managed_transactions.end() ||
                (it->status() != TransactionStatus::CREATED &&
                 it->status() != TransactionStatus::PENDING);
       default:
@@ -1409,63 +1450,87 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
   }
 
   void Handle(std::unique_ptr<tablet::UpdateTxnOperation> request, int64_t term) {
-    auto& state = *request->request();
-    auto id = FullyDecodeTransactionId(state.transaction_id());
-    if (!id.ok()) {
-      LOG(WARNING) << "Failed to decode id from " << state.ShortDebugString() << ": " << id;
-      request->CompleteWithStatus(id.status());
+    auto id = PrepareUpdate(request.get());
+    if (!id) {
       return;
     }
 
-    if (state.has_external_hybrid_time()) {
-      auto ignore_transaction_result =  MaybeIgnoreIfTransactionInWrongState(state.status(), *id);
-      if (!ignore_transaction_result.ok()) {
-        request->CompleteWithStatus(ignore_transaction_result.status());
+    PostponedLeaderActions actions;
+    {
+      auto& shard = ShardFor(*id);
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      shard.postponed_leader_actions.leader_term = term;
+      auto status = DoHandle(&shard, *id, &request);
+      if (!status.ok()) {
+        lock.unlock();
+        request->CompleteWithStatus(status);
         return;
       }
-      if (*ignore_transaction_result) {
-        request->CompleteWithStatus(Status::OK());
-        return;
+      shard.postponed_leader_actions.Swap(&actions);
+    }
+
+    ExecutePostponedLeaderActions(&actions);
+  }
+
+  // Handles requests for several transactions, locking each involved shard once.
+  void Handle(std::vector<std::unique_ptr<tablet::UpdateTxnOperation>> requests, int64_t term) {
+    std::vector<std::pair<TransactionId, std::unique_ptr<tablet::UpdateTxnOperation>>> prepared;
+    prepared.reserve(requests.size());
+    for (auto& request : requests) {
+      auto id = PrepareUpdate(request.get());
+      if (id) {
+        prepared.emplace_back(*id, std::move(request));
       }
     }
+    if (prepared.empty()) {
+      return;
+    }
+    std::sort(prepared.begin(), prepared.end(), [this](const auto& lhs, const auto& rhs) {
+      return ShardIndex(lhs.first) < ShardIndex(rhs.first);
+    });
 
+    std::vector<std::pair<std::unique_ptr<tablet::UpdateTxnOperation>, Status>> failed;
     PostponedLeaderActions actions;
-    {
-      std::unique_lock<std::mutex> lock(managed_mutex_);
-      postponed_leader_actions_.leader_term = term;
-      auto it = managed_transactions_.find(*id);
-      if (it == managed_transactions_.end()) {
-        auto status = HandleTransactionNotFound(*id, state);
-        if (status.ok()) {
-          it = managed_transactions_.emplace(
-              this, *id, context_.clock().Now(), log_prefix_).first;
-        } else {
-          lock.unlock();
-          status = status.CloneAndAddErrorCode(TransactionError(TransactionErrorCode::kAborted));
-          request->CompleteWithStatus(status);
-          return;
+    for (auto it = prepared.begin(); it != prepared.end();) {
+      auto shard_index = ShardIndex(it->first);
+      auto& shard = *shards_[shard_index];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.postponed_leader_actions.leader_term = term;
+      for (; it != prepared.end() && ShardIndex(it->first) == shard_index; ++it) {
+        auto status = DoHandle(&shard, it->first, &it->second);
+        if (!status.ok()) {
+          failed.emplace_back(std::move(it->second), std::move(status));
         }
       }
-
-      managed_transactions_.modify(it, [&request](TransactionState& state) {
-        state.Handle(std::move(request));
-      });
-      postponed_leader_actions_.Swap(&actions);
+      shard.postponed_leader_actions.MoveTo(&actions);
     }
 
+    for (auto& [request, status] : failed) {
+      request->CompleteWithStatus(status);
+    }
     ExecutePostponedLeaderActions(&actions);
   }
 
   int64_t PrepareGC(std::string* details) {
-    std::lock_guard<std::mutex> lock(managed_mutex_);
-    if (!managed_transactions_.empty()) {
-      auto& txn = *managed_transactions_.get<FirstEntryIndexTag>().begin();
-      if (details) {
-        *details += Format("Transaction coordinator: $0\n", txn);
+    auto result = std::numeric_limits<int64_t>::max();
+    std::string min_txn;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      if (shard->managed_transactions.empty()) {
+        continue;
+      }
+      auto& txn = *shard->managed_transactions.get<FirstEntryIndexTag>().begin();
+      if (txn.first_entry_raft_index() < result) {
+        result = txn.first_entry_raft_index();
+        if (details) {
+          min_txn = AsString(txn);
+        }
       }
-      return txn.first_entry_raft_index();
     }
-    return std::numeric_limits<int64_t>::max();
+    if (details && !min_txn.empty()) {
+      *details += Format("Transaction coordinator: $0\n", min_txn);
+    }
+    return result;
   }
 
   // Returns logs prefix for this transaction coordinator.
@@ -1475,10 +1540,12 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
 
   std::string DumpTransactions() {
     std::string result;
-    std::lock_guard<std::mutex> lock(managed_mutex_);
-    for (const auto& txn : managed_transactions_) {
-      result += txn.ToString();
-      result += "\n";
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      for (const auto& txn : shard->managed_transactions) {
+        result += txn.ToString();
+        result += "\n";
+      }
     }
     return result;
   }
@@ -1539,6 +1606,86 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
       >
   > ManagedTransactions;
 
+  // Part of managed transactions, selected by hash of transaction id. Each shard has its own mutex,
+  // postponed actions and poller, so requests for different transactions do not contend.
+  class Shard : public TransactionStateContext {
+   public:
+    explicit Shard(Impl* impl)
+        : poller(impl->LogPrefix(), std::bind(&Impl::Poll, impl, this)), impl_(*impl) {
+    }
+
+    TransactionCoordinatorContext& coordinator_context() override {
+      return impl_.context_;
+    }
+
+    void NotifyApplying(NotifyApplyingData data) override {
+      if (!leader()) {
+        LOG_WITH_PREFIX(WARNING) << __func__ << " at non leader: " << data.ToString();
+        return;
+      }
+      postponed_leader_actions.notify_applying.push_back(std::move(data));
+    }
+
+    MUST_USE_RESULT bool SubmitUpdateTransaction(
+        std::unique_ptr<UpdateTxnOperation> operation) override {
+      if (!postponed_leader_actions.leader()) {
+        auto status = STATUS(IllegalState, "Submit update transaction on non leader");
+        VLOG_WITH_PREFIX(1) << status;
+        operation->CompleteWithStatus(status);
+        return false;
+      }
+
+      postponed_leader_actions.updates.push_back(std::move(operation));
+      return true;
+    }
+
+    void CompleteWithStatus(
+        std::unique_ptr<UpdateTxnOperation> request, Status status) override {
+      auto ptr = request.get();
+      postponed_leader_actions.complete_with_status.push_back({
+          std::move(request), ptr, std::move(status)});
+    }
+
+    void CompleteWithStatus(UpdateTxnOperation* request, Status status) override {
+      postponed_leader_actions.complete_with_status.push_back({
+          nullptr /* holder */, request, std::move(status)});
+    }
+
+    bool leader() const override {
+      return postponed_leader_actions.leader();
+    }
+
+    const std::string& LogPrefix() const {
+      return impl_.log_prefix_;
+    }
+
+    std::mutex mutex;
+    ManagedTransactions managed_transactions;
+    std::condition_variable last_transaction_finished;
+
+    // Actions that should be executed after mutex is unlocked.
+    PostponedLeaderActions postponed_leader_actions;
+
+    rpc::Poller poller;
+
+   private:
+    Impl& impl_;
+  };
+
+  size_t ShardIndex(const TransactionId& id) const {
+    return TransactionIdHash()(id) % shards_.size();
+  }
+
+  Shard& ShardFor(const TransactionId& id) {
+    return *shards_[ShardIndex(id)];
+  }
+
+  bool IsManaged(const TransactionId& id) {
+    auto& shard = ShardFor(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.managed_transactions.contains(id);
+  }
+
   void SendUpdateTransactionRequest(
       const NotifyApplyingData& action, HybridTime now,
       const CoarseTimePoint& deadline) {
@@ -1603,12 +1750,13 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
             const auto split_child_tablet_ids = SplitChildTabletIdsData(status).value();
             const bool tablet_has_been_split = !split_child_tablet_ids.empty();
             if (status.IsNotFound() || tablet_has_been_split) {
-              std::lock_guard<std::mutex> lock(managed_mutex_);
-              auto it = managed_transactions_.find(action.transaction);
-              if (it == managed_transactions_.end()) {
+              auto& shard = ShardFor(action.transaction);
+              std::lock_guard<std::mutex> lock(shard.mutex);
+              auto it = shard.managed_transactions.find(action.transaction);
+              if (it == shard.managed_transactions.end()) {
                 return;
               }
-              managed_transactions_.modify(
+              shard.managed_transactions.modify(
                   it, [this, &action, &split_child_tablet_ids,
                        tablet_has_been_split](TransactionState& state) {
                     if (tablet_has_been_split) {
@@ -1668,19 +1816,68 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
     }
   }
 
-  ManagedTransactions::iterator GetTransaction(const TransactionId& id,
+  ManagedTransactions::iterator GetTransaction(Shard* shard,
+                                               const TransactionId& id,
                                                TransactionStatus status,
                                                HybridTime hybrid_time) {
-    auto it = managed_transactions_.find(id);
-    if (it == managed_transactions_.end()) {
+    auto& managed_transactions = shard->managed_transactions;
+    auto it = managed_transactions.find(id);
+    if (it == managed_transactions.end()) {
       if (status != TransactionStatus::APPLIED_IN_ALL_INVOLVED_TABLETS) {
-        it = managed_transactions_.emplace(this, id, hybrid_time, log_prefix_).first;
+        it = managed_transactions.emplace(shard, id, hybrid_time, log_prefix_).first;
         VLOG_WITH_PREFIX(1) << Format("Added: $0", *it);
       }
     }
     return it;
   }
 
+  // Decodes transaction id of the update request. Returns nullopt when the request does not
+  // require further processing, in this case it is already completed.
+  std::optional<TransactionId> PrepareUpdate(tablet::UpdateTxnOperation* request) {
+    auto& state = *request->request();
+    auto id = FullyDecodeTransactionId(state.transaction_id());
+    if (!id.ok()) {
+      LOG(WARNING) << "Failed to decode id from " << state.ShortDebugString() << ": " << id;
+      request->CompleteWithStatus(id.status());
+      return std::nullopt;
+    }
+
+    if (state.has_external_hybrid_time()) {
+      auto ignore_transaction_result =  MaybeIgnoreIfTransactionInWrongState(state.status(), *id);
+      if (!ignore_transaction_result.ok()) {
+        request->CompleteWithStatus(ignore_transaction_result.status());
+        return std::nullopt;
+      }
+      if (*ignore_transaction_result) {
+        request->CompleteWithStatus(Status::OK());
+        return std::nullopt;
+      }
+    }
+
+    return *id;
+  }
+
+  // Passes the request to the state of the appropriate transaction. On failure the request is
+  // left untouched, and should be completed with returned status after shard mutex is released.
+  Status DoHandle(
+      Shard* shard, const TransactionId& id,
+      std::unique_ptr<tablet::UpdateTxnOperation>* request) {
+    auto& managed_transactions = shard->managed_transactions;
+    auto it = managed_transactions.find(id);
+    if (it == managed_transactions.end()) {
+      auto status = HandleTransactionNotFound(id, *(*request)->request());
+      if (!status.ok()) {
+        return status.CloneAndAddErrorCode(TransactionError(TransactionErrorCode::kAborted));
+      }
+      it = managed_transactions.emplace(shard, id, context_.clock().Now(), log_prefix_).first;
+    }
+
+    managed_transactions.modify(it, [request](TransactionState& state) {
+      state.Handle(std::move(*request));
+    });
+    return Status::OK();
+  }
+
   Status HandleTransactionNotFound(const TransactionId& id,
                                    const LWTransactionStatePB& state) {
     if (state.status() != TransactionStatus::CREATED &&
@@ -1703,64 +1900,23 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
     return Status::OK();
   }
 
-  TransactionCoordinatorContext& coordinator_context() override {
-    return context_;
-  }
-
-  void NotifyApplying(NotifyApplyingData data) override {
-    if (!leader()) {
-      LOG_WITH_PREFIX(WARNING) << __func__ << " at non leader: " << data.ToString();
-      return;
-    }
-    postponed_leader_actions_.notify_applying.push_back(std::move(data));
-  }
-
-  MUST_USE_RESULT bool SubmitUpdateTransaction(
-      std::unique_ptr<UpdateTxnOperation> operation) override {
-    if (!postponed_leader_actions_.leader()) {
-      auto status = STATUS(IllegalState, "Submit update transaction on non leader");
-      VLOG_WITH_PREFIX(1) << status;
-      operation->CompleteWithStatus(status);
-      return false;
-    }
-
-    postponed_leader_actions_.updates.push_back(std::move(operation));
-    return true;
-  }
-
-  void CompleteWithStatus(
-      std::unique_ptr<UpdateTxnOperation> request, Status status) override {
-    auto ptr = request.get();
-    postponed_leader_actions_.complete_with_status.push_back({
-        std::move(request), ptr, std::move(status)});
-  }
-
-  void CompleteWithStatus(UpdateTxnOperation* request, Status status) override {
-    postponed_leader_actions_.complete_with_status.push_back({
-        nullptr /* holder */, request, std::move(status)});
-  }
-
-  bool leader() const override {
-    return postponed_leader_actions_.leader();
-  }
-
   void PollDeadlockDetector() {
     if (ANNOTATE_UNPROTECTED_READ(FLAGS_enable_deadlock_detection)) {
       deadlock_detector_.TriggerProbes();
     }
   }
 
-  void Poll() {
+  void Poll(Shard* shard) {
     auto now = context_.clock().Now();
 
     auto leader_term = context_.LeaderTerm();
     bool leader = leader_term != OpId::kUnknownTerm;
     PostponedLeaderActions actions;
     {
-      std::lock_guard<std::mutex> lock(managed_mutex_);
-      postponed_leader_actions_.leader_term = leader_term;
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->postponed_leader_actions.leader_term = leader_term;
 
-      auto& index = managed_transactions_.get<LastTouchTag>();
+      auto& index = shard->managed_transactions.get<LastTouchTag>();
 
       if (VLOG_IS_ON(4) && leader && !index.empty()) {
         const auto& txn = *index.begin();
@@ -1788,25 +1944,25 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
         }
       }
       auto now_physical = MonoTime::Now();
-      for (auto& transaction : managed_transactions_) {
+      for (auto& transaction : shard->managed_transactions) {
         const_cast<TransactionState&>(transaction).Poll(leader, now_physical);
       }
-      postponed_leader_actions_.Swap(&actions);
+      shard->postponed_leader_actions.Swap(&actions);
     }
     ExecutePostponedLeaderActions(&actions);
   }
 
-  void CheckCompleted(ManagedTransactions::iterator it) {
+  void CheckCompleted(Shard* shard, ManagedTransactions::iterator it) {
     if (it->Completed()) {
       if (PREDICT_FALSE(FLAGS_TEST_disable_cleanup_applied_transactions)) {
         return;
       }
       auto status = STATUS_FORMAT(Expired, "Transaction completed: $0", *it);
       VLOG_WITH_PREFIX(1) << status;
-      managed_transactions_.modify(it, [&status](TransactionState& state) {
+      shard->managed_transactions.modify(it, [&status](TransactionState& state) {
         state.ClearRequests(status);
       });
-      managed_transactions_.erase(it);
+      shard->managed_transactions.erase(it);
     }
   }
 
@@ -1814,20 +1970,14 @@ class TransactionCoordinator::Impl : public TransactionStateContext,
   Counter& expired_metric_;
   const std::string log_prefix_;
 
-  std::mutex managed_mutex_;
-  ManagedTransactions managed_transactions_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 
   std::atomic<bool> deleting_{false};
   std::atomic<uint32_t> num_outstanding_apply_external_transaction_rpcs_;
-  std::condition_variable last_transaction_finished_;
-
-  // Actions that should be executed after mutex is unlocked.
-  PostponedLeaderActions postponed_leader_actions_;
 
   DeadlockDetector deadlock_detector_;
   rpc::Poller deadlock_detection_poller_;
 
-  rpc::Poller poller_;
   rpc::Rpcs rpcs_;
 };
 
@@ -1866,6 +2016,11 @@ void TransactionCoordinator::Handle(
   impl_->Handle(std::move(request), term);
 }
 
+void TransactionCoordinator::Handle(
+    std::vector<std::unique_ptr<tablet::UpdateTxnOperation>> requests, int64_t term) {
+  impl_->Handle(std::move(requests), term);
+}
+
 void TransactionCoordinator::Start() {
   impl_->Start();
 }
@@ -136,6 +136,9 @@ WriteQuery::WriteQuery(
       kind_(kind),
       start_time_(CoarseMonoClock::Now()),
       execute_mode_(ExecuteMode::kSimple) {
+  if (rpc_context_ && *rpc_context_) {
+    operation_->set_inbound_call(rpc_context_->inbound_call());
+  }
 }
 
 LWWritePB& WriteQuery::request() {
@@ -315,6 +318,7 @@ Status WriteQuery::InitExecute(ExecuteMode mode) {
 }
 
 Result<bool> WriteQuery::RedisPrepareExecute() {
+  auto tablet = VERIFY_RESULT(tablet_safe());
   RETURN_NOT_OK(InitExecute(ExecuteMode::kRedis));
 
   // Since we take exclusive locks, it's okay to use Now as the read TS for writes.
@@ -322,6 +326,7 @@ Result<bool> WriteQuery::RedisPrepareExecute() {
 
   doc_ops_.reserve(redis_write_batch.size());
   for (const auto& redis_request : redis_write_batch) {
+    tablet->RecordKeyAccess(TabletAccessType::kWrite, AccessedHashCode(redis_request.key_value()));
     doc_ops_.emplace_back(new docdb::RedisWriteOperation(redis_request));
   }
 
@@ -358,6 +363,7 @@ Result<bool> WriteQuery::CqlPrepareExecute() {
   auto table_info = metadata.primary_table_info();
   for (const auto& req : ql_write_batch) {
     QLResponsePB* resp = response_->add_ql_response_batch();
+    tablet->RecordKeyAccess(TabletAccessType::kWrite, AccessedHashCode(req));
     auto write_op = std::make_unique<docdb::QLWriteOperation>(
         req,
         table_info->schema_version,
@@ -398,6 +404,9 @@ Result<bool> WriteQuery::PgsqlPrepareExecute() {
       resp->set_skipped(true);
       continue;
     }
+    tablet->RecordKeyAccess(
+        TabletAccessType::kWrite, AccessedHashCode(req),
+        req.ybctid_column_value().value().binary_value());
     const TableInfoPtr table_info = VERIFY_RESULT(metadata.GetTableInfo(req.table_id()));
     docdb::AddTableSchemaVersion(
         table_info->cotable_id, table_info->schema_version, request().mutable_write_batch());
@@ -0,0 +1,196 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+
+#include "yb/tserver/read_index_batcher.h"
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "yb/common/wire_protocol.h"
+
+#include "yb/consensus/consensus.proxy.h"
+#include "yb/consensus/consensus_meta.h"
+#include "yb/consensus/raft_consensus.h"
+
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/tserver/tserver_error.h"
+
+#include "yb/util/status_format.h"
+
+namespace yb {
+namespace tserver {
+
+struct ReadIndexBatcher::Batch {
+  std::vector<TabletId> tablet_ids;
+  std::vector<std::pair<TabletId, Callback>> waiters;
+  CoarseTimePoint deadline = CoarseTimePoint::min();
+
+  std::optional<consensus::ConsensusServiceProxy> proxy;
+  consensus::GetReadIndexRequestPB req;
+  consensus::GetReadIndexResponsePB resp;
+  rpc::RpcController controller;
+  std::unordered_map<TabletId, Result<HybridTime>> results;
+};
+
+ReadIndexBatcher::ReadIndexBatcher(rpc::ProxyCache* proxy_cache, const CloudInfoPB& cloud_info)
+    : proxy_cache_(*proxy_cache), cloud_info_(cloud_info) {
+}
+
+ReadIndexBatcher::~ReadIndexBatcher() {
+  std::unique_lock lock(mutex_);
+  cond_.wait(lock, [this]() NO_THREAD_SAFETY_ANALYSIS { return queues_.empty(); });
+}
+
+void ReadIndexBatcher::GetLeaderSafeTimeAsync(
+    const tablet::TabletPeer& tablet_peer, CoarseTimePoint deadline, Callback callback) {
+  auto consensus = tablet_peer.shared_raft_consensus();
+  if (!consensus) {
+    callback(STATUS(IllegalState, "Consensus unavailable", tablet_peer.tablet_id(),
+                    TabletServerError(TabletServerErrorPB::TABLET_NOT_RUNNING)));
+    return;
+  }
+  auto cstate = consensus->ConsensusState(consensus::CONSENSUS_CONFIG_ACTIVE, nullptr);
+  const consensus::RaftPeerPB* leader = nullptr;
+  for (const auto& peer : cstate.config().peers()) {
+    if (cstate.has_leader_uuid() && peer.permanent_uuid() == cstate.leader_uuid()) {
+      leader = &peer;
+      break;
+    }
+  }
+  if (!leader) {
+    callback(STATUS(IllegalState, "Leader is not known", tablet_peer.tablet_id(),
+                    TabletServerError(TabletServerErrorPB::NOT_THE_LEADER)));
+    return;
+  }
+  auto leader_hostport = HostPortFromPB(consensus::DesiredHostPort(*leader, cloud_info_));
+
+  BatchPtr batch_to_send;
+  {
+    std::lock_guard lock(mutex_);
+    auto [it, inserted] = queues_.try_emplace(cstate.leader_uuid());
+    auto& queue = it->second;
+    queue.leader_hostport = leader_hostport;
+    if (!queue.pending) {
+      queue.pending = std::make_shared<Batch>();
+    }
+    auto& batch = *queue.pending;
+    const auto& tablet_id = tablet_peer.tablet_id();
+    if (std::find(batch.tablet_ids.begin(), batch.tablet_ids.end(), tablet_id) ==
+            batch.tablet_ids.end()) {
+      batch.tablet_ids.push_back(tablet_id);
+    }
+    batch.waiters.emplace_back(tablet_id, std::move(callback));
+    batch.deadline = std::max(batch.deadline, deadline);
+    if (inserted) {
+      // Nothing is in flight to this leader, so the batch is sent right away.
+      batch_to_send = std::move(queue.pending);
+    }
+  }
+
+  if (batch_to_send) {
+    SendBatch(cstate.leader_uuid(), leader_hostport, std::move(batch_to_send));
+  }
+}
+
+void ReadIndexBatcher::SendBatch(
+    const std::string& leader_uuid, const HostPort& leader_hostport, BatchPtr batch) {
+  batch->req.set_dest_uuid(leader_uuid);
+  for (const auto& tablet_id : batch->tablet_ids) {
+    batch->req.add_tablet_ids(tablet_id);
+  }
+  batch->controller.set_deadline(batch->deadline);
+  batch->proxy.emplace(&proxy_cache_, leader_hostport);
+
+  auto& proxy = *batch->proxy;
+  auto& req = batch->req;
+  auto* resp = &batch->resp;
+  auto* controller = &batch->controller;
+  proxy.GetReadIndexAsync(
+      req, resp, controller, [this, leader_uuid, batch = std::move(batch)] {
+    BatchDone(leader_uuid, batch);
+  });
+}
+
+void ReadIndexBatcher::BatchDone(const std::string& leader_uuid, const BatchPtr& batch) {
+  auto status = ProcessResponse(batch.get());
+
+  HostPort leader_hostport;
+  BatchPtr next_batch;
+  bool idle = false;
+  {
+    std::lock_guard lock(mutex_);
+    auto it = queues_.find(leader_uuid);
+    if (it != queues_.end()) {
+      next_batch = std::move(it->second.pending);
+      if (next_batch) {
+        leader_hostport = it->second.leader_hostport;
+      } else {
+        queues_.erase(it);
+        idle = queues_.empty();
+      }
+    }
+  }
+  if (idle) {
+    cond_.notify_all();
+  }
+
+  for (auto& [tablet_id, callback] : batch->waiters) {
+    if (!status.ok()) {
+      callback(status);
+      continue;
+    }
+    auto it = batch->results.find(tablet_id);
+    if (it == batch->results.end()) {
+      callback(STATUS_FORMAT(IllegalState, "No read index received for $0", tablet_id));
+    } else {
+      callback(it->second);
+    }
+  }
+
+  if (next_batch) {
+    SendBatch(leader_uuid, leader_hostport, std::move(next_batch));
+  }
+}
+
+Status ReadIndexBatcher::ProcessResponse(Batch* batch) {
+  RETURN_NOT_OK(batch->controller.status());
+  const auto& req = batch->req;
+  const auto& resp = batch->resp;
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  if (resp.tablets_size() != req.tablet_ids_size()) {
+    return STATUS_FORMAT(
+        IllegalState, "Wrong number of read index entries: $0 vs $1", resp.tablets_size(),
+        req.tablet_ids_size());
+  }
+
+  for (int i = 0; i != resp.tablets_size(); ++i) {
+    const auto& entry = resp.tablets(i);
+    if (entry.has_error()) {
+      batch->results.emplace(
+          req.tablet_ids(i),
+          StatusFromPB(entry.error().status()).CloneAndAddErrorCode(
+              TabletServerError(entry.error().code())));
+    } else {
+      batch->results.emplace(req.tablet_ids(i), HybridTime(entry.safe_time()));
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace tserver
+} // namespace yb
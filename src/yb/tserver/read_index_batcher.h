@@ -0,0 +1,85 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/common_net.pb.h"
+#include "yb/common/hybrid_time.h"
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/tablet/tablet_fwd.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/net/net_util.h"
+
+namespace yb {
+namespace tserver {
+
+// - ReadIndexBatcher lets a follower serve strongly consistent reads without forwarding them
+//   to the leader: the follower obtains the leader safe time (the "read index") and then waits
+//   for its own safe time to reach it before reading locally
+// - Requests for tablets led by the same tserver are coalesced into a single GetReadIndex RPC.
+//   While an RPC to a leader is in flight, newly arriving requests are collected into the next
+//   batch, which is sent as soon as the previous one completes
+// - A request never joins a batch that was already sent, since the safe time returned for that
+//   batch could predate the start of the read
+// - Each batch is sent with the latest deadline of the requests it contains
+class ReadIndexBatcher {
+ public:
+  using Callback = std::function<void(Result<HybridTime>)>;
+
+  ReadIndexBatcher(rpc::ProxyCache* proxy_cache, const CloudInfoPB& cloud_info);
+
+  // Waits for the in flight batches to complete.
+  ~ReadIndexBatcher();
+
+  // Obtains the current leader safe time of the tablet replicated by the given follower.
+  // The callback is invoked once the batch containing this request completes, possibly on the
+  // reactor thread, so it should not block.
+  void GetLeaderSafeTimeAsync(
+      const tablet::TabletPeer& tablet_peer, CoarseTimePoint deadline, Callback callback);
+
+ private:
+  struct Batch;
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  struct LeaderQueue {
+    HostPort leader_hostport;
+    // Batch collecting requests that will be sent once the in flight batch completes.
+    BatchPtr pending;
+  };
+
+  void SendBatch(const std::string& leader_uuid, const HostPort& leader_hostport, BatchPtr batch);
+  void BatchDone(const std::string& leader_uuid, const BatchPtr& batch);
+  static Status ProcessResponse(Batch* batch);
+
+  rpc::ProxyCache& proxy_cache_;
+  const CloudInfoPB cloud_info_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  // Contains an entry only while a batch is in flight to the corresponding leader.
+  std::unordered_map<std::string, LeaderQueue> queues_ GUARDED_BY(mutex_);
+};
+
+} // namespace tserver
+} // namespace yb
@@ -28,6 +28,7 @@
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tablet/write_query.h"
 
+#include "yb/tserver/read_index_batcher.h"
 #include "yb/tserver/service_util.h"
 #include "yb/tserver/tablet_server_interface.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -36,7 +37,6 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flags.h"
-#include "yb/util/scope_exit.h"
 #include "yb/util/trace.h"
 
 using namespace std::literals;
@@ -65,6 +65,13 @@ DEFINE_RUNTIME_bool(ysql_follower_reads_avoid_waiting_for_safe_time, true,
     "faster than waiting for safe time to catch up.");
 TAG_FLAG(ysql_follower_reads_avoid_waiting_for_safe_time, advanced);
 
+DEFINE_RUNTIME_bool(enable_follower_read_index, false,
+    "Allow followers to serve strongly consistent single shard reads. The follower fetches the "
+    "leader safe time through a batched GetReadIndex RPC and waits for its own safe time to "
+    "reach it before reading locally. Reads that fail to obtain the read index are rejected, so "
+    "that the client retries them at the leader.");
+TAG_FLAG(enable_follower_read_index, advanced);
+
 namespace yb {
 namespace tserver {
 
@@ -122,6 +129,19 @@ class ReadQuery : public std::enable_shared_from_this<ReadQuery>, public rpc::Th
   bool IsForBackfill() const;
   bool IsPgsqlFollowerReadAtAFollower() const;
 
+  // Whether a strong read could be served by this replica using the leader read index, if it is
+  // not the leader.
+  bool CanUseReadIndex() const;
+
+  // Requests the read index from the leader. The read proceeds in Run once it is received.
+  void RequestReadIndex();
+
+  // Waits for the local safe time to reach the received read index.
+  Result<HybridTime> SafeTimeAfterReadIndex();
+
+  // Creates the request scope of a transactional read, after the read time is picked.
+  Status InitRequestScope();
+
   // Read implementation. If restart is required returns restart time, in case of success
   // returns invalid ReadHybridTime. Otherwise returns error status.
   Result<ReadHybridTime> DoRead();
@@ -135,11 +155,18 @@ class ReadQuery : public std::enable_shared_from_this<ReadQuery>, public rpc::Th
   // We cannot proceed with read from completion callback, to avoid holding
   // replica state lock for too long.
   // So ThreadPool is used to proceed with read.
+  // The same applies to a follower read, which proceeds once the read index is received.
   void Run() override {
     auto status = PickReadTime(server_.Clock());
+    if (status.ok() && read_index_peer_) {
+      status = InitRequestScope();
+    }
     if (status.ok()) {
       status = Complete();
     }
+    if (status.ok() && read_index_peer_) {
+      tablet()->metrics()->read_index_read_requests->Increment();
+    }
     RespondIfFailed(status);
   }
 
@@ -163,6 +190,9 @@ class ReadQuery : public std::enable_shared_from_this<ReadQuery>, public rpc::Th
   HostPortPB host_port_pb_;
   bool allow_retry_ = false;
   bool reading_from_non_leader_ = false;
+  // Set when a strong read is served by a follower using the leader read index.
+  tablet::TabletPeerPtr read_index_peer_;
+  HybridTime leader_safe_time_;
   RequestScope request_scope_;
   std::shared_ptr<ReadQuery> retained_self_;
 };
@@ -280,9 +310,22 @@ Status ReadQuery::DoPerform() {
     RETURN_NOT_OK(CheckWriteThrottling(req_->rejection_score(), leader_peer.peer.get()));
     abstract_tablet_ = VERIFY_RESULT(leader_peer.peer->shared_tablet_safe());
   } else {
+    auto consistency_level = req_->consistency_level();
+    if (consistency_level == YBConsistencyLevel::STRONG && CanUseReadIndex()) {
+      if (!peer_tablet.tablet_peer) {
+        peer_tablet = VERIFY_RESULT(LookupTabletPeer(
+            server_.tablet_peer_lookup(), req_->tablet_id()));
+        tablet_peer = peer_tablet.tablet_peer;
+      }
+      if (!CheckPeerIsLeader(*tablet_peer).ok()) {
+        // Follower checks, such as the staleness bound, apply to reads served by read index.
+        read_index_peer_ = tablet_peer;
+        consistency_level = YBConsistencyLevel::CONSISTENT_PREFIX;
+      }
+    }
     abstract_tablet_ = VERIFY_RESULT(read_tablet_provider_.GetTabletForRead(
         req_->tablet_id(), std::move(peer_tablet.tablet_peer),
-        req_->consistency_level(), AllowSplitTablet::kFalse));
+        consistency_level, AllowSplitTablet::kFalse));
     leader_peer.leader_term = OpId::kUnknownTerm;
   }
 
@@ -298,6 +341,11 @@ Status ReadQuery::DoPerform() {
         server_.tablet_peer_lookup()->GetServingTablet(req_->tablet_id()), {});
   }
   reading_from_non_leader_ = tablet_peer && !CheckPeerIsLeader(*tablet_peer).ok();
+  if (reading_from_non_leader_ && tablet()->is_witness()) {
+    return STATUS(
+        IllegalState, "Cannot read from a witness replica", req_->tablet_id(),
+        TabletServerError(TabletServerErrorPB::NOT_THE_LEADER));
+  }
   if (PREDICT_FALSE(FLAGS_TEST_assert_reads_served_by_follower)) {
     CHECK_NE(req_->consistency_level(), YBConsistencyLevel::STRONG)
         << "--TEST_assert_reads_served_by_follower is true but consistency level is "
@@ -329,33 +377,26 @@ Status ReadQuery::DoPerform() {
   read_time_ = ReadHybridTime::FromReadTimePB(*req_);
 
   allow_retry_ = !read_time_;
-  require_lease_ = tablet::RequireLease(req_->consistency_level() == YBConsistencyLevel::STRONG);
-  // TODO: should check all the tables referenced by the requests to decide if it is transactional.
-  const bool transactional = this->transactional();
+  require_lease_ = tablet::RequireLease(
+      req_->consistency_level() == YBConsistencyLevel::STRONG && !read_index_peer_);
+
+  const auto& remote_address = context_.remote_address();
+  host_port_pb_.set_host(remote_address.address().to_string());
+  host_port_pb_.set_port(remote_address.port());
+
   // Should not pick read time for serializable isolation, since it is picked after read intents
   // are added. Also conflict resolution for serializable isolation should be done without read time
   // specified. So we use max hybrid time for conflict resolution in such case.
   // It was implemented as part of #655.
   if (!serializable_isolation) {
+    if (read_index_peer_) {
+      RequestReadIndex();
+      return Status::OK();
+    }
     RETURN_NOT_OK(PickReadTime(server_.Clock()));
   }
 
-  if (transactional) {
-    // TODO(wait-queues) -- having this RequestScope live during conflict resolution may prevent
-    // intent cleanup for any transactions resolved after this is created and before it's destroyed.
-    // This may be especially problematic for operations which need to wait, as their waiting may
-    // now cause intents_db scans to become less performant. Moving this initialization to only
-    // cover cases where we avoid writes may cause inconsistency issues, as exposed by
-    // PgOnConflictTest.OnConflict which fails if we move this code below.
-    request_scope_ = VERIFY_RESULT(RequestScope::Create(tablet()->transaction_participant()));
-    // Serial number is used to check whether this operation was initiated before
-    // transaction status request. So we should initialize it as soon as possible.
-    read_time_.serial_no = request_scope_.request_id();
-  }
-
-  const auto& remote_address = context_.remote_address();
-  host_port_pb_.set_host(remote_address.address().to_string());
-  host_port_pb_.set_port(remote_address.port());
+  RETURN_NOT_OK(InitRequestScope());
 
   if (serializable_isolation || has_row_mark) {
     auto deadline = context_.GetClientDeadline();
@@ -405,6 +446,24 @@ Status ReadQuery::DoPerform() {
   return Complete();
 }
 
+Status ReadQuery::InitRequestScope() {
+  // TODO: should check all the tables referenced by the requests to decide if it is transactional.
+  if (!transactional()) {
+    return Status::OK();
+  }
+  // TODO(wait-queues) -- having this RequestScope live during conflict resolution may prevent
+  // intent cleanup for any transactions resolved after this is created and before it's destroyed.
+  // This may be especially problematic for operations which need to wait, as their waiting may
+  // now cause intents_db scans to become less performant. Moving this initialization to only
+  // cover cases where we avoid writes may cause inconsistency issues, as exposed by
+  // PgOnConflictTest.OnConflict which fails if we move this code below.
+  request_scope_ = VERIFY_RESULT(RequestScope::Create(tablet()->transaction_participant()));
+  // Serial number is used to check whether this operation was initiated before
+  // transaction status request. So we should initialize it as soon as possible.
+  read_time_.serial_no = request_scope_.request_id();
+  return Status::OK();
+}
+
 Status ReadQuery::DoPickReadTime(server::Clock* clock) {
   auto* metrics = abstract_tablet_->system() ? nullptr : tablet()->metrics();
   MonoTime start_time;
@@ -412,7 +471,9 @@ Status ReadQuery::DoPickReadTime(server::Clock* clock) {
     start_time = MonoTime::Now();
   }
   if (!read_time_) {
-    safe_ht_to_read_ = VERIFY_RESULT(abstract_tablet_->SafeTime(require_lease_));
+    safe_ht_to_read_ = read_index_peer_
+        ? VERIFY_RESULT(SafeTimeAfterReadIndex())
+        : VERIFY_RESULT(abstract_tablet_->SafeTime(require_lease_));
     // If the read time is not specified, then it is a single-shard read.
     // So we should restart it in server in case of failure.
     read_time_.read = safe_ht_to_read_;
@@ -450,6 +511,40 @@ Status ReadQuery::DoPickReadTime(server::Clock* clock) {
   return Status::OK();
 }
 
+bool ReadQuery::CanUseReadIndex() const {
+  return GetAtomicFlag(&FLAGS_enable_follower_read_index) &&
+         server_.tablet_manager() &&
+         !req_->has_transaction() &&
+         !ReadHybridTime::FromReadTimePB(*req_);
+}
+
+void ReadQuery::RequestReadIndex() {
+  TRACE("Requesting read index");
+  server_.tablet_manager()->read_index_batcher()->GetLeaderSafeTimeAsync(
+      *read_index_peer_, context_.GetClientDeadline(),
+      [self = shared_from_this()](Result<HybridTime> leader_safe_time) {
+    if (!leader_safe_time.ok()) {
+      // Let the client retry the read at the leader.
+      self->RespondFailure(STATUS(
+          IllegalState, Format("Failed to get read index: $0", leader_safe_time.status()),
+          self->req_->tablet_id(), TabletServerError(TabletServerErrorPB::NOT_THE_LEADER)));
+      return;
+    }
+    self->leader_safe_time_ = *leader_safe_time;
+    // Waiting for the local safe time could block, so the read proceeds on the tablet peer
+    // thread pool instead of the reactor thread.
+    self->retained_self_ = self;
+    self->read_index_peer_->Enqueue(self.get());
+  });
+}
+
+Result<HybridTime> ReadQuery::SafeTimeAfterReadIndex() {
+  TRACE("Got read index: $0", leader_safe_time_.ToString());
+  server_.Clock()->Update(leader_safe_time_);
+  return abstract_tablet_->SafeTime(
+      tablet::RequireLease::kFalse, leader_safe_time_, context_.GetClientDeadline());
+}
+
 bool ReadQuery::IsPgsqlFollowerReadAtAFollower() const {
   return reading_from_non_leader_ &&
          (!req_->pgsql_batch().empty() &&
@@ -624,13 +719,10 @@ Result<ReadHybridTime> ReadQuery::DoReadImpl() {
     DCHECK_EQ(abstract_tablet_->table_type(), TableType::YQL_TABLE_TYPE);
     ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(req_);
     for (QLReadRequestPB& ql_read_req : *mutable_req->mutable_ql_batch()) {
-      // Update the remote endpoint.
-      ql_read_req.set_allocated_remote_endpoint(&host_port_pb_);
-      ql_read_req.set_allocated_proxy_uuid(mutable_req->mutable_proxy_uuid());
-      auto se = ScopeExit([&ql_read_req] {
-        ql_read_req.release_remote_endpoint();
-        ql_read_req.release_proxy_uuid();
-      });
+      // Update the remote endpoint. Fields are copied, since the request could be allocated on the
+      // call arena, that would take ownership of borrowed objects.
+      *ql_read_req.mutable_remote_endpoint() = host_port_pb_;
+      ql_read_req.set_proxy_uuid(req_->proxy_uuid());
 
       tablet::QLReadRequestResult result;
       TRACE("Start HandleQLReadRequest");
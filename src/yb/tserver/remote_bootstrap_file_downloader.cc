@@ -14,6 +14,7 @@
 #include "yb/tserver/remote_bootstrap_file_downloader.h"
 
 #include <iomanip>
+#include <unordered_set>
 
 #include "yb/common/wire_protocol.h"
 
@@ -29,9 +30,11 @@
 #include "yb/util/flags.h"
 #include "yb/util/logging.h"
 #include "yb/util/net/rate_limiter.h"
+#include "yb/util/scope_exit.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status_format.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 
 using namespace yb::size_literals;
 
@@ -51,6 +54,13 @@ DEFINE_UNKNOWN_int32(bytes_remote_bootstrap_durable_write_mb, 1024,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
 
+DEFINE_RUNTIME_int32(remote_bootstrap_max_concurrent_file_downloads, 1,
+             "Maximum number of files fetched in parallel by a single remote bootstrap session. "
+             "The transmission rate limit is shared between all files being downloaded, so "
+             "raising this mostly helps when a single stream is bound by latency or by the "
+             "per-chunk CRC verification and write, rather than by the rate limit.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+
 // RETURN_NOT_OK_PREPEND() with a remote-error unwinding step.
 #define RETURN_NOT_OK_UNWIND_PREPEND(status, controller, msg) \
   RETURN_NOT_OK_PREPEND(UnwindRemoteError(status, controller), msg)
@@ -75,6 +85,9 @@ Status ExtractRemoteError(
           " from remote service");
 }
 
+// Number of file downloads currently in progress across all remote bootstrap sessions.
+std::atomic<int32_t> remote_bootstrap_file_downloads_in_progress{0};
+
 } // namespace
 
 extern std::atomic<int32_t> remote_bootstrap_clients_started_;
@@ -102,16 +115,23 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
   RETURN_NOT_OK(env().CreateDirs(DirName(file_path)));
 
   if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+    std::string existing_file;
+    {
+      std::lock_guard lock(inode2file_mutex_);
+      auto it = inode2file_.find(file_pb.inode());
+      if (it != inode2file_.end()) {
+        existing_file = it->second;
+      }
+    }
+    if (!existing_file.empty()) {
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = env().LinkFile(it->second, file_path);
+                          << " => " << existing_file;
+      auto link_status = env().LinkFile(existing_file, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << existing_file
                              << ": " << link_status;
     }
   }
@@ -130,12 +150,107 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
   VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
 
   if (file_pb.inode() != 0) {
+    std::lock_guard lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
   return Status::OK();
 }
 
+Status RemoteBootstrapFileDownloader::DownloadFiles(
+    const google::protobuf::RepeatedPtrField<tablet::FilePB>& files, const std::string& dir,
+    DataIdPB::IdType type) {
+  // Files sharing an inode with an earlier file are postponed, so that they are hard linked
+  // instead of being fetched again by a concurrent download.
+  std::vector<const tablet::FilePB*> primary_files;
+  std::vector<const tablet::FilePB*> linked_files;
+  {
+    std::unordered_set<uint64_t> seen_inodes;
+    for (const auto& file_pb : files) {
+      if (file_pb.inode() != 0 && !seen_inodes.insert(file_pb.inode()).second) {
+        linked_files.push_back(&file_pb);
+      } else {
+        primary_files.push_back(&file_pb);
+      }
+    }
+  }
+
+  auto download = [this, &dir, type](const tablet::FilePB& file_pb) -> Status {
+    DataIdPB data_id;
+    data_id.set_type(type);
+    auto start = MonoTime::Now();
+    RETURN_NOT_OK(DownloadFile(file_pb, dir, &data_id));
+    LOG_WITH_PREFIX(INFO)
+        << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
+        << " in " << (MonoTime::Now() - start).ToSeconds() << " seconds";
+    return Status::OK();
+  };
+
+  const auto max_concurrency = std::min<size_t>(
+      std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1), primary_files.size());
+  uint64_t total_bytes = 0;
+  for (const auto* file_pb : primary_files) {
+    total_bytes += file_pb->size_bytes();
+  }
+  auto start = MonoTime::Now();
+
+  if (max_concurrency <= 1) {
+    for (const auto* file_pb : primary_files) {
+      RETURN_NOT_OK(download(*file_pb));
+    }
+  } else {
+    std::unique_ptr<ThreadPool> pool;
+    RETURN_NOT_OK(ThreadPoolBuilder("rb-download")
+                      .set_min_threads(0)
+                      .set_max_threads(narrow_cast<int>(max_concurrency))
+                      .Build(&pool));
+    std::mutex status_mutex;
+    Status first_failure;
+    for (const auto* file_pb : primary_files) {
+      auto submit_status = pool->SubmitFunc(
+          [&download, &status_mutex, &first_failure, file_pb] {
+        {
+          std::lock_guard lock(status_mutex);
+          if (!first_failure.ok()) {
+            return;
+          }
+        }
+        auto status = download(*file_pb);
+        if (!status.ok()) {
+          std::lock_guard lock(status_mutex);
+          if (first_failure.ok()) {
+            first_failure = std::move(status);
+          }
+        }
+      });
+      if (!submit_status.ok()) {
+        std::lock_guard lock(status_mutex);
+        if (first_failure.ok()) {
+          first_failure = std::move(submit_status);
+        }
+        break;
+      }
+    }
+    pool->Wait();
+    pool->Shutdown();
+    RETURN_NOT_OK(first_failure);
+  }
+
+  auto elapsed = MonoTime::Now() - start;
+  LOG_WITH_PREFIX(INFO)
+      << "Downloaded " << primary_files.size() << " files (" << total_bytes << " bytes) with "
+      << max_concurrency << " concurrent downloads in " << elapsed.ToSeconds()
+      << " seconds, throughput: "
+      << (elapsed.ToSeconds() > 0 ? total_bytes / elapsed.ToSeconds() : total_bytes)
+      << " bytes/sec";
+
+  for (const auto* file_pb : linked_files) {
+    RETURN_NOT_OK(download(*file_pb));
+  }
+
+  return Status::OK();
+}
+
 template<class Appendable>
 Status RemoteBootstrapFileDownloader::DownloadFile(
     const DataIdPB& data_id, Appendable* appendable) {
@@ -149,6 +264,11 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
 
   std::unique_ptr<RateLimiter> rate_limiter;
 
+  remote_bootstrap_file_downloads_in_progress.fetch_add(1, std::memory_order_acq_rel);
+  auto se = ScopeExit([] {
+    remote_bootstrap_file_downloads_in_progress.fetch_sub(1, std::memory_order_acq_rel);
+  });
+
   if (FLAGS_remote_bootstrap_rate_limit_bytes_per_sec > 0) {
     static auto rate_updater = []() {
       auto remote_bootstrap_clients_started =
@@ -158,8 +278,13 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
                                    << remote_bootstrap_clients_started;
         return static_cast<uint64_t>(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec);
       }
+      // A session may download several files concurrently, so split the limit between all the
+      // active downloads rather than only between sessions.
+      auto num_streams = std::max(
+          remote_bootstrap_clients_started,
+          remote_bootstrap_file_downloads_in_progress.load(std::memory_order_acquire));
       return static_cast<uint64_t>(
-          FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / remote_bootstrap_clients_started);
+          FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / num_streams);
     };
 
     rate_limiter = std::make_unique<RateLimiter>(rate_updater);
@@ -170,6 +295,8 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
 
   rpc::RpcController controller;
   controller.set_timeout(session_idle_timeout_);
+  // Remote bootstrap should not delay user requests on the source tablet server.
+  controller.set_priority_class(rpc::RpcPriorityClass::kBackground);
   FetchDataRequestPB req;
   Stopwatch verify_data_timer;
   Stopwatch append_data_timer;
@@ -17,6 +17,8 @@
 
 #include "yb/tserver/remote_bootstrap_client-test.h"
 
+DECLARE_int32(remote_bootstrap_max_concurrent_file_downloads);
+
 using std::vector;
 
 namespace yb {
@@ -27,6 +29,9 @@ using tablet::TabletStatusListener;
 class RemoteBootstrapRocksDBClientTest : public RemoteBootstrapClientTest {
  public:
   RemoteBootstrapRocksDBClientTest() : RemoteBootstrapClientTest(YQL_TABLE_TYPE) {}
+
+ protected:
+  void TestDownloadRocksDBFiles();
 };
 
 // Basic begin / end remote bootstrap session.
@@ -36,8 +41,7 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestBeginEndSession) {
   ASSERT_OK(client_->Finish());
 }
 
-// Basic RocksDB files download unit test.
-TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
+void RemoteBootstrapRocksDBClientTest::TestDownloadRocksDBFiles() {
   TabletStatusListener listener(meta_);
   ASSERT_OK(client_->FetchAll(&listener));
   auto tablet_peer_checkpoint_dir =
@@ -77,5 +81,16 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   }
 }
 
+// Basic RocksDB files download unit test.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
+  TestDownloadRocksDBFiles();
+}
+
+// Same as above, but fetch several files in parallel.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesConcurrently) {
+  ANNOTATE_UNPROTECTED_WRITE(FLAGS_remote_bootstrap_max_concurrent_file_downloads) = 4;
+  TestDownloadRocksDBFiles();
+}
+
 } // namespace tserver
 } // namespace yb
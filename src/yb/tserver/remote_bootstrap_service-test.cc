@@ -53,6 +53,7 @@
 
 #include "yb/util/crc.h"
 #include "yb/util/env_util.h"
+#include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
@@ -66,6 +67,8 @@ using std::vector;
 DECLARE_uint64(remote_bootstrap_idle_timeout_ms);
 DECLARE_uint64(remote_bootstrap_timeout_poll_period_ms);
 
+METRIC_DECLARE_counter(remote_bootstrap_bytes_sent);
+
 namespace yb {
 namespace tserver {
 
@@ -374,6 +377,10 @@ TEST_F(RemoteBootstrapServiceTest, TestFetchLog) {
   ASSERT_OK(ReadFully(segment->readable_file_checkpoint().get(), 0, size, &slice, scratch.data()));
 
   AssertDataEqual(slice.data(), slice.size(), resp.chunk());
+
+  auto bytes_sent = METRIC_remote_bootstrap_bytes_sent.Instantiate(
+      mini_server_->server()->metric_entity());
+  ASSERT_EQ(bytes_sent->value(), static_cast<int64_t>(resp.chunk().data().size()));
 }
 
 // Test that the remote bootstrap session timeout works properly.
@@ -33,7 +33,6 @@
 #include "yb/tserver/remote_bootstrap_service.h"
 
 #include <algorithm>
-#include <iomanip>
 #include <string>
 #include <vector>
 
@@ -57,6 +56,7 @@
 #include "yb/util/crc.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flags.h"
+#include "yb/util/metrics.h"
 #include "yb/util/status.h"
 #include "yb/util/status_format.h"
 #include "yb/util/status_log.h"
@@ -120,6 +120,17 @@ DEFINE_test_flag(
 DEFINE_UNKNOWN_uint64(remote_bootstrap_change_role_timeout_ms, 15000,
               "Timeout for change role operation during remote bootstrap.");
 
+METRIC_DEFINE_counter(server, remote_bootstrap_bytes_sent,
+                      "Remote Bootstrap Bytes Sent",
+                      yb::MetricUnit::kBytes,
+                      "Number of bytes of data files sent to remote bootstrap clients.");
+
+METRIC_DEFINE_counter(server, remote_bootstrap_data_read_time_us,
+                      "Remote Bootstrap Data Read Time",
+                      yb::MetricUnit::kMicroseconds,
+                      "Total time spent reading data files sent to remote bootstrap clients. "
+                      "Compare with remote_bootstrap_bytes_sent to get the read throughput.");
+
 namespace yb {
 namespace tserver {
 
@@ -152,7 +163,9 @@ RemoteBootstrapServiceImpl::RemoteBootstrapServiceImpl(
       tablet_peer_lookup_(CHECK_NOTNULL(tablet_peer_lookup)),
       local_cloud_info_pb_(cloud_info),
       proxy_cache_(proxy_cache),
-      shutdown_latch_(1) {
+      shutdown_latch_(1),
+      bytes_sent_(METRIC_remote_bootstrap_bytes_sent.Instantiate(metric_entity)),
+      data_read_time_us_(METRIC_remote_bootstrap_data_read_time_us.Instantiate(metric_entity)) {
   CHECK_OK(Thread::Create("remote-bootstrap", "rb-session-exp",
                           &RemoteBootstrapServiceImpl::EndExpiredSessions, this,
                           &session_expiration_thread_));
@@ -291,7 +304,7 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
 
   MAYBE_FAULT(FLAGS_TEST_fault_crash_on_handle_rb_fetch_data);
 
-  int64_t rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+  int64_t rate_limit = session->GetMaxSizeForNextTransmission();
   VLOG(3) << " rate limiter max len: " << rate_limit;
   GetDataPieceInfo info = {
     .offset = req->offset(),
@@ -304,15 +317,18 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
   RPC_RETURN_NOT_OK(ValidateFetchRequestDataId(data_id, &info.error_code, session),
                     info.error_code, "Invalid DataId");
 
-  session->data_read_timer().resume();
+  auto start = MonoTime::Now();
   RPC_RETURN_NOT_OK(session->GetDataPiece(data_id, &info),
                     info.error_code, "Unable to get piece of data file");
-  session->data_read_timer().stop();
+  auto read_finish = MonoTime::Now();
+  session->AddDataReadTime(read_finish - start);
+  bytes_sent_->IncrementBy(info.data.size());
+  data_read_time_us_->IncrementBy((read_finish - start).ToMicroseconds());
 
-  session->rate_limiter().UpdateDataSizeAndMaybeSleep(info.data.size());
-  session->crc_compute_timer().resume();
+  session->UpdateDataSizeAndMaybeSleep(info.data.size());
+  start = MonoTime::Now();
   uint32_t crc32 = Crc32c(info.data.data(), info.data.length());
-  session->crc_compute_timer().stop();
+  session->AddCrcComputeTime(MonoTime::Now() - start);
 
   DataChunkPB* data_chunk = resp->mutable_chunk();
   *data_chunk->mutable_data() = std::move(info.data);
@@ -448,17 +464,8 @@ Status RemoteBootstrapServiceImpl::DoEndRemoteBootstrapSession(
     if(!session->Succeeded()) {
       session->SetSuccess();
 
-      const auto total_bytes = session->rate_limiter().total_bytes();
-      LOG(INFO) << std::fixed << std::setprecision(3) << "Remote bootstrap session with id "
-        << session_id << " completed. Stats: Transmission rate: "
-        << session->rate_limiter().GetRate() << ", RateLimiter total time slept: "
-        << session->rate_limiter().total_time_slept() << ", Total bytes: "
-        << total_bytes << ", Read rate "
-        << (total_bytes / session->data_read_timer().elapsed().wall_millis())
-        << " bytes/msec (Total ms: " << session->data_read_timer().elapsed().wall_millis()
-        << "), CRC computation rate: "
-        << (total_bytes / session->crc_compute_timer().elapsed().wall_millis()) << " bytes/msec"
-        << "(Total ms: " << session->crc_compute_timer().elapsed().wall_millis() << ")";
+      LOG(INFO) << "Remote bootstrap session with id " << session_id << " completed. Stats: "
+                << session->TransmissionStatsToString();
     }
 
     if (PREDICT_FALSE(FLAGS_TEST_inject_latency_before_change_role_secs)) {
@@ -44,6 +44,7 @@
 #include "yb/util/status_fwd.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/locks.h"
+#include "yb/util/metrics_fwd.h"
 #include "yb/util/monotime.h"
 
 namespace yb {
@@ -190,6 +191,9 @@ class RemoteBootstrapServiceImpl : public RemoteBootstrapServiceIf {
   // TODO: this is a hack, replace with some kind of timer impl. See KUDU-286.
   CountDownLatch shutdown_latch_;
   scoped_refptr<Thread> session_expiration_thread_;
+
+  scoped_refptr<Counter> bytes_sent_;
+  scoped_refptr<Counter> data_read_time_us_;
 };
 
 } // namespace tserver
@@ -540,11 +540,46 @@ bool RemoteBootstrapSession::Succeeded() {
 }
 
 void RemoteBootstrapSession::EnsureRateLimiterIsInitialized() {
+  std::lock_guard lock(transmission_mutex_);
   if (!rate_limiter_.IsInitialized()) {
     InitRateLimiter();
   }
 }
 
+uint64_t RemoteBootstrapSession::GetMaxSizeForNextTransmission() {
+  std::lock_guard lock(transmission_mutex_);
+  return rate_limiter_.GetMaxSizeForNextTransmission();
+}
+
+void RemoteBootstrapSession::UpdateDataSizeAndMaybeSleep(uint64_t data_size) {
+  // Sleeping under the lock also delays concurrent fetches, so they share the session rate.
+  std::lock_guard lock(transmission_mutex_);
+  rate_limiter_.UpdateDataSizeAndMaybeSleep(data_size);
+}
+
+void RemoteBootstrapSession::AddDataReadTime(MonoDelta time) {
+  std::lock_guard lock(transmission_mutex_);
+  data_read_time_ += time;
+}
+
+void RemoteBootstrapSession::AddCrcComputeTime(MonoDelta time) {
+  std::lock_guard lock(transmission_mutex_);
+  crc_compute_time_ += time;
+}
+
+std::string RemoteBootstrapSession::TransmissionStatsToString() {
+  std::lock_guard lock(transmission_mutex_);
+  const auto total_bytes = rate_limiter_.total_bytes();
+  const auto data_read_ms = std::max<int64_t>(data_read_time_.ToMilliseconds(), 1);
+  const auto crc_compute_ms = std::max<int64_t>(crc_compute_time_.ToMilliseconds(), 1);
+  return Format(
+      "Transmission rate: $0, RateLimiter total time slept: $1, Total bytes: $2, "
+      "Read rate $3 bytes/msec (Total ms: $4), CRC computation rate: $5 bytes/msec (Total ms: $6)",
+      rate_limiter_.GetRate(), rate_limiter_.total_time_slept(), total_bytes,
+      total_bytes / data_read_ms, data_read_time_.ToMilliseconds(),
+      total_bytes / crc_compute_ms, crc_compute_time_.ToMilliseconds());
+}
+
 Status RemoteBootstrapSession::RefreshRemoteLogAnchorSessionAsync() {
   if (rbs_anchor_client_ && rbs_anchor_session_created_) {
     RETURN_NOT_OK(rbs_anchor_client_->KeepLogAnchorAliveAsync());
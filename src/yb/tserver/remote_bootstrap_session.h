@@ -134,14 +134,19 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   // Change the peer's role to VOTER.
   Status ChangeRole();
 
-  void InitRateLimiter();
-
   void EnsureRateLimiterIsInitialized();
 
-  RateLimiter& rate_limiter() { return rate_limiter_; }
+  // FetchData calls of the same session run concurrently when the client downloads several files
+  // at once, so the rate limiter and transmission stats are accessed under transmission_mutex_.
+  uint64_t GetMaxSizeForNextTransmission();
+
+  void UpdateDataSizeAndMaybeSleep(uint64_t data_size);
+
+  void AddDataReadTime(MonoDelta time);
 
-  Stopwatch& crc_compute_timer() { return crc_compute_timer_; }
-  Stopwatch& data_read_timer() { return data_read_timer_; }
+  void AddCrcComputeTime(MonoDelta time);
+
+  std::string TransmissionStatsToString();
 
   static const std::string kCheckpointsDir;
 
@@ -165,6 +170,8 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   virtual ~RemoteBootstrapSession();
 
+  void InitRateLimiter() REQUIRES(transmission_mutex_);
+
   template <class Source>
   void AddSource() {
     sources_[Source::id_type()] = std::make_unique<Source>(tablet_peer_, &tablet_superblock_);
@@ -229,12 +236,14 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   // Time when this session was initialized.
   MonoTime start_time_;
 
-  // Stopwatch to capture the latency of different operations
-  Stopwatch crc_compute_timer_;
-  Stopwatch data_read_timer_;
+  std::mutex transmission_mutex_;
+
+  // Total latency of different operations.
+  MonoDelta crc_compute_time_ GUARDED_BY(transmission_mutex_) = MonoDelta::kZero;
+  MonoDelta data_read_time_ GUARDED_BY(transmission_mutex_) = MonoDelta::kZero;
 
   // Used to limit the transmission rate.
-  RateLimiter rate_limiter_;
+  RateLimiter rate_limiter_ GUARDED_BY(transmission_mutex_);
 
   // Pointer to the counter for of the number of sessions in RemoteBootstrapService. Used to
   // calculate the rate for the rate limiter.
@@ -171,6 +171,7 @@ Result<int64_t> LeaderTerm(const tablet::TabletPeer& tablet_peer) {
         // that we're a partitioned-away leader, and the client needs to do another leader lookup.
         return status.CloneAndAddErrorCode(TabletServerError(TabletServerErrorPB::NOT_THE_LEADER));
       case LeaderStatus::LEADER_BUT_NO_OP_NOT_COMMITTED: FALLTHROUGH_INTENDED;
+      case LeaderStatus::LEADER_BUT_WITNESS: FALLTHROUGH_INTENDED;
       case LeaderStatus::LEADER_BUT_OLD_LEADER_MAY_HAVE_LEASE:
         return status.CloneAndAddErrorCode(TabletServerError(
             TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE));
@@ -441,6 +442,18 @@ Status CheckWriteThrottling(double score, tablet::TabletPeer* tablet_peer) {
     }
   }
 
+  auto throttle_delay = tablet->AdmitWrite(
+      sst_files_soft_limit ? static_cast<double>(num_sst_files) / sst_files_soft_limit : 0);
+  if (throttle_delay > MonoDelta::kZero) {
+    tablet->metrics()->write_throttling_rejections->Increment();
+    auto message = Format("Tablet write rate throttled, backoff: $0", throttle_delay);
+    // Ask the client to back off for the time needed to admit this write, within rejection delay
+    // bounds.
+    auto overlimit = 1.0 + std::min(
+        throttle_delay.ToSeconds() * 1000.0 / FLAGS_max_rejection_delay_ms, 1.0);
+    return RejectWrite(tablet_peer, message, overlimit);
+  }
+
   if (FLAGS_TEST_write_rejection_percentage != 0 &&
       score >= 1.0 - FLAGS_TEST_write_rejection_percentage * 0.01) {
     auto status = Format("TEST: Write request rejected, desired percentage: $0, score: $1",
@@ -42,6 +42,13 @@ DEFINE_UNKNOWN_bool(log_cache_gc_evict_only_over_allocated, true,
             "If set to true, log cache garbage collection would evict only memory that was "
             "allocated over limit for log cache. Otherwise it will try to evict requested number "
             "of bytes.");
+DEFINE_RUNTIME_bool(log_cache_gc_cost_aware_eviction, true,
+            "If set to true, log cache garbage collection first evicts ops that are no longer "
+            "needed by live followers, then ops of tablets that use more than their fair share of "
+            "the global log cache limit, and only then falls back to evicting from the largest "
+            "caches.");
+TAG_FLAG(log_cache_gc_cost_aware_eviction, advanced);
+
 DEFINE_UNKNOWN_int64(global_memstore_size_percentage, 10,
              "Percentage of total available memory to use for the global memstore. "
              "Default is 10. See also memstore_size_mb and "
@@ -146,10 +153,19 @@ int64_t GetTargetBlockCacheSize(const int32_t default_block_cache_size_percentag
   return target_block_cache_size_bytes;
 }
 
+consensus::RaftConsensus* GetRaftConsensus(tablet::TabletPeer* peer) {
+  return down_cast<consensus::RaftConsensus*>(peer->consensus());
+}
+
 size_t GetLogCacheSize(tablet::TabletPeer* peer) {
-  return down_cast<consensus::RaftConsensus*>(peer->consensus())->LogCacheSize();
+  return GetRaftConsensus(peer)->LogCacheSize();
 }
 
+struct LogCacheGCCandidate {
+  tablet::TabletPeer* peer;
+  size_t size;
+};
+
 }  // namespace
 
 TabletMemoryManager::TabletMemoryManager(
@@ -259,27 +275,69 @@ void TabletMemoryManager::LogCacheGC(MemTracker* log_cache_mem_tracker, size_t b
   }
 
   auto peers = peers_fn_();
+  std::vector<LogCacheGCCandidate> candidates;
+  candidates.reserve(peers.size());
+  for (const auto& peer : peers) {
+    auto size = GetLogCacheSize(peer.get());
+    if (size > 0) {
+      candidates.push_back({peer.get(), size});
+    }
+  }
   // Sort by inverse log size.
-  std::sort(peers.begin(), peers.end(), [](const auto& lhs, const auto& rhs) {
-    return GetLogCacheSize(lhs.get()) > GetLogCacheSize(rhs.get());
+  std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.size > rhs.size;
   });
 
   size_t total_evicted = 0;
-  for (const auto& peer : peers) {
-    if (GetLogCacheSize(peer.get()) <= 0) {
-      continue;
+  size_t evicted_not_needed = 0;
+  size_t evicted_over_fair_share = 0;
+  if (FLAGS_log_cache_gc_cost_aware_eviction && !candidates.empty()) {
+    // Ops that are retained only for CDC or lagging followers are the cheapest to evict, since
+    // nobody is going to read them from the cache soon.
+    for (auto& candidate : candidates) {
+      auto evicted = GetRaftConsensus(candidate.peer)->EvictLogCacheNotNeededByLiveFollowers(
+          bytes_to_evict - total_evicted);
+      candidate.size -= std::min(candidate.size, evicted);
+      total_evicted += evicted;
+      if (total_evicted >= bytes_to_evict) {
+        break;
+      }
     }
-    size_t evicted = down_cast<consensus::RaftConsensus*>(
-        peer->consensus())->EvictLogCache(bytes_to_evict - total_evicted);
-    total_evicted += evicted;
-    if (total_evicted >= bytes_to_evict) {
-      break;
+    evicted_not_needed = total_evicted;
+
+    // Then evict from tablets that use more than their fair share of the global limit, so that a
+    // few hot tablets do not push the others out of the cache.
+    if (total_evicted < bytes_to_evict && log_cache_mem_tracker->has_limit()) {
+      const size_t fair_share = log_cache_mem_tracker->limit() / candidates.size();
+      for (const auto& candidate : candidates) {
+        if (candidate.size <= fair_share) {
+          continue;
+        }
+        total_evicted += GetRaftConsensus(candidate.peer)->EvictLogCache(
+            std::min(candidate.size - fair_share, bytes_to_evict - total_evicted));
+        if (total_evicted >= bytes_to_evict) {
+          break;
+        }
+      }
     }
+    evicted_over_fair_share = total_evicted - evicted_not_needed;
   }
 
+  if (total_evicted < bytes_to_evict) {
+    for (const auto& candidate : candidates) {
+      total_evicted += GetRaftConsensus(candidate.peer)->EvictLogCache(
+          bytes_to_evict - total_evicted);
+      if (total_evicted >= bytes_to_evict) {
+        break;
+      }
+    }
+  }
 
   LOG(INFO) << "Evicted from log cache: " << HumanReadableNumBytes::ToString(total_evicted)
-            << ", required: " << HumanReadableNumBytes::ToString(bytes_to_evict);
+            << " (not needed by live followers: "
+            << HumanReadableNumBytes::ToString(evicted_not_needed)
+            << ", over fair share: " << HumanReadableNumBytes::ToString(evicted_over_fair_share)
+            << "), required: " << HumanReadableNumBytes::ToString(bytes_to_evict);
 }
 
 void TabletMemoryManager::FlushTabletIfLimitExceeded() {
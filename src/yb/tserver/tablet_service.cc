@@ -33,6 +33,7 @@
 #include "yb/tserver/tablet_service.h"
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -70,6 +71,7 @@
 #include "yb/tablet/abstract_tablet.h"
 #include "yb/tablet/metadata.pb.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/ingest_external_file_operation.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -1025,8 +1027,8 @@ void TabletServiceImpl::VerifyTableRowRange(
   context.RespondSuccess();
 }
 
-void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
-                                          UpdateTransactionResponsePB* resp,
+void TabletServiceImpl::UpdateTransaction(const LWUpdateTransactionRequestPB* req,
+                                          LWUpdateTransactionResponsePB* resp,
                                           rpc::RpcContext context) {
   TRACE("UpdateTransaction");
 
@@ -1043,25 +1045,30 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
       << TransactionStatus_Name(req->state().status());
   UpdateClock(*req, server_->Clock());
 
+  // Request is parsed into the call arena, so tablet id is a slice of the received buffer.
+  auto peer_tablet = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context));
   LeaderTabletPeer tablet;
   auto txn_status = req->state().status();
   auto cleanup = txn_status == TransactionStatus::IMMEDIATE_CLEANUP ||
                  txn_status == TransactionStatus::GRACEFUL_CLEANUP;
   if (cleanup) {
-    auto peer_tablet = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
-        server_->tablet_peer_lookup(), req->tablet_id(), resp, &context));
     tablet.FillTabletPeer(std::move(peer_tablet));
     tablet.leader_term = OpId::kUnknownTerm;
   } else {
+    const auto& tablet_id = peer_tablet.tablet_peer->tablet_id();
     tablet = LookupLeaderTabletOrRespond(
-        server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+        server_->tablet_peer_lookup(), tablet_id, resp, &context, std::move(peer_tablet));
   }
   if (!tablet) {
     return;
   }
 
   auto state = std::make_unique<tablet::UpdateTxnOperation>(tablet.tablet);
-  state->AllocateRequest()->CopyFrom(req->state());
+  // Operation shares the request arena instead of copying the transaction state, the context keeps
+  // it alive until the operation is completed.
+  state->TakeRequest(rpc::SharedField(
+      context.shared_params(), const_cast<tablet::LWTransactionStatePB*>(&req->state())));
   state->set_completion_callback(MakeRpcOperationCompletionCallback(
       std::move(context), resp, server_->Clock()));
 
@@ -1108,6 +1115,97 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
   }
 }
 
+namespace {
+
+// Collects results of operations created for UpdateTransactions request, and responds when all of
+// them are completed.
+class UpdateTransactionsCompletion {
+ public:
+  UpdateTransactionsCompletion(
+      rpc::RpcContext context, UpdateTransactionsResponsePB* resp, server::ClockPtr clock)
+      : context_(std::move(context)), resp_(resp), clock_(std::move(clock)),
+        left_(resp->results_size()) {
+  }
+
+  void Completed(int idx, const Status& status) {
+    if (!status.ok()) {
+      SetupError(resp_->mutable_results(idx)->mutable_error(), status);
+    }
+    if (left_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    resp_->set_propagated_hybrid_time(clock_->Now().ToUint64());
+    context_.RespondSuccess();
+  }
+
+ private:
+  rpc::RpcContext context_;
+  UpdateTransactionsResponsePB* const resp_;
+  const server::ClockPtr clock_;
+  std::atomic<int> left_;
+};
+
+} // namespace
+
+void TabletServiceImpl::UpdateTransactions(const UpdateTransactionsRequestPB* req,
+                                           UpdateTransactionsResponsePB* resp,
+                                           rpc::RpcContext context) {
+  TRACE("UpdateTransactions");
+
+  VLOG(1) << "UpdateTransactions: " << req->ShortDebugString()
+          << ", context: " << context.ToString();
+  UpdateClock(*req, server_->Clock());
+
+  auto tablet = LookupLeaderTabletOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!tablet) {
+    return;
+  }
+
+  auto* coordinator = tablet.tablet->transaction_coordinator();
+  if (!coordinator) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS(InvalidArgument, "Does not have transaction coordinator to process heartbeats"),
+        &context);
+    return;
+  }
+
+  if (req->states().empty()) {
+    resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
+    context.RespondSuccess();
+    return;
+  }
+
+  // All results are allocated before any operation is started, so completion callbacks could fill
+  // them concurrently.
+  for (int i = 0; i != req->states_size(); ++i) {
+    resp->add_results();
+  }
+  auto completion = std::make_shared<UpdateTransactionsCompletion>(
+      std::move(context), resp, server_->Clock());
+
+  std::vector<std::unique_ptr<tablet::UpdateTxnOperation>> operations;
+  operations.reserve(req->states_size());
+  for (int i = 0; i != req->states_size(); ++i) {
+    const auto& state = req->states(i);
+    if (state.status() != TransactionStatus::PENDING) {
+      completion->Completed(i, STATUS_FORMAT(
+          InvalidArgument, "Only heartbeats could be batched, but $0 requested",
+          TransactionStatus_Name(state.status())));
+      continue;
+    }
+    auto operation = std::make_unique<tablet::UpdateTxnOperation>(tablet.tablet);
+    operation->AllocateRequest()->CopyFrom(state);
+    operation->set_completion_callback([completion, i](const Status& status) {
+      completion->Completed(i, status);
+    });
+    operations.push_back(std::move(operation));
+  }
+
+  coordinator->Handle(std::move(operations), tablet.leader_term);
+}
+
 template <class Req, class Resp, class Action>
 void TabletServiceImpl::PerformAtLeader(
     const Req& req, Resp* resp, rpc::RpcContext* context, const Action& action) {
@@ -1340,6 +1438,38 @@ void TabletServiceImpl::Truncate(const TruncateRequestPB* req,
   tablet.peer->Submit(std::move(operation), tablet.leader_term);
 }
 
+void TabletServiceImpl::IngestExternalFile(const IngestExternalFileRequestPB* req,
+                                           IngestExternalFileResponsePB* resp,
+                                           rpc::RpcContext context) {
+  TRACE("IngestExternalFile");
+
+  UpdateClock(*req, server_->Clock());
+
+  auto tablet = LookupLeaderTabletOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!tablet) {
+    return;
+  }
+
+  // Replicate the name of the staged copy of the file, so the client could not move or change the
+  // file while it is ingested by the followers, or by this peer during bootstrap.
+  auto staged_file_name = tablet.tablet->StageExternalFile(req->ingest().file_path());
+  if (!staged_file_name.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), staged_file_name.status(), &context);
+    return;
+  }
+
+  auto operation = std::make_unique<IngestExternalFileOperation>(tablet.tablet);
+  operation->AllocateRequest()->set_staged_file_name(*staged_file_name);
+
+  operation->set_completion_callback(
+      MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+  // Only the name of the staged file is replicated, each peer rewrites it at the operation hybrid
+  // time and adds it to the regular DB when the operation is applied.
+  tablet.peer->Submit(std::move(operation), tablet.leader_term);
+}
+
 void TabletServiceImpl::GetCompatibleSchemaVersion(
     const GetCompatibleSchemaVersionRequestPB* req,
     GetCompatibleSchemaVersionResponsePB* resp,
@@ -2043,6 +2173,62 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   PerformRead(server_, this, req, resp, std::move(context));
 }
 
+namespace {
+
+// Responds to a MultiRaftUpdateConsensus RPC once all the updates of the batch are done.
+class MultiRaftUpdateBatch {
+ public:
+  MultiRaftUpdateBatch(rpc::RpcContext context, size_t num_updates)
+      : context_(std::move(context)), pending_updates_(num_updates) {
+    if (num_updates == 0) {
+      context_.RespondSuccess();
+    }
+  }
+
+  void UpdateDone() {
+    if (pending_updates_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      context_.RespondSuccess();
+    }
+  }
+
+ private:
+  rpc::RpcContext context_;
+  std::atomic<size_t> pending_updates_;
+};
+
+// Performs a single update of a MultiRaftUpdateConsensus batch.
+class MultiRaftUpdateTask : public rpc::ThreadPoolTask {
+ public:
+  using Update = std::function<void(consensus::LWConsensusResponsePB*)>;
+
+  MultiRaftUpdateTask(
+      std::shared_ptr<MultiRaftUpdateBatch> batch, consensus::LWConsensusResponsePB* resp,
+      Update update)
+      : batch_(std::move(batch)), resp_(resp), update_(std::move(update)) {}
+
+  virtual ~MultiRaftUpdateTask() = default;
+
+  void Run() override {
+    update_(resp_);
+  }
+
+  void Done(const Status& status) override {
+    if (!status.ok()) {
+      resp_->Clear();
+      SetupError(resp_->mutable_error(), status);
+    }
+    batch_->UpdateDone();
+    delete this;
+  }
+
+ private:
+  std::shared_ptr<MultiRaftUpdateBatch> batch_;
+  consensus::LWConsensusResponsePB* resp_;
+  Update update_;
+};
+
+} // namespace
+
 ConsensusServiceImpl::ConsensusServiceImpl(const scoped_refptr<MetricEntity>& metric_entity,
                                            TabletPeerLookupIf* tablet_manager)
     : ConsensusServiceIf(metric_entity),
@@ -2063,60 +2249,78 @@ void ConsensusServiceImpl::CompleteUpdateConsensusResponse(
 }
 
 void ConsensusServiceImpl::MultiRaftUpdateConsensus(
-      const consensus::MultiRaftConsensusRequestPB *req,
-      consensus::MultiRaftConsensusResponsePB *resp,
-      rpc::RpcContext context) {
-    DVLOG(3) << "Received Batch Consensus Update RPC: " << req->ShortDebugString();
-    // Effectively performs ConsensusServiceImpl::UpdateConsensus for
-    // each ConsensusRequestPB in the batch but does not fail the entire
-    // batch if a single request fails.
-    for (int i = 0; i < req->consensus_request_size(); i++) {
-      // Unfortunately, we have to use const_cast here,
-      // because the protobuf-generated interface only gives us a const request
-      // but we need to be able to move messages out of the request for efficiency.
-      auto consensus_req = const_cast<ConsensusRequestPB*>(&req->consensus_request(i));
-      auto consensus_resp = resp->add_consensus_response();;
-
-      auto uuid_match_res = CheckUuidMatch(tablet_manager_, "UpdateConsensus", consensus_req,
-                                           context.requestor_string());
-      if (!uuid_match_res.ok()) {
-        SetupError(consensus_resp->mutable_error(), uuid_match_res.status());
-        continue;
-      }
-
-      auto peer_tablet_res = LookupTabletPeer(tablet_manager_, consensus_req->tablet_id());
-      if (!peer_tablet_res.ok()) {
-        SetupError(consensus_resp->mutable_error(), peer_tablet_res.status());
-        continue;
-      }
-      auto tablet_peer = peer_tablet_res.get().tablet_peer;
+    const consensus::LWMultiRaftConsensusRequestPB* req,
+    consensus::LWMultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Batch Consensus Update RPC: " << req->ShortDebugString();
+  // Effectively performs ConsensusServiceImpl::UpdateConsensus for each ConsensusRequestPB in the
+  // batch but does not fail the entire batch if a single request fails.
+  // Updates are performed concurrently on the tablet peer thread pools, the last one on the current
+  // thread, so a slow tablet does not delay the updates of the other tablets in the batch.
+  const auto requestor_string = context.requestor_string();
+  auto deadline = context.GetClientDeadline();
+  auto shared_params = context.shared_params();
+  auto batch = std::make_shared<MultiRaftUpdateBatch>(
+      std::move(context), req->consensus_request().size());
+  std::vector<std::pair<TabletPeerPtr, MultiRaftUpdateTask*>> tasks;
+  for (const auto& consensus_req : req->consensus_request()) {
+    auto& consensus_resp = *resp->add_consensus_response();
+
+    auto uuid_match_res = CheckUuidMatch(
+        tablet_manager_, "UpdateConsensus", &consensus_req, requestor_string);
+    if (!uuid_match_res.ok()) {
+      SetupError(consensus_resp.mutable_error(), uuid_match_res.status());
+      batch->UpdateDone();
+      continue;
+    }
 
-      // Submit the update directly to the TabletPeer's Consensus instance.
-      auto consensus_res = GetConsensus(tablet_peer);
-      if (!consensus_res.ok()) {
-        SetupError(consensus_resp->mutable_error(), consensus_res.status());
-        continue;
-      }
-      auto consensus = *consensus_res;
+    auto peer_tablet_res = LookupTabletPeer(tablet_manager_, consensus_req.tablet_id());
+    if (!peer_tablet_res.ok()) {
+      SetupError(consensus_resp.mutable_error(), peer_tablet_res.status());
+      batch->UpdateDone();
+      continue;
+    }
+    auto tablet_peer = peer_tablet_res.get().tablet_peer;
+
+    // Submit the update directly to the TabletPeer's Consensus instance.
+    auto consensus_res = GetConsensus(tablet_peer);
+    if (!consensus_res.ok()) {
+      SetupError(consensus_resp.mutable_error(), consensus_res.status());
+      batch->UpdateDone();
+      continue;
+    }
 
-      // TODO(lw_uc) effective update for multiraft.
-      auto temp_resp = rpc::MakeSharedMessage<consensus::LWConsensusResponsePB>();
-      Status s = consensus->Update(
-         rpc::CopySharedMessage(*consensus_req),
-         temp_resp.get(), context.GetClientDeadline());
+    // Unfortunately, we have to use const_cast here, because the protobuf-generated interface only
+    // gives us a const request, but we need to be able to move messages out of the request for
+    // efficiency.
+    auto shared_req = rpc::SharedField(
+        shared_params, const_cast<consensus::LWConsensusRequestPB*>(&consensus_req));
+    tasks.emplace_back(tablet_peer, new MultiRaftUpdateTask(
+        batch, &consensus_resp,
+        [this, tablet_peer, consensus = *consensus_res, shared_req, deadline](
+            consensus::LWConsensusResponsePB* consensus_resp) {
+      Status s = consensus->Update(shared_req, consensus_resp, deadline);
       if (PREDICT_FALSE(!s.ok())) {
         // Clear the response first, since a partially-filled response could
         // result in confusing a caller, or in having missing required fields
         // in embedded optional messages.
         consensus_resp->Clear();
         SetupError(consensus_resp->mutable_error(), s);
-        continue;
+        return;
       }
+      CompleteUpdateConsensusResponse(tablet_peer, consensus_resp);
+    }));
+  }
 
-      CompleteUpdateConsensusResponse(tablet_peer, temp_resp.get());
-      temp_resp->ToGoogleProtobuf(consensus_resp);
-    }
-    context.RespondSuccess();
+  if (tasks.empty()) {
+    return;
+  }
+  for (auto it = tasks.begin(); it != tasks.end() - 1; ++it) {
+    it->first->Enqueue(it->second);
+  }
+  auto* last_task = tasks.back().second;
+  last_task->Run();
+  last_task->Done(Status::OK());
 }
 
 void ConsensusServiceImpl::UpdateConsensus(const consensus::LWConsensusRequestPB* req,
@@ -2461,6 +2665,35 @@ void ConsensusServiceImpl::StartRemoteBootstrap(const StartRemoteBootstrapReques
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::GetReadIndex(const consensus::GetReadIndexRequestPB* req,
+                                        consensus::GetReadIndexResponsePB* resp,
+                                        rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(tablet_manager_, "GetReadIndex", req, resp, &context)) {
+    return;
+  }
+  const auto deadline = context.GetClientDeadline();
+  HybridTime max_safe_time = HybridTime::kMin;
+  for (const auto& tablet_id : req->tablet_ids()) {
+    auto* entry = resp->add_tablets();
+    // The leader lease guarantees that every write acknowledged before this point has a hybrid
+    // time below the returned safe time, and no new write will be assigned one below it.
+    auto safe_time = [this, &tablet_id, deadline]() -> Result<HybridTime> {
+      auto leader = VERIFY_RESULT(LookupLeaderTablet(tablet_manager_, tablet_id));
+      return leader.tablet->SafeTime(tablet::RequireLease::kTrue, HybridTime::kMin, deadline);
+    }();
+    if (!safe_time.ok()) {
+      SetupError(entry->mutable_error(), safe_time.status());
+      continue;
+    }
+    entry->set_safe_time(safe_time->ToUint64());
+    max_safe_time.MakeAtLeast(*safe_time);
+  }
+  if (max_safe_time != HybridTime::kMin) {
+    resp->set_propagated_hybrid_time(max_safe_time.ToUint64());
+  }
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::NoOp(const NoOpRequestPB *req,
                              NoOpResponsePB *resp,
                              rpc::RpcContext context) {
@@ -2638,8 +2871,21 @@ void TabletServiceImpl::GetSplitKey(
           return STATUS(IllegalState, "Tablet has orphaned post-split data");
         }
         std::string partition_split_hash_key;
-        const auto split_encoded_key =
-            VERIFY_RESULT(tablet->GetEncodedMiddleSplitKey(&partition_split_hash_key));
+        std::string split_encoded_key;
+        if (req->split_by_key_access()) {
+          auto median_key = tablet->GetEncodedMedianAccessedSplitKey(&partition_split_hash_key);
+          if (median_key.ok()) {
+            split_encoded_key = std::move(*median_key);
+          } else {
+            LOG(INFO) << "Falling back to middle split key for tablet " << tablet->tablet_id()
+                      << ": " << median_key.status();
+            partition_split_hash_key.clear();
+          }
+        }
+        if (split_encoded_key.empty()) {
+          split_encoded_key =
+              VERIFY_RESULT(tablet->GetEncodedMiddleSplitKey(&partition_split_hash_key));
+        }
         resp->set_split_encoded_key(split_encoded_key);
         resp->set_split_partition_key(partition_split_hash_key.size() ? partition_split_hash_key
                                                                       : split_encoded_key);
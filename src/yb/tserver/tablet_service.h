@@ -111,10 +111,14 @@ class TabletServiceImpl : public TabletServerServiceIf, public ReadTabletProvide
                   ImportDataResponsePB* resp,
                   rpc::RpcContext context) override;
 
-  void UpdateTransaction(const UpdateTransactionRequestPB* req,
-                         UpdateTransactionResponsePB* resp,
+  void UpdateTransaction(const LWUpdateTransactionRequestPB* req,
+                         LWUpdateTransactionResponsePB* resp,
                          rpc::RpcContext context) override;
 
+  void UpdateTransactions(const UpdateTransactionsRequestPB* req,
+                          UpdateTransactionsResponsePB* resp,
+                          rpc::RpcContext context) override;
+
   void GetTransactionStatus(const GetTransactionStatusRequestPB* req,
                             GetTransactionStatusResponsePB* resp,
                             rpc::RpcContext context) override;
@@ -145,6 +149,10 @@ class TabletServiceImpl : public TabletServerServiceIf, public ReadTabletProvide
                 TruncateResponsePB* resp,
                 rpc::RpcContext context) override;
 
+  void IngestExternalFile(const IngestExternalFileRequestPB* req,
+                          IngestExternalFileResponsePB* resp,
+                          rpc::RpcContext context) override;
+
   void GetCompatibleSchemaVersion(const GetCompatibleSchemaVersionRequestPB* req,
                                   GetCompatibleSchemaVersionResponsePB* resp,
                                   rpc::RpcContext context) override;
@@ -311,8 +319,8 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                        consensus::LWConsensusResponsePB *resp,
                        rpc::RpcContext context) override;
 
-  void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB *req,
-                                consensus::MultiRaftConsensusResponsePB *resp,
+  void MultiRaftUpdateConsensus(const consensus::LWMultiRaftConsensusRequestPB *req,
+                                consensus::LWMultiRaftConsensusResponsePB *resp,
                                 rpc::RpcContext context) override;
 
   void RequestConsensusVote(const consensus::VoteRequestPB* req,
@@ -355,6 +363,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                             consensus::StartRemoteBootstrapResponsePB* resp,
                             rpc::RpcContext context) override;
 
+  void GetReadIndex(const consensus::GetReadIndexRequestPB* req,
+                    consensus::GetReadIndexResponsePB* resp,
+                    rpc::RpcContext context) override;
+
  private:
   void CompleteUpdateConsensusResponse(std::shared_ptr<tablet::TabletPeer> tablet_peer,
                                        consensus::LWConsensusResponsePB* resp);
@@ -90,6 +90,7 @@
 
 #include "yb/tserver/full_compaction_manager.h"
 #include "yb/tserver/heartbeater.h"
+#include "yb/tserver/read_index_batcher.h"
 #include "yb/tserver/remote_bootstrap_client.h"
 #include "yb/tserver/remote_bootstrap_session.h"
 #include "yb/tserver/tablet_server.h"
@@ -522,6 +523,8 @@ Status TSTabletManager::Init() {
   multi_raft_manager_ = std::make_unique<consensus::MultiRaftManager>(server_->messenger(),
                                                                       &server_->proxy_cache(),
                                                                       local_peer_pb_.cloud_info());
+  read_index_batcher_ = std::make_unique<ReadIndexBatcher>(
+      &server_->proxy_cache(), local_peer_pb_.cloud_info());
 
   if (FLAGS_enable_wait_queues) {
     waiting_txn_registry_ = std::make_unique<docdb::LocalWaitingTxnRegistry>(
@@ -687,6 +690,7 @@ void TSTabletManager::CleanupSplitTablets() {
   VLOG_WITH_PREFIX_AND_FUNC(3) << "looking for tablets to cleanup...";
   auto tablet_peers = GetTabletPeers();
   for (const auto& tablet_peer : tablet_peers) {
+    tablet_peer->CleanupStagedExternalFiles();
     if (tablet_peer->CanBeDeleted()) {
       const auto& tablet_id = tablet_peer->tablet_id();
       if (PREDICT_FALSE(FLAGS_TEST_skip_deleting_split_tablets)) {
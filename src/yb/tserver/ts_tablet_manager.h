@@ -97,6 +97,7 @@ class RaftConfigPB;
 namespace tserver {
 class TabletServer;
 class FullCompactionManager;
+class ReadIndexBatcher;
 
 using rocksdb::MemoryMonitor;
 
@@ -347,6 +348,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   FullCompactionManager* full_compaction_manager() { return full_compaction_manager_.get(); }
 
+  ReadIndexBatcher* read_index_batcher() { return read_index_batcher_.get(); }
+
   Status UpdateSnapshotsInfo(const master::TSSnapshotsInfoPB& info);
 
   // Background task that verifies the data on each tablet for consistency.
@@ -638,6 +641,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
 
   std::unique_ptr<consensus::MultiRaftManager> multi_raft_manager_;
 
+  std::unique_ptr<ReadIndexBatcher> read_index_batcher_;
+
   TabletPeers shutting_down_peers_;
 
   std::shared_ptr<TabletMemoryManager> mem_manager_;
@@ -95,6 +95,9 @@ void TServerMetricsHeartbeatDataProvider::DoAddData(
           storage_metadata->set_uncompressed_sst_file_size(sizes.second);
           storage_metadata->set_may_have_orphaned_post_split_data(
                 tablet->MayHaveOrphanedPostSplitData());
+          auto access_rates = tablet->access_tracker().TakeRates();
+          storage_metadata->set_read_ops_per_sec(access_rates.read_ops_per_sec);
+          storage_metadata->set_write_ops_per_sec(access_rates.write_ops_per_sec);
           if (FLAGS_tserver_heartbeat_metrics_add_leader_info) {
             auto consensus = tablet_peer->shared_raft_consensus();
             if (consensus) {
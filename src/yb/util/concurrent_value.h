@@ -291,6 +291,12 @@ class ConcurrentValue {
     DoSet(new T(std::move(t)));
   }
 
+  // Waits until all references obtained via get() before this call are released. Could be used to
+  // reclaim objects that are reachable from the value and were replaced without replacing it.
+  void Synchronize() {
+    urcu_.Synchronize();
+  }
+
  private:
   void DoSet(T* new_value) {
     auto* old_value = value_.exchange(new_value, std::memory_order_acq_rel);
@@ -0,0 +1,356 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/io_uring.h"
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "yb/util/errno.h"
+#include "yb/util/status_format.h"
+
+namespace yb {
+
+// IO_URING_OP_SUPPORTED was added together with IORING_REGISTER_PROBE and IORING_OP_SENDMSG in
+// 5.6 headers, IORING_FEAT_SINGLE_MMAP in 5.4. Those are enum values or macros that could be
+// missing in older headers, so the stub is used in this case.
+#if defined(__linux__) && defined(__NR_io_uring_setup) && defined(IO_URING_OP_SUPPORTED) && \
+    defined(IORING_FEAT_SINGLE_MMAP)
+
+namespace {
+
+int IoUringSetup(uint32_t entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return static_cast<int>(syscall(
+      __NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int fd, uint32_t opcode, void* arg, uint32_t nr_args) {
+  return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <class T>
+T* RingField(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+// Ring head and tail are shared with the kernel.
+uint32_t LoadAcquire(const uint32_t* ptr) {
+  return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void StoreRelease(uint32_t* ptr, uint32_t value) {
+  __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+} // namespace
+
+class IoUring::Impl {
+ public:
+  ~Impl() {
+    if (sqes_) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+    if (event_fd_ >= 0) {
+      close(event_fd_);
+    }
+  }
+
+  Status Init(uint32_t entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = IoUringSetup(entries, &params);
+    if (fd_ < 0) {
+      return STATUS(NotSupported, "io_uring_setup failed", Errno(errno));
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = VERIFY_RESULT(Map(sq_ring_size_, IORING_OFF_SQ_RING));
+    cq_ring_ = single_mmap ? sq_ring_ : VERIFY_RESULT(Map(cq_ring_size_, IORING_OFF_CQ_RING));
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(VERIFY_RESULT(Map(sqes_size_, IORING_OFF_SQES)));
+
+    sq_head_ = RingField<uint32_t>(sq_ring_, params.sq_off.head);
+    sq_tail_ = RingField<uint32_t>(sq_ring_, params.sq_off.tail);
+    sq_mask_ = *RingField<uint32_t>(sq_ring_, params.sq_off.ring_mask);
+    sq_array_ = RingField<uint32_t>(sq_ring_, params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+    cq_head_ = RingField<uint32_t>(cq_ring_, params.cq_off.head);
+    cq_tail_ = RingField<uint32_t>(cq_ring_, params.cq_off.tail);
+    cq_mask_ = *RingField<uint32_t>(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = RingField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+
+    RETURN_NOT_OK(CheckSendMsgSupported());
+
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd_ < 0) {
+      return STATUS(IOError, "Failed to create io_uring event fd", Errno(errno));
+    }
+    if (IoUringRegister(fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) < 0) {
+      return STATUS(NotSupported, "Failed to register io_uring event fd", Errno(errno));
+    }
+    return Status::OK();
+  }
+
+  int completion_fd() const {
+    return event_fd_;
+  }
+
+  size_t capacity() const {
+    // Entries are not queued while the completion queue could overflow, since the completion queue
+    // is twice as large as the submission queue, it is enough to limit entries that are in flight.
+    return sq_entries_ - queued_ - in_flight_;
+  }
+
+  size_t in_flight() const {
+    return in_flight_;
+  }
+
+  bool PrepareSendMsg(int fd, const msghdr* msg, int flags, uint64_t user_data) {
+    // Only this side advances the submission queue tail.
+    const auto tail = *sq_tail_;
+    if (capacity() == 0 || tail - LoadAcquire(sq_head_) >= sq_entries_) {
+      return false;
+    }
+    const auto index = tail & sq_mask_;
+    auto& sqe = sqes_[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_SENDMSG;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(msg);
+    sqe.len = 1;
+    sqe.msg_flags = static_cast<uint32_t>(flags);
+    sqe.user_data = user_data;
+    sq_array_[index] = index;
+    StoreRelease(sq_tail_, tail + 1);
+    ++queued_;
+    return true;
+  }
+
+  Result<size_t> Submit() {
+    size_t result = 0;
+    while (queued_) {
+      auto submitted = IoUringEnter(fd_, queued_, 0, 0);
+      if (submitted < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return STATUS(IOError, "io_uring_enter failed", Errno(errno));
+      }
+      if (submitted == 0) {
+        return STATUS_FORMAT(IllegalState, "io_uring did not accept $0 entries", queued_);
+      }
+      queued_ -= submitted;
+      in_flight_ += submitted;
+      result += submitted;
+    }
+    return result;
+  }
+
+  size_t ReapCompletions(const CompletionHandler& handler) {
+    // Reset the event counter before reaping, so completions that arrive after it signal the event
+    // fd again.
+    uint64_t events;
+    while (read(event_fd_, &events, sizeof(events)) < 0 && errno == EINTR) {
+    }
+
+    completions_.clear();
+    auto head = *cq_head_;
+    const auto tail = LoadAcquire(cq_tail_);
+    for (; head != tail; ++head) {
+      const auto& cqe = cqes_[head & cq_mask_];
+      completions_.emplace_back(cqe.user_data, cqe.res);
+    }
+    StoreRelease(cq_head_, head);
+    in_flight_ -= completions_.size();
+
+    for (const auto& [user_data, res] : completions_) {
+      handler(user_data, res);
+    }
+    return completions_.size();
+  }
+
+  Result<size_t> WaitAll(const CompletionHandler& handler) {
+    size_t result = 0;
+    while (in_flight_) {
+      if (IoUringEnter(fd_, 0, in_flight_, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+        return STATUS(IOError, "io_uring_enter failed", Errno(errno));
+      }
+      result += ReapCompletions(handler);
+    }
+    return result;
+  }
+
+ private:
+  Result<void*> Map(size_t size, uint64_t offset) {
+    auto* result = mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+        static_cast<off_t>(offset));
+    if (result == MAP_FAILED) {
+      return STATUS(NotSupported, "Failed to map io_uring", Errno(errno));
+    }
+    return result;
+  }
+
+  Status CheckSendMsgSupported() {
+    constexpr size_t kMaxOps = 256;
+    std::vector<char> buffer(sizeof(io_uring_probe) + kMaxOps * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+    if (IoUringRegister(fd_, IORING_REGISTER_PROBE, probe, kMaxOps) < 0) {
+      return STATUS(NotSupported, "Failed to probe io_uring operations", Errno(errno));
+    }
+    if (probe->last_op < IORING_OP_SENDMSG ||
+        !(probe->ops[IORING_OP_SENDMSG].flags & IO_URING_OP_SUPPORTED)) {
+      return STATUS(NotSupported, "io_uring does not support sendmsg");
+    }
+    return Status::OK();
+  }
+
+  int fd_ = -1;
+  int event_fd_ = -1;
+
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_entries_ = 0;
+  uint32_t* cq_head_ = nullptr;
+  uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  // Entries that were queued but not submitted yet.
+  uint32_t queued_ = 0;
+  // Entries that were submitted but not completed yet.
+  uint32_t in_flight_ = 0;
+  // Completions reaped by ReapCompletions, member field to avoid memory allocation.
+  std::vector<std::pair<uint64_t, int32_t>> completions_;
+};
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t entries) {
+  auto impl = std::make_unique<Impl>();
+  RETURN_NOT_OK(impl->Init(entries));
+  return std::unique_ptr<IoUring>(new IoUring(std::move(impl)));
+}
+
+int IoUring::completion_fd() const {
+  return impl_->completion_fd();
+}
+
+size_t IoUring::capacity() const {
+  return impl_->capacity();
+}
+
+size_t IoUring::in_flight() const {
+  return impl_->in_flight();
+}
+
+bool IoUring::PrepareSendMsg(int fd, const msghdr* msg, int flags, uint64_t user_data) {
+  return impl_->PrepareSendMsg(fd, msg, flags, user_data);
+}
+
+Result<size_t> IoUring::Submit() {
+  return impl_->Submit();
+}
+
+size_t IoUring::ReapCompletions(const CompletionHandler& handler) {
+  return impl_->ReapCompletions(handler);
+}
+
+Result<size_t> IoUring::WaitAll(const CompletionHandler& handler) {
+  return impl_->WaitAll(handler);
+}
+
+#else
+
+class IoUring::Impl {
+};
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t entries) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+int IoUring::completion_fd() const {
+  return -1;
+}
+
+size_t IoUring::capacity() const {
+  return 0;
+}
+
+size_t IoUring::in_flight() const {
+  return 0;
+}
+
+bool IoUring::PrepareSendMsg(int fd, const msghdr* msg, int flags, uint64_t user_data) {
+  return false;
+}
+
+Result<size_t> IoUring::Submit() {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+size_t IoUring::ReapCompletions(const CompletionHandler& handler) {
+  return 0;
+}
+
+Result<size_t> IoUring::WaitAll(const CompletionHandler& handler) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+#endif
+
+IoUring::IoUring(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {
+}
+
+IoUring::~IoUring() = default;
+
+} // namespace yb
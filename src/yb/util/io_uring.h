@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#pragma once
+
+#include <sys/socket.h>
+
+#include <functional>
+#include <memory>
+
+#include "yb/util/result.h"
+
+namespace yb {
+
+// Minimal io_uring ring, that is driven by raw syscalls, since liburing is not a thirdparty
+// dependency. Only supports what RPC layer needs: batched sendmsg submission and reaping of
+// completions, that are signalled via an eventfd, so the ring could be polled by an event loop.
+//
+// Not thread safe, should be used from a single thread, e.g. a reactor thread.
+class IoUring {
+ public:
+  // Invoked for each completion with user data of the entry and its result, i.e. the number of
+  // bytes sent or a negated errno.
+  using CompletionHandler = std::function<void(uint64_t user_data, int32_t res)>;
+
+  ~IoUring();
+
+  // Returns NotSupported if io_uring or IORING_OP_SENDMSG is not available, e.g. on other
+  // platforms, on kernels older than 5.6, when the binary was built against older kernel headers,
+  // or when io_uring is disabled by seccomp or sysctl.
+  static Result<std::unique_ptr<IoUring>> Create(uint32_t entries);
+
+  // Event fd that becomes readable when there are completions to reap.
+  int completion_fd() const;
+
+  // Number of entries that could be queued before the next submission, entries that were
+  // submitted but not reaped yet are also taken into account.
+  size_t capacity() const;
+
+  // Number of entries that were submitted but not reaped yet.
+  size_t in_flight() const;
+
+  // Queues sendmsg of msg to fd. msg and the buffers it refers to should stay valid until the
+  // entry is completed. Returns false if the submission queue is full.
+  bool PrepareSendMsg(int fd, const msghdr* msg, int flags, uint64_t user_data);
+
+  // Submits all queued entries with a single io_uring_enter, without waiting for their completion.
+  // Returns the number of submitted entries.
+  Result<size_t> Submit();
+
+  // Invokes handler for each available completion, without blocking. Completions are reaped
+  // before the handler is invoked, so the handler could queue new entries. Returns the number of
+  // completions.
+  size_t ReapCompletions(const CompletionHandler& handler);
+
+  // Blocks until all submitted entries are completed and reaps them, used on shutdown when
+  // buffers referenced by entries are about to be released.
+  Result<size_t> WaitAll(const CompletionHandler& handler);
+
+ private:
+  class Impl;
+
+  explicit IoUring(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace yb
@@ -35,6 +35,10 @@
 #include <netinet/in.h>
 #include <sys/types.h>
 
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#endif
+
 #include <limits>
 #include <string>
 
@@ -66,6 +70,22 @@ DEFINE_UNKNOWN_bool(socket_inject_short_recvs, false,
 TAG_FLAG(socket_inject_short_recvs, hidden);
 TAG_FLAG(socket_inject_short_recvs, unsafe);
 
+#if defined(__linux__)
+// Older glibc headers do not provide these constants, values are from the kernel ABI.
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+#endif
+
 namespace yb {
 
 size_t IoVecsFullSize(const IoVecs& io_vecs) {
@@ -271,6 +291,33 @@ Status Socket::SetReuseAddr(bool flag) {
   return Status::OK();
 }
 
+Status Socket::SetReusePort(bool flag) {
+  int int_flag = flag ? 1 : 0;
+  if (setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &int_flag, sizeof(int_flag)) == -1) {
+    return STATUS(NetworkError, "Failed to set SO_REUSEPORT", Errno(errno));
+  }
+  return Status::OK();
+}
+
+Status Socket::SetLingerZero() {
+  struct linger linger_value = { .l_onoff = 1, .l_linger = 0 };
+  if (setsockopt(fd_, SOL_SOCKET, SO_LINGER, &linger_value, sizeof(linger_value)) == -1) {
+    return STATUS(NetworkError, "Failed to set SO_LINGER", Errno(errno));
+  }
+  return Status::OK();
+}
+
+Status Socket::SetIncomingCpu(int cpu) {
+#if defined(SO_INCOMING_CPU)
+  if (setsockopt(fd_, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu)) == -1) {
+    return STATUS(NetworkError, "Failed to set SO_INCOMING_CPU", Errno(errno));
+  }
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "SO_INCOMING_CPU is not supported on this platform");
+#endif
+}
+
 Status Socket::BindAndListen(const Endpoint& sockaddr,
                              int listenQueueSize) {
   RETURN_NOT_OK(SetReuseAddr(true));
@@ -450,6 +497,92 @@ Result<size_t> Socket::Writev(const struct ::iovec *iov, int iov_len) {
   return res;
 }
 
+Status Socket::SetZeroCopy(bool enabled) {
+#if defined(__linux__)
+  int flag = enabled ? 1 : 0;
+  if (setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &flag, sizeof(flag)) == -1) {
+    if (errno == ENOPROTOOPT || errno == EOPNOTSUPP) {
+      return STATUS(NotSupported, "SO_ZEROCOPY is not supported", Errno(errno));
+    }
+    return STATUS(NetworkError, "Failed to set SO_ZEROCOPY", Errno(errno));
+  }
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "SO_ZEROCOPY is not supported on this platform");
+#endif
+}
+
+Result<size_t> Socket::WritevZeroCopy(const struct ::iovec *iov, int iov_len) {
+#if defined(__linux__)
+  if (PREDICT_FALSE(iov_len <= 0)) {
+    return STATUS(NetworkError,
+                  StringPrintf("WritevZeroCopy: invalid io vector length of %d", iov_len),
+                  Slice() /* msg2 */, Errno(EINVAL));
+  }
+  DCHECK_GE(fd_, 0);
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(struct msghdr));
+  msg.msg_iov = const_cast<iovec *>(iov);
+  msg.msg_iovlen = iov_len;
+  auto res = ::sendmsg(fd_, &msg, MSG_NOSIGNAL | MSG_ZEROCOPY);
+  if (PREDICT_FALSE(res < 0)) {
+    if (IsTemporarySocketError(errno)) {
+      static const Status try_write_again = STATUS(TryAgain, "Write not yet ready");
+      return try_write_again;
+    }
+    if (errno == ENOBUFS) {
+      return STATUS(Busy, "Zero copy send limit reached", Errno(errno));
+    }
+    return STATUS(NetworkError, "sendmsg error", Errno(errno));
+  }
+
+  return res;
+#else
+  return STATUS(NotSupported, "MSG_ZEROCOPY is not supported on this platform");
+#endif
+}
+
+Result<bool> Socket::ReadZeroCopyCompletion(ZeroCopyCompletion* out) {
+#if defined(__linux__)
+  DCHECK_GE(fd_, 0);
+  char control[CMSG_SPACE(sizeof(sock_extended_err))];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(struct msghdr));
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  for (;;) {
+    auto res = ::recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+    if (res < 0) {
+      if (IsTemporarySocketError(errno)) {
+        return false;
+      }
+      return STATUS(NetworkError, "recvmsg error queue error", Errno(errno));
+    }
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      const bool is_recverr =
+          (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+          (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+      if (!is_recverr) {
+        continue;
+      }
+      const auto* err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+      if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      out->first = err->ee_info;
+      out->last = err->ee_data;
+      out->copied = (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
+      return true;
+    }
+    // Not a zero copy notification, skip it.
+    msg.msg_controllen = sizeof(control);
+  }
+#else
+  return false;
+#endif
+}
+
 // Mostly follows writen() from Stevens (2004) or Kerrisk (2010).
 Status Socket::BlockingWrite(const uint8_t *buf, size_t buflen, const MonoTime& deadline) {
   DCHECK_LE(buflen, std::numeric_limits<int32_t>::max()) << "Writes > INT32_MAX not supported";
@@ -46,6 +46,14 @@ namespace yb {
 class MonoDelta;
 class MonoTime;
 
+// Range of zero copy send calls reported as completed by the kernel, see Socket::WritevZeroCopy.
+struct ZeroCopyCompletion {
+  uint32_t first;
+  uint32_t last;
+  // Kernel had to copy the data instead of sending it from user pages.
+  bool copied;
+};
+
 // Vector of io buffers. Could be used with receive, already received data etc.
 typedef boost::container::small_vector<::iovec, 4> IoVecs;
 
@@ -111,6 +119,17 @@ class Socket {
   // Sets SO_REUSEADDR to 'flag'. Should be used prior to Bind().
   Status SetReuseAddr(bool flag);
 
+  // Sets SO_REUSEPORT to 'flag'. Should be used prior to Bind().
+  Status SetReusePort(bool flag);
+
+  // Enables SO_LINGER with zero timeout, so Close() resets the connection and drops unsent data
+  // instead of sending it in the background.
+  Status SetLingerZero();
+
+  // Sets SO_INCOMING_CPU, so connections accepted on this listening socket are preferably those
+  // whose packets are processed on the specified cpu. Returns NotSupported if unavailable.
+  Status SetIncomingCpu(int cpu);
+
   // Convenience method to invoke the common sequence:
   // 1) SetReuseAddr(true)
   // 2) Bind()
@@ -146,6 +165,21 @@ class Socket {
 
   Result<size_t> Writev(const struct ::iovec *iov, int iov_len);
 
+  // Enables SO_ZEROCOPY on the socket. Returns NotSupported if the platform or kernel does not
+  // support it.
+  Status SetZeroCopy(bool enabled);
+
+  // Same as Writev, but sends data with MSG_ZEROCOPY. Pages referenced by iov should not be
+  // modified or released until the kernel reports completion of this call via
+  // ReadZeroCopyCompletion. Each successful call is assigned the next sequence number, starting
+  // from 0. Returns Busy when the kernel cannot pin more pages, the caller should fall back to
+  // Writev in this case.
+  Result<size_t> WritevZeroCopy(const struct ::iovec *iov, int iov_len);
+
+  // Reads next zero copy completion from the socket error queue.
+  // Returns false if there are no pending notifications.
+  Result<bool> ReadZeroCopyCompletion(ZeroCopyCompletion* out);
+
   // Blocking Write call, returns IOError unless full buffer is sent.
   // Underlying Socket expected to be in blocking mode. Fails if any Write() sends 0 bytes.
   // Returns OK if buflen bytes were sent, otherwise IOError.